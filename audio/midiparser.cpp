@@ -22,9 +22,20 @@
 
 #include "audio/midiparser.h"
 #include "audio/mididrv.h"
+#include "common/algorithm.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
+// The number of events jumpToTick() parses between two checkpoints
+#define CHECKPOINT_INTERVAL 256
+
+// Flags of CheckpointMessage::parameter, besides the parameter number or
+// the bank select values. The MSB and LSB flags are used for both.
+#define DATA_ENTRY_NRPN      0x04000
+#define DATA_ENTRY_MSB_SET   0x10000
+#define DATA_ENTRY_LSB_SET   0x20000
+#define BANK_SELECT_SAVED    0x40000
+
 //////////////////////////////////////////////////
 //
 // MidiParser implementation
@@ -45,7 +56,9 @@ _sendSustainOffOnNotesOff(false),
 _numTracks(0),
 _activeTrack(255),
 _abortParse(false),
-_jumpingToTick(false) {
+_jumpingToTick(false),
+_useCheckpoints(false),
+_checkpointTrack(0) {
 	memset(_activeNotes, 0, sizeof(_activeNotes));
 	memset(_tracks, 0, sizeof(_tracks));
 	_nextEvent.start = NULL;
@@ -393,9 +406,52 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 	Tracker currentPos(_position);
 	EventInfo currentEvent(_nextEvent);
 
+	if (_checkpointTrack != _tracks[_activeTrack]) {
+		clearCheckpoints();
+		_checkpointTrack = _tracks[_activeTrack];
+	}
+
+	// Events before the first tempo event are timed with the current tempo
+	const uint32 startPsecPerTick = _psecPerTick;
+
 	resetTracking();
 	_position._playPos = _tracks[_activeTrack];
-	parseNextEvent(_nextEvent);
+
+	// Checkpoints do not include the notes which are playing, so they can
+	// only be used if the notes the jump passes are not sent, or stopped
+	int checkpoint = -1;
+	if (tick > 0 && _useCheckpoints && (!fireEvents || stopNotes || dontSendNoteOn))
+		checkpoint = findCheckpoint(tick);
+
+	if (checkpoint >= 0)
+		restoreCheckpoint(checkpoint, startPsecPerTick, fireEvents);
+	else
+		parseNextEvent(_nextEvent);
+
+	// New checkpoints are recorded when parsing beyond the last one
+	const bool recording = tick > 0 && _useCheckpoints && checkpoint + 1 == (int)_checkpoints.size();
+	bool tempoChanged = false;
+	uint32 ticksBeforeTempo = 0;
+	uint32 sequence = 0;
+	uint eventsSinceCheckpoint = 0;
+
+	if (recording) {
+		_checkpointChannelState.clear();
+		if (checkpoint >= 0) {
+			const Checkpoint &cp = _checkpoints[checkpoint];
+			for (uint i = 0; i < cp.messageCount; i++) {
+				const CheckpointMessage &message = _checkpointMessages[cp.firstMessage + i];
+				recordCheckpointEvent(message, message.sequence);
+			}
+			_checkpointKeptEvents.resize(cp.keptEventCount);
+			tempoChanged = cp.tempoChanged;
+			ticksBeforeTempo = cp.ticksBeforeTempo;
+			sequence = cp.sequence;
+		} else {
+			_checkpointKeptEvents.clear();
+		}
+	}
+
 	if (tick > 0) {
 		while (true) {
 			EventInfo &info = _nextEvent;
@@ -422,10 +478,25 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 				_jumpingToTick = false;
 				return false;
 			} else {
+				const uint32 psecPerTick = _psecPerTick;
 				processEvent(info, fireEvents);
+
+				if (recording) {
+					if (!tempoChanged && _psecPerTick != psecPerTick) {
+						tempoChanged = true;
+						ticksBeforeTempo = _position._lastEventTick;
+					}
+					recordCheckpointEvent(info, sequence);
+				}
 			}
 
+			sequence++;
 			parseNextEvent(_nextEvent);
+
+			if (recording && ++eventsSinceCheckpoint >= CHECKPOINT_INTERVAL && saveCheckpointState()) {
+				addCheckpoint(startPsecPerTick, tempoChanged, ticksBeforeTempo, sequence);
+				eventsSinceCheckpoint = 0;
+			}
 		}
 	}
 
@@ -450,9 +521,219 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 	return true;
 }
 
+void MidiParser::clearCheckpoints() {
+	_checkpointTrack = 0;
+	_checkpoints.clear();
+	_checkpointMessages.clear();
+	_checkpointKeptEvents.clear();
+	_checkpointChannelState.clear();
+}
+
+bool MidiParser::keepEventForCheckpoints(const EventInfo &info) {
+	// SysEx, META and system common events
+	return info.command() == 0xF;
+}
+
+void MidiParser::replayCheckpointEvent(const EventInfo &info, bool fireEvents) {
+	if (fireEvents)
+		processEvent(info, true);
+}
+
+int MidiParser::findCheckpoint(uint32 tick) const {
+	// The last checkpoint which the jump would parse through: all events
+	// before it need to come before the target tick
+	int low = 0, high = _checkpoints.size();
+	while (low < high) {
+		int mid = (low + high) / 2;
+		if (_checkpoints[mid].position._lastEventTick < tick)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low - 1;
+}
+
+void MidiParser::restoreCheckpoint(uint index, uint32 startPsecPerTick, bool fireEvents) {
+	const Checkpoint &cp = _checkpoints[index];
+
+	restoreCheckpointState(index);
+
+	// Bring the device up to date, keeping the order in which the
+	// channel state and the kept events were sent
+	const CheckpointMessage *message = &_checkpointMessages[cp.firstMessage];
+	const CheckpointMessage *messageEnd = message + cp.messageCount;
+	for (uint i = 0; i < cp.keptEventCount; i++) {
+		const CheckpointKeptEvent &kept = _checkpointKeptEvents[i];
+		for (; fireEvents && message != messageEnd && message->sequence < kept.sequence; ++message)
+			sendCheckpointMessage(*message);
+		replayCheckpointEvent(kept.info, fireEvents);
+	}
+	for (; fireEvents && message != messageEnd; ++message)
+		sendCheckpointMessage(*message);
+
+	_position = cp.position;
+	_nextEvent = cp.nextEvent;
+
+	if (cp.tempoChanged) {
+		_tempo = cp.tempo;
+		_psecPerTick = cp.psecPerTick;
+		_position._lastEventTime = cp.ticksBeforeTempo * startPsecPerTick + cp.timeAfterTempo;
+	} else {
+		_position._lastEventTime = cp.position._lastEventTick * startPsecPerTick;
+	}
+	_position._playTime = _position._lastEventTime;
+}
+
+bool MidiParser::checkpointMessageLess(const CheckpointMessage &a, const CheckpointMessage &b) {
+	return a.sequence < b.sequence;
+}
+
+void MidiParser::addCheckpoint(uint32 startPsecPerTick, bool tempoChanged, uint32 ticksBeforeTempo, uint32 sequence) {
+	Checkpoint cp;
+	cp.position = _position;
+	cp.nextEvent = _nextEvent;
+	cp.tempo = _tempo;
+	cp.psecPerTick = _psecPerTick;
+	cp.tempoChanged = tempoChanged;
+	cp.ticksBeforeTempo = ticksBeforeTempo;
+	cp.timeAfterTempo = _position._lastEventTime - ticksBeforeTempo * startPsecPerTick;
+	cp.sequence = sequence;
+	cp.firstMessage = _checkpointMessages.size();
+	cp.messageCount = _checkpointChannelState.size();
+	cp.keptEventCount = _checkpointKeptEvents.size();
+
+	for (CheckpointChannelState::const_iterator i = _checkpointChannelState.begin(); i != _checkpointChannelState.end(); ++i)
+		_checkpointMessages.push_back(i->_value);
+	Common::sort(_checkpointMessages.begin() + cp.firstMessage, _checkpointMessages.end(), checkpointMessageLess);
+
+	_checkpoints.push_back(cp);
+}
+
+void MidiParser::recordCheckpointEvent(const EventInfo &info, uint32 sequence) {
+	if (keepEventForCheckpoints(info)) {
+		CheckpointKeptEvent kept;
+		kept.sequence = sequence;
+		kept.info = info;
+		_checkpointKeptEvents.push_back(kept);
+		return;
+	}
+
+	CheckpointMessage message;
+	message.sequence = sequence;
+	message.message = info.event | ((uint32)info.basic.param1 << 8) | ((uint32)info.basic.param2 << 16);
+	message.parameter = 0;
+
+	recordCheckpointEvent(message, sequence);
+}
+
+void MidiParser::recordCheckpointEvent(const CheckpointMessage &message, uint32 sequence) {
+	const byte status = message.message & 0xFF;
+	const byte controller = (message.message >> 8) & 0xFF;
+	uint32 key;
+
+	switch (status >> 4) {
+	case 0xB:
+		// All sound off and all notes off only concern the notes
+		if (controller == 0x78 || controller == 0x7B)
+			return;
+		key = status | (controller << 8);
+		break;
+	case 0xC: // Program change
+	case 0xD: // Channel pressure
+	case 0xE: // Pitch bend
+		key = status;
+		break;
+	default:
+		// Notes and polyphonic key pressure
+		return;
+	}
+
+	CheckpointMessage entry = message;
+	entry.sequence = sequence;
+
+	// Data entry sets the selected RPN or NRPN, so there is a value for each
+	if (status >> 4 == 0xB && (controller == 0x06 || controller == 0x26)) {
+		if (!entry.parameter)
+			entry.parameter = getDataEntryParameter(status & 0x0F);
+		key |= (entry.parameter & 0xFFFF) << 16;
+	}
+
+	// A program change selects the program from the bank selected at that
+	// time, which may have changed since
+	if (status >> 4 == 0xC && !entry.parameter)
+		entry.parameter = getBankSelect(status & 0x0F);
+
+	_checkpointChannelState[key] = entry;
+}
+
+uint32 MidiParser::getDataEntryParameter(byte channel) const {
+	// Parameter numbers which have not been sent are taken as 0x7F, the
+	// null parameter
+	uint32 rpnSequence = 0, nrpnSequence = 0;
+	uint32 rpn = 0x3FFF, nrpn = DATA_ENTRY_NRPN | 0x3FFF;
+
+	for (int i = 0; i < 2; i++) {
+		// MSB first
+		const uint32 shift = i ? 0 : 7;
+		const uint32 set = i ? DATA_ENTRY_LSB_SET : DATA_ENTRY_MSB_SET;
+
+		CheckpointChannelState::const_iterator it = _checkpointChannelState.find((0xB0 | channel) | ((i ? 0x64 : 0x65) << 8));
+		if (it != _checkpointChannelState.end()) {
+			rpn = (rpn & ~(0x7F << shift)) | set | (((it->_value.message >> 16) & 0x7F) << shift);
+			rpnSequence = MAX(rpnSequence, it->_value.sequence + 1);
+		}
+
+		it = _checkpointChannelState.find((0xB0 | channel) | ((i ? 0x62 : 0x63) << 8));
+		if (it != _checkpointChannelState.end()) {
+			nrpn = (nrpn & ~(0x7F << shift)) | set | (((it->_value.message >> 16) & 0x7F) << shift);
+			nrpnSequence = MAX(nrpnSequence, it->_value.sequence + 1);
+		}
+	}
+
+	// Whichever kind was selected last
+	return nrpnSequence > rpnSequence ? nrpn : rpn;
+}
+
+uint32 MidiParser::getBankSelect(byte channel) const {
+	uint32 bank = BANK_SELECT_SAVED;
+
+	CheckpointChannelState::const_iterator it = _checkpointChannelState.find((0xB0 | channel) | (0x00 << 8));
+	if (it != _checkpointChannelState.end())
+		bank |= DATA_ENTRY_MSB_SET | (((it->_value.message >> 16) & 0x7F) << 7);
+
+	it = _checkpointChannelState.find((0xB0 | channel) | (0x20 << 8));
+	if (it != _checkpointChannelState.end())
+		bank |= DATA_ENTRY_LSB_SET | ((it->_value.message >> 16) & 0x7F);
+
+	return bank;
+}
+
+void MidiParser::sendCheckpointMessage(const CheckpointMessage &message) {
+	// Select the parameter the value was meant for, or the bank the program
+	// was meant for. The selection which was active at the checkpoint has
+	// its own messages, which come after this one if it differs.
+	const byte status = message.message & 0xFF;
+	if (message.parameter & BANK_SELECT_SAVED) {
+		const byte controlStatus = 0xB0 | (status & 0x0F);
+		if (message.parameter & DATA_ENTRY_MSB_SET)
+			sendToDriver(controlStatus, 0x00, (message.parameter >> 7) & 0x7F);
+		if (message.parameter & DATA_ENTRY_LSB_SET)
+			sendToDriver(controlStatus, 0x20, message.parameter & 0x7F);
+	} else {
+		const bool nrpn = (message.parameter & DATA_ENTRY_NRPN) != 0;
+		if (message.parameter & DATA_ENTRY_MSB_SET)
+			sendToDriver(status, nrpn ? 0x63 : 0x65, (message.parameter >> 7) & 0x7F);
+		if (message.parameter & DATA_ENTRY_LSB_SET)
+			sendToDriver(status, nrpn ? 0x62 : 0x64, message.parameter & 0x7F);
+	}
+
+	sendToDriver(message.message);
+}
+
 void MidiParser::unloadMusic() {
 	resetTracking();
 	allNotesOff();
+	clearCheckpoints();
 	_numTracks = 0;
 	_activeTrack = 255;
 	_abortParse = true;
@@ -26,7 +26,9 @@
 #define AUDIO_MIDIPARSER_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/endian.h"
+#include "common/hashmap.h"
 
 class MidiDriver_BASE;
 
@@ -289,6 +291,53 @@ protected:
 	bool   _abortParse;    ///< If a jump or other operation interrupts parsing, flag to abort.
 	bool   _jumpingToTick; ///< True if currently inside jumpToTick
 
+	/**
+	 * The parser state at a point of the active track, recorded while
+	 * jumpToTick() parses the track, so that later jumps can start from
+	 * the nearest checkpoint instead of the start of the track.
+	 */
+	struct Checkpoint {
+		Tracker position;        ///< The position. Its times are recomputed when restoring it
+		EventInfo nextEvent;     ///< The preparsed event at the position
+		uint32 tempo;            ///< The tempo, if tempoChanged is set
+		uint32 psecPerTick;
+		bool   tempoChanged;     ///< True if a tempo event came before the checkpoint
+		uint32 ticksBeforeTempo; ///< Ticks before the first tempo event, which play at the tempo the jump started with
+		uint32 timeAfterTempo;   ///< Microseconds since the first tempo event
+		uint32 sequence;         ///< Number of events processed before the checkpoint
+		uint   firstMessage;     ///< The channel state at the checkpoint, in _checkpointMessages
+		uint   messageCount;
+		uint   keptEventCount;   ///< Number of entries of _checkpointKeptEvents before the checkpoint
+	};
+
+	/**
+	 * The last value sent for one piece of channel state (a controller,
+	 * program, pitch bend or channel pressure).
+	 */
+	struct CheckpointMessage {
+		uint32 sequence;  ///< Number of events processed before this one
+		uint32 message;   ///< The event, packed like for sendToDriver()
+		uint32 parameter; ///< For data entry, the selected RPN or NRPN (see getDataEntryParameter()), for program changes the selected bank (see getBankSelect())
+	};
+
+	/**
+	 * An event which cannot be summarized by channel state, like a SysEx
+	 * event. These are all replayed when a checkpoint is restored.
+	 */
+	struct CheckpointKeptEvent {
+		uint32 sequence;
+		EventInfo info;
+	};
+
+	typedef Common::HashMap<uint32, CheckpointMessage> CheckpointChannelState;
+
+	bool   _useCheckpoints;    ///< Set by formats which support checkpoints in jumpToTick()
+	byte  *_checkpointTrack;   ///< The track the checkpoints belong to
+	Common::Array<Checkpoint> _checkpoints;
+	Common::Array<CheckpointMessage> _checkpointMessages;
+	Common::Array<CheckpointKeptEvent> _checkpointKeptEvents;
+	CheckpointChannelState _checkpointChannelState; ///< The channel state while recording checkpoints
+
 protected:
 	static uint32 readVLQ(byte * &data);
 	virtual void resetTracking();
@@ -296,10 +345,52 @@ protected:
 	virtual void parseNextEvent(EventInfo &info) = 0;
 	virtual bool processEvent(const EventInfo &info, bool fireEvents = true);
 
+	/**
+	 * Drops all checkpoints. Formats need to call this whenever the
+	 * way the active track is parsed changes.
+	 */
+	virtual void clearCheckpoints();
+
+	/**
+	 * Stores the format specific parser state for a new checkpoint, which
+	 * gets the index _checkpoints.size().
+	 * @return false if no checkpoint can be made at the current position
+	 */
+	virtual bool saveCheckpointState() { return true; }
+
+	/**
+	 * Restores the format specific parser state of a checkpoint. It is
+	 * called after resetTracking().
+	 */
+	virtual void restoreCheckpointState(uint index) { }
+
+	/**
+	 * Returns whether an event needs to be replayed itself when a
+	 * checkpoint after it is restored, rather than being summarized by the
+	 * channel state. This is the case for SysEx, META and system common
+	 * events.
+	 */
+	virtual bool keepEventForCheckpoints(const EventInfo &info);
+
+	/**
+	 * Replays an event kept by keepEventForCheckpoints().
+	 */
+	virtual void replayCheckpointEvent(const EventInfo &info, bool fireEvents);
+
 	void activeNote(byte channel, byte note, bool active);
 	void hangingNote(byte channel, byte note, uint32 ticksLeft, bool recycle = true);
 	void hangAllActiveNotes();
 
+	int findCheckpoint(uint32 tick) const;
+	void restoreCheckpoint(uint index, uint32 startPsecPerTick, bool fireEvents);
+	void addCheckpoint(uint32 startPsecPerTick, bool tempoChanged, uint32 ticksBeforeTempo, uint32 sequence);
+	void recordCheckpointEvent(const EventInfo &info, uint32 sequence);
+	void recordCheckpointEvent(const CheckpointMessage &message, uint32 sequence);
+	static bool checkpointMessageLess(const CheckpointMessage &a, const CheckpointMessage &b);
+	uint32 getDataEntryParameter(byte channel) const;
+	uint32 getBankSelect(byte channel) const;
+	void sendCheckpointMessage(const CheckpointMessage &message);
+
 	virtual void sendToDriver(uint32 b);
 	void sendToDriver(byte status, byte firstOp, byte secondOp) {
 		sendToDriver(status | ((uint32)firstOp << 8) | ((uint32)secondOp << 16));
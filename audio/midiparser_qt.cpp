@@ -395,6 +395,28 @@ void MidiParser_QT::resetTracking() {
 	_partMap.clear();
 }
 
+void MidiParser_QT::clearCheckpoints() {
+	MidiParser::clearCheckpoints();
+	_checkpointPartMaps.clear();
+	_checkpointChannelMaps.clear();
+}
+
+bool MidiParser_QT::saveCheckpointState() {
+	// Events which have been read but not parsed yet are not part of the
+	// checkpoints
+	if (!_queuedEvents.empty())
+		return false;
+
+	_checkpointPartMaps.push_back(_partMap);
+	_checkpointChannelMaps.push_back(_channelMap);
+	return true;
+}
+
+void MidiParser_QT::restoreCheckpointState(uint index) {
+	_partMap = _checkpointPartMaps[index];
+	_channelMap = _checkpointChannelMaps[index];
+}
+
 Common::QuickTimeParser::SampleDesc *MidiParser_QT::readSampleDesc(Track *track, uint32 format, uint32 descSize) {
 	if (track->codecType == CODEC_TYPE_MIDI) {
 		debug(0, "MIDI Codec FourCC '%s'", tag2str(format));
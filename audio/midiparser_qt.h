@@ -47,7 +47,7 @@
  */
 class MidiParser_QT : public MidiParser, public Common::QuickTimeParser {
 public:
-	MidiParser_QT() {}
+	MidiParser_QT() { _useCheckpoints = true; }
 	~MidiParser_QT() {}
 
 	// MidiParser
@@ -73,6 +73,9 @@ protected:
 	// MidiParser
 	void parseNextEvent(EventInfo &info);
 	void resetTracking();
+	void clearCheckpoints();
+	bool saveCheckpointState();
+	void restoreCheckpointState(uint index);
 
 	// QuickTimeParser
 	SampleDesc *readSampleDesc(Track *track, uint32 format, uint32 descSize);
@@ -126,6 +129,9 @@ private:
 	typedef Common::HashMap<uint, byte> ChannelMap;
 	ChannelMap _channelMap;
 
+	Common::Array<PartMap> _checkpointPartMaps;
+	Common::Array<ChannelMap> _checkpointChannelMaps;
+
 	void initFromContainerTracks();
 	void initCommon();
 	uint32 readUint32();
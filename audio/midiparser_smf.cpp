@@ -37,7 +37,7 @@ protected:
 	void parseNextEvent(EventInfo &info);
 
 public:
-	MidiParser_SMF() : _buffer(0), _malformedPitchBends(false) {}
+	MidiParser_SMF() : _buffer(0), _malformedPitchBends(false) { _useCheckpoints = true; }
 	~MidiParser_SMF();
 
 	bool loadMusic(byte *data, uint32 size);
@@ -56,6 +56,7 @@ void MidiParser_SMF::property(int prop, int value) {
 	switch (prop) {
 	case mpMalformedPitchBends:
 		_malformedPitchBends = (value > 0);
+		clearCheckpoints();
 		break;
 	default:
 		MidiParser::property(prop, value);
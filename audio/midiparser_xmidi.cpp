@@ -68,11 +68,16 @@ protected:
 		_loopCount = -1;
 	}
 
+	virtual bool saveCheckpointState();
+	virtual bool keepEventForCheckpoints(const EventInfo &info);
+	virtual void replayCheckpointEvent(const EventInfo &info, bool fireEvents);
+
 public:
 	MidiParser_XMIDI(XMidiCallbackProc proc, void *data, XMidiNewTimbreListProc newTimbreListProc, MidiDriver_BASE *newTimbreListDriver) {
 		_callbackProc = proc;
 		_callbackData = data;
 		_loopCount = -1;
+		_useCheckpoints = true;
 		_newTimbreListProc = newTimbreListProc;
 		_newTimbreListDriver = newTimbreListDriver;
 		memset(_tracksTimbreList, 0, sizeof(_tracksTimbreList));
@@ -238,6 +243,28 @@ void MidiParser_XMIDI::parseNextEvent(EventInfo &info) {
 	}
 }
 
+bool MidiParser_XMIDI::saveCheckpointState() {
+	// Loops are not part of the checkpoints. Callback triggers are handled
+	// while parsing, so the preparsed event must not be one either.
+	return _loopCount < 0 && !(_nextEvent.command() == 0xB && _nextEvent.basic.param1 == 0x77);
+}
+
+bool MidiParser_XMIDI::keepEventForCheckpoints(const EventInfo &info) {
+	return (info.command() == 0xB && info.basic.param1 == 0x77) || MidiParser::keepEventForCheckpoints(info);
+}
+
+void MidiParser_XMIDI::replayCheckpointEvent(const EventInfo &info, bool fireEvents) {
+	if (info.command() == 0xB && info.basic.param1 == 0x77) {
+		if (_callbackProc)
+			_callbackProc(info.basic.param2, _callbackData);
+		if (fireEvents)
+			processEvent(info, true);
+		return;
+	}
+
+	MidiParser::replayCheckpointEvent(info, fireEvents);
+}
+
 bool MidiParser_XMIDI::loadMusic(byte *data, uint32 size) {
 	uint32 i = 0;
 	byte *start;
@@ -0,0 +1,170 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/softsynth/emumidi.h"
+
+#include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/system.h"
+#include "common/timer.h"
+
+MidiDriver_Emulated::~MidiDriver_Emulated() {
+	stopRenderAhead();
+}
+
+int MidiDriver_Emulated::readBuffer(int16 *data, const int numSamples) {
+	bool renderingAhead;
+	int done = takeRenderedSamples(data, numSamples, renderingAhead);
+
+	if (done < numSamples) {
+		Common::StackLock lock(_renderMutex);
+
+		// The timer procedure may have rendered more while we waited
+		done += takeRenderedSamples(data + done, numSamples - done, renderingAhead);
+		if (done < numSamples) {
+			if (renderingAhead) {
+				_underruns++;
+				debug(2, "MidiDriver_Emulated: Render ahead underrun, %d of %d samples were ready", done, numSamples);
+			}
+
+			const int stereoFactor = isStereo() ? 2 : 1;
+			renderSamples(data + done, (numSamples - done) / stereoFactor);
+		}
+	}
+
+	return numSamples;
+}
+
+void MidiDriver_Emulated::renderSamples(int16 *data, int len) {
+	const int stereoFactor = isStereo() ? 2 : 1;
+	int step;
+
+	while (len) {
+		step = len;
+		if (step > (_nextTick >> FIXP_SHIFT))
+			step = (_nextTick >> FIXP_SHIFT);
+
+		generateSamples(data, step);
+
+		_nextTick -= step << FIXP_SHIFT;
+		if (!(_nextTick >> FIXP_SHIFT)) {
+			if (_timerProc)
+				(*_timerProc)(_timerParam);
+
+			onTimer();
+
+			_nextTick += _samplesPerTick;
+		}
+
+		data += step * stereoFactor;
+		len -= step;
+	}
+}
+
+int MidiDriver_Emulated::takeRenderedSamples(int16 *data, int numSamples, bool &renderingAhead) {
+	Common::StackLock lock(_ringMutex);
+
+	renderingAhead = (_ring != 0);
+	if (!_ring)
+		return 0;
+
+	const int count = MIN(numSamples, _ringFill);
+	const int first = MIN(count, _ringSize - _ringStart);
+	memcpy(data, _ring + _ringStart, first * sizeof(int16));
+	memcpy(data + first, _ring, (count - first) * sizeof(int16));
+
+	_ringStart = (_ringStart + count) % _ringSize;
+	_ringFill -= count;
+	_lowestFill = MIN(_lowestFill, _ringFill);
+	return count;
+}
+
+void MidiDriver_Emulated::startRenderAhead() {
+	const int latency = ConfMan.getInt("midi_render_ahead");
+	if (latency <= 0 || _ring)
+		return;
+
+	// Each call renders twice the music played in the meantime, so that the
+	// ring fills up again after an underrun
+	const int interval = MAX<int>(latency / 2, RENDER_AHEAD_MIN_INTERVAL);
+	const int stereoFactor = isStereo() ? 2 : 1;
+	_chunkFrames = getRate() * interval * 2 / 1000;
+	_chunk = new int16[_chunkFrames * stereoFactor];
+	{
+		Common::StackLock lock(_ringMutex);
+		_renderAheadSize = getRate() * latency / 1000 * stereoFactor;
+		_ringSize = _renderAheadSize + _chunkFrames * stereoFactor;
+		_ring = new int16[_ringSize];
+		_ringStart = 0;
+		_ringFill = 0;
+		_lowestFill = _renderAheadSize;
+		_underruns = 0;
+	}
+
+	// Fill the ring before the timer procedure takes over
+	while (renderAhead())
+		;
+	g_system->getTimerManager()->installTimerProc(&renderAheadTimerProc, interval * 1000, this, "MidiDriver_Emulated");
+}
+
+void MidiDriver_Emulated::stopRenderAhead() {
+	if (!_ring)
+		return;
+
+	// This waits for the timer procedure to finish if it is running, which
+	// renders no more than one chunk
+	g_system->getTimerManager()->removeTimerProc(&renderAheadTimerProc);
+
+	Common::StackLock lock(_ringMutex);
+	debug(1, "MidiDriver_Emulated: Rendered %d samples ahead, at least %d were ready, %d underruns", _renderAheadSize, _lowestFill, _underruns);
+	delete[] _ring;
+	_ring = 0;
+	delete[] _chunk;
+	_chunk = 0;
+}
+
+void MidiDriver_Emulated::renderAheadTimerProc(void *refCon) {
+	((MidiDriver_Emulated *)refCon)->renderAhead();
+}
+
+bool MidiDriver_Emulated::renderAhead() {
+	{
+		Common::StackLock lock(_ringMutex);
+		if (!_ring || _ringFill >= _renderAheadSize)
+			return false;
+	}
+
+	// Only the mixer takes samples from the ring meanwhile, so the chunk
+	// still fits. The render mutex is held until the chunk is in the
+	// ring, so that the mixer cannot render the samples after it first.
+	Common::StackLock renderLock(_renderMutex);
+	renderSamples(_chunk, _chunkFrames);
+
+	const int chunkSize = _chunkFrames * (isStereo() ? 2 : 1);
+	Common::StackLock lock(_ringMutex);
+	const int end = (_ringStart + _ringFill) % _ringSize;
+	const int first = MIN(chunkSize, _ringSize - end);
+	memcpy(_ring + end, _chunk, first * sizeof(int16));
+	memcpy(_ring, _chunk + first, (chunkSize - first) * sizeof(int16));
+	_ringFill += chunkSize;
+	return true;
+}
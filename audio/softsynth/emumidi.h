@@ -27,6 +27,20 @@
 #include "audio/mididrv.h"
 #include "audio/mixer.h"
 
+#include "common/mutex.h"
+
+/**
+ * Base class for MIDI drivers which synthesize the music themselves and play
+ * it through the mixer. The timer callback is called in step with the
+ * generated samples.
+ *
+ * Drivers may render ahead of the mixer: a timer procedure then renders one
+ * chunk per call into a ring buffer, until it is as far ahead as the latency
+ * set by the "midi_render_ahead" config key (in milliseconds). The mixer
+ * takes the samples from that ring. That keeps spikes in the rendering time
+ * from making the mixer miss its deadline. MIDI messages sent to the driver
+ * are heard with that latency.
+ */
 class MidiDriver_Emulated : public Audio::AudioStream, public MidiDriver {
 protected:
 	bool _isOpen;
@@ -38,18 +52,62 @@ private:
 	void *_timerParam;
 
 	enum {
-		FIXP_SHIFT = 16
+		FIXP_SHIFT = 16,
+		// Shortest interval of the render ahead timer procedure, in
+		// milliseconds. The timer manager does not run its procedures more
+		// often than that.
+		RENDER_AHEAD_MIN_INTERVAL = 10
 	};
 
 	int _nextTick;
 	int _samplesPerTick;
 
+	// Held while samples are generated, since both the mixer and the render
+	// ahead timer procedure do so
+	Common::Mutex _renderMutex;
+
+	// Guards the ring buffer of samples rendered ahead. All sizes are in
+	// int16 values, not frames.
+	Common::Mutex _ringMutex;
+	int16 *_ring;
+	int _ringSize;
+	int _ringStart;
+	int _ringFill;
+	int _renderAheadSize;
+	int16 *_chunk;     ///< Rendered by one call of the timer procedure
+	int _chunkFrames;
+	int _lowestFill;
+	uint32 _underruns;
+
+	void renderSamples(int16 *data, int len);
+	int takeRenderedSamples(int16 *data, int numSamples, bool &renderingAhead);
+
+	static void renderAheadTimerProc(void *refCon);
+	/**
+	 * Renders one chunk into the ring, unless it is already the latency
+	 * ahead.
+	 * @return whether a chunk was rendered
+	 */
+	bool renderAhead();
+
 protected:
 	int _baseFreq;
 
 	virtual void generateSamples(int16 *buf, int len) = 0;
 	virtual void onTimer() {}
 
+	/**
+	 * Starts rendering ahead of the mixer, if the "midi_render_ahead" config
+	 * key asks for it. Call this after the stream is played by the mixer.
+	 */
+	void startRenderAhead();
+
+	/**
+	 * Stops rendering ahead of the mixer. Call this before anything
+	 * generateSamples() or the timer callback use is taken down.
+	 */
+	void stopRenderAhead();
+
 public:
 	MidiDriver_Emulated(Audio::Mixer *mixer) :
 		_mixer(mixer),
@@ -58,9 +116,20 @@ public:
 		_timerParam(0),
 		_nextTick(0),
 		_samplesPerTick(0),
+		_ring(0),
+		_ringSize(0),
+		_ringStart(0),
+		_ringFill(0),
+		_renderAheadSize(0),
+		_chunk(0),
+		_chunkFrames(0),
+		_lowestFill(0),
+		_underruns(0),
 		_baseFreq(250) {
 	}
 
+	virtual ~MidiDriver_Emulated();
+
 	// MidiDriver API
 	virtual int open() {
 		_isOpen = true;
@@ -88,34 +157,7 @@ public:
 	}
 
 	// AudioStream API
-	virtual int readBuffer(int16 *data, const int numSamples) {
-		const int stereoFactor = isStereo() ? 2 : 1;
-		int len = numSamples / stereoFactor;
-		int step;
-
-		do {
-			step = len;
-			if (step > (_nextTick >> FIXP_SHIFT))
-				step = (_nextTick >> FIXP_SHIFT);
-
-			generateSamples(data, step);
-
-			_nextTick -= step << FIXP_SHIFT;
-			if (!(_nextTick >> FIXP_SHIFT)) {
-				if (_timerProc)
-					(*_timerProc)(_timerParam);
-
-				onTimer();
-
-				_nextTick += _samplesPerTick;
-			}
-
-			data += step * stereoFactor;
-			len -= step;
-		} while (len);
-
-		return numSamples;
-	}
+	virtual int readBuffer(int16 *data, const int numSamples);
 
 	virtual bool endOfData() const {
 		return false;
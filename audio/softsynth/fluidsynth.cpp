@@ -200,6 +200,7 @@ int MidiDriver_FluidSynth::open() {
 	MidiDriver_Emulated::open();
 
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
+	startRenderAhead();
 	return 0;
 }
 
@@ -208,6 +209,7 @@ void MidiDriver_FluidSynth::close() {
 		return;
 	_isOpen = false;
 
+	stopRenderAhead();
 	_mixer->stopHandle(_mixerSoundHandle);
 
 	if (_soundFont != -1)
@@ -222,6 +222,7 @@ int MidiDriver_MT32::open() {
 	MidiDriver_Emulated::open();
 
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
+	startRenderAhead();
 
 	return 0;
 }
@@ -266,6 +267,7 @@ void MidiDriver_MT32::close() {
 		return;
 	_isOpen = false;
 
+	stopRenderAhead();
 	// Detach the player callback handler
 	setTimerCallback(NULL, NULL);
 	// Detach the mixer callback handler
@@ -22,6 +22,11 @@
 #include "BReverbModel.h"
 #include "Synth.h"
 
+#if !MT32EMU_USE_FLOAT_SAMPLES && !MT32EMU_BOSS_REVERB_PRECISE_MODE && defined(__SSE2__)
+#define MT32EMU_REVERB_SSE2
+#include <emmintrin.h>
+#endif
+
 // Analysing of state of reverb RAM address lines gives exact sizes of the buffers of filters used. This also indicates that
 // the reverb model implemented in the real devices consists of three series allpass filters preceded by a non-feedback comb (or a delay with a LPF)
 // and followed by three parallel comb filters
@@ -37,6 +42,11 @@ static const Bit32u PROCESS_DELAY = 1;
 static const Bit32u MODE_3_ADDITIONAL_DELAY = 1;
 static const Bit32u MODE_3_FEEDBACK_DELAY = 1;
 
+#if !MT32EMU_USE_FLOAT_SAMPLES && !MT32EMU_BOSS_REVERB_PRECISE_MODE
+// Number of samples BReverbModel::process() passes through each filter at once
+static const Bit32u BLOCK_SIZE = 128;
+#endif
+
 // Default reverb settings for "new" reverb model implemented in CM-32L / LAPC-I.
 // Found by tracing reverb RAM data lines (thanks go to Lord_Nightmare & balrog).
 const BReverbSettings &BReverbModel::getCM32L_LAPCSettings(const ReverbMode mode) {
@@ -196,6 +206,73 @@ static Sample weirdMul(Sample a, Bit8u addMask, Bit8u carryMask) {
 #endif
 }
 
+#ifdef MT32EMU_REVERB_SSE2
+static inline __m128i loadSamples(const Sample *samples) {
+	return _mm_loadu_si128((const __m128i *)samples);
+}
+
+static inline void storeSamples(Sample *samples, __m128i value) {
+	_mm_storeu_si128((__m128i *)samples, value);
+}
+
+// weirdMul() for eight samples. The 32-bit products are shifted back to 16 bits from their high and low halves.
+static inline __m128i weirdMulSSE2(__m128i a, __m128i addMask) {
+	return _mm_or_si128(_mm_slli_epi16(_mm_mulhi_epi16(a, addMask), 8), _mm_srli_epi16(_mm_mullo_epi16(a, addMask), 8));
+}
+
+// Adds the comb outputs of four samples the way BReverbModel::processReference() does, in 32 bits
+static inline __m128i mixCombOutputsSSE2(__m128i out1, __m128i out2, __m128i out3) {
+	__m128i sum = _mm_add_epi32(out1, _mm_srai_epi32(out1, 1));
+	sum = _mm_add_epi32(sum, out2);
+	sum = _mm_add_epi32(sum, _mm_srai_epi32(out2, 1));
+	return _mm_add_epi32(sum, out3);
+}
+
+static inline __m128i extendLowSamples(__m128i samples) {
+	return _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+}
+
+static inline __m128i extendHighSamples(__m128i samples) {
+	return _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+}
+#endif
+
+#if !MT32EMU_USE_FLOAT_SAMPLES && !MT32EMU_BOSS_REVERB_PRECISE_MODE
+static void mixDryInput(const Sample *inLeft, const Sample *inRight, Sample *dry, Bit32u numSamples, Bit8u dryAmp) {
+	Bit32u i = 0;
+#ifdef MT32EMU_REVERB_SSE2
+	const __m128i dryAmpVector = _mm_set1_epi16(dryAmp);
+	for (; i + 8 <= numSamples; i += 8) {
+		const __m128i in = _mm_add_epi16(_mm_srai_epi16(loadSamples(inLeft + i), 2), _mm_srai_epi16(loadSamples(inRight + i), 2));
+		storeSamples(dry + i, weirdMulSSE2(in, dryAmpVector));
+	}
+#endif
+	for (; i < numSamples; i++) {
+		dry[i] = weirdMul((inLeft[i] >> 2) + (inRight[i] >> 2), dryAmp, 0xFF);
+	}
+}
+
+static void mixCombOutputs(const Sample *out1, const Sample *out2, const Sample *out3, Sample *outBuf, Bit32u numSamples, Bit8u wetLevel) {
+	Bit32u i = 0;
+#ifdef MT32EMU_REVERB_SSE2
+	const __m128i wetLevelVector = _mm_set1_epi16(wetLevel);
+	for (; i + 8 <= numSamples; i += 8) {
+		const __m128i in1 = loadSamples(out1 + i);
+		const __m128i in2 = loadSamples(out2 + i);
+		const __m128i in3 = loadSamples(out3 + i);
+		const __m128i low = mixCombOutputsSSE2(extendLowSamples(in1), extendLowSamples(in2), extendLowSamples(in3));
+		const __m128i high = mixCombOutputsSSE2(extendHighSamples(in1), extendHighSamples(in2), extendHighSamples(in3));
+		// Packing with signed saturation does what Synth::clipSampleEx() does
+		storeSamples(outBuf + i, weirdMulSSE2(_mm_packs_epi32(low, high), wetLevelVector));
+	}
+#endif
+	for (; i < numSamples; i++) {
+		Sample outSample = Synth::clipSampleEx(SampleEx(out1[i]) + (SampleEx(out1[i]) >> 1) + SampleEx(out2[i]) + (SampleEx(out2[i]) >> 1) + SampleEx(out3[i]));
+		outBuf[i] = weirdMul(outSample, wetLevel, 0xFF);
+	}
+}
+#endif
+
 RingBuffer::RingBuffer(Bit32u newsize) : size(newsize), index(0) {
 	buffer = new Sample[size];
 }
@@ -255,6 +332,44 @@ Sample AllpassFilter::process(const Sample in) {
 #endif
 }
 
+#if !MT32EMU_USE_FLOAT_SAMPLES && !MT32EMU_BOSS_REVERB_PRECISE_MODE
+void AllpassFilter::processBlock(const Sample *in, Sample *out, const Bit32u numSamples) {
+	Bit32u done = 0;
+	while (done < numSamples) {
+		// Up to the end of the buffer, each sample only depends on the one stored a buffer size earlier
+		Bit32u start = index + 1;
+		if (start >= size) {
+			start = 0;
+		}
+		Bit32u count = size - start;
+		if (count > numSamples - done) {
+			count = numSamples - done;
+		}
+
+		Sample *buf = buffer + start;
+		const Sample *inBuf = in + done;
+		Sample *outBuf = out + done;
+		Bit32u i = 0;
+#ifdef MT32EMU_REVERB_SSE2
+		for (; i + 8 <= count; i += 8) {
+			const __m128i bufferOut = loadSamples(buf + i);
+			const __m128i stored = _mm_sub_epi16(loadSamples(inBuf + i), _mm_srai_epi16(bufferOut, 1));
+			storeSamples(buf + i, stored);
+			storeSamples(outBuf + i, _mm_add_epi16(bufferOut, _mm_srai_epi16(stored, 1)));
+		}
+#endif
+		for (; i < count; i++) {
+			const Sample bufferOut = buf[i];
+			buf[i] = inBuf[i] - (bufferOut >> 1);
+			outBuf[i] = bufferOut + (buf[i] >> 1);
+		}
+
+		index = start + count - 1;
+		done += count;
+	}
+}
+#endif
+
 CombFilter::CombFilter(const Bit32u useSize, const Bit8u useFilterFactor) : RingBuffer(useSize), filterFactor(useFilterFactor) {}
 
 void CombFilter::process(const Sample in) {
@@ -270,6 +385,33 @@ void CombFilter::process(const Sample in) {
 	buffer[index] = weirdMul(last, filterFactor, 0xC0) - filterIn;
 }
 
+#if !MT32EMU_USE_FLOAT_SAMPLES && !MT32EMU_BOSS_REVERB_PRECISE_MODE
+void CombFilter::processBlock(const Sample *in, const Bit32u numSamples, Sample *out1, const Bit32u position1, Sample *out2, const Bit32u position2) {
+	// The output positions move along with the index, which avoids the modulo of getOutputAt()
+	Bit32u outIndex1 = (index + 1 + size - position1) % size;
+	Bit32u outIndex2 = (index + 1 + size - position2) % size;
+
+	for (Bit32u i = 0; i < numSamples; i++) {
+		const Sample last = buffer[index];
+		if (++index >= size) {
+			index = 0;
+		}
+		const Sample dropped = buffer[index];
+		const Sample filterIn = in[i] + weirdMul(dropped, feedbackFactor, 0xF0);
+		buffer[index] = weirdMul(last, filterFactor, 0xC0) - filterIn;
+
+		out1[i] = (position1 == size) ? dropped : buffer[outIndex1];
+		out2[i] = (position2 == size) ? dropped : buffer[outIndex2];
+		if (++outIndex1 >= size) {
+			outIndex1 = 0;
+		}
+		if (++outIndex2 >= size) {
+			outIndex2 = 0;
+		}
+	}
+}
+#endif
+
 Sample CombFilter::getOutputAt(const Bit32u outIndex) const {
 	return buffer[(size + index - outIndex) % size];
 }
@@ -295,6 +437,20 @@ void DelayWithLowPassFilter::process(const Sample in) {
 	buffer[index] = weirdMul(lpfOut, amp, 0xFF);
 }
 
+#if !MT32EMU_USE_FLOAT_SAMPLES && !MT32EMU_BOSS_REVERB_PRECISE_MODE
+void DelayWithLowPassFilter::processBlock(Sample *samples, const Bit32u numSamples) {
+	for (Bit32u i = 0; i < numSamples; i++) {
+		const Sample last = buffer[index];
+		if (++index >= size) {
+			index = 0;
+		}
+		const Sample lpfOut = weirdMul(last, filterFactor, 0xFF) + samples[i];
+		samples[i] = buffer[index];
+		buffer[index] = weirdMul(lpfOut, amp, 0xFF);
+	}
+}
+#endif
+
 TapDelayCombFilter::TapDelayCombFilter(const Bit32u useSize, const Bit8u useFilterFactor) : CombFilter(useSize, useFilterFactor) {}
 
 void TapDelayCombFilter::process(const Sample in) {
@@ -434,6 +590,59 @@ bool BReverbModel::isMT32Compatible(const ReverbMode mode) const {
 }
 
 void BReverbModel::process(const Sample *inLeft, const Sample *inRight, Sample *outLeft, Sample *outRight, Bit32u numSamples) {
+#if !MT32EMU_USE_FLOAT_SAMPLES && !MT32EMU_BOSS_REVERB_PRECISE_MODE
+	// Passing blocks of samples through one filter after the other keeps the filter loops tight,
+	// and lets the allpass filters and the output mixing work on several samples at once.
+	if (combs != NULL && !tapDelayMode) {
+		while (numSamples > 0) {
+			const Bit32u count = numSamples < BLOCK_SIZE ? numSamples : BLOCK_SIZE;
+			processBlock(inLeft, inRight, outLeft, outRight, count);
+			inLeft += count;
+			inRight += count;
+			if (outLeft != NULL) {
+				outLeft += count;
+			}
+			if (outRight != NULL) {
+				outRight += count;
+			}
+			numSamples -= count;
+		}
+		return;
+	}
+#endif
+	processReference(inLeft, inRight, outLeft, outRight, numSamples);
+}
+
+#if !MT32EMU_USE_FLOAT_SAMPLES && !MT32EMU_BOSS_REVERB_PRECISE_MODE
+void BReverbModel::processBlock(const Sample *inLeft, const Sample *inRight, Sample *outLeft, Sample *outRight, Bit32u numSamples) {
+	Sample link[BLOCK_SIZE];
+	Sample outL1[BLOCK_SIZE], outL2[BLOCK_SIZE], outL3[BLOCK_SIZE];
+	Sample outR1[BLOCK_SIZE], outR2[BLOCK_SIZE], outR3[BLOCK_SIZE];
+
+	// See processReference() for the details
+	mixDryInput(inLeft, inRight, link, numSamples, dryAmp);
+	static_cast<DelayWithLowPassFilter *>(combs[0])->processBlock(link, numSamples);
+	for (Bit32u i = 0; i < numSamples; i++) {
+		link[i] = link[i] - 1;
+	}
+	allpasses[0]->processBlock(link, link, numSamples);
+	allpasses[1]->processBlock(link, link, numSamples);
+	allpasses[2]->processBlock(link, link, numSamples);
+
+	combs[1]->processBlock(link, numSamples, outL1, currentSettings.outLPositions[0], outR1, currentSettings.outRPositions[0]);
+	combs[2]->processBlock(link, numSamples, outL2, currentSettings.outLPositions[1], outR2, currentSettings.outRPositions[1]);
+	combs[3]->processBlock(link, numSamples, outL3, currentSettings.outLPositions[2], outR3, currentSettings.outRPositions[2]);
+
+	if (outLeft != NULL) {
+		mixCombOutputs(outL1, outL2, outL3, outLeft, numSamples, wetLevel);
+	}
+	if (outRight != NULL) {
+		mixCombOutputs(outR1, outR2, outR3, outRight, numSamples, wetLevel);
+	}
+}
+#endif
+
+void BReverbModel::processReference(const Sample *inLeft, const Sample *inRight, Sample *outLeft, Sample *outRight, Bit32u numSamples) {
 	if (combs == NULL) {
 		Synth::muteSampleBuffer(outLeft, numSamples);
 		Synth::muteSampleBuffer(outRight, numSamples);
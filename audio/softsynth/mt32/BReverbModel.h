@@ -56,6 +56,10 @@ class AllpassFilter : public RingBuffer {
 public:
 	AllpassFilter(const Bit32u size);
 	Sample process(const Sample in);
+#if !MT32EMU_USE_FLOAT_SAMPLES && !MT32EMU_BOSS_REVERB_PRECISE_MODE
+	// Same as calling process() for each sample. The buffers may be the same.
+	void processBlock(const Sample *in, Sample *out, const Bit32u numSamples);
+#endif
 };
 
 class CombFilter : public RingBuffer {
@@ -66,6 +70,11 @@ protected:
 public:
 	CombFilter(const Bit32u size, const Bit8u useFilterFactor);
 	virtual void process(const Sample in);
+#if !MT32EMU_USE_FLOAT_SAMPLES && !MT32EMU_BOSS_REVERB_PRECISE_MODE
+	// Same as calling process() for each sample, and getOutputAt() with both positions after each one.
+	// A position equal to the size gives the sample dropped from the buffer, like getOutputAt(size - 1) before process() does.
+	void processBlock(const Sample *in, const Bit32u numSamples, Sample *out1, const Bit32u position1, Sample *out2, const Bit32u position2);
+#endif
 	Sample getOutputAt(const Bit32u outIndex) const;
 	void setFeedbackFactor(const Bit8u useFeedbackFactor);
 };
@@ -76,6 +85,10 @@ class DelayWithLowPassFilter : public CombFilter {
 public:
 	DelayWithLowPassFilter(const Bit32u useSize, const Bit8u useFilterFactor, const Bit8u useAmp);
 	void process(const Sample in);
+#if !MT32EMU_USE_FLOAT_SAMPLES && !MT32EMU_BOSS_REVERB_PRECISE_MODE
+	// Same as calling getOutputAt(size - 1) and process() for each sample, which is replaced by that output.
+	void processBlock(Sample *samples, const Bit32u numSamples);
+#endif
 	void setFeedbackFactor(const Bit8u) {}
 };
 
@@ -103,6 +116,10 @@ class BReverbModel {
 	static const BReverbSettings &getCM32L_LAPCSettings(const ReverbMode mode);
 	static const BReverbSettings &getMT32Settings(const ReverbMode mode);
 
+#if !MT32EMU_USE_FLOAT_SAMPLES && !MT32EMU_BOSS_REVERB_PRECISE_MODE
+	void processBlock(const Sample *inLeft, const Sample *inRight, Sample *outLeft, Sample *outRight, Bit32u numSamples);
+#endif
+
 public:
 	BReverbModel(const ReverbMode mode, const bool mt32CompatibleModel = false);
 	~BReverbModel();
@@ -113,6 +130,8 @@ public:
 	void mute();
 	void setParameters(Bit8u time, Bit8u level);
 	void process(const Sample *inLeft, const Sample *inRight, Sample *outLeft, Sample *outRight, Bit32u numSamples);
+	// Straightforward sample by sample implementation of process(), which has to give exactly the same output.
+	void processReference(const Sample *inLeft, const Sample *inRight, Sample *outLeft, Sample *outRight, Bit32u numSamples);
 	bool isActive() const;
 	bool isMT32Compatible(const ReverbMode mode) const;
 };
@@ -24,12 +24,21 @@
 #define BACKENDS_GRAPHICS_NULL_H
 
 #include "backends/graphics/graphics.h"
+#include "graphics/surface.h"
 
 static const OSystem::GraphicsMode s_noGraphicsModes[] = { {0, 0, 0} };
 
+/**
+ * Graphics manager that never presents anything. It still keeps the game
+ * screen and palette in memory, so screenshots (and the event recorder's
+ * MD5 checks) work on headless runs.
+ */
 class NullGraphicsManager : public GraphicsManager {
 public:
-	virtual ~NullGraphicsManager() {}
+	NullGraphicsManager() : _format(Graphics::PixelFormat::createFormatCLUT8()), _screenChangeID(0) {
+		memset(_palette, 0, sizeof(_palette));
+	}
+	virtual ~NullGraphicsManager() { _screen.free(); }
 
 	bool hasFeature(OSystem::Feature f) const override { return false; }
 	void setFeatureState(OSystem::Feature f, bool enable) override {}
@@ -41,27 +50,47 @@ public:
 	void resetGraphicsScale() override {}
 	int getGraphicsMode() const override { return 0; }
 	inline Graphics::PixelFormat getScreenFormat() const override {
-		return Graphics::PixelFormat::createFormatCLUT8();
+		return _format;
 	}
 	inline Common::List<Graphics::PixelFormat> getSupportedFormats() const override {
 		Common::List<Graphics::PixelFormat> list;
 		list.push_back(Graphics::PixelFormat::createFormatCLUT8());
 		return list;
 	}
-	void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) override {}
-	virtual int getScreenChangeID() const override { return 0; }
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) override {
+		Graphics::PixelFormat newFormat = format ? *format : Graphics::PixelFormat::createFormatCLUT8();
+		if (_screen.w == (int16)width && _screen.h == (int16)height && _format == newFormat)
+			return;
+		_format = newFormat;
+		_screen.free();
+		_screen.create(width, height, _format);
+		_screenChangeID++;
+	}
+	virtual int getScreenChangeID() const override { return _screenChangeID; }
 
 	void beginGFXTransaction() override {}
 	OSystem::TransactionError endGFXTransaction() override { return OSystem::kTransactionSuccess; }
 
-	int16 getHeight() const override { return 0; }
-	int16 getWidth() const override { return 0; }
-	void setPalette(const byte *colors, uint start, uint num) override {}
-	void grabPalette(byte *colors, uint start, uint num) const override {}
-	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) override {}
-	Graphics::Surface *lockScreen() override { return NULL; }
+	int16 getHeight() const override { return _screen.h; }
+	int16 getWidth() const override { return _screen.w; }
+	void setPalette(const byte *colors, uint start, uint num) override {
+		assert(start + num <= 256);
+		memcpy(_palette + start * 3, colors, num * 3);
+	}
+	void grabPalette(byte *colors, uint start, uint num) const override {
+		assert(start + num <= 256);
+		memcpy(colors, _palette + start * 3, num * 3);
+	}
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) override {
+		if (_screen.getPixels())
+			_screen.copyRectToSurface(buf, pitch, x, y, w, h);
+	}
+	Graphics::Surface *lockScreen() override { return _screen.getPixels() ? &_screen : NULL; }
 	void unlockScreen() override {}
-	void fillScreen(uint32 col) override {}
+	void fillScreen(uint32 col) override {
+		if (_screen.getPixels())
+			_screen.fillRect(Common::Rect(_screen.w, _screen.h), col);
+	}
 	void updateScreen() override {}
 	void setShakePos(int shakeOffset) override {}
 	void setFocusRectangle(const Common::Rect& rect) override {}
@@ -80,6 +109,12 @@ public:
 	void warpMouse(int x, int y) override {}
 	void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale = false, const Graphics::PixelFormat *format = NULL) override {}
 	void setCursorPalette(const byte *colors, uint start, uint num) override {}
+
+private:
+	Graphics::Surface _screen;
+	Graphics::PixelFormat _format;
+	byte _palette[256 * 3];
+	int _screenChangeID;
 };
 
 #endif
@@ -29,6 +29,7 @@
 #include "gui/EventRecorder.h"
 
 #include "audio/mixer.h"
+#include "common/profiler.h"
 #include "graphics/pixelformat.h"
 
 ModularBackend::ModularBackend()
@@ -158,6 +159,8 @@ void ModularBackend::fillScreen(uint32 col) {
 }
 
 void ModularBackend::updateScreen() {
+	PROFILE_ZONE("OSystem::updateScreen");
+
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.preDrawOverlayGui();
 #endif
@@ -334,8 +334,12 @@ endif
 
 ifdef ENABLE_EVENTRECORDER
 MODULE_OBJS += \
-	mixer/nullmixer/nullsdl-mixer.o \
 	saves/recorder/recorder-saves.o
+
+ifdef SDL_BACKEND
+MODULE_OBJS += \
+	mixer/nullmixer/nullsdl-mixer.o
+endif
 endif
 
 # Include common rules
@@ -30,6 +30,7 @@
 
 #include "backends/modular-backend.h"
 #include "base/main.h"
+#include "gui/EventRecorder.h"
 
 #if defined(USE_NULL_DRIVER)
 #include "backends/saves/default/default-saves.h"
@@ -38,7 +39,14 @@
 #include "backends/mutex/null/null-mutex.h"
 #include "backends/graphics/null/null-graphics.h"
 #include "audio/mixer_intern.h"
+#include "common/config-manager.h"
 #include "common/scummsys.h"
+#include "common/str.h"
+
+#if defined(POSIX)
+	#include <sys/time.h>
+	#include <sys/resource.h>
+#endif
 
 /*
  * Include header files needed for the getFilesystemFactory() method.
@@ -58,17 +66,97 @@ public:
 
 	virtual void initBackend();
 
+	virtual void engineInit();
+	virtual void engineDone();
+
 	virtual Common::EventSource *getDefaultEventSource() { return this; }
 	virtual bool pollEvent(Common::Event &event);
 
+	virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h);
+	virtual void fillScreen(uint32 col);
+	virtual void updateScreen();
+
 	virtual uint32 getMillis(bool skipRecord = false);
+	virtual uint64 getMicros();
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &t) const {}
 
+#ifdef ENABLE_EVENTRECORDER
+	virtual Common::TimerManager *getTimerManager();
+	virtual Common::SaveFileManager *getSavefileManager();
+#endif
+
 	virtual void logMessage(LogMessageType::Type type, const char *message);
+
+	/** Whether a benchmark run found screenshots differing from the recording */
+	bool benchmarkFailed() const { return _benchmarkFailed; }
+
+private:
+	enum {
+		kSampleRate = 22050,
+		kMixBufferSamples = 1024
+	};
+
+	/**
+	 * Whether a benchmark was requested. Only then do the virtual clock,
+	 * the timers and the mixer run; otherwise the backend stays inert.
+	 */
+	bool _virtualClock;
+
+	/**
+	 * Virtual clock in milliseconds. It only advances when the engine
+	 * delays, so a run takes as long as the CPU needs and no longer.
+	 */
+	uint32 _virtualMillis;
+
+	/**
+	 * Feed the mixer with the samples that are due at the given time. This
+	 * is only done from delayMillis() and updateScreen(), where the engine
+	 * is not in the middle of changing any audio stream.
+	 */
+	void mixAudio(uint32 millis);
+	uint64 _samplesMixed;
+	uint32 _lastMixMillis;
+	bool _mixing;
+	byte _mixBuffer[kMixBufferSamples * 4];
+
+	uint32 getPeakRSS() const;
+
+	bool _benchmark;
+	bool _benchmarkFailed;
+	uint32 _frameCount;
+	uint32 _frameStart;
+	uint32 _frameDraw;
+	uint32 _frameMix;
+	uint32 _runStart;
+	uint64 _totalUpdate;
+	uint64 _totalDraw;
+	uint64 _totalMix;
+#if defined(POSIX)
+	timeval _startTime;
+#endif
 };
 
 OSystem_NULL::OSystem_NULL() {
+	_virtualClock = false;
+	_virtualMillis = 0;
+	_samplesMixed = 0;
+	_lastMixMillis = 0;
+	_mixing = false;
+	_benchmark = false;
+	_benchmarkFailed = false;
+	_frameCount = 0;
+	_frameStart = 0;
+	_frameDraw = 0;
+	_frameMix = 0;
+	_runStart = 0;
+	_totalUpdate = 0;
+	_totalDraw = 0;
+	_totalMix = 0;
+#if defined(POSIX)
+	gettimeofday(&_startTime, 0);
+#endif
+
 	#if defined(__amigaos4__)
 		_fsFactory = new AmigaOSFilesystemFactory();
 	#elif defined(POSIX)
@@ -84,31 +172,228 @@ OSystem_NULL::~OSystem_NULL() {
 }
 
 void OSystem_NULL::initBackend() {
+#ifdef ENABLE_EVENTRECORDER
+	// The command line has been read by now, but the event recorder is
+	// only set up right before the engine starts.
+	_virtualClock = (ConfMan.get("record_mode") == "benchmark");
+#endif
+
 	_mutexManager = new NullMutexManager();
-	_timerManager = new DefaultTimerManager();
+#ifdef ENABLE_EVENTRECORDER
+	if (_virtualClock)
+		g_eventRec.registerTimerManager(new DefaultTimerManager());
+	else
+#endif
+		_timerManager = new DefaultTimerManager();
 	_eventManager = new DefaultEventManager(this);
 	_savefileManager = new DefaultSaveFileManager();
 	_graphicsManager = new NullGraphicsManager();
-	_mixer = new Audio::MixerImpl(this, 22050);
+	_mixer = new Audio::MixerImpl(this, kSampleRate);
 
-	((Audio::MixerImpl *)_mixer)->setReady(false);
+	if (_virtualClock) {
+		// There is no audio device; the mixer and the timer manager are
+		// driven from the virtual clock instead.
+		((Audio::MixerImpl *)_mixer)->setReady(true);
+	} else {
+		((Audio::MixerImpl *)_mixer)->setReady(false);
 
-	// Note that both the mixer and the timer manager are useless
-	// this way; they need to be hooked into the system somehow to
-	// be functional. Of course, can't do that in a NULL backend :).
+		// Note that both the mixer and the timer manager are useless
+		// this way; they need to be hooked into the system somehow to
+		// be functional. Of course, can't do that in a NULL backend :).
+	}
 
 	ModularBackend::initBackend();
 }
 
+void OSystem_NULL::engineInit() {
+#ifdef ENABLE_EVENTRECORDER
+	_benchmark = g_eventRec.isBenchmarking();
+#endif
+	if (!_benchmark)
+		return;
+
+	_benchmarkFailed = false;
+	_frameCount = 0;
+	_frameDraw = 0;
+	_frameMix = 0;
+	_totalUpdate = 0;
+	_totalDraw = 0;
+	_totalMix = 0;
+	_runStart = _frameStart = (uint32)getMicros();
+}
+
+void OSystem_NULL::engineDone() {
+	if (!_benchmark)
+		return;
+
+	uint checks = 0, mismatches = 0;
+#ifdef ENABLE_EVENTRECORDER
+	checks = g_eventRec.getScreenshotChecks();
+	mismatches = g_eventRec.getScreenshotMismatches();
+#endif
+	_benchmarkFailed = (mismatches != 0);
+
+	// All times are reported in microseconds, except for the virtual
+	// clock which is in milliseconds.
+	Common::String summary = Common::String::format(
+		"benchmark:action=summary frames=%u time=%u realtime=%u update=%u draw=%u mix=%u peakrss=%u screenshots=%u mismatches=%u result=%s\n",
+		_frameCount, getMillis(true), (uint32)getMicros() - _runStart,
+		(uint32)_totalUpdate, (uint32)_totalDraw, (uint32)_totalMix, getPeakRSS(),
+		checks, mismatches, _benchmarkFailed ? "fail" : "pass");
+	logMessage(LogMessageType::kInfo, summary.c_str());
+
+	_benchmark = false;
+}
+
 bool OSystem_NULL::pollEvent(Common::Event &event) {
 	return false;
 }
 
+void OSystem_NULL::copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {
+	if (!_benchmark) {
+		ModularBackend::copyRectToScreen(buf, pitch, x, y, w, h);
+		return;
+	}
+
+	uint32 start = (uint32)getMicros();
+	ModularBackend::copyRectToScreen(buf, pitch, x, y, w, h);
+	_frameDraw += (uint32)getMicros() - start;
+}
+
+void OSystem_NULL::fillScreen(uint32 col) {
+	if (!_benchmark) {
+		ModularBackend::fillScreen(col);
+		return;
+	}
+
+	uint32 start = (uint32)getMicros();
+	ModularBackend::fillScreen(col);
+	_frameDraw += (uint32)getMicros() - start;
+}
+
+void OSystem_NULL::updateScreen() {
+	if (_virtualClock)
+		mixAudio(getMillis(true));
+
+	if (!_benchmark) {
+		ModularBackend::updateScreen();
+		return;
+	}
+
+	uint32 start = (uint32)getMicros();
+	ModularBackend::updateScreen();
+	uint32 end = (uint32)getMicros();
+
+	// Everything which is neither drawing nor mixing since the previous
+	// frame is accounted to the engine update.
+	uint32 draw = _frameDraw + (end - start);
+	uint32 frame = end - _frameStart;
+	uint32 update = frame > draw + _frameMix ? frame - draw - _frameMix : 0;
+
+	Common::String line = Common::String::format("benchmark:frame=%u time=%u update=%u draw=%u mix=%u\n",
+		_frameCount, getMillis(true), update, draw, _frameMix);
+	logMessage(LogMessageType::kInfo, line.c_str());
+
+	_totalUpdate += update;
+	_totalDraw += draw;
+	_totalMix += _frameMix;
+	_frameCount++;
+	_frameDraw = 0;
+	_frameMix = 0;
+	_frameStart = (uint32)getMicros();
+}
+
 uint32 OSystem_NULL::getMillis(bool skipRecord) {
-	return 0;
+	if (!_virtualClock)
+		return 0;
+
+	uint32 millis = _virtualMillis;
+
+#ifdef ENABLE_EVENTRECORDER
+	g_eventRec.processMillis(millis, skipRecord);
+#endif
+
+	return millis;
 }
 
 void OSystem_NULL::delayMillis(uint msecs) {
+	if (!_virtualClock)
+		return;
+
+#ifdef ENABLE_EVENTRECORDER
+	// During playback the recording drives the clock.
+	if (g_eventRec.processDelayMillis()) {
+		mixAudio(getMillis(true));
+		return;
+	}
+#endif
+
+	_virtualMillis += msecs;
+	((DefaultTimerManager *)getTimerManager())->handler();
+	mixAudio(getMillis(true));
+}
+
+#ifdef ENABLE_EVENTRECORDER
+Common::TimerManager *OSystem_NULL::getTimerManager() {
+	if (!_virtualClock)
+		return OSystem::getTimerManager();
+	return g_eventRec.getTimerManager();
+}
+
+Common::SaveFileManager *OSystem_NULL::getSavefileManager() {
+	return g_eventRec.getSaveManager(_savefileManager);
+}
+#endif
+
+void OSystem_NULL::mixAudio(uint32 millis) {
+	if (_mixing || !_mixer)
+		return;
+
+	// The clock restarts when a recording is loaded
+	if (millis < _lastMixMillis)
+		_samplesMixed = (uint64)millis * kSampleRate / 1000;
+	_lastMixMillis = millis;
+
+	uint64 due = (uint64)millis * kSampleRate / 1000;
+	if (_samplesMixed >= due)
+		return;
+
+	_mixing = true;
+	uint32 start = _benchmark ? (uint32)getMicros() : 0;
+	while (_samplesMixed < due) {
+		uint32 samples = (uint32)MIN<uint64>(due - _samplesMixed, kMixBufferSamples);
+		((Audio::MixerImpl *)_mixer)->mixCallback(_mixBuffer, samples * 4);
+		_samplesMixed += samples;
+	}
+	if (_benchmark)
+		_frameMix += (uint32)getMicros() - start;
+	_mixing = false;
+}
+
+uint64 OSystem_NULL::getMicros() {
+#if defined(POSIX)
+	timeval now;
+	gettimeofday(&now, 0);
+	return (uint64)(now.tv_sec - _startTime.tv_sec) * 1000000 + now.tv_usec - _startTime.tv_usec;
+#else
+	return ModularBackend::getMicros();
+#endif
+}
+
+uint32 OSystem_NULL::getPeakRSS() const {
+#if defined(POSIX)
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#if defined(MACOSX)
+	// Reported in bytes rather than kilobytes
+	return (uint32)(usage.ru_maxrss / 1024);
+#else
+	return (uint32)usage.ru_maxrss;
+#endif
+#else
+	return 0;
+#endif
 }
 
 void OSystem_NULL::logMessage(LogMessageType::Type type, const char *message) {
@@ -133,6 +418,9 @@ int main(int argc, char *argv[]) {
 
 	// Invoke the actual ScummVM main entry point:
 	int res = scummvm_main(argc, argv);
+	// Let scripts tell benchmark regressions from clean runs
+	if (res == 0 && ((OSystem_NULL *)g_system)->benchmarkFailed())
+		res = 1;
 	delete (OSystem_NULL *)g_system;
 	return res;
 }
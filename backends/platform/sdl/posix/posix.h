@@ -37,6 +37,8 @@ public:
 
 	virtual bool openUrl(const Common::String &url);
 
+	virtual Common::String getCachePath();
+
 	virtual void init();
 	virtual void initBackend();
 
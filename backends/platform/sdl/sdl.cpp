@@ -531,6 +531,15 @@ uint32 OSystem_SDL::getMillis(bool skipRecord) {
 	return millis;
 }
 
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+uint64 OSystem_SDL::getMicros() {
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+	Uint64 counter = SDL_GetPerformanceCounter();
+	// Split the conversion to avoid overflowing the multiplication
+	return (uint64)(counter / frequency * 1000000 + counter % frequency * 1000000 / frequency);
+}
+#endif
+
 void OSystem_SDL::delayMillis(uint msecs) {
 #ifdef ENABLE_EVENTRECORDER
 	if (!g_eventRec.processDelayMillis())
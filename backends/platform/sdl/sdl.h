@@ -76,6 +76,9 @@ public:
 	virtual void setWindowCaption(const char *caption);
 	virtual void addSysArchivesToSearchSet(Common::SearchSet &s, int priority = 0);
 	virtual uint32 getMillis(bool skipRecord = false);
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	virtual uint64 getMicros();
+#endif
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td) const;
 	virtual Audio::Mixer *getMixer();
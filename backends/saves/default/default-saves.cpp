@@ -41,8 +41,12 @@
 #include "common/fs.h"
 #include "common/archive.h"
 #include "common/config-manager.h"
+#include "common/system.h"
 #include "common/zlib.h"
 
+#include "graphics/surface.h"
+#include "graphics/thumbnail.h"
+
 #ifndef _WIN32_WCE
 #include <errno.h>	// for removeSavefile()
 #endif
@@ -166,6 +170,8 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 		fileNode = file->_value;
 	}
 
+	invalidateMetaInfo(filename);
+
 	// Open the file for saving.
 	Common::WriteStream *const sf = fileNode.createWriteStream();
 	Common::OutSaveFile *const result = new Common::OutSaveFile(compress ? Common::wrapCompressedWriteStream(sf) : sf);
@@ -192,6 +198,8 @@ bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
 	}
 #endif
 
+	invalidateMetaInfo(filename);
+
 	// Obtain node if exists.
 	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
 	if (file == _saveFileCache.end()) {
@@ -288,6 +296,173 @@ void DefaultSaveFileManager::assureCached(const Common::String &savePathName) {
 	_cachedDirectory = savePathName;
 }
 
+// Savefile metadata cache
+//
+// The index of a target is stored as "savemeta-<target>.idx" in the cache
+// directory of the system, away from the savefiles. The thumbnail of each
+// savefile is kept in a file of its own next to it, named
+// "savemeta-<target>-<savefile>.thumb", so that only the thumbnails which
+// changed are ever written, and only the ones a dialog shows are read.
+// Dashes in the target and savefile names are escaped, so that the only
+// unescaped dash after the prefix separates the two.
+
+static Common::String escapeMetaFilenamePart(const Common::String &part) {
+	Common::String escaped;
+	for (Common::String::const_iterator c = part.begin(); c != part.end(); ++c) {
+		if (*c == '%')
+			escaped += "%25";
+		else if (*c == '-')
+			escaped += "%2D";
+		else
+			escaped += *c;
+	}
+	return escaped;
+}
+
+Common::String DefaultSaveFileManager::getMetaIndexFilename(const Common::String &target) const {
+	return "savemeta-" + escapeMetaFilenamePart(target) + ".idx";
+}
+
+Common::String DefaultSaveFileManager::getMetaThumbnailFilename(const Common::String &target, const Common::String &name) const {
+	return "savemeta-" + escapeMetaFilenamePart(target) + "-" + escapeMetaFilenamePart(name) + ".thumb";
+}
+
+bool DefaultSaveFileManager::getMetaCacheNode(const Common::String &filename, Common::FSNode &node) const {
+	const Common::String cachePath = g_system->getCachePath();
+	if (cachePath.empty())
+		return false;
+
+	node = Common::FSNode(cachePath).getChild(filename);
+	return true;
+}
+
+bool DefaultSaveFileManager::getSavefileSignature(const Common::String &filename, Common::SaveFileMetaIndex::Signature &signature) {
+	Common::InSaveFile *file = openRawFile(filename);
+	if (!file)
+		return false;
+
+	bool ok = Common::SaveFileMetaIndex::computeSignature(*file, signature);
+	delete file;
+	return ok;
+}
+
+void DefaultSaveFileManager::loadMetaIndex(const Common::String &target) {
+	if (target == _metaIndexTarget)
+		return;
+
+	flushMetaInfoCache();
+	_metaIndex.clear();
+	_metaIndexTarget = target;
+
+	Common::FSNode node;
+	if (!getMetaCacheNode(getMetaIndexFilename(target), node) || !node.exists())
+		return;
+
+	Common::SeekableReadStream *file = node.createReadStream();
+	if (!file)
+		return;
+
+	if (!_metaIndex.load(*file))
+		warning("DefaultSaveFileManager: Ignoring invalid metadata index of '%s'", target.c_str());
+	delete file;
+}
+
+void DefaultSaveFileManager::invalidateMetaInfo(const Common::String &filename) {
+	// Indices of other targets catch the change through the savefile
+	// signature once they are loaded again.
+	const bool hasThumbnail = _metaIndex.hasThumbnail(filename);
+	if (!_metaIndex.remove(filename) || !hasThumbnail)
+		return;
+
+	Common::FSNode node;
+	if (getMetaCacheNode(getMetaThumbnailFilename(_metaIndexTarget, filename), node) && node.exists())
+		remove(node.getPath().c_str());
+}
+
+bool DefaultSaveFileManager::getCachedMetaInfo(const Common::String &target, const Common::String &name, Common::SaveFileMetaInfo &info) {
+	loadMetaIndex(target);
+
+	if (!_metaIndex.contains(name))
+		return false;
+
+	Common::SaveFileMetaIndex::Signature signature;
+	if (!getSavefileSignature(name, signature)) {
+		_metaIndex.remove(name);
+		return false;
+	}
+
+	// A stale thumbnail file is left alone, it is overwritten as soon as
+	// the entry is cached again.
+	return _metaIndex.lookup(name, signature, info);
+}
+
+void DefaultSaveFileManager::setCachedMetaInfo(const Common::String &target, const Common::String &name, const Common::SaveFileMetaInfo &info, const Graphics::Surface *thumbnail) {
+	loadMetaIndex(target);
+
+	Common::SaveFileMetaIndex::Signature signature;
+	if (!getSavefileSignature(name, signature))
+		return;
+
+	Common::FSNode node;
+	if (!getMetaCacheNode(getMetaThumbnailFilename(target, name), node))
+		return;
+
+	bool hasThumbnail = false;
+	if (thumbnail) {
+		Common::WriteStream *file = node.createWriteStream();
+		if (file) {
+			hasThumbnail = Graphics::saveThumbnail(*file, *thumbnail);
+			file->finalize();
+			hasThumbnail = hasThumbnail && !file->err();
+			delete file;
+		}
+	}
+
+	_metaIndex.set(name, signature, info, hasThumbnail);
+}
+
+Graphics::Surface *DefaultSaveFileManager::loadCachedThumbnail(const Common::String &target, const Common::String &name) {
+	loadMetaIndex(target);
+
+	if (!_metaIndex.hasThumbnail(name))
+		return 0;
+
+	Common::FSNode node;
+	if (!getMetaCacheNode(getMetaThumbnailFilename(target, name), node) || !node.exists())
+		return 0;
+
+	Common::SeekableReadStream *file = node.createReadStream();
+	if (!file)
+		return 0;
+
+	Graphics::Surface *thumbnail = Graphics::loadThumbnail(*file);
+	delete file;
+	return thumbnail;
+}
+
+void DefaultSaveFileManager::flushMetaInfoCache() {
+	if (!_metaIndex.isDirty() || _metaIndexTarget.empty())
+		return;
+
+	Common::FSNode node;
+	if (!getMetaCacheNode(getMetaIndexFilename(_metaIndexTarget), node))
+		return;
+
+	// The index only holds the small table of entries, so it is written
+	// as a whole
+	Common::WriteStream *file = node.createWriteStream();
+	if (!file) {
+		warning("DefaultSaveFileManager: Failed to create metadata index '%s'", node.getPath().c_str());
+		return;
+	}
+
+	bool ok = _metaIndex.save(*file);
+	file->finalize();
+	if (!ok || file->err())
+		warning("DefaultSaveFileManager: Failed to write metadata index '%s'", node.getPath().c_str());
+	delete file;
+}
+
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 
 Common::HashMap<Common::String, uint32> DefaultSaveFileManager::loadTimestamps() {
@@ -28,6 +28,7 @@
 #include "common/str.h"
 #include "common/fs.h"
 #include "common/hash-str.h"
+#include "common/savefile-metaindex.h"
 #include <limits.h>
 
 /**
@@ -45,6 +46,11 @@ public:
 	virtual Common::OutSaveFile *openForSaving(const Common::String &filename, bool compress = true);
 	virtual bool removeSavefile(const Common::String &filename);
 
+	virtual bool getCachedMetaInfo(const Common::String &target, const Common::String &name, Common::SaveFileMetaInfo &info);
+	virtual void setCachedMetaInfo(const Common::String &target, const Common::String &name, const Common::SaveFileMetaInfo &info, const Graphics::Surface *thumbnail);
+	virtual Graphics::Surface *loadCachedThumbnail(const Common::String &target, const Common::String &name);
+	virtual void flushMetaInfoCache();
+
 #ifdef USE_LIBCURL
 
 	static const uint32 INVALID_TIMESTAMP = UINT_MAX;
@@ -94,6 +100,27 @@ protected:
 	 */
 	Common::StringArray _lockedFiles;
 
+	bool getSavefileSignature(const Common::String &filename, Common::SaveFileMetaIndex::Signature &signature);
+
+	/**
+	 * Load the metadata index of the given target, writing back the index
+	 * of the previous target first if it changed.
+	 */
+	void loadMetaIndex(const Common::String &target);
+	void invalidateMetaInfo(const Common::String &filename);
+
+	/**
+	 * Get the node of a metadata cache file in the cache directory of the
+	 * system. Returns false if there is no such directory.
+	 */
+	bool getMetaCacheNode(const Common::String &filename, Common::FSNode &node) const;
+	Common::String getMetaIndexFilename(const Common::String &target) const;
+	Common::String getMetaThumbnailFilename(const Common::String &target, const Common::String &name) const;
+
+	/** Metadata index of the target the save/load dialogs were last used for */
+	Common::SaveFileMetaIndex _metaIndex;
+	Common::String _metaIndexTarget;
+
 private:
 	/**
 	 * The currently cached directory.
@@ -44,6 +44,7 @@
 #include "common/events.h"
 #include "gui/EventRecorder.h"
 #include "common/fs.h"
+#include "common/profiler.h"
 #ifdef ENABLE_EVENTRECORDER
 #include "common/recorderfile.h"
 #endif
@@ -55,6 +56,7 @@
 
 #include "gui/gui-manager.h"
 #include "gui/error.h"
+#include "gui/thumbnail-cache.h"
 
 #include "audio/mididrv.h"
 #include "audio/musicplugin.h"  /* for music manager */
@@ -464,6 +466,12 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	system.getAudioCDManager();
 	MusicManager::instance();
 	Common::DebugManager::instance();
+#ifdef ENABLE_ZONE_PROFILER
+	// Create the profiler before the audio thread may record into it. It is
+	// not destroyed on exit, since the mixer keeps running until the
+	// backend is torn down.
+	Common::Profiler::instance();
+#endif
 
 	// Init the event manager. As the virtual keyboard is loaded here, it must
 	// take place after the backend is initiated and the screen has been setup
@@ -519,6 +527,8 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 				g_eventRec.init(g_eventRec.generateRecordFileName(ConfMan.getActiveDomainName()), GUI::EventRecorder::kRecorderRecord);
 			} else if (recordMode == "playback") {
 				g_eventRec.init(recordFileName, GUI::EventRecorder::kRecorderPlayback);
+			} else if (recordMode == "benchmark") {
+				g_eventRec.init(recordFileName, GUI::EventRecorder::kRecorderPlayback, true);
 			} else if ((recordMode == "info") && (!recordFileName.empty())) {
 				Common::PlaybackFile record;
 				record.openRead(recordFileName);
@@ -617,6 +627,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	PluginManager::instance().unloadAllPlugins();
 	PluginManager::destroy();
 	GUI::GuiManager::destroy();
+	GUI::ThumbnailCache::destroy();
 	Common::ConfigManager::destroy();
 	Common::DebugManager::destroy();
 	Common::OSDMessageQueue::destroy();
@@ -22,6 +22,7 @@
 
 #include "common/archive.h"
 #include "common/fs.h"
+#include "common/profiler.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 
@@ -255,6 +256,8 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const String &name) con
 	if (name.empty())
 		return 0;
 
+	PROFILE_ZONE("SearchSet::createReadStreamForMember");
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(name);
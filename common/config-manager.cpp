@@ -49,6 +49,9 @@ char const *const ConfigManager::kKeymapperDomain = "keymapper";
 char const *const ConfigManager::kCloudDomain = "cloud";
 #endif
 
+// Interned keys start out with generation 0, so that is never current.
+uint32 ConfigManager::Domain::_generation = 1;
+
 #pragma mark -
 
 
@@ -78,6 +81,11 @@ void ConfigManager::copyFrom(ConfigManager &source) {
 	_activeDomainName = source._activeDomainName;
 	_activeDomain = &_gameDomains[_activeDomainName];
 	_filename = source._filename;
+
+	// Keep handles given out by the source valid
+	_internedKeyIndices = source._internedKeyIndices;
+	_internedKeys = source._internedKeys;
+	invalidateInternedKeys();
 }
 
 
@@ -122,6 +130,8 @@ void ConfigManager::loadConfigFile(const String &filename) {
 void ConfigManager::addDomain(const String &domainName, const ConfigManager::Domain &domain) {
 	if (domainName.empty())
 		return;
+
+	invalidateInternedKeys();
 	if (domainName == kApplicationDomain) {
 		_appDomain = domain;
 #ifdef ENABLE_KEYMAPPER
@@ -465,10 +475,14 @@ void ConfigManager::removeKey(const String &key, const String &domName) {
 
 
 const String &ConfigManager::get(const String &key) const {
+	// Read through a const pointer, the non-const accessors of Domain
+	// count as modifications.
+	const Domain *activeDomain = _activeDomain;
+
 	if (_transientDomain.contains(key))
 		return _transientDomain[key];
-	else if (_activeDomain && _activeDomain->contains(key))
-		return (*_activeDomain)[key];
+	else if (activeDomain && activeDomain->contains(key))
+		return (*activeDomain)[key];
 	else if (_appDomain.contains(key))
 		return _appDomain[key];
 
@@ -529,6 +543,63 @@ bool ConfigManager::getBool(const String &key, const String &domName) const {
 #pragma mark -
 
 
+ConfigManager::KeyHandle ConfigManager::internKey(const String &key) {
+	HashMap<String, uint, IgnoreCase_Hash, IgnoreCase_EqualTo>::const_iterator i = _internedKeyIndices.find(key);
+	if (i != _internedKeyIndices.end())
+		return KeyHandle(i->_value);
+
+	_internedKeys.push_back(InternedKey(key));
+	_internedKeyIndices[key] = _internedKeys.size() - 1;
+	return KeyHandle(_internedKeys.size() - 1);
+}
+
+const ConfigManager::InternedKey &ConfigManager::lookupInternedKey(KeyHandle key) const {
+	assert(key._index < _internedKeys.size());
+	InternedKey &entry = _internedKeys[key._index];
+	if (entry.generation == Domain::_generation)
+		return entry;
+
+	// The domains are only modified through Domain methods which advance
+	// the generation, so pointing to the value inside the domain is safe
+	// as long as the generation stays the same.
+	entry.generation = Domain::_generation;
+	entry.hasKey = hasKey(entry.name);
+	entry.value = &get(entry.name);
+	entry.intParsed = false;
+	entry.boolParsed = false;
+	return entry;
+}
+
+bool ConfigManager::hasKey(KeyHandle key) const {
+	return lookupInternedKey(key).hasKey;
+}
+
+const String &ConfigManager::get(KeyHandle key) const {
+	return *lookupInternedKey(key).value;
+}
+
+int ConfigManager::getInt(KeyHandle key) const {
+	InternedKey &entry = const_cast<InternedKey &>(lookupInternedKey(key));
+	if (!entry.intParsed) {
+		entry.intValue = getInt(entry.name);
+		entry.intParsed = true;
+	}
+	return entry.intValue;
+}
+
+bool ConfigManager::getBool(KeyHandle key) const {
+	InternedKey &entry = const_cast<InternedKey &>(lookupInternedKey(key));
+	if (!entry.boolParsed) {
+		entry.boolValue = getBool(entry.name);
+		entry.boolParsed = true;
+	}
+	return entry.boolValue;
+}
+
+
+#pragma mark -
+
+
 void ConfigManager::set(const String &key, const String &value) {
 	// Remove the transient domain value, if any.
 	_transientDomain.erase(key);
@@ -619,6 +690,7 @@ void ConfigManager::registerDefault(const String &key, bool value) {
 
 
 void ConfigManager::setActiveDomain(const String &domName) {
+	invalidateInternedKeys();
 	if (domName.empty()) {
 		_activeDomain = 0;
 	} else {
@@ -657,6 +729,7 @@ void ConfigManager::removeGameDomain(const String &domName) {
 		_activeDomain = 0;
 	}
 	_gameDomains.erase(domName);
+	invalidateInternedKeys();
 }
 
 void ConfigManager::removeMiscDomain(const String &domName) {
@@ -672,6 +745,7 @@ void ConfigManager::renameGameDomain(const String &oldName, const String &newNam
 		_activeDomainName = newName;
 		_activeDomain = &_gameDomains[newName];
 	}
+	invalidateInternedKeys();
 }
 
 void ConfigManager::renameMiscDomain(const String &oldName, const String &newName) {
@@ -47,11 +47,15 @@ class ConfigManager : public Singleton<ConfigManager> {
 public:
 
 	class Domain {
+		friend class ConfigManager;
 	private:
 		StringMap _entries;
 		StringMap _keyValueComments;
 		String _domainComment;
 
+		/** Incremented whenever the entries of any domain are modified. */
+		static uint32 _generation;
+
 	public:
 		typedef StringMap::const_iterator const_iterator;
 		const_iterator begin() const { return _entries.begin(); }
@@ -61,17 +65,17 @@ public:
 
 		bool contains(const String &key) const { return _entries.contains(key); }
 
-		String &operator[](const String &key) { return _entries[key]; }
+		String &operator[](const String &key) { ++_generation; return _entries[key]; }
 		const String &operator[](const String &key) const { return _entries[key]; }
 
-		void setVal(const String &key, const String &value) { _entries.setVal(key, value); }
+		void setVal(const String &key, const String &value) { ++_generation; _entries.setVal(key, value); }
 
-		String &getVal(const String &key) { return _entries.getVal(key); }
+		String &getVal(const String &key) { ++_generation; return _entries.getVal(key); }
 		const String &getVal(const String &key) const { return _entries.getVal(key); }
 
-		void clear() { _entries.clear(); }
+		void clear() { ++_generation; _entries.clear(); }
 
-		void erase(const String &key) { _entries.erase(key); }
+		void erase(const String &key) { ++_generation; _entries.erase(key); }
 
 		void setDomainComment(const String &comment);
 		const String &getDomainComment() const;
@@ -83,6 +87,23 @@ public:
 
 	typedef HashMap<String, Domain, IgnoreCase_Hash, IgnoreCase_EqualTo> DomainMap;
 
+	/**
+	 * Handle of an interned configuration key, as returned by internKey().
+	 *
+	 * Looking up a key through its handle remembers where the value was
+	 * found and its parsed int and bool representations. These are reused
+	 * until any domain is modified or the active domain changes, which
+	 * makes handles suitable for keys queried every frame.
+	 */
+	class KeyHandle {
+		friend class ConfigManager;
+		uint _index;
+		explicit KeyHandle(uint index) : _index(index) {}
+	public:
+		KeyHandle() : _index(0xFFFFFFFF) {}
+		bool isValid() const { return _index != 0xFFFFFFFF; }
+	};
+
 	/** The name of the application domain (normally 'scummvm'). */
 	static char const *const kApplicationDomain;
 
@@ -120,6 +141,18 @@ public:
 	const String &		get(const String &key) const;
 	void				set(const String &key, const String &value);
 
+	//
+	// Cached access through interned keys. These behave like the generic
+	// access methods above. Interning the same key twice returns the same
+	// handle.
+	//
+
+	KeyHandle			internKey(const String &key);
+	bool				hasKey(KeyHandle key) const;
+	const String &		get(KeyHandle key) const;
+	int					getInt(KeyHandle key) const;
+	bool				getBool(KeyHandle key) const;
+
 #if 1
 	//
 	// Domain specific access methods: Acces *one specific* domain and modify it.
@@ -183,6 +216,31 @@ private:
 	void			writeDomain(WriteStream &stream, const String &name, const Domain &domain);
 	void			renameDomain(const String &oldName, const String &newName, DomainMap &map);
 
+	/** Mark the results of all interned key lookups as outdated. */
+	void			invalidateInternedKeys() { ++Domain::_generation; }
+
+	struct InternedKey {
+		String name;
+
+		/** Domain generation the fields below were computed for */
+		uint32 generation;
+		const String *value;
+		bool hasKey;
+
+		bool intParsed;
+		int intValue;
+		bool boolParsed;
+		bool boolValue;
+
+		explicit InternedKey(const String &n) : name(n), generation(0), value(0), hasKey(false),
+			intParsed(false), intValue(0), boolParsed(false), boolValue(false) {}
+	};
+
+	const InternedKey &lookupInternedKey(KeyHandle key) const;
+
+	HashMap<String, uint, IgnoreCase_Hash, IgnoreCase_EqualTo> _internedKeyIndices;
+	mutable Array<InternedKey> _internedKeys;
+
 	Domain			_transientDomain;
 	DomainMap		_gameDomains;
 	DomainMap		_miscDomains;		// Any other domains
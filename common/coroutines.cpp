@@ -107,6 +107,7 @@ CoroutineScheduler::CoroutineScheduler() {
 
 	pRCfunction = NULL;
 	pidCounter = 0;
+	_signalCount = 0;
 
 	active = new PROCESS;
 	active->pPrevious = NULL;
@@ -131,9 +132,8 @@ CoroutineScheduler::~CoroutineScheduler() {
 	active = 0;
 
 	// Clear the event list
-	Common::List<EVENT *>::iterator i;
-	for (i = _events.begin(); i != _events.end(); ++i)
-		delete *i;
+	for (EventMap::iterator i = _events.begin(); i != _events.end(); ++i)
+		delete i->_value;
 }
 
 void CoroutineScheduler::reset() {
@@ -166,6 +166,8 @@ void CoroutineScheduler::reset() {
 
 	// no active processes
 	pCurrent = active->pNext = NULL;
+	_pidCounts.clear();
+	_signalCount++;
 
 	// place first process on free list
 	pFreeProcesses = processList;
@@ -226,7 +228,11 @@ void CoroutineScheduler::schedule() {
 	while (pProc != NULL) {
 		pNext = pProc->pNext;
 
-		if (--pProc->sleepTime <= 0) {
+		if (--pProc->sleepTime <= 0 && pProc->waitType != kCoroWaitNone && !isWaitOver(pProc)) {
+			// Running the process would only have it check again, and go
+			// back to sleep until the next cycle
+			pProc->sleepTime = 1;
+		} else if (pProc->sleepTime <= 0) {
 			// process is ready for dispatch, activate it
 			pCurrent = pProc;
 			pProc->coroAddr(pProc->state, pProc->param);
@@ -248,13 +254,23 @@ void CoroutineScheduler::schedule() {
 	}
 
 	// Disable any events that were pulsed
-	Common::List<EVENT *>::iterator i;
-	for (i = _events.begin(); i != _events.end(); ++i) {
-		EVENT *evt = *i;
-		if (evt->pulsing) {
+	for (Common::List<uint32>::iterator i = _pulsedEvents.begin(); i != _pulsedEvents.end(); ++i) {
+		EVENT *evt = getEvent(*i);
+		if (evt && evt->pulsing) {
 			evt->pulsing = evt->signalled = false;
 		}
 	}
+	_pulsedEvents.clear();
+}
+
+bool CoroutineScheduler::isWaitOver(const PROCESS *pProc) const {
+	if (pProc->waitType == kCoroWaitTime)
+		return g_system->getMillis() >= pProc->waitEndTime;
+
+	if (pProc->waitSignal != _signalCount)
+		return true;
+
+	return pProc->waitEndTime != CORO_INFINITE && g_system->getMillis() > pProc->waitEndTime;
 }
 
 void CoroutineScheduler::rescheduleAll() {
@@ -348,7 +364,7 @@ void CoroutineScheduler::waitForSingleObject(CORO_PARAM, int pid, uint32 duratio
 
 	CORO_BEGIN_CONTEXT;
 		uint32 endTime;
-		PROCESS *pProcess;
+		bool processExists;
 		EVENT *pEvent;
 	CORO_END_CONTEXT(_ctx);
 
@@ -363,14 +379,16 @@ void CoroutineScheduler::waitForSingleObject(CORO_PARAM, int pid, uint32 duratio
 		*expired = true;
 
 	// Outer loop for doing checks until expiry
-	while (g_system->getMillis() <= _ctx->endTime) {
+	while (_ctx->endTime == CORO_INFINITE || g_system->getMillis() <= _ctx->endTime) {
+		pCurrent->waitSignal = _signalCount;
+
 		// Check to see if a process or event with the given Id exists
-		_ctx->pProcess = getProcess(pid);
-		_ctx->pEvent = !_ctx->pProcess ? getEvent(pid) : NULL;
+		_ctx->processExists = hasProcess(pid);
+		_ctx->pEvent = !_ctx->processExists ? getEvent(pid) : NULL;
 
 		// If there's no active process or event, presume it's a process that's finished,
 		// so the waiting can immediately exit
-		if ((_ctx->pProcess == NULL) && (_ctx->pEvent == NULL)) {
+		if (!_ctx->processExists && (_ctx->pEvent == NULL)) {
 			if (expired)
 				*expired = false;
 			break;
@@ -388,12 +406,16 @@ void CoroutineScheduler::waitForSingleObject(CORO_PARAM, int pid, uint32 duratio
 			break;
 		}
 
-		// Sleep until the next cycle
+		// Sleep until the next cycle. The scheduler leaves the process asleep
+		// until something it waits for may have changed, or the time is up
+		pCurrent->waitType = kCoroWaitObjects;
+		pCurrent->waitEndTime = _ctx->endTime;
 		CORO_SLEEP(1);
 	}
 
 	// Signal waiting is done
 	Common::fill(&pCurrent->pidWaiting[0], &pCurrent->pidWaiting[CORO_MAX_PID_WAITING], 0);
+	pCurrent->waitType = kCoroWaitNone;
 
 	CORO_END_CODE;
 }
@@ -408,7 +430,7 @@ void CoroutineScheduler::waitForMultipleObjects(CORO_PARAM, int nCount, uint32 *
 		bool signalled;
 		bool pidSignalled;
 		int i;
-		PROCESS *pProcess;
+		bool processExists;
 		EVENT *pEvent;
 	CORO_END_CONTEXT(_ctx);
 
@@ -424,15 +446,16 @@ void CoroutineScheduler::waitForMultipleObjects(CORO_PARAM, int nCount, uint32 *
 		*expired = true;
 
 	// Outer loop for doing checks until expiry
-	while (g_system->getMillis() <= _ctx->endTime) {
+	while (_ctx->endTime == CORO_INFINITE || g_system->getMillis() <= _ctx->endTime) {
+		pCurrent->waitSignal = _signalCount;
 		_ctx->signalled = bWaitAll;
 
 		for (_ctx->i = 0; _ctx->i < nCount; ++_ctx->i) {
-			_ctx->pProcess = getProcess(pidList[_ctx->i]);
-			_ctx->pEvent = !_ctx->pProcess ? getEvent(pidList[_ctx->i]) : NULL;
+			_ctx->processExists = hasProcess(pidList[_ctx->i]);
+			_ctx->pEvent = !_ctx->processExists ? getEvent(pidList[_ctx->i]) : NULL;
 
 			// Determine the signalled state
-			_ctx->pidSignalled = (_ctx->pProcess) || !_ctx->pEvent ? false : _ctx->pEvent->signalled;
+			_ctx->pidSignalled = _ctx->processExists || !_ctx->pEvent ? false : _ctx->pEvent->signalled;
 
 			if (bWaitAll && !_ctx->pidSignalled)
 				_ctx->signalled = false;
@@ -455,12 +478,16 @@ void CoroutineScheduler::waitForMultipleObjects(CORO_PARAM, int nCount, uint32 *
 			break;
 		}
 
-		// Sleep until the next cycle
+		// Sleep until the next cycle. The scheduler leaves the process asleep
+		// until something it waits for may have changed, or the time is up
+		pCurrent->waitType = kCoroWaitObjects;
+		pCurrent->waitEndTime = _ctx->endTime;
 		CORO_SLEEP(1);
 	}
 
 	// Signal waiting is done
 	Common::fill(&pCurrent->pidWaiting[0], &pCurrent->pidWaiting[CORO_MAX_PID_WAITING], 0);
+	pCurrent->waitType = kCoroWaitNone;
 
 	CORO_END_CODE;
 }
@@ -471,8 +498,6 @@ void CoroutineScheduler::sleep(CORO_PARAM, uint32 duration) {
 
 	CORO_BEGIN_CONTEXT;
 		uint32 endTime;
-		PROCESS *pProcess;
-		EVENT *pEvent;
 	CORO_END_CONTEXT(_ctx);
 
 	CORO_BEGIN_CODE(_ctx);
@@ -481,10 +506,15 @@ void CoroutineScheduler::sleep(CORO_PARAM, uint32 duration) {
 
 	// Outer loop for doing checks until expiry
 	while (g_system->getMillis() < _ctx->endTime) {
-		// Sleep until the next cycle
+		// Sleep until the next cycle. The scheduler leaves the process asleep
+		// until the time is up
+		pCurrent->waitType = kCoroWaitTime;
+		pCurrent->waitEndTime = _ctx->endTime;
 		CORO_SLEEP(1);
 	}
 
+	pCurrent->waitType = kCoroWaitNone;
+
 	CORO_END_CODE;
 }
 
@@ -539,6 +569,10 @@ PROCESS *CoroutineScheduler::createProcess(uint32 pid, CORO_ADDR coroAddr, const
 
 	// set new process id
 	pProc->pid = pid;
+	addProcessPid(pid);
+
+	// not waiting for anything
+	pProc->waitType = kCoroWaitNone;
 
 	// set new process specific info
 	if (sizeParam) {
@@ -580,6 +614,7 @@ void CoroutineScheduler::killProcess(PROCESS *pKillProc) {
 
 	delete pKillProc->state;
 	pKillProc->state = 0;
+	removeProcessPid(pKillProc->pid);
 
 	// Take the process out of the active chain list
 	pKillProc->pPrevious->pNext = pKillProc->pNext;
@@ -629,6 +664,7 @@ int CoroutineScheduler::killMatchingProcess(uint32 pidKill, int pidMask) {
 
 				delete pProc->state;
 				pProc->state = 0;
+				removeProcessPid(pProc->pid);
 
 				// make prev point to next to unlink pProc
 				pPrev->pNext = pProc->pNext;
@@ -663,23 +699,27 @@ void CoroutineScheduler::setResourceCallback(VFPTRPP pFunc) {
 	pRCfunction = pFunc;
 }
 
-PROCESS *CoroutineScheduler::getProcess(uint32 pid) {
-	PROCESS *pProc = active->pNext;
-	while ((pProc != NULL) && (pProc->pid != pid))
-		pProc = pProc->pNext;
-
-	return pProc;
+bool CoroutineScheduler::hasProcess(uint32 pid) const {
+	return _pidCounts.contains(pid);
 }
 
 EVENT *CoroutineScheduler::getEvent(uint32 pid) {
-	Common::List<EVENT *>::iterator i;
-	for (i = _events.begin(); i != _events.end(); ++i) {
-		EVENT *evt = *i;
-		if (evt->pid == pid)
-			return evt;
-	}
+	EventMap::iterator i = _events.find(pid);
+	return (i != _events.end()) ? i->_value : NULL;
+}
+
+void CoroutineScheduler::addProcessPid(uint32 pid) {
+	_pidCounts[pid]++;
+}
+
+void CoroutineScheduler::removeProcessPid(uint32 pid) {
+	PidCountMap::iterator i = _pidCounts.find(pid);
+	assert(i != _pidCounts.end());
+	if (--i->_value == 0)
+		_pidCounts.erase(i);
 
-	return NULL;
+	// Processes waiting for it may be able to continue
+	_signalCount++;
 }
 
 
@@ -690,22 +730,26 @@ uint32 CoroutineScheduler::createEvent(bool bManualReset, bool bInitialState) {
 	evt->signalled = bInitialState;
 	evt->pulsing = false;
 
-	_events.push_back(evt);
+	_events[evt->pid] = evt;
+	_signalCount++;
 	return evt->pid;
 }
 
 void CoroutineScheduler::closeEvent(uint32 pidEvent) {
 	EVENT *evt = getEvent(pidEvent);
 	if (evt) {
-		_events.remove(evt);
+		_events.erase(pidEvent);
 		delete evt;
+		_signalCount++;
 	}
 }
 
 void CoroutineScheduler::setEvent(uint32 pidEvent) {
 	EVENT *evt = getEvent(pidEvent);
-	if (evt)
+	if (evt) {
 		evt->signalled = true;
+		_signalCount++;
+	}
 }
 
 void CoroutineScheduler::resetEvent(uint32 pidEvent) {
@@ -722,6 +766,8 @@ void CoroutineScheduler::pulseEvent(uint32 pidEvent) {
 	// Set the event as signalled and pulsing
 	evt->signalled = true;
 	evt->pulsing = true;
+	_pulsedEvents.push_back(pidEvent);
+	_signalCount++;
 
 	// If there's an active process, and it's not the first in the queue, then reschedule all
 	// the other prcoesses in the queue to run again this frame
@@ -25,6 +25,7 @@
 
 #include "common/scummsys.h"
 #include "common/util.h"    // for SCUMMVM_CURRENT_FUNCTION
+#include "common/hashmap.h"
 #include "common/list.h"
 #include "common/singleton.h"
 
@@ -297,6 +298,13 @@ public:
 /** Coroutine parameter for methods converted to coroutines */
 typedef void (*CORO_ADDR)(CoroContext &, const void *);
 
+/** What a sleeping process waits for, which the scheduler checks without running it */
+enum CoroWaitType {
+	kCoroWaitNone,      ///< the process runs once its sleep time is over
+	kCoroWaitObjects,   ///< the process waits for processes to end or events to be set
+	kCoroWaitTime       ///< the process waits until waitEndTime
+};
+
 /** process structure */
 struct PROCESS {
 	PROCESS *pNext;     ///< pointer to next process in active or free list
@@ -309,6 +317,10 @@ struct PROCESS {
 	uint32 pid;         ///< process ID
 	uint32 pidWaiting[CORO_MAX_PID_WAITING];    ///< Process ID(s) process is currently waiting on
 	char param[CORO_PARAM_SIZE];    ///< process specific info
+
+	int waitType;       ///< what the process waits for, see CoroWaitType
+	uint32 waitEndTime; ///< time in milliseconds at which the wait ends
+	uint32 waitSignal;  ///< signal count when the process last checked the objects it waits for
 };
 typedef PROCESS *PPROCESS;
 
@@ -359,8 +371,22 @@ private:
 	/** Auto-incrementing process Id */
 	int pidCounter;
 
-	/** Event list */
-	Common::List<EVENT *> _events;
+	/** Events by Id */
+	typedef Common::HashMap<uint32, EVENT *> EventMap;
+	EventMap _events;
+
+	/** Ids of the events pulsed since the last schedule() */
+	Common::List<uint32> _pulsedEvents;
+
+	/** Number of active processes with each Id */
+	typedef Common::HashMap<uint32, uint> PidCountMap;
+	PidCountMap _pidCounts;
+
+	/**
+	 * Incremented whenever a process ends or an event is set or closed. Waiting
+	 * processes only need to check the objects they wait for after it changed.
+	 */
+	uint32 _signalCount;
 
 #ifdef DEBUG
 	// diagnostic process counters
@@ -380,8 +406,17 @@ private:
 	 */
 	VFPTRPP pRCfunction;
 
-	PROCESS *getProcess(uint32 pid);
+	bool hasProcess(uint32 pid) const;
 	EVENT *getEvent(uint32 pid);
+
+	void addProcessPid(uint32 pid);
+	void removeProcessPid(uint32 pid);
+
+	/**
+	 * Returns true if a process that is waiting for something may be able
+	 * to continue, and so has to be run
+	 */
+	bool isWaitOver(const PROCESS *pProc) const;
 public:
 	/**
 	 * Kills all processes and places them on the free list.
@@ -29,6 +29,7 @@ MODULE_OBJS := \
 	random.o \
 	rational.o \
 	rendermode.o \
+	savefile-metaindex.o \
 	str.o \
 	stream.o \
 	system.o \
@@ -58,6 +59,11 @@ MODULE_OBJS += \
 	recorderfile.o
 endif
 
+ifdef ENABLE_ZONE_PROFILER
+MODULE_OBJS += \
+	profiler.o
+endif
+
 ifdef USE_UPDATES
 MODULE_OBJS += \
 	updates.o
@@ -0,0 +1,181 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/profiler.h"
+
+#ifdef ENABLE_ZONE_PROFILER
+
+#include "common/algorithm.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/stream.h"
+#include "common/system.h"
+
+namespace Common {
+DECLARE_SINGLETON(Profiler);
+
+Profiler::Profiler() : _enabled(true) {
+	for (int i = 0; i < kLaneCount; i++)
+		_depth[i] = 0;
+	reset();
+}
+
+void Profiler::reset() {
+	for (int i = 0; i < kLaneCount; i++) {
+		_lanes[i].next = 0;
+		_lanes[i].count = 0;
+	}
+}
+
+void Profiler::leaveZone(Lane lane, const char *name, uint64 start, uint32 duration, uint16 depth) {
+	_depth[lane] = depth;
+
+	LaneBuffer &buffer = _lanes[lane];
+	Event &event = buffer.events[buffer.next];
+	event.name = name;
+	event.start = start;
+	event.duration = duration;
+	event.depth = depth;
+
+	buffer.next = (buffer.next + 1) % kEventsPerLane;
+	if (buffer.count < kEventsPerLane)
+		buffer.count++;
+}
+
+namespace {
+
+struct ZoneSamples {
+	const char *name;
+	uint64 total;
+	Array<uint32> durations;
+
+	ZoneSamples() : name(0), total(0) {}
+};
+
+struct ZoneStatsTotalGreater {
+	const HashMap<String, ZoneSamples> &_samples;
+
+	ZoneStatsTotalGreater(const HashMap<String, ZoneSamples> &samples) : _samples(samples) {}
+
+	bool operator()(const Profiler::ZoneStats &a, const Profiler::ZoneStats &b) const {
+		return _samples[a.name].total > _samples[b.name].total;
+	}
+};
+
+uint32 percentile(const Array<uint32> &sorted, uint p) {
+	uint index = (sorted.size() - 1) * p / 100;
+	return sorted[index];
+}
+
+void writeJSONString(WriteStream &stream, const char *str) {
+	stream.writeByte('"');
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\')
+			stream.writeByte('\\');
+		stream.writeByte(*str);
+	}
+	stream.writeByte('"');
+}
+
+} // End of anonymous namespace
+
+void Profiler::getStats(Array<ZoneStats> &stats) const {
+	HashMap<String, ZoneSamples> samples;
+
+	for (int lane = 0; lane < kLaneCount; lane++) {
+		const LaneBuffer &buffer = _lanes[lane];
+		for (uint32 i = 0; i < buffer.count; i++) {
+			const Event &event = buffer.events[i];
+			ZoneSamples &zone = samples[event.name];
+			zone.name = event.name;
+			zone.total += event.duration;
+			zone.durations.push_back(event.duration);
+		}
+	}
+
+	stats.clear();
+	for (HashMap<String, ZoneSamples>::iterator i = samples.begin(); i != samples.end(); ++i) {
+		Array<uint32> &durations = i->_value.durations;
+		sort(durations.begin(), durations.end());
+
+		ZoneStats zone;
+		zone.name = i->_value.name;
+		zone.count = durations.size();
+		zone.p50 = percentile(durations, 50);
+		zone.p90 = percentile(durations, 90);
+		zone.p99 = percentile(durations, 99);
+		zone.max = durations.back();
+		stats.push_back(zone);
+	}
+
+	sort(stats.begin(), stats.end(), ZoneStatsTotalGreater(samples));
+}
+
+void Profiler::exportChromeTrace(WriteStream &stream) const {
+	static const char *const laneNames[kLaneCount] = { "main", "audio" };
+
+	stream.writeString("{\"traceEvents\":[\n");
+	bool first = true;
+
+	for (int lane = 0; lane < kLaneCount; lane++) {
+		if (!first)
+			stream.writeString(",\n");
+		first = false;
+		stream.writeString(String::format("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", lane, laneNames[lane]));
+
+		// Oldest event first
+		const LaneBuffer &buffer = _lanes[lane];
+		uint32 index = (buffer.next + kEventsPerLane - buffer.count) % kEventsPerLane;
+		for (uint32 i = 0; i < buffer.count; i++) {
+			const Event &event = buffer.events[index];
+			stream.writeString(",\n{\"name\":");
+			writeJSONString(stream, event.name);
+			// printf style formatting of 64-bit integers is not portable,
+			// but a double holds any realistic timestamp exactly.
+			stream.writeString(String::format(",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.0f,\"dur\":%u}",
+				lane, (double)event.start, event.duration));
+			index = (index + 1) % kEventsPerLane;
+		}
+	}
+
+	stream.writeString("\n]}\n");
+}
+
+ProfileZone::ProfileZone(const char *name, Profiler::Lane lane) : _name(name), _lane(lane), _start(0), _depth(0) {
+	Profiler &profiler = Profiler::instance();
+	_active = g_system && profiler.isEnabled();
+	if (_active) {
+		_depth = profiler.enterZone(lane);
+		_start = g_system->getMicros();
+	}
+}
+
+ProfileZone::~ProfileZone() {
+	if (_active) {
+		uint64 end = g_system->getMicros();
+		Profiler::instance().leaveZone(_lane, _name, _start, (uint32)(end - _start), _depth);
+	}
+}
+
+} // End of namespace Common
+
+#endif // ENABLE_ZONE_PROFILER
@@ -0,0 +1,147 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_PROFILER_H
+#define COMMON_PROFILER_H
+
+#include "common/scummsys.h"
+
+#ifdef ENABLE_ZONE_PROFILER
+
+#include "common/array.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+namespace Common {
+
+class WriteStream;
+
+/**
+ * Lightweight scoped-zone profiler.
+ *
+ * Code marks interesting regions with PROFILE_ZONE(). Each completed zone
+ * is appended to a fixed size ring buffer, so only the most recent events
+ * are kept and recording never allocates.
+ *
+ * There is no portable way to identify threads, so events are sorted into
+ * lanes instead. Each lane must only ever be written from one thread: the
+ * audio callback uses kLaneAudio, everything else the main lane.
+ */
+class Profiler : public Singleton<Profiler> {
+public:
+	enum Lane {
+		kLaneMain = 0,
+		kLaneAudio,
+		kLaneCount
+	};
+
+	enum {
+		kEventsPerLane = 16384
+	};
+
+	struct Event {
+		const char *name; ///< Zone name, must be a string literal
+		uint64 start;     ///< Start time in microseconds
+		uint32 duration;  ///< Duration in microseconds
+		uint16 depth;     ///< Nesting depth within the lane
+	};
+
+	struct ZoneStats {
+		const char *name;
+		uint32 count;
+		uint32 p50, p90, p99, max; ///< Durations in microseconds
+	};
+
+	bool isEnabled() const { return _enabled; }
+	void setEnabled(bool enabled) { _enabled = enabled; }
+
+	/** Drop all recorded events */
+	void reset();
+
+	/** Called by ProfileZone when a zone is entered and left */
+	uint16 enterZone(Lane lane) { return _depth[lane]++; }
+	void leaveZone(Lane lane, const char *name, uint64 start, uint32 duration, uint16 depth);
+
+	/**
+	 * Compute duration percentiles of every zone over the events currently
+	 * held in the ring buffers, sorted by total time spent.
+	 */
+	void getStats(Array<ZoneStats> &stats) const;
+
+	/**
+	 * Write the recorded events in the Chrome trace event format, which can
+	 * be loaded in chrome://tracing or Perfetto.
+	 */
+	void exportChromeTrace(WriteStream &stream) const;
+
+private:
+	friend class Singleton<SingletonBaseType>;
+	Profiler();
+
+	struct LaneBuffer {
+		Event events[kEventsPerLane];
+		uint32 next;   ///< Index the next event is written to
+		uint32 count;  ///< Number of valid events, up to kEventsPerLane
+	};
+
+	bool _enabled;
+	uint16 _depth[kLaneCount];
+	LaneBuffer _lanes[kLaneCount];
+};
+
+/**
+ * Records the lifetime of the object as a profiler zone.
+ */
+class ProfileZone {
+public:
+	ProfileZone(const char *name, Profiler::Lane lane = Profiler::kLaneMain);
+	~ProfileZone();
+
+private:
+	const char *_name;
+	Profiler::Lane _lane;
+	uint64 _start;
+	uint16 _depth;
+	bool _active;
+};
+
+} // End of namespace Common
+
+#define PROFILE_ZONE_CONCAT2(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT2(a, b)
+
+/** Profile the rest of the enclosing scope under the given name */
+#define PROFILE_ZONE(name) \
+	Common::ProfileZone PROFILE_ZONE_CONCAT(profileZone, __LINE__)(name)
+
+/** Profile the rest of the enclosing scope in a specific lane */
+#define PROFILE_ZONE_LANE(name, lane) \
+	Common::ProfileZone PROFILE_ZONE_CONCAT(profileZone, __LINE__)(name, Common::Profiler::lane)
+
+#else
+
+#define PROFILE_ZONE(name) do {} while (0)
+#define PROFILE_ZONE_LANE(name, lane) do {} while (0)
+
+#endif // ENABLE_ZONE_PROFILER
+
+#endif
@@ -128,6 +128,8 @@ public:
 	PlaybackFileHeader &getHeader() {return _header;}
 	void updateHeader();
 	void addSaveFile(const String &fileName, InSaveFile *saveStream);
+	uint getScreenshotChecks() const { return _screenshotChecks; }
+	uint getScreenshotMismatches() const { return _screenshotMismatches; }
 private:
 	WriteStream *_recordFile;
 	WriteStream *_writeStream;
@@ -140,6 +142,8 @@ private:
 	bool _headerDumped;
 	int _recordCount;
 	uint32 _eventsSize;
+	uint _screenshotChecks;
+	uint _screenshotMismatches;
 	byte _tmpBuffer[kRecordBuffSize];
 	PlaybackFileHeader _header;
 	PlaybackFileState _playbackParseState;
@@ -0,0 +1,183 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/savefile-metaindex.h"
+#include "common/endian.h"
+#include "common/md5.h"
+#include "common/stream.h"
+
+namespace Common {
+
+// The index is stored uncompressed:
+//
+//   uint32BE 'SMIX', uint32LE version, uint32LE entry count, the entries
+//
+// Each entry holds the savefile name, its signature and the metadata, with
+// the strings stored as uint32LE length and characters.
+
+namespace {
+
+enum {
+	kMetaIndexTag = MKTAG('S', 'M', 'I', 'X'),
+	kMetaIndexVersion = 3
+};
+
+enum {
+	kMetaFlagDeletable = 1 << 0,
+	kMetaFlagWriteProtected = 1 << 1,
+	kMetaFlagThumbnail = 1 << 2
+};
+
+void writeIndexString(WriteStream &stream, const String &str) {
+	stream.writeUint32LE(str.size());
+	stream.writeString(str);
+}
+
+String readIndexString(SeekableReadStream &stream) {
+	String str;
+	uint32 size = stream.readUint32LE();
+	while (size-- > 0 && !stream.eos())
+		str += (char)stream.readByte();
+	return str;
+}
+
+} // End of anonymous namespace
+
+bool SaveFileMetaIndex::Signature::operator==(const Signature &other) const {
+	return size == other.size && !memcmp(md5, other.md5, sizeof(md5));
+}
+
+bool SaveFileMetaIndex::computeSignature(SeekableReadStream &stream, Signature &signature) {
+#ifdef DISABLE_MD5
+	// Without the hash a savefile rewritten at the same size goes unnoticed
+	return false;
+#endif
+
+	signature.size = stream.size();
+	stream.seek(0);
+	return computeStreamMD5(stream, signature.md5) && !stream.err();
+}
+
+bool SaveFileMetaIndex::load(SeekableReadStream &stream) {
+	clear();
+
+	if (stream.readUint32BE() != kMetaIndexTag || stream.readUint32LE() != kMetaIndexVersion)
+		return false;
+
+	const uint32 count = stream.readUint32LE();
+	for (uint32 i = 0; i < count && !stream.eos() && !stream.err(); ++i) {
+		const String name = readIndexString(stream);
+		Entry entry;
+		entry.signature.size = stream.readUint32LE();
+		stream.read(entry.signature.md5, sizeof(entry.signature.md5));
+		entry.info.slot = stream.readSint32LE();
+		entry.info.description = readIndexString(stream);
+		const byte flags = stream.readByte();
+		entry.info.deletable = (flags & kMetaFlagDeletable) != 0;
+		entry.info.writeProtected = (flags & kMetaFlagWriteProtected) != 0;
+		entry.hasThumbnail = (flags & kMetaFlagThumbnail) != 0;
+		entry.info.saveDate = readIndexString(stream);
+		entry.info.saveTime = readIndexString(stream);
+		entry.info.playTime = readIndexString(stream);
+		_entries[name] = entry;
+	}
+
+	if (stream.eos() || stream.err()) {
+		clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool SaveFileMetaIndex::save(WriteStream &stream) {
+	stream.writeUint32BE(kMetaIndexTag);
+	stream.writeUint32LE(kMetaIndexVersion);
+	stream.writeUint32LE(_entries.size());
+
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		const Entry &entry = i->_value;
+
+		writeIndexString(stream, i->_key);
+		stream.writeUint32LE(entry.signature.size);
+		stream.write(entry.signature.md5, sizeof(entry.signature.md5));
+		stream.writeSint32LE(entry.info.slot);
+		writeIndexString(stream, entry.info.description);
+		stream.writeByte((entry.info.deletable ? kMetaFlagDeletable : 0) |
+		                 (entry.info.writeProtected ? kMetaFlagWriteProtected : 0) |
+		                 (entry.hasThumbnail ? kMetaFlagThumbnail : 0));
+		writeIndexString(stream, entry.info.saveDate);
+		writeIndexString(stream, entry.info.saveTime);
+		writeIndexString(stream, entry.info.playTime);
+	}
+
+	if (stream.err())
+		return false;
+
+	_dirty = false;
+	return true;
+}
+
+void SaveFileMetaIndex::clear() {
+	_entries.clear();
+	_dirty = false;
+}
+
+bool SaveFileMetaIndex::lookup(const String &name, const Signature &signature, SaveFileMetaInfo &info) {
+	EntryMap::iterator entry = _entries.find(name);
+	if (entry == _entries.end())
+		return false;
+
+	if (!(entry->_value.signature == signature)) {
+		_entries.erase(entry);
+		_dirty = true;
+		return false;
+	}
+
+	info = entry->_value.info;
+	return true;
+}
+
+bool SaveFileMetaIndex::hasThumbnail(const String &name) const {
+	EntryMap::const_iterator entry = _entries.find(name);
+	return entry != _entries.end() && entry->_value.hasThumbnail;
+}
+
+void SaveFileMetaIndex::set(const String &name, const Signature &signature, const SaveFileMetaInfo &info, bool hasThumbnail) {
+	Entry entry;
+	entry.info = info;
+	entry.signature = signature;
+	entry.hasThumbnail = hasThumbnail;
+	_entries[name] = entry;
+	_dirty = true;
+}
+
+bool SaveFileMetaIndex::remove(const String &name) {
+	if (!_entries.contains(name))
+		return false;
+
+	_entries.erase(name);
+	_dirty = true;
+	return true;
+}
+
+} // End of namespace Common
@@ -0,0 +1,117 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_SAVEFILE_METAINDEX_H
+#define COMMON_SAVEFILE_METAINDEX_H
+
+#include "common/savefile.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+
+namespace Common {
+
+class SeekableReadStream;
+class WriteStream;
+
+/**
+ * The cached metadata of the savefiles of one target, as used by savefile
+ * managers to implement SaveFileManager::getCachedMetaInfo.
+ *
+ * There is no modification time API in Common::FSNode, so every entry is
+ * validated against a signature of the savefile instead. Thumbnails are
+ * not part of the index, which only records whether an entry has one.
+ */
+class SaveFileMetaIndex {
+public:
+	/**
+	 * Identifies the contents of a savefile: its size and the MD5 of all of
+	 * its bytes. Reading a savefile is cheap compared to having the engine
+	 * decompress and parse it.
+	 */
+	struct Signature {
+		uint32 size;
+		uint8 md5[16];
+
+		bool operator==(const Signature &other) const;
+	};
+
+	/**
+	 * Compute the signature of a savefile from its raw (not decompressed)
+	 * contents.
+	 */
+	static bool computeSignature(SeekableReadStream &stream, Signature &signature);
+
+	SaveFileMetaIndex() : _dirty(false) {}
+
+	/**
+	 * Replace the entries with the ones of an index written by save().
+	 *
+	 * @return false if the stream holds no valid index, which leaves the
+	 *         index empty.
+	 */
+	bool load(SeekableReadStream &stream);
+
+	/** Write all entries, and mark the index as unchanged. */
+	bool save(WriteStream &stream);
+
+	/** Whether entries changed since the last load() or save() */
+	bool isDirty() const { return _dirty; }
+
+	void clear();
+
+	bool contains(const String &name) const { return _entries.contains(name); }
+
+	/**
+	 * Look up the metadata of a savefile. An entry whose signature does not
+	 * match the current one of the savefile is dropped.
+	 *
+	 * @return false if there is no up to date entry.
+	 */
+	bool lookup(const String &name, const Signature &signature, SaveFileMetaInfo &info);
+
+	/** Whether the entry of a savefile has a thumbnail */
+	bool hasThumbnail(const String &name) const;
+
+	void set(const String &name, const Signature &signature, const SaveFileMetaInfo &info, bool hasThumbnail);
+
+	/**
+	 * Drop the entry of a savefile.
+	 *
+	 * @return false if there was none.
+	 */
+	bool remove(const String &name);
+
+private:
+	struct Entry {
+		SaveFileMetaInfo info;
+		Signature signature;
+		bool hasThumbnail;
+	};
+
+	typedef HashMap<String, Entry, IgnoreCase_Hash, IgnoreCase_EqualTo> EntryMap;
+	EntryMap _entries;
+	bool _dirty;
+};
+
+} // End of namespace Common
+
+#endif
@@ -30,6 +30,10 @@
 #include "common/error.h"
 #include "common/ptr.h"
 
+namespace Graphics {
+struct Surface;
+}
+
 namespace Common {
 
 
@@ -61,6 +65,23 @@ public:
 	virtual int32 pos() const;
 };
 
+/**
+ * Metadata of a savefile as shown by the save/load dialogs. It mirrors the
+ * parts of SaveStateDescriptor which can be cached without involving the
+ * engine.
+ */
+struct SaveFileMetaInfo {
+	SaveFileMetaInfo() : slot(0), deletable(true), writeProtected(false) {}
+
+	int slot;
+	String description;
+	String saveDate;
+	String saveTime;
+	String playTime;
+	bool deletable;
+	bool writeProtected;
+};
+
 /**
  * The SaveFileManager is serving as a factory for InSaveFile
  * and OutSaveFile objects.
@@ -204,6 +225,44 @@ public:
 	 * for saving or loading because they are being synced by CloudManager.
 	 */
 	virtual void updateSavefilesList(StringArray &lockedFiles) = 0;
+
+	/**
+	 * @name Savefile metadata cache
+	 *
+	 * Engines can only provide the description, date and thumbnail of a
+	 * save by opening and parsing it. Savefile managers may remember that
+	 * metadata per target so save/load dialogs can skip the engine for
+	 * unchanged files. Entries are keyed by savefile name and dropped as
+	 * soon as the savefile changes. The default implementation caches
+	 * nothing.
+	 */
+	//@{
+
+	/**
+	 * Look up the cached metadata of a savefile.
+	 *
+	 * @return false if nothing is cached or the file changed since.
+	 */
+	virtual bool getCachedMetaInfo(const String &target, const String &name, SaveFileMetaInfo &info) { return false; }
+
+	/**
+	 * Remember the metadata of an existing savefile. The thumbnail, if any,
+	 * is copied.
+	 */
+	virtual void setCachedMetaInfo(const String &target, const String &name, const SaveFileMetaInfo &info, const Graphics::Surface *thumbnail) {}
+
+	/**
+	 * Load the cached thumbnail of a savefile. The caller takes ownership
+	 * of the returned surface.
+	 *
+	 * @return The thumbnail, or 0 if there is none.
+	 */
+	virtual Graphics::Surface *loadCachedThumbnail(const String &target, const String &name) { return 0; }
+
+	/** Write pending metadata changes to permanent storage. */
+	virtual void flushMetaInfoCache() {}
+
+	//@}
 };
 
 } // End of namespace Common
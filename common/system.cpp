@@ -149,6 +149,16 @@ Common::String OSystem::getDefaultConfigFileName() {
 	return "scummvm.ini";
 }
 
+Common::String OSystem::getCachePath() {
+	const Common::String configFile = getDefaultConfigFileName();
+	for (int i = (int)configFile.size() - 1; i >= 0; --i) {
+		if (configFile[i] == '/' || configFile[i] == '\\')
+			return Common::String(configFile.c_str(), i);
+	}
+
+	return Common::String();
+}
+
 Common::String OSystem::getSystemLanguage() const {
 	return "en_US";
 }
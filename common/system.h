@@ -994,6 +994,14 @@ public:
 	*/
 	virtual uint32 getMillis(bool skipRecord = false) = 0;
 
+	/**
+	 * Get a high resolution timestamp in microseconds. This is meant for
+	 * performance measurements only: the origin is unspecified and the
+	 * value is never recorded by the event recorder. Backends without a
+	 * better timer fall back to millisecond resolution.
+	 */
+	virtual uint64 getMicros() { return (uint64)getMillis(true) * 1000; }
+
 	/** Delay/sleep for the specified amount of milliseconds. */
 	virtual void delayMillis(uint msecs) = 0;
 
@@ -1272,6 +1280,20 @@ public:
 	 */
 	virtual Common::String getDefaultConfigFileName();
 
+	/**
+	 * Get the directory for files which only speed things up and can be
+	 * recreated at any time, like indices of savefiles or game directories.
+	 * Savefiles are never stored there, so these files are not synced or
+	 * listed along with them.
+	 *
+	 * The default implementation returns the directory of the default
+	 * config file.
+	 *
+	 * @return the path of the directory, or an empty string if there is
+	 *         none, in which case nothing should be cached on disk.
+	 */
+	virtual Common::String getCachePath();
+
 	/**
 	 * Logs a given message.
 	 *
@@ -31,6 +31,7 @@
 #include "bladerunner/chapters.h"
 #include "bladerunner/combat.h"
 #include "bladerunner/crimes_database.h"
+#include "bladerunner/debugger.h"
 #include "bladerunner/dialogue_menu.h"
 #include "bladerunner/elevator.h"
 #include "bladerunner/font.h"
@@ -66,6 +67,7 @@
 #include "common/array.h"
 #include "common/error.h"
 #include "common/events.h"
+#include "common/profiler.h"
 #include "common/system.h"
 
 #include "engines/util.h"
@@ -92,6 +94,7 @@ BladeRunnerEngine::BladeRunnerEngine(OSystem *syst)
 	_adq = new ADQ(this);
 	_obstacles = new Obstacles(this);
 	_itemPickup = new ItemPickup(this);
+	_debugger = new Debugger(this);
 
 	_playerActorIdle = false;
 	_playerDead = false;
@@ -123,6 +126,7 @@ BladeRunnerEngine::~BladeRunnerEngine() {
 
 	delete _zbuffer;
 
+	delete _debugger;
 	delete _itemPickup;
 	delete _obstacles;
 	delete _adq;
@@ -137,6 +141,10 @@ bool BladeRunnerEngine::hasFeature(EngineFeature f) const {
 	return f == kSupportsRTL;
 }
 
+GUI::Debugger *BladeRunnerEngine::getDebugger() {
+	return _debugger;
+}
+
 Common::Error BladeRunnerEngine::run() {
 	Graphics::PixelFormat format = createRGB555();
 	initGraphics(640, 480, &format);
@@ -608,7 +616,10 @@ void drawBBox(Vector3 start, Vector3 end, View *view, Graphics::Surface *surface
 #endif
 
 void BladeRunnerEngine::gameTick() {
+	PROFILE_ZONE("BladeRunner::gameTick");
+
 	handleEvents();
+	_debugger->onFrame();
 
 	if (_gameIsRunning && _windowIsActive) {
 		// TODO: Only run if not in Kia, script, nor AI
@@ -915,6 +926,9 @@ void BladeRunnerEngine::handleKeyUp(Common::Event &event) {
 }
 
 void BladeRunnerEngine::handleKeyDown(Common::Event &event) {
+	if ((event.kbd.flags & Common::KBD_CTRL) && event.kbd.keycode == Common::KEYCODE_d) {
+		_debugger->attach();
+	}
 }
 
 void BladeRunnerEngine::handleMouseAction(int x, int y, bool buttonLeft, bool buttonDown) {
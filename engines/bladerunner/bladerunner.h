@@ -66,6 +66,7 @@ class AudioSpeech;
 class Chapters;
 class CrimesDatabase;
 class Combat;
+class Debugger;
 class DialogueMenu;
 class Elevator;
 class Font;
@@ -112,6 +113,7 @@ public:
 	Chapters         *_chapters;
 	CrimesDatabase   *_crimesDatabase;
 	Combat           *_combat;
+	Debugger         *_debugger;
 	DialogueMenu     *_dialogueMenu;
 	Elevator         *_elevator;
 	GameFlags        *_gameFlags;
@@ -180,6 +182,7 @@ public:
 	~BladeRunnerEngine();
 
 	bool hasFeature(EngineFeature f) const;
+	GUI::Debugger *getDebugger();
 
 	Common::Error run();
 
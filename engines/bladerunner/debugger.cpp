@@ -0,0 +1,124 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#include "bladerunner/debugger.h"
+
+#include "bladerunner/bladerunner.h"
+#include "bladerunner/slice_renderer.h"
+#include "bladerunner/vqa_decoder.h"
+
+#include "common/system.h"
+
+#include "graphics/surface.h"
+
+namespace BladeRunner {
+
+Debugger::Debugger(BladeRunnerEngine *vm) : GUI::Debugger() {
+	_vm = vm;
+	_frameCount = 0;
+
+	registerCmd("slicetiming", WRAP_METHOD(Debugger, cmdSliceTiming));
+	registerCmd("vqa", WRAP_METHOD(Debugger, cmdVqa));
+}
+
+Debugger::~Debugger() {
+}
+
+void Debugger::onFrame() {
+	++_frameCount;
+	GUI::Debugger::onFrame();
+}
+
+bool Debugger::cmdSliceTiming(int argc, const char **argv) {
+	if (argc != 1) {
+		debugPrintf("Shows how much time per frame the actors took to draw since the last call.\n");
+		debugPrintf("Usage: %s\n", argv[0]);
+		return true;
+	}
+
+	const SliceRenderer::Timing &timing = _vm->_sliceRenderer->getTiming();
+	float frameCount = MAX<uint32>(_frameCount, 1);
+
+	debugPrintf("%u frames, %.2f actors per frame\n", _frameCount, timing.drawCount / frameCount);
+	debugPrintf("Setup:   %.3f ms per frame\n", timing.setupTime / 1000.0f / frameCount);
+	debugPrintf("Slices:  %.3f ms per frame\n", timing.slicesTime / 1000.0f / frameCount);
+	debugPrintf("Shadows: %.3f ms per frame\n", timing.shadowsTime / 1000.0f / frameCount);
+
+	_vm->_sliceRenderer->resetTiming();
+	_frameCount = 0;
+
+	return true;
+}
+
+bool Debugger::cmdVqa(int argc, const char **argv) {
+	if (argc != 2 && argc != 3) {
+		debugPrintf("Decodes all video frames of a VQA file and reports the decoding speed.\n");
+		debugPrintf("Usage: %s <name> [<passes>]\n", argv[0]);
+		return true;
+	}
+
+	Common::String name = argv[1];
+	name.toUppercase();
+	if (!name.hasSuffix(".VQA")) {
+		name += ".VQA";
+	}
+
+	int passes = argc == 3 ? atoi(argv[2]) : 2;
+
+	Common::SeekableReadStream *s = _vm->getResourceStream(name);
+	if (!s) {
+		debugPrintf("Unable to open %s\n", name.c_str());
+		return true;
+	}
+
+	Graphics::Surface surface;
+	surface.create(640, 480, createRGB555());
+
+	VQADecoder *decoder = new VQADecoder(&surface);
+	if (decoder->loadStream(s)) {
+		int frameCount = decoder->numFrames();
+
+		// The first pass includes decompressing the codebooks, later
+		// passes measure the looping case with all codebooks cached
+		for (int pass = 0; pass < passes; ++pass) {
+			uint32 startTime = _vm->_system->getMillis();
+
+			for (int frame = 0; frame < frameCount; ++frame) {
+				decoder->readFrame(frame, kVQAReadVideo);
+				decoder->decodeVideoFrame(frame);
+			}
+
+			uint32 elapsedTime = MAX<uint32>(_vm->_system->getMillis() - startTime, 1);
+			debugPrintf("Pass %d: %d frames in %u ms, %.1f fps\n",
+				pass + 1, frameCount, elapsedTime, 1000.0f * frameCount / elapsedTime);
+		}
+	} else {
+		debugPrintf("Unable to load %s\n", name.c_str());
+	}
+
+	delete decoder;
+	surface.free();
+	delete s;
+
+	return true;
+}
+
+} // End of namespace BladeRunner
@@ -20,6 +20,7 @@ MODULE_OBJS = \
 	crimes_database.o \
 	decompress_lcw.o \
 	decompress_lzo.o \
+	debugger.o \
 	detection.o \
 	dialogue_menu.o \
 	elevator.o \
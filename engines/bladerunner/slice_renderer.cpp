@@ -30,8 +30,17 @@
 
 #include "common/memstream.h"
 #include "common/rect.h"
+#include "common/system.h"
 #include "common/util.h"
 
+#if defined(__SSE2__)
+#define SLICE_RENDERER_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SLICE_RENDERER_NEON
+#include <arm_neon.h>
+#endif
+
 namespace BladeRunner {
 
 SliceRenderer::SliceRenderer(BladeRunnerEngine *vm) {
@@ -42,6 +51,8 @@ SliceRenderer::SliceRenderer(BladeRunnerEngine *vm) {
 	for (i = 0; i < 942; i++) { // yes, its going just to 942 and not 997
 		_animationsShadowEnabled[i] = true;
 	}
+
+	resetTiming();
 }
 
 SliceRenderer::~SliceRenderer() {
@@ -343,6 +354,8 @@ void SliceRenderer::drawInWorld(int animationId, int animationFrame, Vector3 pos
 	assert(_setEffects);
 	//assert(_view);
 
+	uint64 setupStartTime = _vm->_system->getMicros();
+
 	_vm->_sliceRenderer->setupFrameInWorld(animationId, animationFrame, position, facing);
 	assert(_sliceFramePtr);
 
@@ -391,11 +404,16 @@ void SliceRenderer::drawInWorld(int animationId, int animationFrame, Vector3 pos
 	setupLookupTable(_m22lookup, sliceLineIterator._sliceMatrix[1][1]);
 	_m23 = sliceLineIterator._sliceMatrix[1][2];
 
+	uint64 shadowsStartTime = _vm->_system->getMicros();
+	_timing.setupTime += shadowsStartTime - setupStartTime;
 
 	if(_animationsShadowEnabled[_animation]) {
 		//TODO: draw shadows
 	}
 
+	uint64 slicesStartTime = _vm->_system->getMicros();
+	_timing.shadowsTime += slicesStartTime - shadowsStartTime;
+
 	int frameY = sliceLineIterator._startY;
 
 	uint16 *frameLinePtr  = (uint16*)surface.getPixels() + 640 * frameY;
@@ -431,6 +449,9 @@ void SliceRenderer::drawInWorld(int animationId, int animationFrame, Vector3 pos
 		frameLinePtr += 640;
 		zBufferLinePtr += 640;
 	}
+
+	_timing.slicesTime += _vm->_system->getMicros() - slicesStartTime;
+	++_timing.drawCount;
 }
 
 void SliceRenderer::drawOnScreen(int animationId, int animationFrame, int screenX, int screenY, float facing, float scale, Graphics::Surface &surface, uint16 *zbuffer) {
@@ -495,6 +516,48 @@ void SliceRenderer::drawOnScreen(int animationId, int animationFrame, int screen
 	}
 }
 
+/**
+ * Writes color and depth for all pixels in [xBegin, xEnd) that are nearer than
+ * the z-buffer. The depth test is done eight pixels at a time when possible.
+ */
+static void drawSliceSpan(uint16 *frameLinePtr, uint16 *zbufLinePtr, int xBegin, int xEnd, uint16 color, uint16 z) {
+	int x = xBegin;
+
+#if defined(SLICE_RENDERER_SSE2)
+	// SSE2 only has signed 16-bit comparisons, so both sides are biased by 0x8000
+	const __m128i bias   = _mm_set1_epi16((short)0x8000);
+	const __m128i zValue = _mm_set1_epi16((short)z);
+	const __m128i zTest  = _mm_xor_si128(zValue, bias);
+	const __m128i cValue = _mm_set1_epi16((short)color);
+	for (; x + 8 <= xEnd; x += 8) {
+		__m128i zbuf  = _mm_loadu_si128((const __m128i *)(zbufLinePtr + x));
+		__m128i frame = _mm_loadu_si128((const __m128i *)(frameLinePtr + x));
+		__m128i mask  = _mm_cmpgt_epi16(_mm_xor_si128(zbuf, bias), zTest);
+		zbuf  = _mm_or_si128(_mm_and_si128(mask, zValue), _mm_andnot_si128(mask, zbuf));
+		frame = _mm_or_si128(_mm_and_si128(mask, cValue), _mm_andnot_si128(mask, frame));
+		_mm_storeu_si128((__m128i *)(zbufLinePtr + x), zbuf);
+		_mm_storeu_si128((__m128i *)(frameLinePtr + x), frame);
+	}
+#elif defined(SLICE_RENDERER_NEON)
+	const uint16x8_t zValue = vdupq_n_u16(z);
+	const uint16x8_t cValue = vdupq_n_u16(color);
+	for (; x + 8 <= xEnd; x += 8) {
+		uint16x8_t zbuf  = vld1q_u16(zbufLinePtr + x);
+		uint16x8_t frame = vld1q_u16(frameLinePtr + x);
+		uint16x8_t mask  = vcltq_u16(zValue, zbuf);
+		vst1q_u16(zbufLinePtr + x, vbslq_u16(mask, zValue, zbuf));
+		vst1q_u16(frameLinePtr + x, vbslq_u16(mask, cValue, frame));
+	}
+#endif
+
+	for (; x < xEnd; ++x) {
+		if (z < zbufLinePtr[x]) {
+			frameLinePtr[x] = color;
+			zbufLinePtr[x] = z;
+		}
+	}
+}
+
 void SliceRenderer::drawSlice(int slice, bool advanced, uint16 *frameLinePtr, uint16 *zbufLinePtr, int y) {
 	if (slice < 0 || (uint32)slice >= _frameSliceCount)
 		return;
@@ -541,12 +604,7 @@ void SliceRenderer::drawSlice(int slice, bool advanced, uint16 *frameLinePtr, ui
 						int bladeToScummVmConstant = 256 / 32;
 						color555 = _pixelFormat.RGBToColor(CLIP(color.r * bladeToScummVmConstant, 0, 255), CLIP(color.g * bladeToScummVmConstant, 0, 255), CLIP(color.b * bladeToScummVmConstant, 0, 255));
 					}
-					for (int x = previousVertexX; x != vertexX; ++x) {
-						if (vertexZ < zbufLinePtr[x]) {
-							frameLinePtr[x] = color555;
-							zbufLinePtr[x] = (uint16)vertexZ;
-						}
-					}
+					drawSliceSpan(frameLinePtr, zbufLinePtr, previousVertexX, vertexX, color555, vertexZ);
 				}
 			}
 			p += 3;
@@ -555,6 +613,13 @@ void SliceRenderer::drawSlice(int slice, bool advanced, uint16 *frameLinePtr, ui
 	}
 }
 
+void SliceRenderer::resetTiming() {
+	_timing.drawCount   = 0;
+	_timing.setupTime   = 0;
+	_timing.slicesTime  = 0;
+	_timing.shadowsTime = 0;
+}
+
 void SliceRenderer::preload(int animationId) {
 	int i;
 	int frameCount = _vm->_sliceAnimations->getFrameCount(animationId);
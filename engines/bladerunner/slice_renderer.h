@@ -44,6 +44,16 @@ class Lights;
 class SetEffects;
 
 class SliceRenderer {
+public:
+	/** Time spent in drawInWorld, in microseconds, accumulated since the last reset */
+	struct Timing {
+		uint32 drawCount;
+		uint64 setupTime;
+		uint64 slicesTime;
+		uint64 shadowsTime;
+	};
+
+private:
 	BladeRunnerEngine *_vm;
 
 	int       _animation;
@@ -88,6 +98,8 @@ class SliceRenderer {
 
 	Graphics::PixelFormat _pixelFormat;
 
+	Timing _timing;
+
 	Matrix3x2 calculateFacingRotationMatrix();
 	void drawSlice(int slice, bool advanced, uint16 *frameLinePtr, uint16 *zbufLinePtr, int y);
 
@@ -110,6 +122,9 @@ public:
 
 	void disableShadows(int *animationsIdsList, int listSize);
 
+	const Timing &getTiming() const { return _timing; }
+	void resetTiming();
+
 private:
 
 	void calculateBoundingRect();
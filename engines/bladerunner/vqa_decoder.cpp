@@ -630,7 +630,7 @@ Common::Rational VQADecoder::VQAVideoTrack::getFrameRate() const {
 
 void VQADecoder::VQAVideoTrack::decodeVideoFrame(bool forceDraw) {
 	if (_hasNewFrame || forceDraw) {
-		decodeFrame((uint16*)_surface->getPixels());
+		decodeFrame(_surface);
 		_hasNewFrame = false;
 	}
 }
@@ -671,8 +671,10 @@ bool VQADecoder::VQAVideoTrack::readCBFZ(Common::SeekableReadStream *s, uint32 s
 		return true;
 	}
 
-	uint32 codebookSize = 2 * _maxBlocks * _blockW * _blockH;
-	codebookInfo.data = new uint8[codebookSize];
+	// Codebooks are decompressed only once and kept for the lifetime of
+	// the decoder, so looping backgrounds never decompress them again
+	uint32 codebookEntries = _maxBlocks * _blockW * _blockH;
+	codebookInfo.data = new uint16[codebookEntries];
 
 	if (!_cbfz) {
 		_cbfz = new uint8[roundup(_maxCBFZSize)];
@@ -680,7 +682,13 @@ bool VQADecoder::VQAVideoTrack::readCBFZ(Common::SeekableReadStream *s, uint32 s
 
 	s->read(_cbfz, roundup(size));
 
-	decompress_lcw(_cbfz, size, codebookInfo.data, codebookSize);
+	decompress_lcw(_cbfz, size, (uint8 *)codebookInfo.data, 2 * codebookEntries);
+
+#ifdef SCUMM_BIG_ENDIAN
+	for (uint32 i = 0; i != codebookEntries; ++i) {
+		codebookInfo.data[i] = FROM_LE_16(codebookInfo.data[i]);
+	}
+#endif
 
 	return true;
 }
@@ -800,45 +808,50 @@ bool VQADecoder::VQAVideoTrack::readVPTR(Common::SeekableReadStream *s, uint32 s
 	return true;
 }
 
-void VQADecoder::VQAVideoTrack::VPTRWriteBlock(uint16 *frame, unsigned int dstBlock, unsigned int srcBlock, int count, bool alpha) {
-	uint16 frame_width  = _width;
-	uint32 frame_stride = 640;
-	uint16 block_width  = _blockW;
-	uint16 block_height = _blockH;
+void VQADecoder::VQAVideoTrack::VPTRWriteBlock(Graphics::Surface *surface, unsigned int dstBlock, unsigned int srcBlock, int count, bool alpha) {
+	const uint16 blockW = _blockW;
+	const uint16 blockH = _blockH;
+	const uint32 dstPitch = surface->pitch / 2;
+	const int blocksPerLine = _width / blockW;
 
-	const uint8 *const block_src =
-		&_codebook[2 * srcBlock * block_width * block_height];
-
-	int blocks_per_line = frame_width / block_width;
+	const uint16 *const blockSrc = &_codebook[srcBlock * blockW * blockH];
 
 	do {
-		uint32 frame_x = dstBlock % blocks_per_line * block_width  + _offsetX;
-		uint32 frame_y = dstBlock / blocks_per_line * block_height + _offsetY;
-
-		uint32 dst_offset = frame_x + frame_y * frame_stride;
-
-		const uint8 *__restrict src = block_src;
-		uint16      *__restrict dst = frame + dst_offset;
-
-		unsigned int block_y;
-		for (block_y = 0; block_y != block_height; ++block_y) {
-			unsigned int block_x;
-			for (block_x = 0; block_x != block_width; ++block_x) {
-				uint16 rgb555 = src[0] | (src[1] << 8);
-				src += 2;
-
-				if (!(alpha && (rgb555 & 0x8000)))
-					*dst = rgb555;
-				++dst;
+		uint32 x = dstBlock % blocksPerLine * blockW + _offsetX;
+		uint32 y = dstBlock / blocksPerLine * blockH + _offsetY;
+
+		const uint16 *__restrict src = blockSrc;
+		uint16       *__restrict dst = (uint16 *)surface->getBasePtr(x, y);
+
+		if (alpha) {
+			for (uint blockY = 0; blockY != blockH; ++blockY) {
+				for (uint blockX = 0; blockX != blockW; ++blockX) {
+					if (!(src[blockX] & 0x8000))
+						dst[blockX] = src[blockX];
+				}
+				src += blockW;
+				dst += dstPitch;
+			}
+		} else if (blockW == 4) {
+			// Each block row is exactly 64 bits, copy it with a single move
+			for (uint blockY = 0; blockY != blockH; ++blockY) {
+				WRITE_UINT64(dst, READ_UINT64(src));
+				src += 4;
+				dst += dstPitch;
+			}
+		} else {
+			for (uint blockY = 0; blockY != blockH; ++blockY) {
+				memcpy(dst, src, blockW * sizeof(uint16));
+				src += blockW;
+				dst += dstPitch;
 			}
-			dst += frame_stride - block_width;
 		}
 
 		++dstBlock;
 	} while (--count);
 }
 
-bool VQADecoder::VQAVideoTrack::decodeFrame(uint16 *frame) {
+bool VQADecoder::VQAVideoTrack::decodeFrame(Graphics::Surface *surface) {
 	CodebookInfo &codebookInfo = _vqaDecoder->codebookInfoForFrame(_vqaDecoder->_decodingFrame);
 
 	if (!codebookInfo.data) {
@@ -869,19 +882,19 @@ bool VQADecoder::VQAVideoTrack::decodeFrame(uint16 *frame) {
 			count = 2 * (((command >> 8) & 0x1f) + 1);
 			srcBlock = command & 0x00ff;
 
-			VPTRWriteBlock(frame, dstBlock, srcBlock, count);
+			VPTRWriteBlock(surface, dstBlock, srcBlock, count);
 			dstBlock += count;
 			break;
 		case 2:
 			count = 2 * (((command >> 8) & 0x1f) + 1);
 			srcBlock = command & 0x00ff;
 
-			VPTRWriteBlock(frame, dstBlock, srcBlock, 1);
+			VPTRWriteBlock(surface, dstBlock, srcBlock, 1);
 			++dstBlock;
 
 			for (int i = 0; i < count; ++i) {
 				srcBlock = *src++;
-				VPTRWriteBlock(frame, dstBlock, srcBlock, 1);
+				VPTRWriteBlock(surface, dstBlock, srcBlock, 1);
 				++dstBlock;
 			}
 			break;
@@ -890,7 +903,7 @@ bool VQADecoder::VQAVideoTrack::decodeFrame(uint16 *frame) {
 			count = 1;
 			srcBlock = command & 0x1fff;
 
-			VPTRWriteBlock(frame, dstBlock, srcBlock, count, prefix == 4);
+			VPTRWriteBlock(surface, dstBlock, srcBlock, count, prefix == 4);
 			++dstBlock;
 			break;
 		case 5:
@@ -898,7 +911,7 @@ bool VQADecoder::VQAVideoTrack::decodeFrame(uint16 *frame) {
 			count = *src++;
 			srcBlock = command & 0x1fff;
 
-			VPTRWriteBlock(frame, dstBlock, srcBlock, count, prefix == 6);
+			VPTRWriteBlock(surface, dstBlock, srcBlock, count, prefix == 6);
 			dstBlock += count;
 			break;
 		default:
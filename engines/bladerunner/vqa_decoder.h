@@ -132,7 +132,7 @@ private:
 	struct CodebookInfo {
 		uint16  frame;
 		uint32  size;
-		uint8  *data;
+		uint16 *data; // decompressed and in native endianness
 	};
 
 	class VQAVideoTrack;
@@ -216,7 +216,7 @@ private:
 		uint32  _maxCBFZSize;
 		uint32  _maxZBUFChunkSize;
 
-		uint8   *_codebook;
+		const uint16 *_codebook;
 		uint8   *_cbfz;
 		bool     _zbufChunkComplete;
 		uint32   _zbufChunkSize;
@@ -234,8 +234,8 @@ private:
 		uint8   *_screenEffectsData;
 		uint32   _screenEffectsDataSize;
 
-		void VPTRWriteBlock(uint16 *frame, unsigned int dstBlock, unsigned int srcBlock, int count, bool alpha = false);
-		bool decodeFrame(uint16 *frame);
+		void VPTRWriteBlock(Graphics::Surface *surface, unsigned int dstBlock, unsigned int srcBlock, int count, bool alpha = false);
+		bool decodeFrame(Graphics::Surface *surface);
 	};
 
 	class VQAAudioTrack {
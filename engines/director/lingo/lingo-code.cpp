@@ -64,10 +64,10 @@ static struct FuncDescr {
 	{ Lingo::c_fconstpush,	"c_fconstpush",	"f" },
 	{ Lingo::c_stringpush,	"c_stringpush",	"s" },
 	{ Lingo::c_symbolpush,	"c_symbolpush",	"s" },	// D3
-	{ Lingo::c_varpush,		"c_varpush",	"s" },
+	{ Lingo::c_varpush,		"c_varpush",	"is" },
 	{ Lingo::c_setImmediate,"c_setImmediate","i" },
 	{ Lingo::c_assign,		"c_assign",		"" },
-	{ Lingo::c_eval,		"c_eval",		"s" },
+	{ Lingo::c_eval,		"c_eval",		"is" },
 	{ Lingo::c_theentitypush,"c_theentitypush","ii" }, // entity, field
 	{ Lingo::c_theentityassign,"c_theentityassign","ii" },
 	{ Lingo::c_swap,		"c_swap",		"" },
@@ -255,19 +255,30 @@ void Lingo::c_arraypush() {
 }
 
 void Lingo::c_varpush() {
-	Common::String name((char *)&(*g_lingo->_currentScript)[g_lingo->_pc]);
+	inst i = (*g_lingo->_currentScript)[g_lingo->_pc++];
+	int slot = READ_UINT32(&i);
+	const char *varName = (char *)&(*g_lingo->_currentScript)[g_lingo->_pc];
 	Datum d;
 
-	g_lingo->_pc += g_lingo->calcStringAlignment(name.c_str());
+	g_lingo->_pc += g_lingo->calcStringAlignment(varName);
 
 	// In immediate mode we will push variables as strings
 	// This is used for playAccel
 	if (g_lingo->_immediateMode) {
-		g_lingo->push(Datum(new Common::String(name)));
+		g_lingo->push(Datum(new Common::String(varName)));
+
+		return;
+	}
 
+	d.u.sym = g_lingo->lookupVarSlot(slot);
+	if (d.u.sym) {
+		d.type = VAR;
+		g_lingo->push(d);
 		return;
 	}
 
+	Common::String name(varName);
+
 	if (g_lingo->getHandler(name) != NULL) {
 		d.type = HANDLER;
 		d.u.s = new Common::String(name);
@@ -285,6 +296,7 @@ void Lingo::c_varpush() {
 		d.u.i = val;
 	} else {
 		d.type = VAR;
+		g_lingo->cacheVarSlot(slot, varName, d.u.sym);
 	}
 
 	g_lingo->push(d);
@@ -339,8 +351,7 @@ void Lingo::c_assign() {
 	} else if (d2.type == FLOAT) {
 		d1.u.sym->u.f = d2.u.f;
 	} else if (d2.type == STRING) {
-		d1.u.sym->u.s = new Common::String(*d2.u.s);
-		delete d2.u.s;
+		d1.u.sym->u.s = d2.u.s;
 	} else if (d2.type == POINT) {
 		d1.u.sym->u.arr = new FloatArray(*d2.u.arr);
 		delete d2.u.arr;
@@ -1110,9 +1121,11 @@ void Lingo::call(Common::String name, int nargs) {
 	fp->retpc = g_lingo->_pc;
 	fp->retscript = g_lingo->_currentScript;
 	fp->localvars = g_lingo->_localvars;
+	fp->localslots = g_lingo->_localslots;
 
 	// Create new set of local variables
 	g_lingo->_localvars = new SymbolHash;
+	g_lingo->_localslots = new VarSlots;
 
 	g_lingo->_callstack.push_back(fp);
 
@@ -1141,6 +1154,7 @@ void Lingo::c_procret() {
 
 	// Restore local variables
 	g_lingo->_localvars = fp->localvars;
+	g_lingo->_localslots = fp->localslots;
 
 	delete fp;
 
@@ -54,12 +54,14 @@ namespace Director {
 
 void Lingo::execute(uint pc) {
 	for(_pc = pc; (*_currentScript)[_pc] != STOP && !_returning;) {
-		Common::String instr = decodeInstruction(_pc);
-
 		if (debugChannelSet(5, kDebugLingoExec))
 			printStack("Stack before: ");
 
-		debugC(1, kDebugLingoExec, "[%3d]: %s", _pc, instr.c_str());
+		// Decoding is expensive, so only do it when it is going to be shown
+		if (debugChannelSet(1, kDebugLingoExec)) {
+			Common::String instr = decodeInstruction(_pc);
+			debugC(1, kDebugLingoExec, "[%3d]: %s", _pc, instr.c_str());
+		}
 
 		_pc++;
 		(*((*_currentScript)[_pc - 1]))();
@@ -192,6 +194,37 @@ Symbol *Lingo::lookupVar(const char *name, bool create, bool putInGlobalList) {
 	return sym;
 }
 
+Symbol *Lingo::lookupVarSlot(int slot) {
+	if (!_localslots || slot >= (int)_localslots->symbols.size() || _localslots->handlerGeneration != _handlerGeneration)
+		return NULL;
+
+	Symbol *sym = _localslots->symbols[slot];
+
+	// The variable could have been declared global since
+	if (sym && sym->global)
+		return NULL;
+
+	return sym;
+}
+
+void Lingo::cacheVarSlot(int slot, const char *name, Symbol *sym) {
+	// Only local variables are kept, as they live exactly as long as the call.
+	// Event names are skipped, as their handlers depend on the current entity
+	if (!_localslots || sym->global || _eventHandlerTypeIds.contains(name) ||
+			!_localvars->contains(name) || (*_localvars)[name] != sym)
+		return;
+
+	if (_localslots->handlerGeneration != _handlerGeneration) {
+		_localslots->symbols.clear();
+		_localslots->handlerGeneration = _handlerGeneration;
+	}
+
+	if (slot >= (int)_localslots->symbols.size())
+		_localslots->symbols.resize(slot + 1);
+
+	_localslots->symbols[slot] = sym;
+}
+
 void Lingo::cleanLocalVars() {
 	// Clean up current scope local variables and clean up memory
 	debugC(3, kDebugLingoExec, "cleanLocalVars: have %d vars", _localvars->size());
@@ -203,8 +236,10 @@ void Lingo::cleanLocalVars() {
 	}
 
 	delete g_lingo->_localvars;
+	delete g_lingo->_localslots;
 
 	g_lingo->_localvars = 0;
+	g_lingo->_localslots = 0;
 }
 
 void Lingo::define(Common::String &name, int start, int nargs, Common::String *prefix, int end) {
@@ -213,6 +248,8 @@ void Lingo::define(Common::String &name, int start, int nargs, Common::String *p
 
 	debugC(1, kDebugLingoCompile, "define(\"%s\", %d, %d, %d)", name.c_str(), start, _currentScript->size() - 1, nargs);
 
+	_handlerGeneration++;
+
 	Symbol *sym = getHandler(name);
 	if (sym == NULL) { // Create variable if it was not defined
 		sym = new Symbol;
@@ -257,6 +294,21 @@ int Lingo::codeString(const char *str) {
 	return _currentScript->size();
 }
 
+int Lingo::codeVarName(const char *name) {
+	// Give every variable name a slot, so c_varpush only has to look up
+	// each variable once per call
+	if (!_varSlots.contains(name)) {
+		int slot = _varSlots.size();
+		_varSlots[name] = slot;
+	}
+
+	inst i = 0;
+	WRITE_UINT32(&i, _varSlots[name]);
+	code1(i);
+
+	return codeString(name);
+}
+
 int Lingo::codeFloat(double f) {
 	int numInsts = calcCodeAlignment(sizeof(double));
 
@@ -280,9 +332,103 @@ int Lingo::codeConst(int val) {
 	WRITE_UINT32(&i, val);
 	g_lingo->code1(i);
 
+	noteConstantPush(res);
+
 	return res;
 }
 
+int Lingo::codeFloatConst(double f) {
+	int res = code1(c_fconstpush);
+	codeFloat(f);
+
+	noteConstantPush(res);
+
+	return res;
+}
+
+void Lingo::noteConstantPush(int pos) {
+	// Forget the constants which the code has been cut back over
+	while (!_constantPushes.empty() && _constantPushes.back() >= pos)
+		_constantPushes.pop_back();
+
+	_constantPushes.push_back(pos);
+}
+
+bool Lingo::readConstant(int pos, Datum &d, int &end) {
+	if (pos + 1 >= (int)_currentScript->size())
+		return false;
+
+	inst i = (*_currentScript)[pos + 1];
+
+	if ((*_currentScript)[pos] == c_constpush) {
+		d = Datum((int)READ_UINT32(&i));
+		end = pos + 2;
+	} else if ((*_currentScript)[pos] == c_fconstpush) {
+		double f;
+		memcpy(&f, &(*_currentScript)[pos + 1], sizeof(f));
+		d = Datum(f);
+		end = pos + 1 + calcCodeAlignment(sizeof(double));
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
+void Lingo::codeArithmetic(inst op) {
+	int numOperands = (op == c_negate) ? 1 : 2;
+	int start = _currentScript->size();
+	Datum operands[2];
+
+	// Fold the operation if all its operands are constants pushed right before
+	if ((int)_constantPushes.size() >= numOperands) {
+		for (int n = numOperands - 1; n >= 0; n--) {
+			int pos = _constantPushes[_constantPushes.size() - numOperands + n];
+			int end;
+
+			if (!readConstant(pos, operands[n], end) || end != start) {
+				start = -1;
+				break;
+			}
+
+			start = pos;
+		}
+	} else {
+		start = -1;
+	}
+
+	// Leave divisions by zero to report at runtime
+	if (start != -1 && op == c_div &&
+			((operands[1].type == INT && operands[1].u.i == 0) || (operands[1].type == FLOAT && operands[1].u.f == 0.0)))
+		start = -1;
+
+	if (start != -1 && op == c_mod) {
+		Datum divisor = operands[1];
+		if (divisor.toInt() == 0)
+			start = -1;
+	}
+
+	if (start == -1) {
+		code1(op);
+		return;
+	}
+
+	for (int n = 0; n < numOperands; n++)
+		push(operands[n]);
+	(*op)();
+	Datum res = pop();
+
+	debugC(2, kDebugLingoCompile, "codeArithmetic(): folded %s", _functions[(void *)op]->name.c_str());
+
+	_currentScript->resize(start);
+	_constantPushes.resize(_constantPushes.size() - numOperands);
+
+	if (res.type == FLOAT)
+		codeFloatConst(res.u.f);
+	else
+		codeConst(res.u.i);
+}
+
 int Lingo::codeArray(int arraySize) {
 	int res = g_lingo->code1(g_lingo->c_arraypush);
 	inst i = 0;
@@ -306,7 +452,7 @@ void Lingo::codeArgStore() {
 		_argstack.pop_back();
 
 		code1(c_varpush);
-		codeString(arg->c_str());
+		codeVarName(arg->c_str());
 		code1(c_assign);
 
 		delete arg;
@@ -399,6 +545,7 @@ void Lingo::codeFactory(Common::String &name) {
 	sym->parens = true;
 	sym->u.bltin = g_lingo->b_factory;
 
+	_handlerGeneration++;
 	_handlers[ENTITY_INDEX(_eventHandlerTypeIds[name.c_str()], _currentEntityId)] = sym;
 }
 
@@ -134,7 +134,7 @@ programline: /* empty */
 
 asgn: tPUT expr tINTO ID 		{
 		g_lingo->code1(g_lingo->c_varpush);
-		g_lingo->codeString($4->c_str());
+		g_lingo->codeVarName($4->c_str());
 		g_lingo->code1(g_lingo->c_assign);
 		$$ = $2;
 		delete $4; }
@@ -145,7 +145,7 @@ asgn: tPUT expr tINTO ID 		{
 	| tPUT expr tBEFORE expr 		{ $$ = g_lingo->code1(g_lingo->c_before); }		// D3
 	| tSET ID '=' expr			{
 		g_lingo->code1(g_lingo->c_varpush);
-		g_lingo->codeString($2->c_str());
+		g_lingo->codeVarName($2->c_str());
 		g_lingo->code1(g_lingo->c_assign);
 		$$ = $4;
 		delete $2; }
@@ -167,7 +167,7 @@ asgn: tPUT expr tINTO ID 		{
 		$$ = $5; }
 	| tSET ID tTO expr			{
 		g_lingo->code1(g_lingo->c_varpush);
-		g_lingo->codeString($2->c_str());
+		g_lingo->codeVarName($2->c_str());
 		g_lingo->code1(g_lingo->c_assign);
 		$$ = $4;
 		delete $2; }
@@ -415,9 +415,7 @@ tell:	  tTELL				{
 		g_lingo->code1(STOP); }
 
 expr: INT		{ $$ = g_lingo->codeConst($1); }
-	| FLOAT		{
-		$$ = g_lingo->code1(g_lingo->c_fconstpush);
-		g_lingo->codeFloat($1); }
+	| FLOAT		{ $$ = g_lingo->codeFloatConst($1); }
 	| SYMBOL	{											// D3
 		$$ = g_lingo->code1(g_lingo->c_symbolpush);
 		g_lingo->codeString($1->c_str()); }
@@ -437,7 +435,7 @@ expr: INT		{ $$ = g_lingo->codeConst($1); }
 		delete $1; }
 	| ID		{
 		$$ = g_lingo->code1(g_lingo->c_eval);
-		g_lingo->codeString($1->c_str());
+		g_lingo->codeVarName($1->c_str());
 		delete $1; }
 	| THEENTITY	{
 		$$ = g_lingo->codeConst(0); // Put dummy id
@@ -453,11 +451,11 @@ expr: INT		{ $$ = g_lingo->codeConst($1); }
 		WRITE_UINT32(&f, $1[1]);
 		g_lingo->code2(e, f); }
 	| asgn
-	| expr '+' expr				{ g_lingo->code1(g_lingo->c_add); }
-	| expr '-' expr				{ g_lingo->code1(g_lingo->c_sub); }
-	| expr '*' expr				{ g_lingo->code1(g_lingo->c_mul); }
-	| expr '/' expr				{ g_lingo->code1(g_lingo->c_div); }
-	| expr tMOD expr			{ g_lingo->code1(g_lingo->c_mod); }
+	| expr '+' expr				{ g_lingo->codeArithmetic(g_lingo->c_add); }
+	| expr '-' expr				{ g_lingo->codeArithmetic(g_lingo->c_sub); }
+	| expr '*' expr				{ g_lingo->codeArithmetic(g_lingo->c_mul); }
+	| expr '/' expr				{ g_lingo->codeArithmetic(g_lingo->c_div); }
+	| expr tMOD expr			{ g_lingo->codeArithmetic(g_lingo->c_mod); }
 	| expr '>' expr				{ g_lingo->code1(g_lingo->c_gt); }
 	| expr '<' expr				{ g_lingo->code1(g_lingo->c_lt); }
 	| expr tNEQ expr			{ g_lingo->code1(g_lingo->c_neq); }
@@ -471,7 +469,7 @@ expr: INT		{ $$ = g_lingo->codeConst($1); }
 	| expr tCONTAINS expr		{ g_lingo->code1(g_lingo->c_contains); }
 	| expr tSTARTS expr			{ g_lingo->code1(g_lingo->c_starts); }
 	| '+' expr  %prec UNARY		{ $$ = $2; }
-	| '-' expr  %prec UNARY		{ $$ = $2; g_lingo->code1(g_lingo->c_negate); }
+	| '-' expr  %prec UNARY		{ $$ = $2; g_lingo->codeArithmetic(g_lingo->c_negate); }
 	| '(' expr ')'				{ $$ = $2; }
 	| '[' arglist ']'			{ $$ = g_lingo->codeArray($2); }
 	| tSPRITE expr tINTERSECTS expr 	{ g_lingo->code1(g_lingo->c_intersects); }
@@ -23,6 +23,7 @@
 #include "common/archive.h"
 #include "common/file.h"
 #include "common/str-array.h"
+#include "common/system.h"
 
 #include "director/lingo/lingo.h"
 #include "director/lingo/lingo-gr.h"
@@ -68,6 +69,8 @@ Lingo::Lingo(DirectorEngine *vm) : _vm(vm) {
 	_exitRepeat = false;
 
 	_localvars = NULL;
+	_localslots = NULL;
+	_handlerGeneration = 0;
 
 	initEventHandlerTypes();
 
@@ -129,6 +132,7 @@ void Lingo::addCode(const char *code, ScriptType type, uint16 id) {
 	_currentScriptType = type;
 	_scripts[type][id] = _currentScript;
 	_currentEntityId = id;
+	_constantPushes.clear();
 
 	_linenumber = _colnumber = 1;
 	_hadError = false;
@@ -174,6 +178,7 @@ void Lingo::addCode(const char *code, ScriptType type, uint16 id) {
 			}
 
 			_currentScript->clear();
+			_constantPushes.clear();
 
 			begin = end;
 		}
@@ -215,6 +220,7 @@ void Lingo::executeScript(ScriptType type, uint16 id) {
 	_returning = false;
 
 	_localvars = new SymbolHash;
+	_localslots = new VarSlots;
 
 	execute(_pc);
 
@@ -231,6 +237,11 @@ void Lingo::restartLingo() {
 		_scripts[i].clear();
 	}
 
+	// The next movie gets its own variable slots. Handlers which are kept
+	// still work, as the slots they cached are dropped with the generation
+	_varSlots.clear();
+	_handlerGeneration++;
+
 	// TODO
 	//
 	// reset the following:
@@ -390,9 +401,11 @@ void Lingo::runTests() {
 			_hadError = false;
 			addCode(script, kMovieScript, counter);
 
-			if (!_hadError)
+			if (!_hadError) {
+				uint64 start = g_system->getMicros();
 				executeScript(kMovieScript, counter);
-			else
+				debug(">> Executed in %d us", (int)(g_system->getMicros() - start));
+			} else
 				debug(">> Skipping execution");
 
 			free(script);
@@ -148,11 +148,25 @@ typedef Common::HashMap<Common::String, Builtin *, Common::IgnoreCase_Hash, Comm
 typedef Common::HashMap<Common::String, TheEntity *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TheEntityHash;
 typedef Common::HashMap<Common::String, TheEntityField *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TheEntityFieldHash;
 
+typedef Common::HashMap<Common::String, int, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> VarSlotHash;
+
+/**
+ * The local variables of a call which c_varpush has already looked up,
+ * indexed by the slot the compiler gave to their name.
+ */
+struct VarSlots {
+	Common::Array<Symbol *> symbols;
+	uint handlerGeneration;	/* _handlerGeneration when the slots were filled */
+
+	VarSlots() : handlerGeneration(0) {}
+};
+
 struct CFrame {	/* proc/func call stack frame */
 	Symbol	*sp;	/* symbol table entry */
 	int		retpc;	/* where to resume after return */
 	ScriptData	*retscript;	 /* which script to resume after return */
 	SymbolHash *localvars;
+	VarSlots *localslots;
 };
 
 class Lingo {
@@ -197,6 +211,8 @@ public:
 	void pushContext();
 	void popContext();
 	Symbol *lookupVar(const char *name, bool create = true, bool putInGlobalList = false);
+	Symbol *lookupVarSlot(int slot);
+	void cacheVarSlot(int slot, const char *name, Symbol *sym);
 	void cleanLocalVars();
 	void define(Common::String &s, int start, int nargs, Common::String *prefix = NULL, int end = -1);
 	void processIf(int elselabel, int endlabel);
@@ -207,8 +223,11 @@ public:
 	int code2(inst code_1, inst code_2) { int o = code1(code_1); code1(code_2); return o; }
 	int code3(inst code_1, inst code_2, inst code_3) { int o = code1(code_1); code1(code_2); code1(code_3); return o; }
 	int codeString(const char *s);
+	int codeVarName(const char *s);
 	void codeLabel(int label);
 	int codeConst(int val);
+	int codeFloatConst(double f);
+	void codeArithmetic(inst op);
 	int codeArray(int arraySize);
 
 	int calcStringAlignment(const char *s) {
@@ -554,6 +573,20 @@ private:
 
 	SymbolHash _globalvars;
 	SymbolHash *_localvars;
+	VarSlots *_localslots;
+
+	// Slots of the variable names compiled for the current movie, and a
+	// counter which changes whenever a handler is defined, as that can turn
+	// a variable name into a handler call, or when the movie changes
+	VarSlotHash _varSlots;
+	uint _handlerGeneration;
+
+	// Start positions of the constants pushed at the end of the code being
+	// compiled, which codeArithmetic() can fold
+	Common::Array<int> _constantPushes;
+
+	void noteConstantPush(int pos);
+	bool readConstant(int pos, Datum &d, int &end);
 
 	FuncHash _functions;
 
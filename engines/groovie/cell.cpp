@@ -22,6 +22,8 @@
 
 #include "groovie/cell.h"
 
+#include "common/math.h"
+
 namespace Groovie {
 
 CellGame::CellGame() {
@@ -34,6 +36,38 @@ CellGame::CellGame() {
 	_coeff3 = 0;
 
 	_moveCount = 0;
+
+	// Zobrist keys for each cell and color, from a fixed xorshift sequence
+	uint32 seed = 0x2545F491;
+	for (int i = 0; i < 49; ++i) {
+		for (int j = 0; j < kCellColors; ++j) {
+			uint64 key = 0;
+			for (int k = 0; k < 2; ++k) {
+				seed ^= seed << 13;
+				seed ^= seed >> 17;
+				seed ^= seed << 5;
+				key = (key << 32) | seed;
+			}
+			_zobrist[i][j] = key;
+		}
+	}
+
+	initMoveMasks();
+
+	setFastSearch(true);
+}
+
+void CellGame::setFastSearch(bool fastSearch) {
+	_fastSearch = fastSearch;
+	_transpositionTable.clear();
+
+	if (fastSearch) {
+		TranspositionEntry empty;
+		memset(&empty, 0, sizeof(empty));
+		_transpositionTable.resize(kTranspositionTableSize);
+		for (uint i = 0; i < _transpositionTable.size(); ++i)
+			_transpositionTable[i] = empty;
+	}
 }
 
 byte CellGame::getStartX() {
@@ -180,6 +214,18 @@ const int8 strategy2[][17] = {
 	{ 32, 33, 34, 39, 46, -1 }
 };
 
+void CellGame::initMoveMasks() {
+	for (int i = 0; i < 49; ++i) {
+		_neighbourMask[i] = 0;
+		for (const int8 *str = possibleMoves[i]; *str >= 0; ++str)
+			_neighbourMask[i] |= (uint64)1 << *str;
+
+		_jumpMask[i] = 0;
+		for (const int8 *str = strategy2[i]; *str >= 0; ++str)
+			_jumpMask[i] |= (uint64)1 << *str;
+	}
+}
+
 void CellGame::copyToTempBoard() {
 	for (int i = 0; i < 53; ++i) {
 		_tempBoard[i] = _board[i];
@@ -551,6 +597,47 @@ void CellGame::chooseBestMove(int8 color) {
 }
 
 int8 CellGame::calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight) {
+	if (!_fastSearch)
+		return searchBestWeight(color1, color2, depth, bestWeight);
+
+	// Nodes right above the leaves are cheaper to search than to look up
+	if (depth < 2)
+		return searchBestWeight(color1, color2, depth, bestWeight);
+
+	uint64 cells[kCellColors] = { 0, 0, 0, 0 };
+	uint64 hash = 0;
+	for (int i = 0; i < 49; ++i) {
+		int8 cell = _tempBoard[i];
+		if (cell > 0) {
+			assert(cell <= kCellColors);
+			cells[cell - 1] |= (uint64)1 << i;
+			hash ^= _zobrist[i][cell - 1];
+		}
+	}
+
+	int8 colors = (color1 << 4) | color2;
+	int8 coeff3 = _coeff3;
+	uint32 params = (uint32)(bestWeight & 0xFFFF) | (depth << 16) | ((uint32)colors << 24) | ((uint32)coeff3 << 31);
+	uint32 index = (uint32)(hash ^ (hash >> 32) ^ (params * 0x9E3779B9)) & (kTranspositionTableSize - 1);
+
+	TranspositionEntry &entry = _transpositionTable[index];
+	if (entry.depth == depth && !memcmp(entry.cells, cells, sizeof(cells)) &&
+	        entry.bestWeight == bestWeight && entry.colors == colors && entry.coeff3 == coeff3)
+		return entry.weight;
+
+	int8 res = searchBestWeight(color1, color2, depth, bestWeight);
+
+	memcpy(entry.cells, cells, sizeof(cells));
+	entry.bestWeight = bestWeight;
+	entry.depth = depth;
+	entry.colors = colors;
+	entry.coeff3 = coeff3;
+	entry.weight = res;
+
+	return res;
+}
+
+int8 CellGame::searchBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight) {
 	int8 res;
 	int8 curColor;
 	bool canMove;
@@ -596,6 +683,12 @@ int8 CellGame::calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWe
 		return bestWeight + 1;
 	}
 
+	if (depth == 1 && _fastSearch) {
+		res = calcLeafWeight(color1, curColor, bestWeight, type == 1);
+		popBoard();
+		return res;
+	}
+
 	depth -= 1;
 	if (depth) {
 		makeMove(curColor);
@@ -662,6 +755,136 @@ int8 CellGame::calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWe
 	return res;
 }
 
+static inline int countBits(uint64 bits) {
+	int count = 0;
+	for (; bits; bits &= bits - 1)
+		++count;
+	return count;
+}
+
+static inline int lowestBit(uint64 bits) {
+	uint32 low = (uint32)bits;
+	if (low)
+		return Common::intLog2(low & (~low + 1));
+	uint32 high = (uint32)(bits >> 32);
+	return 32 + Common::intLog2(high & (~high + 1));
+}
+
+int8 CellGame::calcLeafWeight(int8 color1, int8 curColor, int bestWeight, bool byTarget) {
+	// Returns the same weight as the move loop of searchBestWeight at the
+	// last level, but gets the weight of each move from bitboards instead
+	// of walking the moves and calling getBoardWeight. When byTarget is set
+	// the moves are ordered like canMoveFunc2 does, otherwise like
+	// canMoveFunc3.
+	uint64 cells[5] = { 0, 0, 0, 0, 0 };
+	for (int i = 0; i < 49; ++i) {
+		if (_board[i] > 0)
+			cells[(int)_board[i]] |= (uint64)1 << i;
+	}
+
+	uint64 occupied = cells[1] | cells[2] | cells[3] | cells[4];
+	int total = _board[49] + _board[50] + _board[51] + _board[52];
+	int8 currBoardWeight = _coeff3 + 2 * (2 * _board[color1 + 48] - total);
+	bool minimize = color1 != curColor;
+
+	// A move to a cell changes the board weight by a fixed amount per
+	// taken cell, plus a fixed amount if it is a clone and not a jump
+	uint64 takenCells = minimize ? cells[(int)color1] : occupied & ~cells[(int)curColor];
+	int takenWeight = minimize ? -4 : 4;
+	int cloneWeight = minimize ? -2 : 2;
+
+	uint64 cloneTargets = 0;
+	uint64 jumpTargets = 0;
+	for (uint64 sources = cells[(int)curColor]; sources; sources &= sources - 1) {
+		int i = lowestBit(sources);
+		cloneTargets |= _neighbourMask[i];
+		jumpTargets |= _jumpMask[i];
+	}
+	cloneTargets &= ~occupied;
+	jumpTargets &= ~occupied;
+
+	// canMoveFunc2 starts with the lowest target, as a clone if possible.
+	// canMoveFunc3 starts with the first clone target of the lowest source
+	// cell, or with its first jump target when no clone is possible.
+	bool firstClone;
+	int firstTarget;
+	if (byTarget) {
+		firstTarget = lowestBit(cloneTargets | jumpTargets);
+		firstClone = (cloneTargets >> firstTarget) & 1;
+	} else {
+		firstClone = cloneTargets != 0;
+		const int8 *str = nullptr;
+		for (uint64 sources = cells[(int)curColor]; sources; sources &= sources - 1) {
+			int i = lowestBit(sources);
+			if ((firstClone ? _neighbourMask[i] : _jumpMask[i]) & ~occupied) {
+				str = firstClone ? possibleMoves[i] : strategy2[i];
+				break;
+			}
+		}
+		assert(str);
+		while (occupied & ((uint64)1 << *str))
+			++str;
+		firstTarget = *str;
+	}
+
+	int8 res = currBoardWeight + takenWeight * countBits(_neighbourMask[firstTarget] & takenCells) + (firstClone ? cloneWeight : 0);
+	if (res < bestWeight && minimize)
+		return res;
+
+	// Without a cutoff the result is the extreme over all moves, which
+	// does not depend on the order in which they are visited
+	for (uint64 targets = cloneTargets; targets; targets &= targets - 1) {
+		int8 weight = currBoardWeight + takenWeight * countBits(_neighbourMask[lowestBit(targets)] & takenCells) + cloneWeight;
+		if ((weight < res && minimize) || (weight > res && !minimize))
+			res = weight;
+	}
+	for (uint64 targets = jumpTargets; targets; targets &= targets - 1) {
+		int8 weight = currBoardWeight + takenWeight * countBits(_neighbourMask[lowestBit(targets)] & takenCells);
+		if (weight == currBoardWeight)
+			continue;
+		if ((weight < res && minimize) || (weight > res && !minimize))
+			res = weight;
+	}
+
+	if (!(res < bestWeight && minimize))
+		return res;
+
+	// Otherwise the search stops at the first move below bestWeight, so
+	// walk the moves in the order they would have been visited
+	if (byTarget) {
+		for (uint64 targets = cloneTargets | jumpTargets; targets; targets &= targets - 1) {
+			int target = lowestBit(targets);
+			int8 weight = currBoardWeight + takenWeight * countBits(_neighbourMask[target] & takenCells);
+			if (((cloneTargets >> target) & 1) && (int8)(weight + cloneWeight) < bestWeight)
+				return weight + cloneWeight;
+			if (((jumpTargets >> target) & 1) && weight != currBoardWeight && weight < bestWeight)
+				return weight;
+		}
+		return res;
+	}
+
+	for (int pass = 1; pass <= 2; ++pass) {
+		uint64 available = ~occupied;
+		for (uint64 sources = cells[(int)curColor]; sources; sources &= sources - 1) {
+			const int8 *str = pass == 1 ? possibleMoves[lowestBit(sources)] : strategy2[lowestBit(sources)];
+			for (; *str >= 0; ++str) {
+				uint64 target = (uint64)1 << *str;
+				if (!(available & target))
+					continue;
+				available &= ~target;
+
+				int8 weight = currBoardWeight + takenWeight * countBits(_neighbourMask[(int)*str] & takenCells) + (pass == 1 ? cloneWeight : 0);
+				if (pass == 2 && weight == currBoardWeight)
+					continue;
+				if (weight < bestWeight)
+					return weight;
+			}
+		}
+	}
+
+	return res;
+}
+
 int16 CellGame::doGame(int8 color, int depth) {
 	bool canMove;
 	int type;
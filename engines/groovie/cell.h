@@ -23,6 +23,7 @@
 #ifndef GROOVIE_CELL_H
 #define GROOVIE_CELL_H
 
+#include "common/array.h"
 #include "common/textconsole.h"
 
 #define BOARDSIZE 7
@@ -45,7 +46,15 @@ public:
 	byte getEndY();
 	int playStauf(byte color, uint16 depth, byte *scriptBoard);
 
+	/**
+	 * Enables the bitboard leaf evaluation and the transposition table.
+	 * Without them the plain search of the original is used. Both searches
+	 * choose the same moves.
+	 */
+	void setFastSearch(bool fastSearch);
+
 private:
+	void initMoveMasks();
 	void copyToTempBoard();
 	void copyFromTempBoard();
 	void copyToShadowBoard();
@@ -66,6 +75,8 @@ private:
 	int getBoardWeight(int8 color1, int8 color2);
 	void chooseBestMove(int8 color);
 	int8 calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight);
+	int8 searchBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight);
+	int8 calcLeafWeight(int8 color1, int8 curColor, int bestWeight, bool byTarget);
 	int16 doGame(int8 color, int depth);
 	int16 calcMove(int8 color, uint16 depth);
 
@@ -90,6 +101,34 @@ private:
 	int _coeff3;
 	bool _flag1, _flag2, _flag4;
 	int _moveCount;
+
+	/**
+	 * The result of calcBestWeight only depends on the cells of the
+	 * temporary board and on its arguments, so it can be reused for
+	 * transpositions. The cells are keyed as one bitboard per color.
+	 */
+	enum {
+		kCellColors = 4
+	};
+
+	struct TranspositionEntry {
+		uint64 cells[kCellColors];
+		int16 bestWeight;
+		uint8 depth; // 0 for unused entries
+		int8 colors;
+		int8 coeff3;
+		int8 weight;
+	};
+
+	enum {
+		kTranspositionTableSize = 1 << 15
+	};
+
+	bool _fastSearch;
+	Common::Array<TranspositionEntry> _transpositionTable;
+	uint64 _zobrist[49][kCellColors];
+	uint64 _neighbourMask[49];
+	uint64 _jumpMask[49];
 };
 
 } // End of Groovie namespace
@@ -20,12 +20,14 @@
  *
  */
 
+#include "groovie/cell.h"
 #include "groovie/debug.h"
 #include "groovie/graphics.h"
 #include "groovie/groovie.h"
 #include "groovie/script.h"
 
 #include "common/debug-channels.h"
+#include "common/random.h"
 #include "common/system.h"
 
 #include "graphics/palette.h"
@@ -46,6 +48,7 @@ Debugger::Debugger(GroovieEngine *vm) :
 	registerCmd("save", WRAP_METHOD(Debugger, cmd_savegame));
 	registerCmd("playref", WRAP_METHOD(Debugger, cmd_playref));
 	registerCmd("dumppal", WRAP_METHOD(Debugger, cmd_dumppal));
+	registerCmd("cellcheck", WRAP_METHOD(Debugger, cmd_cellcheck));
 }
 
 Debugger::~Debugger() {
@@ -145,4 +148,85 @@ bool Debugger::cmd_dumppal(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmd_cellcheck(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Plays cell games between random search depths and checks that the\n");
+		debugPrintf("fast search picks the same moves as the original search.\n");
+		debugPrintf("Usage: %s [<games>]\n", argv[0]);
+		return true;
+	}
+
+	int games = argc == 2 ? getNumber(argv[1]) : 10;
+
+	Common::RandomSource rnd("groovieCellCheck");
+	CellGame reference;
+	CellGame fast;
+	reference.setFastSearch(false);
+
+	uint32 referenceTime = 0;
+	uint32 fastTime = 0;
+	int positions = 0;
+	int mismatches = 0;
+
+	for (int game = 0; game < games; ++game) {
+		// Script encoding of the board: 50 is blue, 66 is green
+		byte board[49];
+		memset(board, 0, sizeof(board));
+		board[0] = board[48] = 50;
+		board[6] = board[42] = 66;
+
+		byte color = 1;
+		int passes = 0;
+		for (int ply = 0; ply < 200 && passes < 2; ++ply) {
+			uint16 depth = rnd.getRandomNumberRng(0, 8);
+
+			uint32 startTime = g_system->getMillis();
+			int referenceResult = reference.playStauf(color, depth, board);
+			uint32 midTime = g_system->getMillis();
+			int fastResult = fast.playStauf(color, depth, board);
+			uint32 endTime = g_system->getMillis();
+
+			referenceTime += midTime - startTime;
+			fastTime += endTime - midTime;
+			++positions;
+
+			if (referenceResult != fastResult ||
+			        (referenceResult && (reference.getStartX() != fast.getStartX() || reference.getStartY() != fast.getStartY() ||
+			                             reference.getEndX() != fast.getEndX() || reference.getEndY() != fast.getEndY()))) {
+				debugPrintf("Game %d, position %d: moves differ at depth %d\n", game, positions, depth);
+				++mismatches;
+			}
+
+			if (!referenceResult) {
+				++passes;
+			} else {
+				passes = 0;
+
+				int startX = reference.getStartX();
+				int startY = reference.getStartY();
+				int endX = reference.getEndX();
+				int endY = reference.getEndY();
+				byte cell = color == 1 ? 50 : 66;
+
+				if (ABS(endX - startX) > 1 || ABS(endY - startY) > 1)
+					board[startY * 7 + startX] = 0;
+				board[endY * 7 + endX] = cell;
+
+				for (int y = MAX(endY - 1, 0); y <= MIN(endY + 1, 6); ++y) {
+					for (int x = MAX(endX - 1, 0); x <= MIN(endX + 1, 6); ++x) {
+						if (board[y * 7 + x])
+							board[y * 7 + x] = cell;
+					}
+				}
+			}
+
+			color = 3 - color;
+		}
+	}
+
+	debugPrintf("%d positions, %d mismatches\n", positions, mismatches);
+	debugPrintf("Original search: %d ms, fast search: %d ms\n", referenceTime, fastTime);
+	return true;
+}
+
 } // End of Groovie namespace
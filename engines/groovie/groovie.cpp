@@ -38,6 +38,7 @@
 #include "common/events.h"
 #include "common/file.h"
 #include "common/macresman.h"
+#include "common/profiler.h"
 #include "common/textconsole.h"
 
 #include "backends/audiocd/audiocd.h"
@@ -333,6 +334,7 @@ Common::Error GroovieEngine::run() {
 			_system->delayMillis(30);
 		} else {
 			// Everything's fine, execute another script step
+			PROFILE_ZONE("Groovie::Script::step");
 			_script->step();
 		}
 
@@ -132,6 +132,12 @@ public:
 	 */
 	void setSaveDate(int year, int month, int day);
 
+	/**
+	 * Sets the human readable description of the date the save state was
+	 * created, as returned by getSaveDate.
+	 */
+	void setSaveDate(const Common::String &date) { _saveDate = date; }
+
 	/**
 	 * Queries a human readable description of the date the save state was created.
 	 *
@@ -147,6 +153,12 @@ public:
 	 */
 	void setSaveTime(int hour, int min);
 
+	/**
+	 * Sets the human readable description of the time the save state was
+	 * created, as returned by getSaveTime.
+	 */
+	void setSaveTime(const Common::String &time) { _saveTime = time; }
+
 	/**
 	 * Queries a human readable description of the time the save state was created.
 	 *
@@ -169,6 +181,12 @@ public:
 	 */
 	void setPlayTime(uint32 msecs);
 
+	/**
+	 * Sets the human readable description of the time the game was played
+	 * before the save state was created, as returned by getPlayTime.
+	 */
+	void setPlayTime(const Common::String &playTime) { _playTime = playTime; }
+
 	/**
 	 * Queries a human readable description of the time the game was played
 	 * before the save state was created.
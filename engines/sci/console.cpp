@@ -30,6 +30,7 @@
 #include "sci/resource.h"
 #include "sci/engine/state.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/savegame.h"
 #include "sci/engine/gc.h"
@@ -128,6 +129,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("room",				WRAP_METHOD(Console, cmdRoomNumber));
 	registerCmd("quit",				WRAP_METHOD(Console, cmdQuit));
 	registerCmd("list_saves",			WRAP_METHOD(Console, cmdListSaves));
+	registerCmd("avoidpath_record",	WRAP_METHOD(Console, cmdAvoidPathRecord));
+	registerCmd("avoidpath_bench",	WRAP_METHOD(Console, cmdAvoidPathBench));
 	// Graphics
 	registerCmd("show_map",			WRAP_METHOD(Console, cmdShowMap));
 	registerCmd("set_palette",		WRAP_METHOD(Console, cmdSetPalette));
@@ -346,6 +349,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" save_game - Saves the current game state to the hard disk\n");
 	debugPrintf(" restore_game - Restores a saved game from the hard disk\n");
 	debugPrintf(" list_saves - List all saved games including filenames\n");
+	debugPrintf(" avoidpath_record - Records the pathfinding calls of the game\n");
+	debugPrintf(" avoidpath_bench - Replays the recorded pathfinding calls and compares the results\n");
 	debugPrintf(" restart_game - Restarts the game\n");
 	debugPrintf(" version - Shows the resource and interpreter versions\n");
 	debugPrintf(" room - Gets or sets the current room number\n");
@@ -1646,6 +1651,60 @@ bool Console::cmdListSaves(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdAvoidPathRecord(int argc, const char **argv) {
+	AvoidPathCache *cache = _engine->_gamestate->_avoidPathCache;
+
+	if (argc != 2) {
+		debugPrintf("Records the input of the pathfinding calls of the game, for avoidpath_bench.\n");
+		debugPrintf("Usage: %s on|off|clear\n", argv[0]);
+		debugPrintf("Recording is %s, %d calls recorded\n", cache->_recording ? "on" : "off", cache->_recordedCalls.size());
+		return true;
+	}
+
+	if (!scumm_stricmp(argv[1], "on"))
+		cache->_recording = true;
+	else if (!scumm_stricmp(argv[1], "off"))
+		cache->_recording = false;
+	else if (!scumm_stricmp(argv[1], "clear"))
+		cache->_recordedCalls.clear();
+	else
+		debugPrintf("Invalid parameter %s\n", argv[1]);
+
+	return true;
+}
+
+bool Console::cmdAvoidPathBench(int argc, const char **argv) {
+	AvoidPathCache *cache = _engine->_gamestate->_avoidPathCache;
+
+	if (argc > 2) {
+		debugPrintf("Replays the pathfinding calls recorded with avoidpath_record, with the\n");
+		debugPrintf("current pathfinder and the reference one, and compares the paths.\n");
+		debugPrintf("Usage: %s [<repeat count>]\n", argv[0]);
+		return true;
+	}
+
+	if (cache->_recordedCalls.empty()) {
+		debugPrintf("No pathfinding calls recorded, use avoidpath_record first\n");
+		return true;
+	}
+
+	int repeat = (argc == 2) ? atoi(argv[1]) : 10;
+	if (repeat < 1) {
+		debugPrintf("Invalid repeat count %s\n", argv[1]);
+		return true;
+	}
+
+	AvoidPathBenchmarkResult result;
+	benchmarkAvoidPath(cache, repeat, result);
+
+	debugPrintf("%d calls, %d times\n", result.calls, repeat);
+	debugPrintf("Reference: %d ms\n", result.referenceTime);
+	debugPrintf("Current: %d ms\n", result.cachedTime);
+	debugPrintf("Differing paths: %d\n", result.mismatches);
+
+	return true;
+}
+
 bool Console::cmdClassTable(int argc, const char **argv) {
 	debugPrintf("Available classes (parse a parameter to filter the table by a specific class):\n");
 
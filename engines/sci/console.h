@@ -83,6 +83,8 @@ private:
 	bool cmdRoomNumber(int argc, const char **argv);
 	bool cmdQuit(int argc, const char **argv);
 	bool cmdListSaves(int argc, const char **argv);
+	bool cmdAvoidPathRecord(int argc, const char **argv);
+	bool cmdAvoidPathBench(int argc, const char **argv);
 	// Screen
 	bool cmdShowMap(int argc, const char **argv);
 	// Graphics
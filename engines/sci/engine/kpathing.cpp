@@ -24,6 +24,7 @@
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/graphics/paint16.h"
 #include "sci/graphics/palette.h"
 #include "sci/graphics/screen.h"
@@ -111,10 +112,26 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Position in the vertex index of the pathfinding state
+	int index;
+
+	// A* open set variables: position in the heap (-1 when not in the open
+	// set) and when the vertex was added to it
+	int heapPos;
+	uint32 openOrder;
+
+	// Whether the shortest path to this vertex is known
+	bool closed;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
+		costF = HUGE_DISTANCE;
 		costG = HUGE_DISTANCE;
 		path_prev = NULL;
+		index = -1;
+		heapPos = -1;
+		openOrder = 0;
+		closed = false;
 	}
 };
 
@@ -257,6 +274,16 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Number of single-vertex polygons added by merge_point(), these come
+	// first in the vertex index
+	int _mergedVertices;
+
+	// Whether merge_point() split up an edge
+	bool _splitEdge;
+
+	// Visibility graph of the polygon set, without the merged vertices
+	VisibilityGraph *_visibility;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
 		vertex_start = NULL;
 		vertex_end = NULL;
@@ -264,6 +291,9 @@ struct PathfindingState {
 		_prependPoint = NULL;
 		_appendPoint = NULL;
 		vertices = 0;
+		_mergedVertices = 0;
+		_splitEdge = false;
+		_visibility = NULL;
 	}
 
 	~PathfindingState() {
@@ -659,6 +689,39 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 	return 0;
 }
 
+/**
+ * Determines whether a vertex is visible from another one.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex to look from
+ * @param vertex		the vertex to look at
+ * @return true if vertex is visible from vertex_cur
+ */
+static bool visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
+
+	// Check for intersecting edges
+	for (int j = 0; j < s->vertices; j++) {
+		Vertex *edge = s->vertex_index[j];
+		if (VERTEX_HAS_EDGES(edge)) {
+			if (between(vertex_cur->v, vertex->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+					return false;
+
+				// This edge won't properly intersect, so we continue
+				continue;
+			}
+
+			if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				return false;
+		}
+	}
+
+	return true;
+}
+
 /**
  * Returns a list of all vertices that are visible from a particular vertex.
  * @param s				the pathfinding state
@@ -671,34 +734,56 @@ static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 	for (int i = 0; i < s->vertices; i++) {
 		Vertex *vertex = s->vertex_index[i];
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
+		if (visible(s, vertex_cur, vertex))
+			visVerts->push_front(vertex);
+	}
 
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
-
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
+	return visVerts;
+}
 
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
-			}
+/**
+ * Collects all vertices that are visible from a particular vertex, in the
+ * same order as visible_vertices(). Visibility between the vertices of the
+ * polygon set is taken from its visibility graph, when there is one.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex
+ * @param visVerts		receives the vertices that are visible from vertex_cur
+ */
+static void cached_visible_vertices(PathfindingState *s, Vertex *vertex_cur, Common::Array<Vertex *> &visVerts) {
+	VisibilityGraph *graph = s->_visibility;
+	const int first = s->_mergedVertices;
+	int i;
+
+	visVerts.clear();
+
+	if (!graph || vertex_cur->index < first) {
+		for (i = s->vertices - 1; i >= 0; i--) {
+			if (visible(s, vertex_cur, s->vertex_index[i]))
+				visVerts.push_back(s->vertex_index[i]);
 		}
+		return;
+	}
 
-		if (j == s->vertices)
-			visVerts->push_front(vertex);
+	const uint row = vertex_cur->index - first;
+	if (!graph->rowValid[row]) {
+		// The merged vertices have no edges, so they do not affect the
+		// visibility between the other ones
+		graph->rows[row].clear();
+		for (i = s->vertices - 1; i >= first; i--) {
+			if (visible(s, vertex_cur, s->vertex_index[i]))
+				graph->rows[row].push_back(i - first);
+		}
+		graph->rowValid[row] = true;
 	}
 
-	return visVerts;
+	const Common::Array<uint16> &visible_row = graph->rows[row];
+	for (uint j = 0; j < visible_row.size(); j++)
+		visVerts.push_back(s->vertex_index[first + visible_row[j]]);
+
+	for (i = first - 1; i >= 0; i--) {
+		if (visible(s, vertex_cur, s->vertex_index[i]))
+			visVerts.push_back(s->vertex_index[i]);
+	}
 }
 
 /**
@@ -1083,6 +1168,7 @@ static Vertex *merge_point(PathfindingState *s, const Common::Point &v) {
 				if (between(vertex->v, next->v, v)) {
 					// Split edge by adding vertex
 					polygon->vertices.insertAfter(vertex, v_new);
+					s->_splitEdge = true;
 					return v_new;
 				}
 			}
@@ -1093,6 +1179,7 @@ static Vertex *merge_point(PathfindingState *s, const Common::Point &v) {
 	polygon = new Polygon(POLY_BARRED_ACCESS);
 	polygon->vertices.insertHead(v_new);
 	s->polygons.push_front(polygon);
+	s->_mergedVertices++;
 
 	return v_new;
 }
@@ -1186,39 +1273,20 @@ static void change_polygons_opt_0(PathfindingState *s) {
 }
 
 /**
- * Converts the SCI input data for pathfinding
+ * Prepares converted polygons for pathfinding: applies the optimization
+ * level, moves the start and end points to valid positions and merges them
+ * into the polygon set
  * Parameters: (EngineState *) s: The game state
- *             (reg_t) poly_list: Polygon list
+ *             (PathfindingState *) pf_s: The pathfinding state with the converted polygons
  *             (Common::Point) start: The start point
  *             (Common::Point) end: The end point
  *             (int) opt: Optimization level (0, 1 or 2)
- * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
- *                            NULL otherwise
+ *             (AvoidPathCache *) cache: Visibility graphs to use, or NULL
+ * Returns   : (PathfindingState *) pf_s on success, NULL otherwise. pf_s is
+ *                            deleted on failure
  */
-static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
-	SegManager *segMan = s->_segMan;
+static PathfindingState *prepare_polygon_set(EngineState *s, PathfindingState *pf_s, Common::Point start, Common::Point end, int opt, AvoidPathCache *cache) {
 	Polygon *polygon;
-	int count = 0;
-	PathfindingState *pf_s = new PathfindingState(width, height);
-
-	// Convert all polygons
-	if (poly_list.getSegment()) {
-		List *list = s->_segMan->lookupList(poly_list);
-		Node *node = s->_segMan->lookupNode(list->first);
-
-		while (node) {
-			// The node value might be null, in which case there's no polygon to parse.
-			// Happens in LB2 floppy - refer to bug #3041232
-			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
-
-			if (polygon) {
-				pf_s->polygons.push_back(polygon);
-				count += readSelectorValue(segMan, node->value, SELECTOR(size));
-			}
-
-			node = s->_segMan->lookupNode(node->succ);
-		}
-	}
 
 	if (opt == 0)
 		change_polygons_opt_0(pf_s);
@@ -1284,7 +1352,12 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	delete new_end;
 
 	// Allocate and build vertex index
-	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * (count + 2));
+	int count = 0;
+
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it)
+		count += (*it)->vertices.size();
+
+	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * count);
 
 	count = 0;
 
@@ -1293,23 +1366,133 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		Vertex *vertex;
 
 		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->index = count;
 			pf_s->vertex_index[count++] = vertex;
 		}
 	}
 
 	pf_s->vertices = count;
 
+	// Look up the visibility graph of the polygon set. The start and end
+	// points are left out, unless merging them split up an edge, which
+	// changes the polygons themselves.
+	if (cache && !pf_s->_splitEdge) {
+		Common::Array<Common::Point> points;
+		Common::Array<uint> polygonSizes;
+
+		points.reserve(count - pf_s->_mergedVertices);
+		for (int i = pf_s->_mergedVertices; i < count; i++)
+			points.push_back(pf_s->vertex_index[i]->v);
+
+		int skip = pf_s->_mergedVertices;
+		for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+			if (skip > 0)
+				skip--;
+			else
+				polygonSizes.push_back((*it)->vertices.size());
+		}
+
+		pf_s->_visibility = cache->getGraph(points, polygonSizes);
+	}
+
 	return pf_s;
 }
 
 /**
- * Computes a shortest path from vertex_start to vertex_end. The caller can
- * construct the resulting path by following the path_prev links from
- * vertex_end back to vertex_start. If no path exists vertex_end->path_prev
- * will be NULL
+ * Converts the SCI input data for pathfinding
+ * Parameters: (EngineState *) s: The game state
+ *             (reg_t) poly_list: Polygon list
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
+ *                            NULL otherwise
+ */
+static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
+	Polygon *polygon;
+	PathfindingState *pf_s = new PathfindingState(width, height);
+
+	// Convert all polygons
+	if (poly_list.getSegment()) {
+		List *list = s->_segMan->lookupList(poly_list);
+		Node *node = s->_segMan->lookupNode(list->first);
+
+		while (node) {
+			// The node value might be null, in which case there's no polygon to parse.
+			// Happens in LB2 floppy - refer to bug #3041232
+			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
+
+			if (polygon)
+				pf_s->polygons.push_back(polygon);
+
+			node = s->_segMan->lookupNode(node->succ);
+		}
+	}
+
+	AvoidPathCache *cache = s->_avoidPathCache;
+
+	if (cache->_recording) {
+		AvoidPathInput input;
+
+		for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+			AvoidPathInput::Polygon recorded;
+			Vertex *vertex;
+
+			recorded.type = (*it)->type;
+			CLIST_FOREACH(vertex, &(*it)->vertices)
+				recorded.points.push_back(vertex->v);
+			input.polygons.push_back(recorded);
+		}
+
+		input.start = start;
+		input.end = end;
+		input.width = width;
+		input.height = height;
+		input.opt = opt;
+		cache->_recordedCalls.push_back(input);
+	}
+
+	return prepare_polygon_set(s, pf_s, start, end, opt, cache);
+}
+
+/**
+ * Computes the cost of travelling from one vertex to another
  * Parameters: (PathfindingState *) s: The pathfinding state
+ *             (Vertex *) from, to: The vertices
+ * Returns   : (uint32) The cost of the edge
  */
-static void AStar(PathfindingState *s) {
+static uint32 edge_cost(PathfindingState *s, Vertex *from, Vertex *to) {
+	uint32 dist = (uint32)sqrt((float)from->v.sqrDist(to->v));
+
+	// When travelling to a vertex on the screen edge, we
+	// add a penalty score to make this path less appealing.
+	// NOTE: If an obstacle has only one vertex on a screen edge,
+	// later SSCI pathfinders will treat that vertex like any
+	// other, while we apply a penalty to paths traversing it.
+	// This difference might lead to problems, but none are
+	// known at the time of writing.
+
+	// WORKAROUND: This check fails in QFG1VGA, room 81 (bug report #3568452).
+	// However, it is needed in other SCI1.1 games, such as LB2. Therefore, we
+	// add this workaround for that scene in QFG1VGA, until our algorithm matches
+	// better what SSCI is doing. With this workaround, QFG1VGA no longer freezes
+	// in that scene.
+	bool qfg1VgaWorkaround = (g_sci->getGameId() == GID_QFG1VGA &&
+							  g_sci->getEngineState()->currentRoomNumber() == 81);
+
+	if (s->pointOnScreenBorder(to->v) && !qfg1VgaWorkaround)
+		dist += 10000;
+
+	return dist;
+}
+
+/**
+ * Computes a shortest path from vertex_start to vertex_end, like AStar(),
+ * but without visibility graph and with a linear search of the open set.
+ * This is the original implementation, used to check AStar().
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ */
+static void AStarReference(PathfindingState *s) {
 	// Vertices of which the shortest path is known
 	VertexList closedSet;
 
@@ -1357,35 +1540,145 @@ static void AStar(PathfindingState *s) {
 			if (!openSet.contains(vertex))
 				openSet.push_front(vertex);
 
-			new_dist = vertex_min->costG + (uint32)sqrt((float)vertex_min->v.sqrDist(vertex->v));
+			new_dist = vertex_min->costG + edge_cost(s, vertex_min, vertex);
+
+			if (new_dist < vertex->costG) {
+				vertex->costG = new_dist;
+				vertex->costF = vertex->costG + (uint32)sqrt((float)vertex->v.sqrDist(s->vertex_end->v));
+				vertex->path_prev = vertex_min;
+			}
+		}
+
+		delete visVerts;
+	}
+
+	if (openSet.empty())
+		debugC(kDebugLevelAvoidPath, "AvoidPath: End point (%i, %i) is unreachable", s->vertex_end->v.x, s->vertex_end->v.y);
+}
+
+/**
+ * Determines whether a vertex is taken from the open set before another one:
+ * the one with the lowest F cost, and of those the one added last, which is
+ * the order the list based open set of AStarReference() uses
+ */
+static bool open_set_before(const Vertex *a, const Vertex *b) {
+	if (a->costF != b->costF)
+		return a->costF < b->costF;
+	return a->openOrder > b->openOrder;
+}
+
+/**
+ * Moves a vertex up the open set heap as far as its cost requires
+ */
+static void open_set_up(Common::Array<Vertex *> &openSet, Vertex *vertex) {
+	int pos = vertex->heapPos;
+
+	while (pos > 0) {
+		int parent = (pos - 1) / 2;
+		if (!open_set_before(vertex, openSet[parent]))
+			break;
+		openSet[pos] = openSet[parent];
+		openSet[pos]->heapPos = pos;
+		pos = parent;
+	}
+
+	openSet[pos] = vertex;
+	vertex->heapPos = pos;
+}
 
-			// When travelling to a vertex on the screen edge, we
-			// add a penalty score to make this path less appealing.
-			// NOTE: If an obstacle has only one vertex on a screen edge,
-			// later SSCI pathfinders will treat that vertex like any
-			// other, while we apply a penalty to paths traversing it.
-			// This difference might lead to problems, but none are
-			// known at the time of writing.
+/**
+ * Removes the first vertex from the open set heap
+ */
+static void open_set_pop(Common::Array<Vertex *> &openSet) {
+	openSet[0]->heapPos = -1;
 
-			// WORKAROUND: This check fails in QFG1VGA, room 81 (bug report #3568452).
-			// However, it is needed in other SCI1.1 games, such as LB2. Therefore, we
-			// add this workaround for that scene in QFG1VGA, until our algorithm matches
-			// better what SSCI is doing. With this workaround, QFG1VGA no longer freezes
-			// in that scene.
-			bool qfg1VgaWorkaround = (g_sci->getGameId() == GID_QFG1VGA &&
-									  g_sci->getEngineState()->currentRoomNumber() == 81);
+	Vertex *vertex = openSet.back();
+	openSet.pop_back();
+	if (openSet.empty())
+		return;
 
-			if (s->pointOnScreenBorder(vertex->v) && !qfg1VgaWorkaround)
-				new_dist += 10000;
+	int size = openSet.size();
+	int pos = 0;
+
+	for (;;) {
+		int child = pos * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && open_set_before(openSet[child + 1], openSet[child]))
+			child++;
+		if (!open_set_before(openSet[child], vertex))
+			break;
+		openSet[pos] = openSet[child];
+		openSet[pos]->heapPos = pos;
+		pos = child;
+	}
+
+	openSet[pos] = vertex;
+	vertex->heapPos = pos;
+}
+
+/**
+ * Computes a shortest path from vertex_start to vertex_end. The caller can
+ * construct the resulting path by following the path_prev links from
+ * vertex_end back to vertex_start. If no path exists vertex_end->path_prev
+ * will be NULL
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ */
+static void AStar(PathfindingState *s) {
+	// The remaining vertices, as a binary heap. Vertices of which the
+	// shortest path is known are marked as closed.
+	Common::Array<Vertex *> openSet;
+	Common::Array<Vertex *> visVerts;
+	uint32 openOrder = 0;
+
+	s->vertex_start->costG = 0;
+	s->vertex_start->costF = (uint32)sqrt((float)s->vertex_start->v.sqrDist(s->vertex_end->v));
+	s->vertex_start->openOrder = openOrder++;
+	s->vertex_start->heapPos = 0;
+	openSet.push_back(s->vertex_start);
+
+	while (!openSet.empty()) {
+		// The vertex in open set with lowest F cost
+		Vertex *vertex_min = openSet[0];
+
+		assert(vertex_min->costF < HUGE_DISTANCE);	// the vertex cost should never be bigger than HUGE_DISTANCE
+
+		// Check if we are done
+		if (vertex_min == s->vertex_end)
+			break;
+
+		// Move vertex from set open to set closed
+		open_set_pop(openSet);
+		vertex_min->closed = true;
+
+		cached_visible_vertices(s, vertex_min, visVerts);
+
+		for (uint i = 0; i < visVerts.size(); i++) {
+			Vertex *vertex = visVerts[i];
+
+			if (vertex->closed)
+				continue;
+
+			bool added = false;
+			if (vertex->heapPos < 0) {
+				vertex->openOrder = openOrder++;
+				vertex->heapPos = openSet.size();
+				openSet.push_back(vertex);
+				added = true;
+			}
+
+			uint32 new_dist = vertex_min->costG + edge_cost(s, vertex_min, vertex);
 
 			if (new_dist < vertex->costG) {
 				vertex->costG = new_dist;
 				vertex->costF = vertex->costG + (uint32)sqrt((float)vertex->v.sqrDist(s->vertex_end->v));
 				vertex->path_prev = vertex_min;
+				added = true;
 			}
-		}
 
-		delete visVerts;
+			if (added)
+				open_set_up(openSet, vertex);
+		}
 	}
 
 	if (openSet.empty())
@@ -1577,6 +1870,152 @@ reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 	}
 }
 
+AvoidPathCache::AvoidPathCache() : _recording(false), _useCounter(0) {
+	for (int i = 0; i < kGraphCount; i++)
+		_graphs[i] = NULL;
+}
+
+AvoidPathCache::~AvoidPathCache() {
+	clear();
+}
+
+VisibilityGraph *AvoidPathCache::getGraph(const Common::Array<Common::Point> &points, const Common::Array<uint> &polygonSizes) {
+	int oldest = 0;
+
+	_useCounter++;
+
+	for (int i = 0; i < kGraphCount; i++) {
+		VisibilityGraph *graph = _graphs[i];
+
+		if (graph && graph->points == points && graph->polygonSizes == polygonSizes) {
+			graph->lastUse = _useCounter;
+			return graph;
+		}
+
+		// Empty slots are used first
+		if (_graphs[oldest] && (!graph || graph->lastUse < _graphs[oldest]->lastUse))
+			oldest = i;
+	}
+
+	delete _graphs[oldest];
+
+	VisibilityGraph *graph = new VisibilityGraph();
+	graph->points = points;
+	graph->polygonSizes = polygonSizes;
+	graph->rowValid.resize(points.size());
+	for (uint i = 0; i < points.size(); i++)
+		graph->rowValid[i] = false;
+	graph->rows.resize(points.size());
+	graph->lastUse = _useCounter;
+
+	_graphs[oldest] = graph;
+	return graph;
+}
+
+void AvoidPathCache::clear() {
+	for (int i = 0; i < kGraphCount; i++) {
+		delete _graphs[i];
+		_graphs[i] = NULL;
+	}
+}
+
+/**
+ * Rebuilds the pathfinding state of a recorded kAvoidPath call
+ * Parameters: (EngineState *) s: The game state
+ *             (const AvoidPathInput &) input: The recorded call
+ *             (AvoidPathCache *) cache: Visibility graphs to use, or NULL
+ * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
+ *                            NULL otherwise
+ */
+static PathfindingState *replay_polygon_set(EngineState *s, const AvoidPathInput &input, AvoidPathCache *cache) {
+	PathfindingState *pf_s = new PathfindingState(input.width, input.height);
+
+	for (uint i = 0; i < input.polygons.size(); i++) {
+		Polygon *polygon = new Polygon(input.polygons[i].type);
+
+		// The points were recorded after convert_polygon() fixed their order
+		for (uint j = 0; j < input.polygons[i].points.size(); j++)
+			polygon->vertices.insertAtEnd(new Vertex(input.polygons[i].points[j]));
+
+		pf_s->polygons.push_back(polygon);
+	}
+
+	return prepare_polygon_set(s, pf_s, input.start, input.end, input.opt, cache);
+}
+
+/**
+ * Collects the final path, like output_path() stores it
+ * Parameters: (PathfindingState *) p: The pathfinding state
+ *             (Common::Array<Common::Point> &) path: Receives the path
+ */
+static void get_path(PathfindingState *p, Common::Array<Common::Point> &path) {
+	path.clear();
+
+	if (!p->vertex_end->path_prev) {
+		path.push_back(p->_prependPoint ? *p->_prependPoint : p->vertex_start->v);
+		path.push_back(p->vertex_start->v);
+		return;
+	}
+
+	if (p->_prependPoint)
+		path.push_back(*p->_prependPoint);
+
+	const uint offset = path.size();
+	for (Vertex *vertex = p->vertex_end; vertex; vertex = vertex->path_prev)
+		path.insert_at(offset, vertex->v);
+
+	if (p->_appendPoint)
+		path.push_back(*p->_appendPoint);
+}
+
+void benchmarkAvoidPath(AvoidPathCache *cache, uint repeat, AvoidPathBenchmarkResult &result) {
+	EngineState *s = g_sci->getEngineState();
+	const Common::Array<AvoidPathInput> &calls = cache->_recordedCalls;
+	Common::Array<Common::Array<Common::Point> > referencePaths, cachedPaths;
+	uint32 start;
+
+	referencePaths.resize(calls.size());
+	cachedPaths.resize(calls.size());
+
+	start = g_system->getMillis();
+	for (uint r = 0; r < repeat; r++) {
+		for (uint i = 0; i < calls.size(); i++) {
+			PathfindingState *p = replay_polygon_set(s, calls[i], NULL);
+			if (p) {
+				AStarReference(p);
+				get_path(p, referencePaths[i]);
+				delete p;
+			}
+		}
+	}
+	result.referenceTime = g_system->getMillis() - start;
+
+	// Start out without visibility graphs, like the game would
+	cache->clear();
+
+	start = g_system->getMillis();
+	for (uint r = 0; r < repeat; r++) {
+		for (uint i = 0; i < calls.size(); i++) {
+			PathfindingState *p = replay_polygon_set(s, calls[i], cache);
+			if (p) {
+				AStar(p);
+				get_path(p, cachedPaths[i]);
+				delete p;
+			}
+		}
+	}
+	result.cachedTime = g_system->getMillis() - start;
+
+	result.calls = calls.size();
+	result.mismatches = 0;
+	for (uint i = 0; i < calls.size(); i++) {
+		if (referencePaths[i] != cachedPaths[i]) {
+			result.mismatches++;
+			debugC(kDebugLevelAvoidPath, "[avoidpath] Path of recorded call %d differs", i);
+		}
+	}
+}
+
 static bool PointInRect(const Common::Point &point, int16 rectX1, int16 rectY1, int16 rectX2, int16 rectY2) {
 	int16 top = MIN<int16>(rectY1, rectY2);
 	int16 left = MIN<int16>(rectX1, rectX2);
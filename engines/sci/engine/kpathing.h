@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_ENGINE_KPATHING_H
+#define SCI_ENGINE_KPATHING_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Sci {
+
+/**
+ * The input of a kAvoidPath call, after the polygons have been read from
+ * the script objects.
+ */
+struct AvoidPathInput {
+	struct Polygon {
+		int type;
+		Common::Array<Common::Point> points;
+	};
+
+	Common::Array<Polygon> polygons;
+	Common::Point start;
+	Common::Point end;
+	int width;
+	int height;
+	int opt;
+};
+
+/**
+ * Which polygon vertices can be seen from which others, for one polygon set.
+ * Rows are filled in when the pathfinder first needs them.
+ */
+struct VisibilityGraph {
+	// The polygon set the graph belongs to: the vertices of all polygons,
+	// polygon after polygon, and the number of vertices of each polygon
+	Common::Array<Common::Point> points;
+	Common::Array<uint> polygonSizes;
+
+	// For every vertex, whether its row is filled in yet, and the indices of
+	// the vertices visible from it, highest index first
+	Common::Array<bool> rowValid;
+	Common::Array<Common::Array<uint16> > rows;
+
+	uint32 lastUse;
+};
+
+struct AvoidPathBenchmarkResult {
+	uint calls;
+	uint mismatches;
+	uint32 referenceTime;
+	uint32 cachedTime;
+};
+
+/**
+ * State kept by kAvoidPath between calls: the visibility graphs of the most
+ * recently used polygon sets, and the calls recorded for the "avoidpath"
+ * debugger command.
+ *
+ * Graphs are looked up by the contents of the polygon set, so any change
+ * the scripts make to their polygons simply leads to a new graph.
+ */
+class AvoidPathCache {
+public:
+	enum {
+		kGraphCount = 4
+	};
+
+	AvoidPathCache();
+	~AvoidPathCache();
+
+	/**
+	 * Returns the visibility graph of a polygon set, creating an empty one
+	 * in place of the least recently used graph if there is none yet.
+	 */
+	VisibilityGraph *getGraph(const Common::Array<Common::Point> &points, const Common::Array<uint> &polygonSizes);
+
+	void clear();
+
+	bool _recording;
+	Common::Array<AvoidPathInput> _recordedCalls;
+
+private:
+	VisibilityGraph *_graphs[kGraphCount];
+	uint32 _useCounter;
+};
+
+/**
+ * Replays the recorded kAvoidPath calls, with both the cached pathfinder and
+ * the reference one, which recomputes visibility for every step and keeps
+ * the open set in a plain list.
+ */
+void benchmarkAvoidPath(AvoidPathCache *cache, uint repeat, AvoidPathBenchmarkResult &result);
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_KPATHING_H
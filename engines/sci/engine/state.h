@@ -43,6 +43,7 @@ class WriteStream;
 
 namespace Sci {
 
+class AvoidPathCache;
 class FileHandle;
 class DirSeeker;
 class EventManager;
@@ -192,6 +193,8 @@ public:
 
 	MessageState *_msgState;
 
+	AvoidPathCache *_avoidPathCache; /**< Visibility graphs and recorded calls of kAvoidPath */
+
 	// MemorySegment provides access to a 256-byte block of memory that remains
 	// intact across restarts and restores
 	enum {
@@ -485,6 +485,8 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 		_debugMode = true;
 
 	_copyProtection = ConfMan.getBool("copy_protection");
+	_subtitlesKey = ConfMan.internKey("subtitles");
+	_speechMuteKey = ConfMan.internKey("speech_mute");
 	if (ConfMan.getBool("demo_mode"))
 		_game.features |= GF_DEMO;
 	if (ConfMan.hasKey("nosubtitles")) {
@@ -25,6 +25,7 @@
 
 #include "engines/engine.h"
 
+#include "common/config-manager.h"
 #include "common/endian.h"
 #include "common/events.h"
 #include "common/file.h"
@@ -1127,6 +1128,10 @@ protected:
 	bool _enable_gs;
 	bool _copyProtection;
 
+	// Settings queried while printing text
+	Common::ConfigManager::KeyHandle _subtitlesKey;
+	Common::ConfigManager::KeyHandle _speechMuteKey;
+
 	// Indy4 Amiga specific
 	uint16 _amigaFirstUsedColor;
 	byte _amigaPalette[3 * 64];
@@ -223,7 +223,7 @@ void ScummEngine_v6::removeBlastTexts() {
 void ScummEngine_v7::processSubtitleQueue() {
 	for (int i = 0; i < _subtitleQueuePos; ++i) {
 		SubtitleText *st = &_subtitleQueue[i];
-		if (!st->actorSpeechMsg && (!ConfMan.getBool("subtitles") || VAR(VAR_VOICE_MODE) == 0))
+		if (!st->actorSpeechMsg && (!ConfMan.getBool(_subtitlesKey) || VAR(VAR_VOICE_MODE) == 0))
 			// no subtitles and there's a speech variant of the message, don't display the text
 			continue;
 		enqueueText(st->text, st->xpos, st->ypos, st->color, st->charset, false);
@@ -659,11 +659,11 @@ void ScummEngine::CHARSET_1() {
 			} else {
 				if (_game.features & GF_16BIT_COLOR) {
 					// HE games which use sprites for subtitles
-				} else if (_game.heversion >= 60 && !ConfMan.getBool("subtitles") && _sound->isSoundRunning(1)) {
+				} else if (_game.heversion >= 60 && !ConfMan.getBool(_subtitlesKey) && _sound->isSoundRunning(1)) {
 					// Special case for HE games
-				} else if (_game.id == GID_LOOM && !ConfMan.getBool("subtitles") && (_sound->pollCD())) {
+				} else if (_game.id == GID_LOOM && !ConfMan.getBool(_subtitlesKey) && (_sound->pollCD())) {
 					// Special case for Loom (CD), since it only uses CD audio.for sound
-				} else if (!ConfMan.getBool("subtitles") && (!_haveActorSpeechMsg || _mixer->isSoundHandleActive(*_sound->_talkChannelHandle))) {
+				} else if (!ConfMan.getBool(_subtitlesKey) && (!_haveActorSpeechMsg || _mixer->isSoundHandleActive(*_sound->_talkChannelHandle))) {
 					// Subtitles are turned off, and there is a voice version
 					// of this message -> don't print it.
 				} else {
@@ -1477,7 +1477,7 @@ void ScummEngine_v7::loadLanguageBundle() {
 }
 
 void ScummEngine_v7::playSpeech(const byte *ptr) {
-	if (_game.id == GID_DIG && (ConfMan.getBool("speech_mute") || VAR(VAR_VOICE_MODE) == 2))
+	if (_game.id == GID_DIG && (ConfMan.getBool(_speechMuteKey) || VAR(VAR_VOICE_MODE) == 2))
 		return;
 
 	if ((_game.id == GID_DIG || _game.id == GID_CMI) && ptr[0]) {
@@ -49,6 +49,13 @@ static const ExtraGuiOption sword25ExtraGuiOption = {
 	false
 };
 
+static const ExtraGuiOption sword25ImageCacheOption = {
+	_s("Cache decoded images"),
+	_s("Store decoded images in the cache directory, so that scenes load faster the next time"),
+	"image_cache",
+	false
+};
+
 class Sword25MetaEngine : public AdvancedMetaEngine {
 public:
 	Sword25MetaEngine() : AdvancedMetaEngine(Sword25::gameDescriptions, sizeof(ADGameDescription), sword25Game) {
@@ -86,6 +93,7 @@ bool Sword25MetaEngine::hasFeature(MetaEngineFeature f) const {
 const ExtraGuiOptions Sword25MetaEngine::getExtraGuiOptions(const Common::String &target) const {
 	ExtraGuiOptions options;
 	options.push_back(sword25ExtraGuiOption);
+	options.push_back(sword25ImageCacheOption);
 	return options;
 }
 
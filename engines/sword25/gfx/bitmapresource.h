@@ -51,6 +51,13 @@ public:
 		return (_pImage != 0);
 	}
 
+	/**
+	    @brief Returns the size of the decoded bitmap in bytes.
+	*/
+	virtual uint getMemoryUsage() const {
+		return _pImage ? _pImage->getWidth() * _pImage->getHeight() * 4 : 0;
+	}
+
 	/**
 	    @brief Gibt die Breite des Bitmaps zurck.
 	*/
@@ -38,6 +38,7 @@
 #include "sword25/gfx/panel.h"
 #include "sword25/gfx/renderobjectmanager.h"
 #include "sword25/gfx/screenshot.h"
+#include "sword25/gfx/image/imagecache.h"
 #include "sword25/gfx/image/renderedimage.h"
 #include "sword25/gfx/image/swimage.h"
 #include "sword25/gfx/image/vectorimage.h"
@@ -74,6 +75,8 @@ GraphicEngine::GraphicEngine(Kernel *pKernel) :
 	ResourceService(pKernel) {
 	_frameTimeSamples.resize(FRAMETIME_SAMPLE_COUNT);
 
+	_imageCachePtr.reset(new ImageCache());
+
 	if (!registerScriptBindings())
 		error("Script bindings could not be registered.");
 	else
@@ -330,6 +333,13 @@ Resource *GraphicEngine::loadResource(const Common::String &filename) {
 
 // -----------------------------------------------------------------------------
 
+void GraphicEngine::prefetchResource(const Common::String &filename) {
+	// Only images from the packages can be decoded ahead of time. Software
+	// buffer images ("_s.png") are decoded the same way as sprites.
+	if (filename.hasSuffix(".png") && !filename.hasPrefix("/saves"))
+		_imageCachePtr->prefetch(filename);
+}
+
 bool GraphicEngine::canLoadResource(const Common::String &filename) {
 	return filename.hasSuffix(".png") ||
 		filename.hasSuffix("_ani.xml") ||
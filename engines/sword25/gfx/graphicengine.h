@@ -59,6 +59,7 @@ class Image;
 class Panel;
 class Screenshot;
 class RenderObjectManager;
+class ImageCache;
 
 typedef uint BS_COLOR;
 
@@ -235,6 +236,8 @@ public:
 	Common::SeekableReadStream *_thumbnail;
 	Common::SeekableReadStream *getThumbnail() { return _thumbnail; }
 
+	ImageCache *getImageCache() { return _imageCachePtr.get(); }
+
 	// Access methods
 
 	/**
@@ -274,6 +277,7 @@ public:
 	// --------------------------
 	virtual Resource *loadResource(const Common::String &fileName);
 	virtual bool canLoadResource(const Common::String &fileName);
+	virtual void prefetchResource(const Common::String &fileName);
 
 	// Persistence Methods
 	// -------------------
@@ -314,6 +318,8 @@ private:
 
 	Common::ScopedPtr<RenderObjectManager> _renderObjectManagerPtr;
 
+	Common::ScopedPtr<ImageCache> _imageCachePtr;
+
 	struct DebugLine {
 		DebugLine(const Vertex &start, const Vertex &end, uint color) :
 			_start(start),
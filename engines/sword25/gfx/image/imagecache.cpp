@@ -0,0 +1,401 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/config-manager.h"
+#include "common/stream.h"
+#include "common/system.h"
+
+#include "sword25/sword25.h"	// for kDebugResource
+#include "sword25/gfx/image/imagecache.h"
+#include "sword25/gfx/image/imgloader.h"
+#include "sword25/package/packagemanager.h"
+
+namespace Sword25 {
+
+enum {
+	// Prefetched images which have not been loaded yet may take this many bytes.
+	// Beyond that, the oldest ones are dropped again.
+	kMaxDecodedSize = 64 * 1024 * 1024,
+	// The disk cache may take this many bytes. Beyond that, the least
+	// recently used images are dropped again.
+	kMaxDiskCacheSize = 256 * 1024 * 1024
+};
+
+static const uint32 kDiskCacheMagic = MKTAG('B', 'S', 'I', 'C');
+static const byte kDiskCacheVersion = 1;
+
+static const uint32 kDiskCacheIndexMagic = MKTAG('B', 'S', 'I', 'X');
+static const byte kDiskCacheIndexVersion = 2;
+static const char *const kDiskCacheIndexName = "sword25-img.idx";
+
+ImageCache::ImageCache() : _diskCacheSize(0), _diskCacheClock(0), _diskCacheDirty(false), _decodedSize(0) {
+	_useDiskCache = ConfMan.hasKey("image_cache") && ConfMan.getBool("image_cache");
+
+	if (_useDiskCache) {
+		const Common::String cachePath = g_system->getCachePath();
+		if (cachePath.empty()) {
+			_useDiskCache = false;
+		} else {
+			_diskCacheDir = Common::FSNode(cachePath);
+			loadDiskCacheIndex();
+		}
+	}
+}
+
+ImageCache::~ImageCache() {
+	clear();
+
+	if (_useDiskCache)
+		saveDiskCacheIndex();
+}
+
+void ImageCache::prefetch(const Common::String &fileName) {
+	if (_decoded.contains(fileName))
+		return;
+	for (Common::List<Common::String>::const_iterator i = _jobs.begin(); i != _jobs.end(); ++i) {
+		if (*i == fileName)
+			return;
+	}
+
+	// The file is only read once the image is decoded
+	_jobs.push_back(fileName);
+}
+
+bool ImageCache::decodeNext() {
+	if (_jobs.empty())
+		return false;
+
+	// Take the jobs from the back. When a run of prefetched images is
+	// loaded, like the frames of an animation, the ones which did not get
+	// decoded yet are taken from the front.
+	const Common::String fileName = _jobs.back();
+	_jobs.pop_back();
+
+	DecodedImage image;
+	if (readImage(fileName, image, false))
+		addDecodedImage(fileName, image);
+
+	return true;
+}
+
+bool ImageCache::loadPNGImage(const Common::String &fileName, Graphics::Surface *dest) {
+	DecodedImage image;
+	if (takeDecodedImage(fileName, image)) {
+		debugC(kDebugResource, "Using prefetched image \"%s\".", fileName.c_str());
+	} else {
+		_jobs.remove(fileName);
+		if (!readImage(fileName, image, true))
+			return false;
+	}
+
+	*dest = image.surface;
+	if (_useDiskCache && !image.fromDiskCache)
+		writeDiskCache(fileName, image.hash, *dest);
+	return true;
+}
+
+bool ImageCache::readImage(const Common::String &fileName, DecodedImage &image, bool required) {
+	uint fileSize;
+	byte *fileData = Kernel::getInstance()->getPackage()->getFile(fileName, &fileSize);
+	if (!fileData) {
+		if (required)
+			error("File \"%s\" could not be loaded.", fileName.c_str());
+
+		// The error is reported once the image is actually loaded
+		debugC(kDebugResource, "Could not prefetch \"%s\".", fileName.c_str());
+		return false;
+	}
+
+	image.hash = _useDiskCache ? hashFileData(fileData, fileSize) : 0;
+	image.fromDiskCache = _useDiskCache && readDiskCache(fileName, image.hash, &image.surface);
+
+	bool result = image.fromDiskCache || ImgLoader::decodePNGImage(fileData, fileSize, &image.surface);
+	delete[] fileData;
+	return result;
+}
+
+void ImageCache::clear() {
+	_jobs.clear();
+
+	for (DecodedMap::iterator i = _decoded.begin(); i != _decoded.end(); ++i)
+		i->_value.surface.free();
+	_decoded.clear();
+	_decodedOrder.clear();
+	_decodedSize = 0;
+}
+
+void ImageCache::addDecodedImage(const Common::String &fileName, const DecodedImage &image) {
+	_decoded[fileName] = image;
+	_decodedOrder.push_back(fileName);
+	_decodedSize += image.surface.pitch * image.surface.h;
+
+	while (_decodedSize > kMaxDecodedSize && _decodedOrder.size() > 1) {
+		DecodedImage oldest;
+		takeDecodedImage(_decodedOrder.front(), oldest);
+		oldest.surface.free();
+	}
+}
+
+bool ImageCache::takeDecodedImage(const Common::String &fileName, DecodedImage &image) {
+	DecodedMap::iterator i = _decoded.find(fileName);
+	if (i == _decoded.end())
+		return false;
+
+	image = i->_value;
+	_decoded.erase(i);
+	_decodedOrder.remove(fileName);
+	_decodedSize -= image.surface.pitch * image.surface.h;
+	return true;
+}
+
+uint32 ImageCache::hashFileData(const byte *fileData, uint fileSize) {
+	// FNV-1a
+	uint32 hash = 2166136261u;
+	for (uint i = 0; i < fileSize; i++)
+		hash = (hash ^ fileData[i]) * 16777619u;
+	return hash;
+}
+
+Common::String ImageCache::getDiskCacheName(uint32 slot) {
+	return Common::String::format("sword25-img-%05u.cache", slot);
+}
+
+uint32 ImageCache::allocateDiskCacheSlot() {
+	uint32 slot = 0;
+	while (slot < _diskCacheSlots.size() && _diskCacheSlots[slot])
+		slot++;
+
+	if (slot == _diskCacheSlots.size())
+		_diskCacheSlots.push_back(true);
+	else
+		_diskCacheSlots[slot] = true;
+	return slot;
+}
+
+bool ImageCache::readDiskCache(const Common::String &fileName, uint32 hash, Graphics::Surface *dest) {
+	DiskCacheMap::iterator entry = _diskCache.find(fileName);
+	if (entry == _diskCache.end())
+		return false;
+
+	Common::SeekableReadStream *in = _diskCacheDir.getChild(getDiskCacheName(entry->_value.slot)).createReadStream();
+	if (!in) {
+		dropDiskCacheFile(fileName);
+		return false;
+	}
+
+	bool valid = in->readUint32BE() == kDiskCacheMagic && in->readByte() == kDiskCacheVersion;
+#ifdef SCUMM_BIG_ENDIAN
+	valid = valid && in->readByte() == 1;
+#else
+	valid = valid && in->readByte() == 0;
+#endif
+	if (valid) {
+		// The index may be out of date, and the image may have changed
+		Common::String storedFileName;
+		uint16 nameLength = in->readUint16LE();
+		for (uint16 i = 0; i < nameLength; i++)
+			storedFileName += (char)in->readByte();
+		valid = storedFileName == fileName && in->readUint32LE() == hash;
+	}
+
+	if (valid) {
+		uint16 width = in->readUint16LE();
+		uint16 height = in->readUint16LE();
+		dest->create(width, height, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		valid = in->read(dest->getPixels(), dest->pitch * dest->h) == (uint32)(dest->pitch * dest->h) && !in->err();
+		if (!valid)
+			dest->free();
+	}
+
+	delete in;
+
+	// An outdated file is overwritten once the image has been decoded
+	if (!valid)
+		return false;
+
+	debugC(kDebugResource, "Using cached image \"%s\".", fileName.c_str());
+	entry->_value.lastUse = ++_diskCacheClock;
+	_diskCacheDirty = true;
+	return true;
+}
+
+void ImageCache::writeDiskCache(const Common::String &fileName, uint32 hash, const Graphics::Surface &surface) {
+	// Savegame thumbnails change all the time
+	if (fileName.hasSuffix(".b25s"))
+		return;
+
+	const uint32 size = 4 + 1 + 1 + 2 + fileName.size() + 4 + 2 + 2 + surface.w * surface.h * 4;
+
+	// An outdated file of the image is overwritten in place
+	uint32 slot;
+	DiskCacheMap::iterator old = _diskCache.find(fileName);
+	if (old != _diskCache.end()) {
+		slot = old->_value.slot;
+		_diskCacheSize -= old->_value.size;
+		_diskCache.erase(old);
+		evictDiskCache(size);
+	} else {
+		evictDiskCache(size);
+		slot = allocateDiskCacheSlot();
+	}
+
+	// Decoded images are bigger than compressed ones, but much faster to read
+	Common::WriteStream *out = _diskCacheDir.getChild(getDiskCacheName(slot)).createWriteStream();
+	if (!out) {
+		_diskCacheSlots[slot] = false;
+		return;
+	}
+
+	out->writeUint32BE(kDiskCacheMagic);
+	out->writeByte(kDiskCacheVersion);
+#ifdef SCUMM_BIG_ENDIAN
+	out->writeByte(1);
+#else
+	out->writeByte(0);
+#endif
+	out->writeUint16LE(fileName.size());
+	out->write(fileName.c_str(), fileName.size());
+	out->writeUint32LE(hash);
+	out->writeUint16LE(surface.w);
+	out->writeUint16LE(surface.h);
+	for (int y = 0; y < surface.h; y++)
+		out->write(surface.getBasePtr(0, y), surface.w * 4);
+
+	out->finalize();
+	const bool failed = out->err();
+	delete out;
+
+	// Keep the partly written file in the index, so that it is dropped
+	// like any other one
+	DiskCacheEntry &entry = _diskCache[fileName];
+	entry.slot = slot;
+	entry.size = size;
+	entry.lastUse = ++_diskCacheClock;
+	_diskCacheSize += size;
+	_diskCacheDirty = true;
+
+	if (failed) {
+		warning("Could not write image cache for \"%s\".", fileName.c_str());
+		dropDiskCacheFile(fileName);
+	}
+}
+
+void ImageCache::evictDiskCache(uint32 size) {
+	while (!_diskCache.empty() && _diskCacheSize + size > kMaxDiskCacheSize) {
+		DiskCacheMap::const_iterator oldest = _diskCache.begin();
+		for (DiskCacheMap::const_iterator i = _diskCache.begin(); i != _diskCache.end(); ++i) {
+			if (i->_value.lastUse < oldest->_value.lastUse)
+				oldest = i;
+		}
+		dropDiskCacheFile(oldest->_key);
+	}
+}
+
+void ImageCache::dropDiskCacheFile(const Common::String &fileName) {
+	DiskCacheMap::iterator entry = _diskCache.find(fileName);
+	if (entry == _diskCache.end())
+		return;
+
+	const uint32 slot = entry->_value.slot;
+	_diskCacheSize -= entry->_value.size;
+	_diskCache.erase(entry);
+	_diskCacheSlots[slot] = false;
+	_diskCacheDirty = true;
+
+	// Files cannot be deleted through the FS layer, so leave an empty one
+	// behind instead. Its name is reused by the next image written.
+	Common::WriteStream *out = _diskCacheDir.getChild(getDiskCacheName(slot)).createWriteStream();
+	if (out) {
+		out->finalize();
+		delete out;
+	}
+}
+
+void ImageCache::loadDiskCacheIndex() {
+	Common::FSNode node = _diskCacheDir.getChild(kDiskCacheIndexName);
+	if (!node.exists())
+		return;
+
+	Common::SeekableReadStream *in = node.createReadStream();
+	if (!in)
+		return;
+
+	if (in->readUint32BE() == kDiskCacheIndexMagic && in->readByte() == kDiskCacheIndexVersion) {
+		_diskCacheClock = in->readUint32LE();
+		uint32 count = in->readUint32LE();
+		while (count-- && !in->eos() && !in->err()) {
+			Common::String fileName;
+			uint16 nameLength = in->readUint16LE();
+			for (uint16 i = 0; i < nameLength; i++)
+				fileName += (char)in->readByte();
+
+			DiskCacheEntry &entry = _diskCache[fileName];
+			entry.slot = in->readUint32LE();
+			entry.size = in->readUint32LE();
+			entry.lastUse = in->readUint32LE();
+			_diskCacheSize += entry.size;
+
+			if (entry.slot >= _diskCacheSlots.size())
+				_diskCacheSlots.resize(entry.slot + 1);
+			_diskCacheSlots[entry.slot] = true;
+		}
+
+		if (in->eos() || in->err()) {
+			warning("Discarding corrupt image cache index");
+			_diskCache.clear();
+			_diskCacheSlots.clear();
+			_diskCacheSize = 0;
+		}
+	}
+
+	delete in;
+}
+
+void ImageCache::saveDiskCacheIndex() {
+	if (!_diskCacheDirty)
+		return;
+
+	Common::WriteStream *out = _diskCacheDir.getChild(kDiskCacheIndexName).createWriteStream();
+	if (!out)
+		return;
+
+	out->writeUint32BE(kDiskCacheIndexMagic);
+	out->writeByte(kDiskCacheIndexVersion);
+	out->writeUint32LE(_diskCacheClock);
+	out->writeUint32LE(_diskCache.size());
+	for (DiskCacheMap::const_iterator i = _diskCache.begin(); i != _diskCache.end(); ++i) {
+		out->writeUint16LE(i->_key.size());
+		out->write(i->_key.c_str(), i->_key.size());
+		out->writeUint32LE(i->_value.slot);
+		out->writeUint32LE(i->_value.size);
+		out->writeUint32LE(i->_value.lastUse);
+	}
+
+	out->finalize();
+	if (out->err())
+		warning("Could not write image cache index");
+	delete out;
+
+	_diskCacheDirty = false;
+}
+
+} // End of namespace Sword25
@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SWORD25_IMAGECACHE_H
+#define SWORD25_IMAGECACHE_H
+
+#include "common/array.h"
+#include "common/fs.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/list.h"
+#include "common/str.h"
+#include "graphics/surface.h"
+
+#include "sword25/kernel/common.h"
+
+namespace Sword25 {
+
+/**
+ * Loads the PNG images of the game packages.
+ *
+ * Images can be prefetched: they are queued, and read and decoded one whole
+ * image at a time while the main loop is idle, so that loading them later
+ * only has to take the decoded surface. Optionally, decoded images are also
+ * stored in the cache directory, so that they do not need to be decoded
+ * again on the next run.
+ */
+class ImageCache {
+public:
+	ImageCache();
+	~ImageCache();
+
+	/**
+	 * Queues a PNG image for decoding while the main loop is idle.
+	 * @param fileName  The absolute filename of the image in the packages
+	 */
+	void prefetch(const Common::String &fileName);
+
+	/**
+	 * Reads and decodes the most recently prefetched image which has not
+	 * been decoded yet, if there is one. The image is decoded as a whole.
+	 * @return false if there was nothing left to decode
+	 */
+	bool decodeNext();
+
+	/**
+	 * Loads a PNG image, taking it from the prefetched images if possible.
+	 * @param fileName  The absolute filename of the image in the packages
+	 * @param dest      Receives the image (storage is allocated via create)
+	 * @return false in case of an error
+	 */
+	bool loadPNGImage(const Common::String &fileName, Graphics::Surface *dest);
+
+	/**
+	 * Drops all prefetched images which have not been loaded yet.
+	 */
+	void clear();
+
+private:
+	struct DecodedImage {
+		Graphics::Surface surface;
+		uint32 hash;
+		bool fromDiskCache;
+	};
+
+	typedef Common::HashMap<Common::String, DecodedImage> DecodedMap;
+
+	void addDecodedImage(const Common::String &fileName, const DecodedImage &image);
+	bool takeDecodedImage(const Common::String &fileName, DecodedImage &image);
+
+	/**
+	 * Reads an image from the packages, and decodes it or takes it from the
+	 * disk cache.
+	 * @param required  Whether failing to read the file is an error
+	 */
+	bool readImage(const Common::String &fileName, DecodedImage &image, bool required);
+
+	static uint32 hashFileData(const byte *fileData, uint fileSize);
+
+	/**
+	 * @name Disk cache
+	 *
+	 * The index records the cache file of each image, its size and when it
+	 * was last used, so that the least recently used files can be dropped
+	 * once the cache grows beyond its size limit. The cache files are
+	 * numbered slots. Dropped files cannot be deleted, so they are emptied
+	 * and their slot is reused by the next image written.
+	 */
+	//@{
+	struct DiskCacheEntry {
+		uint32 slot;
+		uint32 size;
+		uint32 lastUse;
+	};
+
+	typedef Common::HashMap<Common::String, DiskCacheEntry> DiskCacheMap;
+
+	static Common::String getDiskCacheName(uint32 slot);
+	uint32 allocateDiskCacheSlot();
+	bool readDiskCache(const Common::String &fileName, uint32 hash, Graphics::Surface *dest);
+	void writeDiskCache(const Common::String &fileName, uint32 hash, const Graphics::Surface &surface);
+	void evictDiskCache(uint32 size);
+	void dropDiskCacheFile(const Common::String &fileName);
+	void loadDiskCacheIndex();
+	void saveDiskCacheIndex();
+
+	bool _useDiskCache;
+	Common::FSNode _diskCacheDir;
+	DiskCacheMap _diskCache;
+	Common::Array<bool> _diskCacheSlots;
+	uint32 _diskCacheSize;
+	uint32 _diskCacheClock;
+	bool _diskCacheDirty;
+	//@}
+
+	Common::List<Common::String> _jobs;
+	DecodedMap _decoded;
+	Common::List<Common::String> _decodedOrder;
+	uint _decodedSize;
+};
+
+} // End of namespace Sword25
+
+#endif
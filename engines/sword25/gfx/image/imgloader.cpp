@@ -42,16 +42,20 @@ bool ImgLoader::decodePNGImage(const byte *fileDataPtr, uint fileSize, Graphics:
 	assert(dest);
 	Common::MemoryReadStream *fileStr = new Common::MemoryReadStream(fileDataPtr, fileSize, DisposeAfterUse::NO);
 
+	// This is also called for images which are only prefetched, so errors
+	// are left to the caller
 	::Image::PNGDecoder png;
-	if (!png.loadStream(*fileStr)) // the fileStr pointer, and thus pFileData will be deleted after this is done
-		error("Error while reading PNG image");
+	if (!png.loadStream(*fileStr)) { // the fileStr pointer, and thus pFileData will be deleted after this is done
+		delete fileStr;
+		return false;
+	}
 
 	const Graphics::Surface *sourceSurface = png.getSurface();
 	Graphics::Surface *pngSurface = sourceSurface->convertTo(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), png.getPalette());
 
-	dest->copyFrom(*pngSurface);
+	// Take over the converted pixels instead of copying them once more
+	*dest = *pngSurface;
 
-	pngSurface->free();
 	delete pngSurface;
 	delete fileStr;
 
@@ -35,6 +35,7 @@
 
 #include "common/savefile.h"
 #include "sword25/package/packagemanager.h"
+#include "sword25/gfx/image/imagecache.h"
 #include "sword25/gfx/image/imgloader.h"
 #include "sword25/gfx/image/renderedimage.h"
 
@@ -103,43 +104,32 @@ RenderedImage::RenderedImage(const Common::String &filename, bool &result) :
 	_isTransparent(true) {
 	result = false;
 
-	PackageManager *pPackage = Kernel::getInstance()->getPackage();
-	assert(pPackage);
-
 	_backSurface = Kernel::getInstance()->getGfx()->getSurface();
 
-	// Load file
-	byte *pFileData;
-	uint fileSize;
-
-	bool isPNG = true;
-
 	if (filename.hasPrefix("/saves")) {
-		pFileData = readSavegameThumbnail(filename, fileSize, isPNG);
+		// Load file
+		uint fileSize;
+		bool isPNG = true;
+		byte *pFileData = readSavegameThumbnail(filename, fileSize, isPNG);
+
+		// Uncompress the image
+		if (isPNG)
+			result = ImgLoader::decodePNGImage(pFileData, fileSize, &_surface);
+		else
+			result = ImgLoader::decodeThumbnailImage(pFileData, fileSize, &_surface);
+
+		// Cleanup FileData
+		delete[] pFileData;
 	} else {
-		pFileData = pPackage->getFile(filename, &fileSize);
+		// Load and uncompress the image, unless it has been prefetched
+		result = Kernel::getInstance()->getGfx()->getImageCache()->loadPNGImage(filename, &_surface);
 	}
 
-	if (!pFileData) {
-		error("File \"%s\" could not be loaded.", filename.c_str());
-		return;
-	}
-
-	// Uncompress the image
-	if (isPNG)
-		result = ImgLoader::decodePNGImage(pFileData, fileSize, &_surface);
-	else
-		result = ImgLoader::decodeThumbnailImage(pFileData, fileSize, &_surface);
-
 	if (!result) {
 		error("Could not decode image.");
-		delete[] pFileData;
 		return;
 	}
 
-	// Cleanup FileData
-	delete[] pFileData;
-
 	_doCleanup = true;
 
 #if defined(SCUMM_LITTLE_ENDIAN)
@@ -30,7 +30,7 @@
  */
 
 #include "sword25/package/packagemanager.h"
-#include "sword25/gfx/image/imgloader.h"
+#include "sword25/gfx/image/imagecache.h"
 #include "sword25/gfx/image/swimage.h"
 
 namespace Sword25 {
@@ -38,27 +38,12 @@ namespace Sword25 {
 SWImage::SWImage(const Common::String &filename, bool &result) : _image() {
 	result = false;
 
-	PackageManager *pPackage = Kernel::getInstance()->getPackage();
-	assert(pPackage);
-
-	// Load file
-	byte *pFileData;
-	uint fileSize;
-	pFileData = pPackage->getFile(filename, &fileSize);
-	if (!pFileData) {
-		error("File \"%s\" could not be loaded.", filename.c_str());
-		return;
-	}
-
-	// Uncompress the image
-	if (!ImgLoader::decodePNGImage(pFileData, fileSize, &_image)) {
+	// Load and uncompress the image, unless it has been prefetched
+	if (!Kernel::getInstance()->getGfx()->getImageCache()->loadPNGImage(filename, &_image)) {
 		error("Could not decode image.");
 		return;
 	}
 
-	// Cleanup FileData
-	delete[] pFileData;
-
 	result = true;
 	return;
 }
@@ -34,6 +34,8 @@
 #include "sword25/kernel/filesystemutil.h"
 #include "sword25/kernel/resmanager.h"
 #include "sword25/kernel/persistenceservice.h"
+#include "sword25/gfx/graphicengine.h"
+#include "sword25/gfx/image/imagecache.h"
 #include "sword25/script/script.h"
 #include "sword25/script/luabindhelper.h"
 
@@ -257,7 +259,16 @@ static int processMessages(lua_State *L) {
 	// to the closeWanted() opcode; see also the TODO comment in there.
 
 	lua_pushbooleancpp(L, !Engine::shouldQuit());
-	g_system->delayMillis(10);
+
+	// Spend the time of a frame which is left decoding prefetched images,
+	// one at a time
+	const uint32 start = g_system->getMillis();
+	ImageCache *imageCache = Kernel::getInstance()->getGfx()->getImageCache();
+	while (g_system->getMillis() - start < 10 && imageCache->decodeNext())
+		;
+	const uint32 elapsed = g_system->getMillis() - start;
+	if (elapsed < 10)
+		g_system->delayMillis(10 - elapsed);
 
 	return 1;
 }
@@ -313,6 +324,9 @@ static int precacheResource(lua_State *L) {
 #ifdef PRECACHE_RESOURCES
 	lua_pushbooleancpp(L, pResource->precacheResource(luaL_checkstring(L, 1)));
 #else
+	// Decode the resource while the main loop is idle instead, so that the
+	// scene does not stall when it is used
+	pResource->prefetchResource(luaL_checkstring(L, 1));
 	lua_pushbooleancpp(L, true);
 #endif
 
@@ -334,15 +348,24 @@ static int forcePrecacheResource(lua_State *L) {
 	return 1;
 }
 
+static int prefetchResource(lua_State *L) {
+	Kernel *pKernel = Kernel::getInstance();
+	assert(pKernel);
+	ResourceManager *pResource = pKernel->getResourceManager();
+	assert(pResource);
+
+	pResource->prefetchResource(luaL_checkstring(L, 1));
+
+	return 0;
+}
+
 static int getMaxMemoryUsage(lua_State *L) {
 	Kernel *pKernel = Kernel::getInstance();
 	assert(pKernel);
 	ResourceManager *pResource = pKernel->getResourceManager();
 	assert(pResource);
 
-	// This is used for debugging, so it doesn't really matter.
-	// The default value set by the scripts is 256000000 bytes
-	lua_pushnumber(L, 256000000);
+	lua_pushnumber(L, pResource->getMaxMemoryUsage());
 
 	return 1;
 }
@@ -353,8 +376,8 @@ static int setMaxMemoryUsage(lua_State *L) {
 	ResourceManager *pResource = pKernel->getResourceManager();
 	assert(pResource);
 
-	// This call is ignored, we set a limit on the number of
-	// simultaneous resources loaded instead.
+	// The number of simultaneously loaded resources is limited as well
+	pResource->setMaxMemoryUsage(static_cast<uint>(luaL_checknumber(L, 1)));
 
 	return 0;
 }
@@ -386,6 +409,7 @@ static const char *RESOURCE_LIBRARY_NAME = "Resource";
 static const luaL_reg RESOURCE_FUNCTIONS[] = {
 	{"PrecacheResource", precacheResource},
 	{"ForcePrecacheResource", forcePrecacheResource},
+	{"PrefetchResource", prefetchResource},
 	{"GetMaxMemoryUsage", getMaxMemoryUsage},
 	{"SetMaxMemoryUsage", setMaxMemoryUsage},
 	{"EmptyCache", emptyCache},
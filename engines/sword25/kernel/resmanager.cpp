@@ -46,6 +46,9 @@ namespace Sword25 {
 // are loaded, the resource manager will start purging resources till it
 // hits the minimum limit above
 #define SWORD25_RESOURCECACHE_MAX 500
+// Likewise, if the loaded resources use more memory than the maximum set by
+// the scripts, resources are purged till they use this percentage of it
+#define SWORD25_RESOURCECACHE_MEMORY_MIN_PERCENT 75
 
 ResourceManager::~ResourceManager() {
 	// Clear all unlocked resources
@@ -87,9 +90,15 @@ bool ResourceManager::registerResourceService(ResourceService *pService) {
  */
 void ResourceManager::deleteResourcesIfNecessary() {
 	// If enough memory is available, or no resources are loaded, then the function can immediately end
-	if (_resources.size() < SWORD25_RESOURCECACHE_MAX)
+	const bool tooManyResources = _resources.size() >= SWORD25_RESOURCECACHE_MAX;
+	const bool tooMuchMemory = _usedMemory >= _maxMemoryUsage;
+	if ((!tooManyResources && !tooMuchMemory) || _resources.empty())
 		return;
 
+	// Purge down to the minimum of whichever limit has been hit
+	const uint countLimit = tooManyResources ? SWORD25_RESOURCECACHE_MIN : SWORD25_RESOURCECACHE_MAX;
+	const uint memoryLimit = tooMuchMemory ? _maxMemoryUsage / 100 * SWORD25_RESOURCECACHE_MEMORY_MIN_PERCENT : _maxMemoryUsage;
+
 	// Keep deleting resources until the memory usage of the process falls below the set maximum limit.
 	// The list is processed backwards in order to first release those resources that have been
 	// not been accessed for the longest
@@ -100,14 +109,17 @@ void ResourceManager::deleteResourcesIfNecessary() {
 		// The resource may be released only if it isn't locked
 		if ((*iter)->getLockCount() == 0)
 			iter = deleteResource(*iter);
-	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
+	} while (iter != _resources.begin() && (_resources.size() >= countLimit || _usedMemory > memoryLimit));
+
+	if (tooMuchMemory && _usedMemory > memoryLimit)
+		debugC(kDebugResource, "Locked resources use %u bytes, more than the limit of %u", _usedMemory, memoryLimit);
 
 	// Are we still above the minimum? If yes, then start releasing locked resources
 	// FIXME: This code shouldn't be needed at all, but it seems like there is a bug
 	// in the resource lock code, and resources are not unlocked when changing rooms.
 	// Only image/animation resources are unlocked forcibly, thus this shouldn't have
 	// any impact on the game itself.
-	if (_resources.size() <= SWORD25_RESOURCECACHE_MIN)
+	if (!tooManyResources || _resources.size() <= SWORD25_RESOURCECACHE_MIN)
 		return;
 
 	iter = _resources.end();
@@ -220,6 +232,24 @@ bool ResourceManager::precacheResource(const Common::String &fileName, bool forc
 
 #endif
 
+/**
+ * Starts loading a resource ahead of time, if its resource service supports that.
+ * @param FileName      The filename of the resource to be prefetched
+ */
+void ResourceManager::prefetchResource(const Common::String &fileName) {
+	// Get the absolute path to the file
+	Common::String uniqueFileName = getUniqueFileName(fileName);
+	if (uniqueFileName.empty() || getResource(uniqueFileName))
+		return;
+
+	for (uint i = 0; i < _resourceServices.size(); ++i) {
+		if (_resourceServices[i]->canLoadResource(uniqueFileName)) {
+			_resourceServices[i]->prefetchResource(uniqueFileName);
+			return;
+		}
+	}
+}
+
 /**
  * Moves a resource to the top of the resource list
  * @param pResource     The resource
@@ -257,6 +287,10 @@ Resource *ResourceManager::loadResource(const Common::String &fileName) {
 			_resources.push_front(pResource);
 			pResource->_iterator = _resources.begin();
 
+			// Account for its memory
+			pResource->_memoryUsage = pResource->getMemoryUsage();
+			_usedMemory += pResource->_memoryUsage;
+
 			// Also store the resource in the hash table for quick lookup
 			_resourceHashMap[pResource->getFileName()] = pResource;
 
@@ -296,6 +330,9 @@ Common::List<Resource *>::iterator ResourceManager::deleteResource(Resource *pRe
 	// Remove the resource from the hash table
 	_resourceHashMap.erase(pResource->_fileName);
 
+	// Release its memory
+	_usedMemory -= pResource->_memoryUsage;
+
 	// Delete the resource from the resource list
 	Common::List<Resource *>::iterator result = _resources.erase(pResource->_iterator);
 
@@ -66,6 +66,13 @@ public:
 	bool precacheResource(const Common::String &fileName, bool forceReload = false);
 #endif
 
+	/**
+	 * Starts loading a resource ahead of time, if its resource service supports that.
+	 * A later requestResource() for the same file then finishes quickly.
+	 * @param FileName      The filename of the resource to be prefetched
+	 */
+	void prefetchResource(const Common::String &fileName);
+
 	/**
 	 * Registers a RegisterResourceService. This method is the constructor of
 	 * BS_ResourceService, and thus helps all resource services in the ResourceManager list
@@ -88,13 +95,34 @@ public:
 	 */
 	void dumpLockedResources();
 
+	/**
+	 * Sets the number of bytes the loaded resources may use before unlocked ones are released
+	 */
+	void setMaxMemoryUsage(uint maxMemoryUsage) {
+		_maxMemoryUsage = maxMemoryUsage;
+		deleteResourcesIfNecessary();
+	}
+
+	uint getMaxMemoryUsage() const {
+		return _maxMemoryUsage;
+	}
+
+	/**
+	 * Returns the number of bytes used by the loaded resources
+	 */
+	uint getUsedMemory() const {
+		return _usedMemory;
+	}
+
 private:
 	/**
 	 * Creates a new resource manager
 	 * Only the BS_Kernel class can generate copies this class. Thus, the constructor is private
 	 */
 	ResourceManager(Kernel *pKernel) :
-		_kernelPtr(pKernel)
+		_kernelPtr(pKernel),
+		_maxMemoryUsage(256000000),
+		_usedMemory(0)
 	{}
 	virtual ~ResourceManager();
 
@@ -135,6 +163,8 @@ private:
 	void deleteResourcesIfNecessary();
 
 	Kernel *_kernelPtr;
+	uint _maxMemoryUsage;
+	uint _usedMemory;
 	Common::Array<ResourceService *> _resourceServices;
 	Common::List<Resource *> _resources;
 	typedef Common::HashMap<Common::String, Resource *> ResMap;
@@ -63,6 +63,12 @@ public:
 	 */
 	virtual bool canLoadResource(const Common::String &fileName) = 0;
 
+	/**
+	 * Prepares loading a resource ahead of time, if the service supports it
+	 * @param FileName  The unique filename of the resource
+	 */
+	virtual void prefetchResource(const Common::String &fileName) {}
+
 };
 
 } // End of namespace Sword25
@@ -21,6 +21,7 @@
  */
 
 #include "titanic/debugger.h"
+#include "titanic/core/dont_save_file_item.h"
 #include "titanic/core/node_item.h"
 #include "titanic/core/room_item.h"
 #include "titanic/core/tree_item.h"
@@ -29,6 +30,7 @@
 #include "titanic/game/movie_tester.h"
 #include "titanic/main_game_window.h"
 #include "titanic/pet_control/pet_control.h"
+#include "titanic/star_control/star_control.h"
 #include "titanic/support/movie.h"
 #include "titanic/titanic.h"
 #include "common/str-array.h"
@@ -45,6 +47,7 @@ Debugger::Debugger(TitanicEngine *vm) : GUI::Debugger(), _vm(vm) {
 	registerCmd("sound",		WRAP_METHOD(Debugger, cmdSound));
 	registerCmd("cheat",        WRAP_METHOD(Debugger, cmdCheat));
 	registerCmd("frame",        WRAP_METHOD(Debugger, cmdFrame));
+	registerCmd("starfield",    WRAP_METHOD(Debugger, cmdStarfield));
 }
 
 int Debugger::strToInt(const char *s) {
@@ -371,4 +374,61 @@ bool Debugger::cmdFrame(int argc, const char **argv) {
 	}
 }
 
+bool Debugger::cmdStarfield(int argc, const char **argv) {
+	CGameManager &gameManager = *g_vm->_window->_gameManager;
+	CDontSaveFileItem *dontSave = g_vm->_window->_project->getDontSaveFileItem();
+	CStarControl *starControl = dontSave ? dynamic_cast<CStarControl *>(
+		dontSave->findChildInstanceOf(CStarControl::_type)) : nullptr;
+	if (!starControl && gameManager.getView())
+		starControl = dynamic_cast<CStarControl *>(
+			gameManager.getView()->findChildInstanceOf(CStarControl::_type));
+
+	if (!starControl) {
+		debugPrintf("Star control not found\n");
+		return true;
+	}
+
+	CStarField *starField = starControl->getStarField();
+	if (argc == 3 && !strcmp(argv[1], "record")) {
+		if (!strcmp(argv[2], "on")) {
+			starField->_recording = true;
+		} else if (!strcmp(argv[2], "off")) {
+			starField->_recording = false;
+		} else if (!strcmp(argv[2], "clear")) {
+			starField->_recordedFrames.clear();
+		} else {
+			debugPrintf("Invalid parameter %s\n", argv[2]);
+			return true;
+		}
+
+		debugPrintf("Recording is %s, %d frames recorded\n",
+			starField->_recording ? "on" : "off", starField->_recordedFrames.size());
+		return true;
+	} else if ((argc == 2 || argc == 3) && !strcmp(argv[1], "bench")) {
+		if (starField->_recordedFrames.empty()) {
+			debugPrintf("No frames recorded, use %s record on first\n", argv[0]);
+			return true;
+		}
+
+		int repeat = (argc == 3) ? strToInt(argv[2]) : 10;
+		if (repeat < 1) {
+			debugPrintf("Invalid repeat count %s\n", argv[2]);
+			return true;
+		}
+
+		CStarBenchmarkResult result;
+		starField->benchmarkDraw(repeat, result);
+		uint frames = result._frames * repeat;
+		debugPrintf("%d frames, %d times\n", result._frames, repeat);
+		debugPrintf("Reference: %d us per frame\n", result._referenceTime / frames);
+		debugPrintf("Catalog: %d us per frame\n", result._catalogTime / frames);
+		debugPrintf("Differing frames: %d\n", result._mismatches);
+		return true;
+	}
+
+	debugPrintf("%s record [on | off | clear]\n", argv[0]);
+	debugPrintf("%s bench [<repeat count>]\n", argv[0]);
+	return true;
+}
+
 } // End of namespace Titanic
@@ -120,6 +120,11 @@ private:
 	 * Set the movie frame for a given object
 	 */
 	bool cmdFrame(int argc, const char **argv);
+
+	/**
+	 * Records the drawn starfield frames, or replays them as a benchmark
+	 */
+	bool cmdStarfield(int argc, const char **argv);
 protected:
 	TitanicEngine *_vm;
 public:
@@ -444,6 +444,7 @@ MODULE_OBJS := \
 	star_control/marked_camera_mover.o \
 	star_control/matrix_transform.o \
 	star_control/orientation_changer.o \
+	star_control/star_catalog.o \
 	star_control/star_camera.o \
 	star_control/star_closeup.o \
 	star_control/star_crosshairs.o \
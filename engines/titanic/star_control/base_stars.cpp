@@ -24,9 +24,13 @@
 #include "titanic/star_control/star_camera.h"
 #include "titanic/star_control/star_closeup.h"
 #include "titanic/star_control/star_ref.h"
+#include "titanic/star_control/surface_area.h"
 #include "titanic/support/files_manager.h"
+#include "titanic/support/screen_manager.h"
 #include "titanic/support/simple_file.h"
+#include "titanic/support/video_surface.h"
 #include "titanic/titanic.h"
+#include "common/system.h"
 
 namespace Titanic {
 
@@ -59,12 +63,19 @@ bool CBaseStarEntry::operator==(const CBaseStarEntry &s) const {
 
 /*------------------------------------------------------------------------*/
 
+CStarProjection::CStarProjection() : _threshold(0.0), _value1(0.0), _value2(0.0),
+		_value3(0.0), _value4(0.0), _starColor(WHITE), _width(0), _height(0) {
+}
+
+/*------------------------------------------------------------------------*/
+
 CBaseStars::CBaseStars() : _minVal(0.0), _maxVal(1.0), _range(0.0),
-		_value1(0.0), _value2(0.0), _value3(0.0), _value4(0.0) {
+		_value1(0.0), _value2(0.0), _value3(0.0), _value4(0.0), _recording(false) {
 }
 
 void CBaseStars::clear() {
 	_data.clear();
+	_catalog.clear();
 }
 
 void CBaseStars::initialize() {
@@ -102,6 +113,8 @@ void CBaseStars::loadData(Common::SeekableReadStream &s) {
 	// Iterate through reading the data for each entry
 	for (uint idx = 0; idx < count; ++idx)
 		_data[idx].load(s);
+
+	_catalog.build(_data);
 }
 
 void CBaseStars::loadData(const CString &resName) {
@@ -127,68 +140,109 @@ void CBaseStars::resetEntry(CBaseStarEntry &entry) {
 }
 
 void CBaseStars::draw(CSurfaceArea *surfaceArea, CStarCamera *camera, CStarCloseup *closeup) {
-	if (!_data.empty()) {
-		switch (camera->getStarColor()) {
-		case WHITE: // draw white, green, and red stars (mostly white)
-			switch (surfaceArea->_bpp) {
-			case 1:
-				draw1(surfaceArea, camera, closeup);
-				break;
-			case 2:
-				draw2(surfaceArea, camera, closeup);
-				break;
-			default:
-				break;
-			}
-			break;
+	if (_data.empty())
+		return;
 
-		case PINK: // draw pink stars
-			switch (surfaceArea->_bpp) {
-			case 1:
-				draw3(surfaceArea, camera, closeup);
-				break;
-			case 2:
-				draw4(surfaceArea, camera, closeup);
-				break;
-			default:
-				break;
-			}
+	CStarProjection proj;
+	proj._pose = camera->getPose();
+	camera->getRelativeXCenterPixels(&_value1, &_value2, &_value3, &_value4);
+	proj._value1 = _value1;
+	proj._value2 = _value2;
+	proj._value3 = _value3;
+	proj._value4 = _value4;
+	proj._threshold = camera->getThreshold();
+	proj._starColor = camera->getStarColor();
+	proj._width = surfaceArea->_width;
+	proj._height = surfaceArea->_height;
+	proj._centroid = surfaceArea->_centroid + FPoint(0.5, 0.5);
+
+	if (_recording)
+		_recordedFrames.push_back(proj);
+
+	drawStars(surfaceArea, proj, camera, closeup, true);
+}
+
+void CBaseStars::drawStars(CSurfaceArea *surfaceArea, const CStarProjection &proj,
+		CStarCamera *camera, CStarCloseup *closeup, bool useCatalog) {
+	if ((proj._starColor != WHITE && proj._starColor != PINK) ||
+			(surfaceArea->_bpp != 1 && surfaceArea->_bpp != 2))
+		return;
+
+	// Find the stars in front of the camera. The catalog also leaves out
+	// groups of stars that are entirely out of view
+	double minVal = proj._threshold - 9216.0;
+	if (useCatalog && _catalog.size() == _data.size()) {
+		_catalog.findCandidates(proj, minVal, _candidates);
+	} else {
+		_candidates.resize(0);
+		for (uint idx = 0; idx < _data.size(); ++idx) {
+			const FVector &vector = _data[idx]._position;
+			CStarCandidate candidate;
+			CStarCatalog::transform(proj._pose, vector._x, vector._y, vector._z,
+				candidate._x, candidate._y, candidate._z);
+			if (candidate._z <= minVal)
+				continue;
+
+			candidate._index = idx;
+			_candidates.push_back(candidate);
+		}
+	}
+
+	switch (proj._starColor) {
+	case WHITE: // draw white, green, and red stars (mostly white)
+		switch (surfaceArea->_bpp) {
+		case 1:
+			draw1(surfaceArea, proj, camera, closeup);
+			break;
+		case 2:
+			draw2(surfaceArea, proj, camera, closeup);
+			break;
+		default:
 			break;
+		}
+		break;
 
+	case PINK: // draw pink stars
+		switch (surfaceArea->_bpp) {
+		case 1:
+			draw3(surfaceArea, proj, camera, closeup);
+			break;
+		case 2:
+			draw4(surfaceArea, proj, camera, closeup);
+			break;
 		default:
 			break;
 		}
+		break;
+
+	default:
+		break;
 	}
 }
 
-void CBaseStars::draw1(CSurfaceArea *surfaceArea, CStarCamera *camera, CStarCloseup *closeup) {
-	FPose pose = camera->getPose();
-	camera->getRelativeXCenterPixels(&_value1, &_value2, &_value3, &_value4);
+void CBaseStars::draw1(CSurfaceArea *surfaceArea, const CStarProjection &proj, CStarCamera *camera, CStarCloseup *closeup) {
+	const FPose &pose = proj._pose;
 
 	const double MAX_VAL = 1.0e9 * 1.0e9;
-	FPoint centroid = surfaceArea->_centroid + FPoint(0.5, 0.5);
-	double threshold = camera->getThreshold();
-	double minVal = threshold - 9216.0;
-	int width1 = surfaceArea->_width - 1;
-	int height1 = surfaceArea->_height - 1;
-	double *v1Ptr = &_value1, *v2Ptr = &_value2;
+	const FPoint &centroid = proj._centroid;
+	double threshold = proj._threshold;
+	int width1 = proj._width - 1;
+	int height1 = proj._height - 1;
+	const double *v1Ptr = &proj._value1, *v2Ptr = &proj._value2;
 	double tempX, tempY, tempZ, total2;
 
-	for (uint idx = 0; idx < _data.size(); ++idx) {
-		CBaseStarEntry &entry = _data[idx];
-		const FVector &vector = entry._position;
-		tempZ = vector._x * pose._row1._z + vector._y * pose._row2._z
-			+ vector._z * pose._row3._z + pose._vector._z;
-		if (tempZ <= minVal)
-			continue;
-
-		tempY = vector._x * pose._row1._y + vector._y * pose._row2._y + vector._z * pose._row3._y + pose._vector._y;
-		tempX = vector._x * pose._row1._x + vector._y * pose._row2._x + vector._z * pose._row3._x + pose._vector._x;
-		total2 = tempY * tempY + tempX * tempX + tempZ * tempZ; 
+	for (uint idx = 0; idx < _candidates.size(); ++idx) {
+		const CStarCandidate &candidate = _candidates[idx];
+		const CBaseStarEntry &entry = _data[candidate._index];
+		tempX = candidate._x;
+		tempY = candidate._y;
+		tempZ = candidate._z;
+		total2 = tempY * tempY + tempX * tempX + tempZ * tempZ;
 
 		if (total2 < 1.0e12) {
-			closeup->draw(pose, vector, FVector(centroid._x, centroid._y, total2),
-				surfaceArea, camera);
+			if (closeup)
+				closeup->draw(pose, entry._position, FVector(centroid._x, centroid._y, total2),
+					surfaceArea, camera);
 			continue;
 		}
 
@@ -246,34 +300,29 @@ void CBaseStars::draw1(CSurfaceArea *surfaceArea, CStarCamera *camera, CStarClos
 	}
 }
 
-void CBaseStars::draw2(CSurfaceArea *surfaceArea, CStarCamera *camera, CStarCloseup *closeup) {
-	FPose pose = camera->getPose();
-	camera->getRelativeXCenterPixels(&_value1, &_value2, &_value3, &_value4);
+void CBaseStars::draw2(CSurfaceArea *surfaceArea, const CStarProjection &proj, CStarCamera *camera, CStarCloseup *closeup) {
+	const FPose &pose = proj._pose;
 
 	const double MAX_VAL = 1.0e9 * 1.0e9;
-	FPoint centroid = surfaceArea->_centroid + FPoint(0.5, 0.5);
-	double threshold = camera->getThreshold();
-	double minVal = threshold - 9216.0;
-	int width1 = surfaceArea->_width - 1;
-	int height1 = surfaceArea->_height - 1;
-	double *v1Ptr = &_value1, *v2Ptr = &_value2;
+	const FPoint &centroid = proj._centroid;
+	double threshold = proj._threshold;
+	int width1 = proj._width - 1;
+	int height1 = proj._height - 1;
+	const double *v1Ptr = &proj._value1, *v2Ptr = &proj._value2;
 	double tempX, tempY, tempZ, total2;
 
-	for (uint idx = 0; idx < _data.size(); ++idx) {
-		CBaseStarEntry &entry = _data[idx];
-		const FVector &vector = entry._position;
-		tempZ = vector._x * pose._row1._z + vector._y * pose._row2._z
-			+ vector._z * pose._row3._z + pose._vector._z;
-		if (tempZ <= minVal)
-			continue;
-
-		tempY = vector._x * pose._row1._y + vector._y * pose._row2._y + vector._z * pose._row3._y + pose._vector._y;
-		tempX = vector._x * pose._row1._x + vector._y * pose._row2._x + vector._z * pose._row3._x + pose._vector._x;
+	for (uint idx = 0; idx < _candidates.size(); ++idx) {
+		const CStarCandidate &candidate = _candidates[idx];
+		const CBaseStarEntry &entry = _data[candidate._index];
+		tempX = candidate._x;
+		tempY = candidate._y;
+		tempZ = candidate._z;
 		total2 = tempY * tempY + tempX * tempX + tempZ * tempZ;
 
 		if (total2 < 1.0e12) {
-			closeup->draw(pose, vector, FVector(centroid._x, centroid._y, total2),
-				surfaceArea, camera);
+			if (closeup)
+				closeup->draw(pose, entry._position, FVector(centroid._x, centroid._y, total2),
+					surfaceArea, camera);
 			continue;
 		}
 
@@ -332,37 +381,32 @@ void CBaseStars::draw2(CSurfaceArea *surfaceArea, CStarCamera *camera, CStarClos
 	}
 }
 
-void CBaseStars::draw3(CSurfaceArea *surfaceArea, CStarCamera *camera, CStarCloseup *closeup) {
-	FPose pose = camera->getPose();
-	camera->getRelativeXCenterPixels(&_value1, &_value2, &_value3, &_value4);
+void CBaseStars::draw3(CSurfaceArea *surfaceArea, const CStarProjection &proj, CStarCamera *camera, CStarCloseup *closeup) {
+	const FPose &pose = proj._pose;
 
 	const double MAX_VAL = 1.0e9 * 1.0e9;
-	FPoint centroid = surfaceArea->_centroid + FPoint(0.5, 0.5);
-	double threshold = camera->getThreshold();
-	double minVal = threshold - 9216.0;
-	int width1 = surfaceArea->_width - 1;
-	int height1 = surfaceArea->_height - 1;
-	double *v1Ptr = &_value1, *v2Ptr = &_value2;
-	double *v3Ptr = &_value3, *v4Ptr = &_value4;
+	const FPoint &centroid = proj._centroid;
+	double threshold = proj._threshold;
+	int width1 = proj._width - 1;
+	int height1 = proj._height - 1;
+	const double *v1Ptr = &proj._value1, *v2Ptr = &proj._value2;
+	const double *v3Ptr = &proj._value3, *v4Ptr = &proj._value4;
 	double tempX, tempY, tempZ, total2, sVal;
 	int xStart, yStart, rgb;
 	uint16 *pixelP;
 
-	for (uint idx = 0; idx < _data.size(); ++idx) {
-		CBaseStarEntry &entry = _data[idx];
-		const FVector &vector = entry._position;
-		tempZ = vector._x * pose._row1._z + vector._y * pose._row2._z
-			+ vector._z * pose._row3._z + pose._vector._z;
-		if (tempZ <= minVal)
-			continue;
-
-		tempY = vector._x * pose._row1._y + vector._y * pose._row2._y + vector._z * pose._row3._y + pose._vector._y;
-		tempX = vector._x * pose._row1._x + vector._y * pose._row2._x + vector._z * pose._row3._x + pose._vector._x;
+	for (uint idx = 0; idx < _candidates.size(); ++idx) {
+		const CStarCandidate &candidate = _candidates[idx];
+		const CBaseStarEntry &entry = _data[candidate._index];
+		tempX = candidate._x;
+		tempY = candidate._y;
+		tempZ = candidate._z;
 		total2 = tempY * tempY + tempX * tempX + tempZ * tempZ;
 
 		if (total2 < 1.0e12) {
-			closeup->draw(pose, vector, FVector(centroid._x, centroid._y, total2),
-				surfaceArea, camera);
+			if (closeup)
+				closeup->draw(pose, entry._position, FVector(centroid._x, centroid._y, total2),
+					surfaceArea, camera);
 			continue;
 		}
 
@@ -439,38 +483,32 @@ void CBaseStars::draw3(CSurfaceArea *surfaceArea, CStarCamera *camera, CStarClos
 	}
 }
 
-void CBaseStars::draw4(CSurfaceArea *surfaceArea, CStarCamera *camera, CStarCloseup *closeup) {
-	FPose pose = camera->getPose();
-	camera->getRelativeXCenterPixels(&_value1, &_value2, &_value3, &_value4);
+void CBaseStars::draw4(CSurfaceArea *surfaceArea, const CStarProjection &proj, CStarCamera *camera, CStarCloseup *closeup) {
+	const FPose &pose = proj._pose;
 
 	const double MAX_VAL = 1.0e9 * 1.0e9;
-	FPoint centroid = surfaceArea->_centroid + FPoint(0.5, 0.5);
-	double threshold = camera->getThreshold();
-	double minVal = threshold - 9216.0;
-	int width1 = surfaceArea->_width - 1;
-	int height1 = surfaceArea->_height - 1;
-	double *v1Ptr = &_value1, *v2Ptr = &_value2, *v3Ptr = &_value3, *v4Ptr = &_value4;
+	const FPoint &centroid = proj._centroid;
+	double threshold = proj._threshold;
+	int width1 = proj._width - 1;
+	int height1 = proj._height - 1;
+	const double *v1Ptr = &proj._value1, *v2Ptr = &proj._value2, *v3Ptr = &proj._value3, *v4Ptr = &proj._value4;
 	double tempX, tempY, tempZ, total2, sVal;
 	int xStart, yStart, rgb;
 	uint16 *pixelP;
 
-	for (uint idx = 0; idx < _data.size(); ++idx) {
-		const CBaseStarEntry &entry = _data[idx];
-		const FVector &vector = entry._position;
-
-		tempZ = vector._x * pose._row1._z + vector._y * pose._row2._z
-			+ vector._z * pose._row3._z + pose._vector._z;
-		if (tempZ <= minVal)
-			continue;
-	
-		tempY = vector._x * pose._row1._y + vector._y * pose._row2._y + vector._z * pose._row3._y + pose._vector._y;
-		tempX = vector._x * pose._row1._x + vector._y * pose._row2._x + vector._z * pose._row3._x + pose._vector._x;
+	for (uint idx = 0; idx < _candidates.size(); ++idx) {
+		const CStarCandidate &candidate = _candidates[idx];
+		const CBaseStarEntry &entry = _data[candidate._index];
+		tempX = candidate._x;
+		tempY = candidate._y;
+		tempZ = candidate._z;
 		total2 = tempY * tempY + tempX * tempX + tempZ * tempZ;
 
 		if (total2 < 1.0e12) {
 			// We're in close proximity to the given star, so draw a closeup of it
-			closeup->draw(pose, vector, FVector(centroid._x, centroid._y, total2),
-				surfaceArea, camera);
+			if (closeup)
+				closeup->draw(pose, entry._position, FVector(centroid._x, centroid._y, total2),
+					surfaceArea, camera);
 			continue;
 		}
 
@@ -560,6 +598,60 @@ int CBaseStars::baseFn2(CSurfaceArea *surfaceArea, CStarCamera *camera) {
 	return ref._index;
 }
 
+void CBaseStars::benchmarkDraw(uint repeat, CStarBenchmarkResult &result) {
+	result = CStarBenchmarkResult();
+	if (_recordedFrames.empty() || _data.empty())
+		return;
+
+	int width = 0, height = 0;
+	for (uint idx = 0; idx < _recordedFrames.size(); ++idx) {
+		width = MAX(width, _recordedFrames[idx]._width);
+		height = MAX(height, _recordedFrames[idx]._height);
+	}
+
+	CVideoSurface *referenceSurface = g_vm->_screenManager->createSurface(width, height);
+	CVideoSurface *catalogSurface = g_vm->_screenManager->createSurface(width, height);
+	referenceSurface->lock();
+	catalogSurface->lock();
+	CSurfaceArea referenceArea(referenceSurface);
+	CSurfaceArea catalogArea(catalogSurface);
+	uint frameSize = referenceArea._pitch * height;
+
+	// Compare the frames drawn both ways. Closeups are left out, as they
+	// don't depend on how the stars were found
+	for (uint idx = 0; idx < _recordedFrames.size(); ++idx) {
+		memset(referenceArea._pixelsPtr, 0, frameSize);
+		memset(catalogArea._pixelsPtr, 0, frameSize);
+		drawStars(&referenceArea, _recordedFrames[idx], nullptr, nullptr, false);
+		drawStars(&catalogArea, _recordedFrames[idx], nullptr, nullptr, true);
+		if (memcmp(referenceArea._pixelsPtr, catalogArea._pixelsPtr, frameSize))
+			++result._mismatches;
+	}
+
+	for (int pass = 0; pass < 2; ++pass) {
+		CSurfaceArea &surfaceArea = pass ? catalogArea : referenceArea;
+		uint64 startTime = g_system->getMicros();
+		for (uint count = 0; count < repeat; ++count) {
+			for (uint idx = 0; idx < _recordedFrames.size(); ++idx) {
+				memset(surfaceArea._pixelsPtr, 0, frameSize);
+				drawStars(&surfaceArea, _recordedFrames[idx], nullptr, nullptr, pass != 0);
+			}
+		}
+
+		uint time = (uint)(g_system->getMicros() - startTime);
+		if (pass)
+			result._catalogTime = time;
+		else
+			result._referenceTime = time;
+	}
+
+	result._frames = _recordedFrames.size();
+	referenceSurface->unlock();
+	catalogSurface->unlock();
+	delete referenceSurface;
+	delete catalogSurface;
+}
+
 /*------------------------------------------------------------------------*/
 
 void CStarVector::apply() {
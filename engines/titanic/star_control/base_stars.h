@@ -23,7 +23,10 @@
 #ifndef TITANIC_BASE_STARS_H
 #define TITANIC_BASE_STARS_H
 
+#include "titanic/star_control/fpoint.h"
+#include "titanic/star_control/fpose.h"
 #include "titanic/star_control/frange.h" // class Fvector
+#include "titanic/star_control/star_catalog.h"
 #include "common/array.h"
 
 namespace Common {
@@ -34,6 +37,13 @@ namespace Titanic {
 
 enum StarMode { MODE_STARFIELD = 0, MODE_PHOTO = 1 };
 
+/**
+ * The color of the stars when drawn (CBaseStars::draw)
+ * For starview it should be white
+ * For skyview it should be pink
+ */
+enum StarColor { WHITE = 0, PINK = 2 };
+
 class CStarCamera;
 class CStarCloseup;
 class CString;
@@ -69,15 +79,62 @@ struct CStarPosition : public Common::Point {
 	}
 };
 
+/**
+ * Everything the stars of one frame are projected with: the camera pose
+ * and the values the camera provides, and the size of the surface
+ */
+struct CStarProjection {
+	FPose _pose;
+	double _threshold;
+	double _value1, _value2;
+	double _value3, _value4;
+	StarColor _starColor;
+	int _width, _height;
+	FPoint _centroid;
+
+	CStarProjection();
+};
+
+/**
+ * A star in front of the camera, with its position in camera space
+ */
+struct CStarCandidate {
+	uint _index;
+	float _x, _y, _z;
+};
+
+/**
+ * Result of CBaseStars::benchmarkDraw, with the times in microseconds
+ */
+struct CStarBenchmarkResult {
+	uint _frames;
+	uint _referenceTime;
+	uint _catalogTime;
+	uint _mismatches;
+
+	CStarBenchmarkResult() : _frames(0), _referenceTime(0), _catalogTime(0), _mismatches(0) {}
+};
+
 /**
  * Base class for views that draw a set of stars in simulated 3D space
  */
 class CBaseStars {
 private:
-	void draw1(CSurfaceArea *surfaceArea, CStarCamera *camera, CStarCloseup *closeup);
-	void draw2(CSurfaceArea *surfaceArea, CStarCamera *camera, CStarCloseup *closeup);
-	void draw3(CSurfaceArea *surfaceArea, CStarCamera *camera, CStarCloseup *closeup);
-	void draw4(CSurfaceArea *surfaceArea, CStarCamera *camera, CStarCloseup *closeup);
+	CStarCatalog _catalog;
+	Common::Array<CStarCandidate> _candidates;
+private:
+	void draw1(CSurfaceArea *surfaceArea, const CStarProjection &proj, CStarCamera *camera, CStarCloseup *closeup);
+	void draw2(CSurfaceArea *surfaceArea, const CStarProjection &proj, CStarCamera *camera, CStarCloseup *closeup);
+	void draw3(CSurfaceArea *surfaceArea, const CStarProjection &proj, CStarCamera *camera, CStarCloseup *closeup);
+	void draw4(CSurfaceArea *surfaceArea, const CStarProjection &proj, CStarCamera *camera, CStarCloseup *closeup);
+
+	/**
+	 * Draws the stars with the given projection. The stars in view are
+	 * either found with the star catalog, or by checking every star.
+	 * Closeups are only drawn if a closeup is passed.
+	 */
+	void drawStars(CSurfaceArea *surfaceArea, const CStarProjection &proj,
+		CStarCamera *camera, CStarCloseup *closeup, bool useCatalog);
 protected:
 	FRange _minMax;
 	double _minVal;
@@ -102,6 +159,13 @@ protected:
 	void resetEntry(CBaseStarEntry &entry);
 public:
 	Common::Array<CBaseStarEntry> _data;
+
+	/**
+	 * When set, the projection of each drawn frame is kept in
+	 * _recordedFrames, to replay them with benchmarkDraw
+	 */
+	bool _recording;
+	Common::Array<CStarProjection> _recordedFrames;
 public:
 	CBaseStars();
 	virtual ~CBaseStars() {}
@@ -158,6 +222,12 @@ public:
 		const Common::Point &pt);
 
 	int baseFn2(CSurfaceArea *surfaceArea, CStarCamera *camera);
+
+	/**
+	 * Draws the recorded frames the given number of times, checking every
+	 * star and with the star catalog, and compares the drawn frames
+	 */
+	void benchmarkDraw(uint repeat, CStarBenchmarkResult &result);
 };
 
 class CStarVector {
@@ -0,0 +1,295 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "titanic/star_control/star_catalog.h"
+#include "titanic/star_control/base_stars.h"
+#include "common/algorithm.h"
+
+#if defined(__SSE2__)
+#define STAR_CATALOG_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Titanic {
+
+// Stars closer than this are drawn as closeups, see CBaseStars::draw1
+#define CLOSEUP_DISTANCE2 1.0e12
+// Stars this far away or further are not drawn
+#define MAX_DISTANCE2 (1.0e9 * 1.0e9)
+
+// Relative error allowed for the single precision star transform
+#define TRANSFORM_SLACK 1.0e-5
+
+/**
+ * Range of one camera space coordinate over the bounding sphere of a cell,
+ * widened by the rounding error of the transform of the stars in it
+ */
+struct CoordRange {
+	double _min, _max;
+	double _mid, _slack;
+
+	CoordRange(float c1, float c2, float c3, float v, const FVector &center, float radius) {
+		_mid = (double)center._x * c1 + (double)center._y * c2 + (double)center._z * c3 + v;
+		_slack = TRANSFORM_SLACK * ((fabs(center._x) + radius) * fabs(c1)
+			+ (fabs(center._y) + radius) * fabs(c2) + (fabs(center._z) + radius) * fabs(c3) + fabs(v));
+		double extent = radius * sqrt((double)c1 * c1 + (double)c2 * c2 + (double)c3 * c3) + _slack;
+		_min = _mid - extent;
+		_max = _mid + extent;
+	}
+
+	/**
+	 * Returns the smallest absolute value within the range
+	 */
+	double closest() const {
+		return (_min > 0.0) ? _min : ((_max < 0.0) ? -_max : 0.0);
+	}
+
+	/**
+	 * Returns the largest absolute value within the range
+	 */
+	double furthest() const {
+		return MAX(fabs(_min), fabs(_max));
+	}
+};
+
+/**
+ * Returns true if a * (t + offset) + b * tz is no larger than zero for all
+ * points of the cell, where t is the camera space X or Y coordinate
+ */
+static bool isBehindPlane(const FPose &pose, const FVector &center, float radius,
+		bool useY, const CoordRange &range, const CoordRange &zRange, double a, double offset, double b) {
+	const FVector &r1 = pose._row1, &r2 = pose._row2, &r3 = pose._row3;
+	double g1 = a * (useY ? r1._y : r1._x) + b * r1._z;
+	double g2 = a * (useY ? r2._y : r2._x) + b * r2._z;
+	double g3 = a * (useY ? r3._y : r3._x) + b * r3._z;
+	double k = a * ((useY ? pose._vector._y : pose._vector._x) + offset) + b * pose._vector._z;
+
+	double maxVal = center._x * g1 + center._y * g2 + center._z * g3 + k
+		+ radius * sqrt(g1 * g1 + g2 * g2 + g3 * g3);
+
+	// Allow for the rounding of the star transform, and of the projection
+	double margin = fabs(a) * range._slack + fabs(b) * zRange._slack
+		+ 1.0e-6 * (fabs(a) * (range.furthest() + fabs(offset)) + fabs(b) * zRange.furthest());
+
+	return maxVal + margin <= 0.0;
+}
+
+bool CStarCatalog::isCellHidden(const Cell &cell, const CStarProjection &proj, double minVal) const {
+	const FPose &pose = proj._pose;
+	CoordRange zRange(pose._row1._z, pose._row2._z, pose._row3._z, pose._vector._z, cell._center, cell._radius);
+	if (zRange._max <= minVal)
+		return true;
+
+	CoordRange yRange(pose._row1._y, pose._row2._y, pose._row3._y, pose._vector._y, cell._center, cell._radius);
+	CoordRange xRange(pose._row1._x, pose._row2._x, pose._row3._x, pose._vector._x, cell._center, cell._radius);
+	double distance2 = xRange.closest() * xRange.closest() + yRange.closest() * yRange.closest()
+		+ zRange.closest() * zRange.closest();
+
+	// Any star of the cell may be close enough for a closeup
+	if (distance2 < CLOSEUP_DISTANCE2 * (1.0 + 1.0e-6))
+		return false;
+	if (distance2 >= MAX_DISTANCE2 * (1.0 + 1.0e-6) || zRange._max <= proj._threshold)
+		return true;
+
+	// The view tests below need the stars to be in front of the camera
+	if (proj._threshold < 0.0)
+		return false;
+
+	// For pink stars the second pixel is only drawn if the first one is on screen
+	double offset = (proj._starColor == PINK) ? proj._value3 : 0.0;
+	double centerX = proj._centroid._x, centerY = proj._centroid._y;
+	int width1 = proj._width - 1, height1 = proj._height - 1;
+
+	return isBehindPlane(pose, cell._center, cell._radius, false, xRange, zRange, proj._value1, offset, centerX + 1.0)
+		|| isBehindPlane(pose, cell._center, cell._radius, false, xRange, zRange, -proj._value1, offset, width1 - centerX)
+		|| isBehindPlane(pose, cell._center, cell._radius, true, yRange, zRange, proj._value2, 0.0, centerY + 1.0)
+		|| isBehindPlane(pose, cell._center, cell._radius, true, yRange, zRange, -proj._value2, 0.0, height1 - centerY);
+}
+
+void CStarCatalog::build(const Common::Array<CBaseStarEntry> &stars) {
+	clear();
+	uint count = stars.size();
+	if (!count)
+		return;
+
+	// Get the bounds of the stars
+	FVector minPos = stars[0]._position, maxPos = stars[0]._position;
+	for (uint idx = 1; idx < count; ++idx) {
+		const FVector &pos = stars[idx]._position;
+		minPos = FVector(MIN(minPos._x, pos._x), MIN(minPos._y, pos._y), MIN(minPos._z, pos._z));
+		maxPos = FVector(MAX(maxPos._x, pos._x), MAX(maxPos._y, pos._y), MAX(maxPos._z, pos._z));
+	}
+
+	// Use cells of about 32 stars, if they were evenly spread
+	int gridSize = CLIP((int)pow(count / 32.0, 1.0 / 3.0), 1, 16);
+	double scaleX = (maxPos._x > minPos._x) ? gridSize / ((double)maxPos._x - minPos._x) : 0.0;
+	double scaleY = (maxPos._y > minPos._y) ? gridSize / ((double)maxPos._y - minPos._y) : 0.0;
+	double scaleZ = (maxPos._z > minPos._z) ? gridSize / ((double)maxPos._z - minPos._z) : 0.0;
+
+	Common::Array<uint> cellIndexes;
+	cellIndexes.resize(count);
+	Common::Array<uint> cellStarts;
+	cellStarts.resize(gridSize * gridSize * gridSize + 1);
+	for (uint idx = 0; idx < cellStarts.size(); ++idx)
+		cellStarts[idx] = 0;
+
+	for (uint idx = 0; idx < count; ++idx) {
+		const FVector &pos = stars[idx]._position;
+		int cellX = MIN((int)((pos._x - minPos._x) * scaleX), gridSize - 1);
+		int cellY = MIN((int)((pos._y - minPos._y) * scaleY), gridSize - 1);
+		int cellZ = MIN((int)((pos._z - minPos._z) * scaleZ), gridSize - 1);
+		cellIndexes[idx] = (cellZ * gridSize + cellY) * gridSize + cellX;
+		++cellStarts[cellIndexes[idx] + 1];
+	}
+
+	for (uint idx = 1; idx < cellStarts.size(); ++idx)
+		cellStarts[idx] += cellStarts[idx - 1];
+
+	// Sort the stars into the cells, keeping the star order within each cell
+	_indexes.resize(count);
+	Common::Array<uint> cellEnds = cellStarts;
+	for (uint idx = 0; idx < count; ++idx)
+		_indexes[cellEnds[cellIndexes[idx]]++] = idx;
+
+	_x.resize(count);
+	_y.resize(count);
+	_z.resize(count);
+	for (uint idx = 0; idx < count; ++idx) {
+		const FVector &pos = stars[_indexes[idx]]._position;
+		_x[idx] = pos._x;
+		_y[idx] = pos._y;
+		_z[idx] = pos._z;
+	}
+
+	for (uint cellIdx = 0; cellIdx + 1 < cellStarts.size(); ++cellIdx) {
+		Cell cell;
+		cell._start = cellStarts[cellIdx];
+		cell._end = cellStarts[cellIdx + 1];
+		if (cell._start == cell._end)
+			continue;
+
+		FVector cellMin(_x[cell._start], _y[cell._start], _z[cell._start]);
+		FVector cellMax = cellMin;
+		for (uint idx = cell._start + 1; idx < cell._end; ++idx) {
+			cellMin = FVector(MIN(cellMin._x, _x[idx]), MIN(cellMin._y, _y[idx]), MIN(cellMin._z, _z[idx]));
+			cellMax = FVector(MAX(cellMax._x, _x[idx]), MAX(cellMax._y, _y[idx]), MAX(cellMax._z, _z[idx]));
+		}
+
+		cell._center = FVector((cellMin._x + cellMax._x) / 2, (cellMin._y + cellMax._y) / 2,
+			(cellMin._z + cellMax._z) / 2);
+		double radius2 = 0.0;
+		for (uint idx = cell._start; idx < cell._end; ++idx) {
+			double dx = (double)_x[idx] - cell._center._x;
+			double dy = (double)_y[idx] - cell._center._y;
+			double dz = (double)_z[idx] - cell._center._z;
+			radius2 = MAX(radius2, dx * dx + dy * dy + dz * dz);
+		}
+		cell._radius = (float)(sqrt(radius2) * (1.0 + 1.0e-6));
+
+		_cells.push_back(cell);
+	}
+}
+
+void CStarCatalog::clear() {
+	_x.clear();
+	_y.clear();
+	_z.clear();
+	_indexes.clear();
+	_cells.clear();
+}
+
+static bool candidateLess(const CStarCandidate &c1, const CStarCandidate &c2) {
+	return c1._index < c2._index;
+}
+
+void CStarCatalog::findCandidates(const CStarProjection &proj, double minVal,
+		Common::Array<CStarCandidate> &candidates) const {
+	const FPose &pose = proj._pose;
+	candidates.resize(0);
+
+#ifdef STAR_CATALOG_SSE2
+	const __m128 r1x = _mm_set1_ps(pose._row1._x), r1y = _mm_set1_ps(pose._row1._y), r1z = _mm_set1_ps(pose._row1._z);
+	const __m128 r2x = _mm_set1_ps(pose._row2._x), r2y = _mm_set1_ps(pose._row2._y), r2z = _mm_set1_ps(pose._row2._z);
+	const __m128 r3x = _mm_set1_ps(pose._row3._x), r3y = _mm_set1_ps(pose._row3._y), r3z = _mm_set1_ps(pose._row3._z);
+	const __m128 vx = _mm_set1_ps(pose._vector._x), vy = _mm_set1_ps(pose._vector._y), vz = _mm_set1_ps(pose._vector._z);
+
+	// A single precision bound no larger than minVal, which the lanes are
+	// checked against before the exact comparison
+	const __m128 lowZ = _mm_set1_ps((float)(minVal - fabs(minVal) * 1.0e-6 - 1.0));
+#endif
+
+	for (uint cellIdx = 0; cellIdx < _cells.size(); ++cellIdx) {
+		const Cell &cell = _cells[cellIdx];
+		if (isCellHidden(cell, proj, minVal))
+			continue;
+
+		uint idx = cell._start;
+#ifdef STAR_CATALOG_SSE2
+		// The same operations in the same order as transform(), four stars at a time
+		for (; idx + 4 <= cell._end; idx += 4) {
+			__m128 x = _mm_loadu_ps(&_x[idx]);
+			__m128 y = _mm_loadu_ps(&_y[idx]);
+			__m128 z = _mm_loadu_ps(&_z[idx]);
+			__m128 tz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, r1z), _mm_mul_ps(y, r2z)),
+				_mm_mul_ps(z, r3z)), vz);
+			int mask = _mm_movemask_ps(_mm_cmpgt_ps(tz, lowZ));
+			if (!mask)
+				continue;
+
+			__m128 ty = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, r1y), _mm_mul_ps(y, r2y)),
+				_mm_mul_ps(z, r3y)), vy);
+			__m128 tx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, r1x), _mm_mul_ps(y, r2x)),
+				_mm_mul_ps(z, r3x)), vx);
+			float xs[4], ys[4], zs[4];
+			_mm_storeu_ps(xs, tx);
+			_mm_storeu_ps(ys, ty);
+			_mm_storeu_ps(zs, tz);
+
+			for (int lane = 0; lane < 4; ++lane) {
+				if ((mask & (1 << lane)) && zs[lane] > minVal) {
+					CStarCandidate c;
+					c._index = _indexes[idx + lane];
+					c._x = xs[lane];
+					c._y = ys[lane];
+					c._z = zs[lane];
+					candidates.push_back(c);
+				}
+			}
+		}
+#endif
+
+		for (; idx < cell._end; ++idx) {
+			CStarCandidate c;
+			transform(pose, _x[idx], _y[idx], _z[idx], c._x, c._y, c._z);
+			if (c._z > minVal) {
+				c._index = _indexes[idx];
+				candidates.push_back(c);
+			}
+		}
+	}
+
+	// Stars are drawn in their original order, as later stars overwrite earlier ones
+	if (_cells.size() > 1 && !candidates.empty())
+		Common::sort(candidates.begin(), candidates.end(), candidateLess);
+}
+
+} // End of namespace Titanic
@@ -0,0 +1,85 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef TITANIC_STAR_CATALOG_H
+#define TITANIC_STAR_CATALOG_H
+
+#include "titanic/star_control/fpose.h"
+#include "common/array.h"
+
+namespace Titanic {
+
+struct CBaseStarEntry;
+struct CStarCandidate;
+struct CStarProjection;
+
+/**
+ * The positions of a set of stars in structure of arrays form, sorted into
+ * cells of nearby stars. Cells which are entirely out of view are skipped
+ * as a whole, and the stars of the others are transformed four at a time.
+ */
+class CStarCatalog {
+	struct Cell {
+		uint _start, _end;
+		FVector _center;
+		float _radius;
+	};
+private:
+	Common::Array<float> _x, _y, _z;
+	Common::Array<uint> _indexes;
+	Common::Array<Cell> _cells;
+private:
+	/**
+	 * Returns true if no star within the cell can be drawn
+	 */
+	bool isCellHidden(const Cell &cell, const CStarProjection &proj, double minVal) const;
+public:
+	/**
+	 * Sorts the positions of the passed stars into cells
+	 */
+	void build(const Common::Array<CBaseStarEntry> &stars);
+
+	void clear();
+
+	uint size() const { return _indexes.size(); }
+
+	/**
+	 * Transforms a star position into camera space
+	 */
+	static void transform(const FPose &pose, float x, float y, float z, float &tx, float &ty, float &tz) {
+		tz = x * pose._row1._z + y * pose._row2._z + z * pose._row3._z + pose._vector._z;
+		ty = x * pose._row1._y + y * pose._row2._y + z * pose._row3._y + pose._vector._y;
+		tx = x * pose._row1._x + y * pose._row2._x + z * pose._row3._x + pose._vector._x;
+	}
+
+	/**
+	 * Fills the candidates with the stars further than minVal along the
+	 * camera axis, in star index order, leaving out cells that cannot be
+	 * drawn with the given projection
+	 */
+	void findCandidates(const CStarProjection &proj, double minVal,
+		Common::Array<CStarCandidate> &candidates) const;
+};
+
+} // End of namespace Titanic
+
+#endif /* TITANIC_STAR_CATALOG_H */
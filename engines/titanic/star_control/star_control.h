@@ -69,6 +69,11 @@ public:
 	 */
 	virtual void draw(CScreenManager *screenManager);
 
+	/**
+	 * Returns the starfield
+	 */
+	CStarField *getStarField() { return &_starField; }
+
 	/**
 	 * _starField is currently showing the starfield
 	 */
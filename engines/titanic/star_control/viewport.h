@@ -30,13 +30,6 @@ class SimpleFile;
 
 namespace Titanic {
 
-/**
- * The color of the stars when drawn (CBaseStars::draw)
- * For starview it should be white
- * For skyview it should be pink
- */
-enum StarColor { WHITE = 0, PINK = 2 };	
-
 /**
  * Implements the viewport functionality for viewing the star field in
  * a given position and orientation.
@@ -21,15 +21,73 @@
  */
 
 #include "toon/console.h"
+#include "toon/path.h"
 #include "toon/toon.h"
 
 namespace Toon {
 
 ToonConsole::ToonConsole(ToonEngine *vm) : GUI::Debugger(), _vm(vm) {
 	assert(_vm);
+
+	registerCmd("pathfinding_record", WRAP_METHOD(ToonConsole, Cmd_PathFindingRecord));
+	registerCmd("pathfinding_bench", WRAP_METHOD(ToonConsole, Cmd_PathFindingBench));
 }
 
 ToonConsole::~ToonConsole() {
 }
 
+bool ToonConsole::Cmd_PathFindingRecord(int argc, const char **argv) {
+	PathFinding *pathFinding = _vm->getPathFinding();
+
+	if (argc != 2) {
+		debugPrintf("Records the pathfinding calls in the current scene, for pathfinding_bench.\n");
+		debugPrintf("Usage: %s on|off|clear\n", argv[0]);
+		debugPrintf("Recording is %s, %d calls recorded\n", pathFinding->_recording ? "on" : "off", pathFinding->_recordedQueries.size());
+		return true;
+	}
+
+	if (!scumm_stricmp(argv[1], "on"))
+		pathFinding->_recording = true;
+	else if (!scumm_stricmp(argv[1], "off"))
+		pathFinding->_recording = false;
+	else if (!scumm_stricmp(argv[1], "clear"))
+		pathFinding->_recordedQueries.clear();
+	else
+		debugPrintf("Invalid parameter %s\n", argv[1]);
+
+	return true;
+}
+
+bool ToonConsole::Cmd_PathFindingBench(int argc, const char **argv) {
+	PathFinding *pathFinding = _vm->getPathFinding();
+
+	if (argc > 2) {
+		debugPrintf("Replays the pathfinding calls recorded with pathfinding_record, with the\n");
+		debugPrintf("current pathfinder and the reference one, and compares the results.\n");
+		debugPrintf("Usage: %s [<repeat count>]\n", argv[0]);
+		return true;
+	}
+
+	if (pathFinding->_recordedQueries.empty()) {
+		debugPrintf("No pathfinding calls recorded, use pathfinding_record first\n");
+		return true;
+	}
+
+	int repeat = (argc == 2) ? atoi(argv[1]) : 10;
+	if (repeat < 1) {
+		debugPrintf("Invalid repeat count %s\n", argv[1]);
+		return true;
+	}
+
+	PathFindingBenchmarkResult result;
+	pathFinding->benchmark(repeat, result);
+
+	debugPrintf("%d calls, %d times\n", result.queries, repeat);
+	debugPrintf("Reference: %d ms\n", result.referenceTime);
+	debugPrintf("Current: %d ms\n", result.currentTime);
+	debugPrintf("Differing results: %d\n", result.mismatches);
+
+	return true;
+}
+
 } // End of namespace Toon
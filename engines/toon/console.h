@@ -36,6 +36,9 @@ public:
 
 private:
 	ToonEngine *_vm;
+
+	bool Cmd_PathFindingRecord(int argc, const char **argv);
+	bool Cmd_PathFindingBench(int argc, const char **argv);
 };
 
 } // End of namespace Toon
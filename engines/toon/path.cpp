@@ -21,6 +21,7 @@
  */
 
 #include "common/debug.h"
+#include "common/system.h"
 
 #include "toon/path.h"
 
@@ -56,8 +57,8 @@ void PathFindingHeap::unload() {
 void PathFindingHeap::clear() {
 	debugC(1, kDebugPath, "clear()");
 
+	// Entries past _count are never read, so they don't need clearing
 	_count = 0;
-	memset(_data, 0, sizeof(HeapDataGrid) * _size);
 }
 
 void PathFindingHeap::push(int16 x, int16 y, uint16 weight) {
@@ -151,7 +152,11 @@ PathFinding::PathFinding() {
 	_height = 0;
 	_heap = new PathFindingHeap();
 	_sq = NULL;
+	_sqClean = false;
+	_regions = NULL;
+	_regionsChangeCount = 0;
 	_numBlockingRects = 0;
+	_recording = false;
 
 	_currentMask = nullptr;
 }
@@ -161,6 +166,7 @@ PathFinding::~PathFinding(void) {
 		_heap->unload();
 	delete _heap;
 	delete[] _sq;
+	delete[] _regions;
 }
 
 void PathFinding::init(Picture *mask) {
@@ -173,9 +179,95 @@ void PathFinding::init(Picture *mask) {
 	_heap->init(500);
 	delete[] _sq;
 	_sq = new uint16[_width * _height];
+	_sqClean = false;
+
+	delete[] _regions;
+	_regions = NULL;
+	_cachedPaths.clear();
+	_recordedQueries.clear();
+}
+
+void PathFinding::updateRegions() {
+	if (_regions && _regionsChangeCount == _currentMask->getChangeCount())
+		return;
+
+	debugC(1, kDebugPath, "updateRegions()");
+
+	int32 size = _width * _height;
+	if (!_regions)
+		_regions = new uint16[size];
+	memset(_regions, 0, size * sizeof(uint16));
+	_regionsChangeCount = _currentMask->getChangeCount();
+	_cachedPaths.clear();
+
+	const uint8 *data = _currentMask->getDataPtr();
+	if (!data)
+		return;
+
+	// Number the walkable areas, which are connected in the same eight
+	// directions the search goes in. Should there be more areas than
+	// numbers, the last ones share a number, which only means that some
+	// unreachable destinations are searched for.
+	uint16 region = 0;
+	Common::Array<int32> stack;
+	for (int32 node = 0; node < size; node++) {
+		if (_regions[node] || !(data[node] & 0x1f))
+			continue;
+
+		if (region < 0xFFFF)
+			region++;
+		_regions[node] = region;
+		stack.push_back(node);
+
+		while (!stack.empty()) {
+			int32 curNode = stack.back();
+			stack.pop_back();
+			int16 curX = curNode % _width;
+			int16 curY = curNode / _width;
+
+			int16 endX = MIN<int16>(curX + 1, _width - 1);
+			int16 endY = MIN<int16>(curY + 1, _height - 1);
+			int16 startX = MAX<int16>(curX - 1, 0);
+			int16 startY = MAX<int16>(curY - 1, 0);
+
+			for (int16 py = startY; py <= endY; py++) {
+				for (int16 px = startX; px <= endX; px++) {
+					int32 pNode = px + py * _width;
+					if (!_regions[pNode] && (data[pNode] & 0x1f)) {
+						_regions[pNode] = region;
+						stack.push_back(pNode);
+					}
+				}
+			}
+		}
+	}
+}
+
+bool PathFinding::isConnected(int16 x, int16 y, int16 destx, int16 desty) {
+	uint16 destRegion = _regions[destx + desty * _width];
+	if (!destRegion)
+		return false;
+
+	// The start itself doesn't need to be walkable, only one of its neighbours
+	int16 endX = MIN<int16>(x + 1, _width - 1);
+	int16 endY = MIN<int16>(y + 1, _height - 1);
+	int16 startX = MAX<int16>(x - 1, 0);
+	int16 startY = MAX<int16>(y - 1, 0);
+
+	for (int16 py = startY; py <= endY; py++) {
+		for (int16 px = startX; px <= endX; px++) {
+			if ((px != x || py != y) && _regions[px + py * _width] == destRegion)
+				return true;
+		}
+	}
+
+	return false;
 }
 
 bool PathFinding::isLikelyWalkable(int16 x, int16 y) {
+	if (!_blockingBounds.contains(x, y))
+		return true;
+
 	for (uint8 i = 0; i < _numBlockingRects; i++) {
 		if (_blockingRects[i][4] == 0) {
 			if (x >= _blockingRects[i][0] && x <= _blockingRects[i][2] && y >= _blockingRects[i][1] && y < _blockingRects[i][3])
@@ -200,6 +292,72 @@ bool PathFinding::isWalkable(int16 x, int16 y) {
 bool PathFinding::findClosestWalkingPoint(int16 xx, int16 yy, int16 *fxx, int16 *fyy, int16 origX, int16 origY) {
 	debugC(1, kDebugPath, "findClosestWalkingPoint(%d, %d, fxx, fyy, %d, %d)", xx, yy, origX, origY);
 
+	if (_recording)
+		recordQuery(true, xx, yy, 0, 0, origX, origY);
+
+	int32 currentFound = -1;
+	int32 dist = -1;
+	int32 dist2 = -1;
+
+	if (origX == -1)
+		origX = xx;
+	if (origY == -1)
+		origY = yy;
+
+	updateRegions();
+
+	// Go through the rows in order of their distance, and stop once no row
+	// can have a closer point. Within a row, only the first points found
+	// going left and right from xx can be the closest. Like the full scan
+	// of findClosestWalkingPointReference, the point nearest to the
+	// original position is used for equal distances, and then the first
+	// point in scan order.
+	int32 maxDy = MAX<int32>(ABS<int32>(yy), ABS<int32>(_height - 1 - yy));
+	for (int32 dy = 0; dy <= maxDy; dy++) {
+		if (currentFound >= 0 && dy * dy > dist)
+			break;
+
+		for (int32 y = yy - dy; y <= yy + dy; y += MAX<int32>(2 * dy, 1)) {
+			if (y < 0 || y >= _height)
+				continue;
+
+			for (int32 dir = -1; dir <= 1; dir += 2) {
+				int32 x = (dir < 0) ? MIN<int32>(xx, _width - 1) : MAX<int32>(xx, 0);
+				for (; x >= 0 && x < _width; x += dir) {
+					if (_regions[y * _width + x] && isLikelyWalkable(x, y))
+						break;
+				}
+
+				if (x < 0 || x >= _width)
+					continue;
+
+				int32 ndist = (x - xx) * (x - xx) + (y - yy) * (y - yy);
+				int32 ndist2 = (x - origX) * (x - origX) + (y - origY) * (y - origY);
+				int32 node = y * _width + x;
+				if (currentFound < 0 || ndist < dist || (ndist == dist && (ndist2 < dist2 ||
+						(ndist2 == dist2 && node < currentFound)))) {
+					dist = ndist;
+					dist2 = ndist2;
+					currentFound = node;
+				}
+			}
+		}
+	}
+
+	if (currentFound != -1) {
+		*fxx = currentFound % _width;
+		*fyy = currentFound / _width;
+		return true;
+	} else {
+		*fxx = 0;
+		*fyy = 0;
+		return false;
+	}
+}
+
+bool PathFinding::findClosestWalkingPointReference(int16 xx, int16 yy, int16 *fxx, int16 *fyy, int16 origX, int16 origY) {
+	debugC(1, kDebugPath, "findClosestWalkingPointReference(%d, %d, fxx, fyy, %d, %d)", xx, yy, origX, origY);
+
 	int32 currentFound = -1;
 	int32 dist = -1;
 	int32 dist2 = -1;
@@ -285,28 +443,85 @@ bool PathFinding::lineIsWalkable(int16 x, int16 y, int16 x2, int16 y2) {
 	return true;
 }
 
-bool PathFinding::findPath(int16 x, int16 y, int16 destx, int16 desty) {
-	debugC(1, kDebugPath, "findPath(%d, %d, %d, %d)", x, y, destx, desty);
-
+bool PathFinding::findTrivialPath(int16 x, int16 y, int16 destx, int16 desty, bool *result) {
 	if (x == destx && y == desty) {
 		_tempPath.clear();
+		*result = true;
 		return true;
 	}
 
 	// ignore path finding if the character is outside the screen
 	if (x < 0 || x > 1280 || y < 0 || y > 400 || destx < 0 || destx > 1280 || desty < 0 || desty > 400) {
 		_tempPath.clear();
+		*result = true;
 		return true;
 	}
 
 	// first test direct line
 	if (lineIsWalkable(x, y, destx, desty)) {
 		walkLine(x, y, destx, desty);
+		*result = true;
 		return true;
 	}
 
+	return false;
+}
+
+bool PathFinding::findPath(int16 x, int16 y, int16 destx, int16 desty) {
+	debugC(1, kDebugPath, "findPath(%d, %d, %d, %d)", x, y, destx, desty);
+
+	if (_recording)
+		recordQuery(false, x, y, destx, desty, -1, -1);
+
+	bool result;
+	if (findTrivialPath(x, y, destx, desty, &result))
+		return result;
+
+	bool pathChanged;
+	if (x >= _width || y >= _height || destx >= _width || desty >= _height)
+		return searchPathReference(x, y, destx, desty, &pathChanged);
+
+	// The search would go through the whole area around the start without
+	// reaching the destination
+	updateRegions();
+	if (!isConnected(x, y, destx, desty)) {
+		_tempPath.clear();
+		return false;
+	}
+
+	for (Common::List<CachedPath>::iterator it = _cachedPaths.begin(); it != _cachedPaths.end(); ++it) {
+		if (isCached(*it, x, y, destx, desty)) {
+			debugC(1, kDebugPath, "findPath: using cached path");
+			CachedPath cachedPath = *it;
+			_cachedPaths.erase(it);
+			_cachedPaths.push_front(cachedPath);
+
+			if (cachedPath.pathChanged)
+				_tempPath = cachedPath.path;
+			return cachedPath.result;
+		}
+	}
+
+	result = searchPath(x, y, destx, desty, &pathChanged);
+	addToCache(x, y, destx, desty, result, pathChanged);
+	return result;
+}
+
+bool PathFinding::findPathReference(int16 x, int16 y, int16 destx, int16 desty) {
+	debugC(1, kDebugPath, "findPathReference(%d, %d, %d, %d)", x, y, destx, desty);
+
+	bool result;
+	if (findTrivialPath(x, y, destx, desty, &result))
+		return result;
+
+	bool pathChanged;
+	return searchPathReference(x, y, destx, desty, &pathChanged);
+}
+
+bool PathFinding::searchPathReference(int16 x, int16 y, int16 destx, int16 desty, bool *pathChanged) {
 	// no direct line, we use the standard A* algorithm
 	memset(_sq , 0, _width * _height * sizeof(uint16));
+	_sqClean = false;
 	_heap->clear();
 	int16 curX = x;
 	int16 curY = y;
@@ -358,11 +573,96 @@ bool PathFinding::findPath(int16 x, int16 y, int16 destx, int16 desty) {
 	if (!_sq[destx + desty * _width]) {
 		// didn't find anything
 		_tempPath.clear();
+		*pathChanged = true;
 		return false;
 	}
 
-	curX = destx;
-	curY = desty;
+	*pathChanged = tracePath(x, y, destx, desty);
+	return *pathChanged;
+}
+
+bool PathFinding::searchPath(int16 x, int16 y, int16 destx, int16 desty, bool *pathChanged) {
+	// The A* search of searchPathReference never stops early, as the weight
+	// of a node never gets zero, so it finds the distance of every node
+	// that can be reached. The path is traced back from the destination
+	// through nodes closer to the start, which only needs the distances up
+	// to the one of the destination. Searching the nodes in order of
+	// distance, these are known once the destination comes up.
+	if (!_sqClean)
+		memset(_sq, 0, _width * _height * sizeof(uint16));
+	_sqClean = false;
+	_sqNodes.resize(0);
+	_heap->clear();
+
+	int32 destNode = destx + desty * _width;
+	_sq[x + y * _width] = 1;
+	_sqNodes.push_back(x + y * _width);
+	_heap->push(x, y, 1);
+
+	int16 curX, curY;
+	uint16 curWeight;
+	while (_heap->getCount()) {
+		_heap->pop(&curX, &curY, &curWeight);
+		int32 curNode = curX + curY * _width;
+
+		// Skip nodes that have been reached in a shorter way since
+		if (curWeight > _sq[curNode])
+			continue;
+		if (_sq[destNode] && curWeight >= _sq[destNode])
+			break;
+
+		int16 endX = MIN<int16>(curX + 1, _width - 1);
+		int16 endY = MIN<int16>(curY + 1, _height - 1);
+		int16 startX = MAX<int16>(curX - 1, 0);
+		int16 startY = MAX<int16>(curY - 1, 0);
+
+		for (int16 px = startX; px <= endX; px++) {
+			for (int16 py = startY; py <= endY; py++) {
+				int32 curPNode = px + py * _width;
+				if ((px != curX || py != curY) && _regions[curPNode]) {
+					uint16 wei = abs(px - curX) + abs(py - curY);
+					uint32 sum = _sq[curNode] + wei * (1 + (isLikelyWalkable(px, py) ? 5 : 0));
+					if (sum > (uint32)0xFFFF) {
+						// Leave distances that don't fit to the original search
+						clearSearch();
+						return searchPathReference(x, y, destx, desty, pathChanged);
+					}
+
+					if (_sq[curPNode] > sum || !_sq[curPNode]) {
+						if (!_sq[curPNode])
+							_sqNodes.push_back(curPNode);
+						_sq[curPNode] = sum;
+						_heap->push(px, py, sum);
+					}
+				}
+			}
+		}
+	}
+
+	bool result;
+	if (!_sq[destNode]) {
+		_tempPath.clear();
+		*pathChanged = true;
+		result = false;
+	} else {
+		result = tracePath(x, y, destx, desty);
+		*pathChanged = result;
+	}
+
+	clearSearch();
+	return result;
+}
+
+void PathFinding::clearSearch() {
+	for (uint32 i = 0; i < _sqNodes.size(); i++)
+		_sq[_sqNodes[i]] = 0;
+	_sqNodes.resize(0);
+	_sqClean = true;
+}
+
+bool PathFinding::tracePath(int16 x, int16 y, int16 destx, int16 desty) {
+	int16 curX = destx;
+	int16 curY = desty;
 
 	Common::Array<Common::Point> retPath;
 	retPath.push_back(Common::Point(curX, curY));
@@ -415,6 +715,30 @@ bool PathFinding::findPath(int16 x, int16 y, int16 destx, int16 desty) {
 	return retVal;
 }
 
+bool PathFinding::isCached(const CachedPath &cachedPath, int16 x, int16 y, int16 destx, int16 desty) const {
+	return cachedPath.x == x && cachedPath.y == y && cachedPath.destX == destx && cachedPath.destY == desty &&
+		cachedPath.numBlockingRects == _numBlockingRects &&
+		!memcmp(cachedPath.blockingRects, _blockingRects, _numBlockingRects * sizeof(_blockingRects[0]));
+}
+
+void PathFinding::addToCache(int16 x, int16 y, int16 destx, int16 desty, bool result, bool pathChanged) {
+	CachedPath cachedPath;
+	cachedPath.x = x;
+	cachedPath.y = y;
+	cachedPath.destX = destx;
+	cachedPath.destY = desty;
+	memcpy(cachedPath.blockingRects, _blockingRects, sizeof(_blockingRects));
+	cachedPath.numBlockingRects = _numBlockingRects;
+	cachedPath.result = result;
+	cachedPath.pathChanged = pathChanged;
+	if (pathChanged)
+		cachedPath.path = _tempPath;
+
+	_cachedPaths.push_front(cachedPath);
+	if (_cachedPaths.size() > kMaxCachedPaths)
+		_cachedPaths.pop_back();
+}
+
 void PathFinding::addBlockingRect(int16 x1, int16 y1, int16 x2, int16 y2) {
 	debugC(1, kDebugPath, "addBlockingRect(%d, %d, %d, %d)", x1, y1, x2, y2);
 	if (_numBlockingRects >= kMaxBlockingRects) {
@@ -428,6 +752,9 @@ void PathFinding::addBlockingRect(int16 x1, int16 y1, int16 x2, int16 y2) {
 	_blockingRects[_numBlockingRects][3] = y2;
 	_blockingRects[_numBlockingRects][4] = 0;
 	_numBlockingRects++;
+
+	// isLikelyWalkable includes the right edge
+	extendBlockingBounds(x1, y1, x2 + 1, y2);
 }
 
 void PathFinding::addBlockingEllipse(int16 x1, int16 y1, int16 w, int16 h) {
@@ -443,6 +770,133 @@ void PathFinding::addBlockingEllipse(int16 x1, int16 y1, int16 w, int16 h) {
 	_blockingRects[_numBlockingRects][3] = h;
 	_blockingRects[_numBlockingRects][4] = 1;
 	_numBlockingRects++;
+
+	// Any distance is inside for a negative size
+	if (w > 0 && h > 0)
+		extendBlockingBounds(x1 - w + 1, y1 - h + 1, x1 + w, y1 + h);
+	else if (w > 0)
+		extendBlockingBounds(x1 - w + 1, -0x8000, x1 + w, 0x7FFF);
+	else if (h > 0)
+		extendBlockingBounds(-0x8000, y1 - h + 1, 0x7FFF, y1 + h);
+	else
+		extendBlockingBounds(-0x8000, -0x8000, 0x7FFF, 0x7FFF);
+}
+
+void PathFinding::extendBlockingBounds(int32 left, int32 top, int32 right, int32 bottom) {
+	left = CLIP<int32>(left, -0x8000, 0x7FFF);
+	top = CLIP<int32>(top, -0x8000, 0x7FFF);
+	right = CLIP<int32>(right, -0x8000, 0x7FFF);
+	bottom = CLIP<int32>(bottom, -0x8000, 0x7FFF);
+	if (left >= right || top >= bottom)
+		return;
+
+	Common::Rect bounds(left, top, right, bottom);
+	if (_blockingBounds.isEmpty())
+		_blockingBounds = bounds;
+	else
+		_blockingBounds.extend(bounds);
+}
+
+void PathFinding::recordQuery(bool closestPoint, int16 x, int16 y, int16 destX, int16 destY, int16 origX, int16 origY) {
+	Query query;
+	query.closestPoint = closestPoint;
+	query.x = x;
+	query.y = y;
+	query.destX = destX;
+	query.destY = destY;
+	query.origX = origX;
+	query.origY = origY;
+	memcpy(query.blockingRects, _blockingRects, sizeof(_blockingRects));
+	query.numBlockingRects = _numBlockingRects;
+	_recordedQueries.push_back(query);
+}
+
+void PathFinding::runQuery(const Query &query, bool reference, bool *result, int16 *fxx, int16 *fyy) {
+	resetBlockingRects();
+	for (uint8 i = 0; i < query.numBlockingRects; i++) {
+		const int16 *rect = query.blockingRects[i];
+		if (rect[4] == 0)
+			addBlockingRect(rect[0], rect[1], rect[2], rect[3]);
+		else
+			addBlockingEllipse(rect[0], rect[1], rect[2], rect[3]);
+	}
+
+	*fxx = 0;
+	*fyy = 0;
+	if (query.closestPoint) {
+		if (reference)
+			*result = findClosestWalkingPointReference(query.x, query.y, fxx, fyy, query.origX, query.origY);
+		else
+			*result = findClosestWalkingPoint(query.x, query.y, fxx, fyy, query.origX, query.origY);
+	} else {
+		if (reference)
+			*result = findPathReference(query.x, query.y, query.destX, query.destY);
+		else
+			*result = findPath(query.x, query.y, query.destX, query.destY);
+	}
+}
+
+void PathFinding::benchmark(uint repeat, PathFindingBenchmarkResult &result) {
+	bool recording = _recording;
+	_recording = false;
+
+	int16 blockingRects[kMaxBlockingRects][5];
+	memcpy(blockingRects, _blockingRects, sizeof(_blockingRects));
+	uint8 numBlockingRects = _numBlockingRects;
+	Common::Rect blockingBounds = _blockingBounds;
+	Common::Array<Common::Point> tempPath = _tempPath;
+
+	result.queries = _recordedQueries.size();
+	result.mismatches = 0;
+
+	// A failed search may leave the previous path, so both implementations
+	// keep their own
+	Common::Array<Common::Point> referencePath;
+	Common::Array<Common::Point> currentPath;
+	_cachedPaths.clear();
+	for (uint32 i = 0; i < _recordedQueries.size(); i++) {
+		bool referenceResult, currentResult;
+		int16 referenceX, referenceY, currentX, currentY;
+
+		_tempPath = referencePath;
+		runQuery(_recordedQueries[i], true, &referenceResult, &referenceX, &referenceY);
+		referencePath = _tempPath;
+
+		_tempPath = currentPath;
+		runQuery(_recordedQueries[i], false, &currentResult, &currentX, &currentY);
+		currentPath = _tempPath;
+
+		if (referenceResult != currentResult || referenceX != currentX || referenceY != currentY ||
+				!(referencePath == currentPath))
+			result.mismatches++;
+	}
+
+	uint32 startTime = g_system->getMillis();
+	for (uint i = 0; i < repeat; i++) {
+		for (uint32 j = 0; j < _recordedQueries.size(); j++) {
+			bool queryResult;
+			int16 fxx, fyy;
+			runQuery(_recordedQueries[j], true, &queryResult, &fxx, &fyy);
+		}
+	}
+	result.referenceTime = g_system->getMillis() - startTime;
+
+	startTime = g_system->getMillis();
+	for (uint i = 0; i < repeat; i++) {
+		_cachedPaths.clear();
+		for (uint32 j = 0; j < _recordedQueries.size(); j++) {
+			bool queryResult;
+			int16 fxx, fyy;
+			runQuery(_recordedQueries[j], false, &queryResult, &fxx, &fyy);
+		}
+	}
+	result.currentTime = g_system->getMillis() - startTime;
+
+	memcpy(_blockingRects, blockingRects, sizeof(_blockingRects));
+	_numBlockingRects = numBlockingRects;
+	_blockingBounds = blockingBounds;
+	_tempPath = tempPath;
+	_recording = recording;
 }
 
 } // End of namespace Toon
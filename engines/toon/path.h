@@ -24,6 +24,7 @@
 #define TOON_PATH_H
 
 #include "common/array.h"
+#include "common/list.h"
 #include "common/rect.h"
 
 #include "toon/toon.h"
@@ -55,8 +56,30 @@ private:
 	uint32 _count;
 };
 
+struct PathFindingBenchmarkResult {
+	uint32 queries;
+	uint32 referenceTime;
+	uint32 currentTime;
+	uint32 mismatches;
+};
+
 class PathFinding {
 public:
+	static const uint8 kMaxBlockingRects = 16;
+
+	/**
+	 * A recorded call of findPath or findClosestWalkingPoint, along with
+	 * the blocking rects in effect
+	 */
+	struct Query {
+		bool closestPoint;
+		int16 x, y;
+		int16 destX, destY;
+		int16 origX, origY;
+		int16 blockingRects[kMaxBlockingRects][5];
+		uint8 numBlockingRects;
+	};
+
 	PathFinding();
 	~PathFinding();
 
@@ -69,7 +92,13 @@ public:
 	bool lineIsWalkable(int16 x, int16 y, int16 x2, int16 y2);
 	void walkLine(int16 x, int16 y, int16 x2, int16 y2);
 
-	void resetBlockingRects() { _numBlockingRects = 0; }
+	/**
+	 * The original implementations, which search the whole walk mask
+	 */
+	bool findPathReference(int16 x, int16 y, int16 destX, int16 destY);
+	bool findClosestWalkingPointReference(int16 xx, int16 yy, int16 *fxx, int16 *fyy, int16 origX = -1, int16 origY = -1);
+
+	void resetBlockingRects() { _numBlockingRects = 0; _blockingBounds = Common::Rect(); }
 	void addBlockingRect(int16 x1, int16 y1, int16 x2, int16 y2);
 	void addBlockingEllipse(int16 x1, int16 y1, int16 w, int16 h);
 
@@ -77,8 +106,27 @@ public:
 	int16 getPathNodeX(uint32 nodeId) const { return _tempPath[(_tempPath.size() - 1) - nodeId].x; }
 	int16 getPathNodeY(uint32 nodeId) const { return _tempPath[(_tempPath.size() - 1) - nodeId].y; }
 
+	/**
+	 * Replays the recorded queries with the original and the current
+	 * implementation, and compares the results
+	 */
+	void benchmark(uint repeat, PathFindingBenchmarkResult &result);
+
+	bool _recording;
+	Common::Array<Query> _recordedQueries;
+
 private:
-	static const uint8 kMaxBlockingRects = 16;
+	static const uint8 kMaxCachedPaths = 8;
+
+	struct CachedPath {
+		int16 x, y;
+		int16 destX, destY;
+		int16 blockingRects[kMaxBlockingRects][5];
+		uint8 numBlockingRects;
+		bool result;
+		bool pathChanged;
+		Common::Array<Common::Point> path;
+	};
 
 	Picture *_currentMask;
 
@@ -88,10 +136,39 @@ private:
 	int16 _width;
 	int16 _height;
 
+	// Nodes set in _sq by the last search, which are cleared afterwards
+	Common::Array<int32> _sqNodes;
+	bool _sqClean;
+
+	// Connected walkable area of each pixel, or 0 if it isn't walkable
+	uint16 *_regions;
+	uint32 _regionsChangeCount;
+
+	// Most recently used first
+	Common::List<CachedPath> _cachedPaths;
+
 	Common::Array<Common::Point> _tempPath;
 
 	int16 _blockingRects[kMaxBlockingRects][5];
 	uint8 _numBlockingRects;
+	Common::Rect _blockingBounds;
+
+	bool findTrivialPath(int16 x, int16 y, int16 destX, int16 destY, bool *result);
+	bool searchPathReference(int16 x, int16 y, int16 destX, int16 destY, bool *pathChanged);
+	bool searchPath(int16 x, int16 y, int16 destX, int16 destY, bool *pathChanged);
+	bool tracePath(int16 x, int16 y, int16 destX, int16 destY);
+	void clearSearch();
+
+	void updateRegions();
+	bool isConnected(int16 x, int16 y, int16 destX, int16 destY);
+
+	bool isCached(const CachedPath &cachedPath, int16 x, int16 y, int16 destX, int16 destY) const;
+	void addToCache(int16 x, int16 y, int16 destX, int16 destY, bool result, bool pathChanged);
+
+	void extendBlockingBounds(int32 left, int32 top, int32 right, int32 bottom);
+
+	void recordQuery(bool closestPoint, int16 x, int16 y, int16 destX, int16 destY, int16 origX, int16 origY);
+	void runQuery(const Query &query, bool reference, bool *result, int16 *fxx, int16 *fyy);
 };
 
 } // End of namespace Toon
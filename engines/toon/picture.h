@@ -51,6 +51,12 @@ public:
 	int16 getWidth() const { return _width; }
 	int16 getHeight() const { return _height; }
 
+	/**
+	 * Returns a counter which changes whenever the picture data is
+	 * changed, so that data derived from a mask can be kept up to date
+	 */
+	uint32 getChangeCount() const { return _changeCount; }
+
 protected:
 	int16 _width;
 	int16 _height;
@@ -58,6 +64,7 @@ protected:
 	uint8 *_palette; // need to be copied at 3-387
 	int32 _paletteEntries;
 	bool _useFullPalette;
+	uint32 _changeCount;
 
 	ToonEngine *_vm;
 };
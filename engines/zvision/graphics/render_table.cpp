@@ -30,10 +30,18 @@ namespace ZVision {
 RenderTable::RenderTable(uint numColumns, uint numRows)
 	: _numRows(numRows),
 	  _numColumns(numColumns),
-	  _renderState(FLAT) {
+	  _renderState(FLAT),
+	  _filtering(false),
+	  _tableDirty(true) {
 	assert(numRows != 0 && numColumns != 0);
 
 	_internalBuffer = new Common::Point[numRows * numColumns];
+	_sourceIndex = new uint32[numRows * numColumns];
+	_sourceFraction = new byte[numRows * numColumns];
+
+	for (uint i = 0; i < numRows * numColumns; ++i)
+		_sourceIndex[i] = i;
+	memset(_sourceFraction, 0, numRows * numColumns);
 
 	memset(&_panoramaOptions, 0, sizeof(_panoramaOptions));
 	memset(&_tiltOptions, 0, sizeof(_tiltOptions));
@@ -41,10 +49,13 @@ RenderTable::RenderTable(uint numColumns, uint numRows)
 
 RenderTable::~RenderTable() {
 	delete[] _internalBuffer;
+	delete[] _sourceIndex;
+	delete[] _sourceFraction;
 }
 
 void RenderTable::setRenderState(RenderState newState) {
 	_renderState = newState;
+	_tableDirty = true;
 
 	switch (newState) {
 	case PANORAMA:
@@ -82,49 +93,79 @@ const Common::Point RenderTable::convertWarpedCoordToFlatCoord(const Common::Poi
 }
 
 void RenderTable::mutateImage(uint16 *sourceBuffer, uint16 *destBuffer, uint32 destWidth, const Common::Rect &subRect) {
-	uint32 destOffset = 0;
-
 	for (int16 y = subRect.top; y < subRect.bottom; ++y) {
-		uint32 sourceOffset = y * _numColumns;
-
-		for (int16 x = subRect.left; x < subRect.right; ++x) {
-			uint32 normalizedX = x - subRect.left;
-			uint32 index = sourceOffset + x;
+		// RenderTable stores the absolute source position, so this is a plain gather
+		const uint32 *sourceIndex = &_sourceIndex[y * _numColumns];
 
-			// RenderTable only stores offsets from the original coordinates
-			uint32 sourceYIndex = y + _internalBuffer[index].y;
-			uint32 sourceXIndex = x + _internalBuffer[index].x;
+		for (int16 x = subRect.left; x < subRect.right; ++x)
+			destBuffer[x - subRect.left] = sourceBuffer[sourceIndex[x]];
 
-			destBuffer[destOffset + normalizedX] = sourceBuffer[sourceYIndex * _numColumns + sourceXIndex];
-		}
-
-		destOffset += destWidth;
+		destBuffer += destWidth;
 	}
 }
 
 void RenderTable::mutateImage(Graphics::Surface *dstBuf, Graphics::Surface *srcBuf) {
-	uint32 destOffset = 0;
-
 	uint16 *sourceBuffer = (uint16 *)srcBuf->getPixels();
 	uint16 *destBuffer = (uint16 *)dstBuf->getPixels();
+	Common::Rect subRect(srcBuf->w, srcBuf->h);
+
+	if (_filtering)
+		mutateImageFiltered(sourceBuffer, destBuffer, srcBuf->w, subRect, srcBuf->format);
+	else
+		mutateImage(sourceBuffer, destBuffer, srcBuf->w, subRect);
+}
+
+// Spreads a 16bpp pixel so that red and blue stay in the low half and green
+// moves to the high half. Each channel then has enough headroom to be
+// multiplied by a 4 bit weight without overflowing into its neighbour.
+static inline uint32 spreadPixel(uint16 color, uint32 mask) {
+	return (color | ((uint32)color << 16)) & mask;
+}
 
-	for (int16 y = 0; y < srcBuf->h; ++y) {
-		uint32 sourceOffset = y * _numColumns;
+static inline uint16 packPixel(uint32 color) {
+	return (uint16)(color | (color >> 16));
+}
+
+static inline uint32 lerpPixel(uint32 a, uint32 b, uint weight, uint32 mask) {
+	return ((a * (16 - weight) + b * weight) >> 4) & mask;
+}
 
-		for (int16 x = 0; x < srcBuf->w; ++x) {
-			uint32 index = sourceOffset + x;
+void RenderTable::mutateImageFiltered(uint16 *sourceBuffer, uint16 *destBuffer, uint32 destWidth, const Common::Rect &subRect, const Graphics::PixelFormat &format) {
+	const uint32 mask = format.RGBToColor(255, 0, 255) | (format.RGBToColor(0, 255, 0) << 16);
 
-			// RenderTable only stores offsets from the original coordinates
-			uint32 sourceYIndex = y + _internalBuffer[index].y;
-			uint32 sourceXIndex = x + _internalBuffer[index].x;
+	for (int16 y = subRect.top; y < subRect.bottom; ++y) {
+		const uint32 *sourceIndex = &_sourceIndex[y * _numColumns];
+		const byte *sourceFraction = &_sourceFraction[y * _numColumns];
 
-			destBuffer[destOffset] = sourceBuffer[sourceYIndex * _numColumns + sourceXIndex];
-			destOffset++;
+		for (int16 x = subRect.left; x < subRect.right; ++x) {
+			const uint16 *source = &sourceBuffer[sourceIndex[x]];
+			uint fractionX = sourceFraction[x] & 0xF;
+			uint fractionY = sourceFraction[x] >> 4;
+
+			// The fractions are zero on the last row and column of the
+			// source, so the neighbours are only read when they exist
+			uint32 color = spreadPixel(source[0], mask);
+			if (fractionX)
+				color = lerpPixel(color, spreadPixel(source[1], mask), fractionX, mask);
+
+			if (fractionY) {
+				uint32 below = spreadPixel(source[_numColumns], mask);
+				if (fractionX)
+					below = lerpPixel(below, spreadPixel(source[_numColumns + 1], mask), fractionX, mask);
+				color = lerpPixel(color, below, fractionY, mask);
+			}
+
+			destBuffer[x - subRect.left] = packPixel(color);
 		}
+
+		destBuffer += destWidth;
 	}
 }
 
 void RenderTable::generateRenderTable() {
+	if (!_tableDirty)
+		return;
+
 	switch (_renderState) {
 	case ZVision::RenderTable::PANORAMA:
 		generatePanoramaLookupTable();
@@ -136,11 +177,31 @@ void RenderTable::generateRenderTable() {
 		// Intentionally left empty
 		break;
 	}
+
+	_tableDirty = false;
 }
 
-void RenderTable::generatePanoramaLookupTable() {
-	memset(_internalBuffer, 0, _numRows * _numColumns * sizeof(uint16));
+void RenderTable::setTableEntry(uint x, uint y, float sourceX, float sourceY) {
+	int32 xInCylinderCoords = int32(floor(sourceX));
+	int32 yInCylinderCoords = int32(floor(sourceY));
+	uint32 index = y * _numColumns + x;
+
+	// Only store the (x,y) offsets instead of the absolute positions
+	_internalBuffer[index].x = xInCylinderCoords - x;
+	_internalBuffer[index].y = yInCylinderCoords - y;
+
+	// ... and the absolute position and sub-pixel fraction used by mutateImage()
+	_sourceIndex[index] = yInCylinderCoords * _numColumns + xInCylinderCoords;
+
+	byte fractionX = 0, fractionY = 0;
+	if (xInCylinderCoords + 1 < (int32)_numColumns)
+		fractionX = (byte)((sourceX - xInCylinderCoords) * 16.0f);
+	if (yInCylinderCoords + 1 < (int32)_numRows)
+		fractionY = (byte)((sourceY - yInCylinderCoords) * 16.0f);
+	_sourceFraction[index] = fractionX | (fractionY << 4);
+}
 
+void RenderTable::generatePanoramaLookupTable() {
 	float halfWidth = (float)_numColumns / 2.0f;
 	float halfHeight = (float)_numRows / 2.0f;
 
@@ -154,20 +215,16 @@ void RenderTable::generatePanoramaLookupTable() {
 
 		// To get x in cylinder coordinates, we just need to calculate the arc length
 		// We also scale it by _panoramaOptions.linearScale
-		int32 xInCylinderCoords = int32(floor((cylinderRadius * _panoramaOptions.linearScale * alpha) + halfWidth));
+		float xInCylinderCoords = (cylinderRadius * _panoramaOptions.linearScale * alpha) + halfWidth;
 
 		float cosAlpha = cos(alpha);
 
 		for (uint y = 0; y < _numRows; ++y) {
 			// To calculate y in cylinder coordinates, we can do similar triangles comparison,
 			// comparing the triangle from the center to the screen and from the center to the edge of the cylinder
-			int32 yInCylinderCoords = int32(floor(halfHeight + ((float)y - halfHeight) * cosAlpha));
+			float yInCylinderCoords = halfHeight + ((float)y - halfHeight) * cosAlpha;
 
-			uint32 index = y * _numColumns + x;
-
-			// Only store the (x,y) offsets instead of the absolute positions
-			_internalBuffer[index].x = xInCylinderCoords - x;
-			_internalBuffer[index].y = yInCylinderCoords - y;
+			setTableEntry(x, y, xInCylinderCoords, yInCylinderCoords);
 		}
 	}
 }
@@ -188,21 +245,16 @@ void RenderTable::generateTiltLookupTable() {
 
 		// To get y in cylinder coordinates, we just need to calculate the arc length
 		// We also scale it by _tiltOptions.linearScale
-		int32 yInCylinderCoords = int32(floor((cylinderRadius * _tiltOptions.linearScale * alpha) + halfHeight));
+		float yInCylinderCoords = (cylinderRadius * _tiltOptions.linearScale * alpha) + halfHeight;
 
 		float cosAlpha = cos(alpha);
-		uint32 columnIndex = y * _numColumns;
 
 		for (uint x = 0; x < _numColumns; ++x) {
 			// To calculate x in cylinder coordinates, we can do similar triangles comparison,
 			// comparing the triangle from the center to the screen and from the center to the edge of the cylinder
-			int32 xInCylinderCoords = int32(floor(halfWidth + ((float)x - halfWidth) * cosAlpha));
-
-			uint32 index = columnIndex + x;
+			float xInCylinderCoords = halfWidth + ((float)x - halfWidth) * cosAlpha;
 
-			// Only store the (x,y) offsets instead of the absolute positions
-			_internalBuffer[index].x = xInCylinderCoords - x;
-			_internalBuffer[index].y = yInCylinderCoords - y;
+			setTableEntry(x, y, xInCylinderCoords, yInCylinderCoords);
 		}
 	}
 }
@@ -210,12 +262,18 @@ void RenderTable::generateTiltLookupTable() {
 void RenderTable::setPanoramaFoV(float fov) {
 	assert(fov > 0.0f);
 
+	if (_panoramaOptions.fieldOfView != fov)
+		_tableDirty = true;
+
 	_panoramaOptions.fieldOfView = fov;
 }
 
 void RenderTable::setPanoramaScale(float scale) {
 	assert(scale > 0.0f);
 
+	if (_panoramaOptions.linearScale != scale)
+		_tableDirty = true;
+
 	_panoramaOptions.linearScale = scale;
 }
 
@@ -238,12 +296,18 @@ uint16 RenderTable::getPanoramaZeroPoint() {
 void RenderTable::setTiltFoV(float fov) {
 	assert(fov > 0.0f);
 
+	if (_tiltOptions.fieldOfView != fov)
+		_tableDirty = true;
+
 	_tiltOptions.fieldOfView = fov;
 }
 
 void RenderTable::setTiltScale(float scale) {
 	assert(scale > 0.0f);
 
+	if (_tiltOptions.linearScale != scale)
+		_tableDirty = true;
+
 	_tiltOptions.linearScale = scale;
 }
 
@@ -45,6 +45,14 @@ private:
 	Common::Point *_internalBuffer;
 	RenderState _renderState;
 
+	/** Absolute index of the source pixel for each destination pixel */
+	uint32 *_sourceIndex;
+	/** Sub-pixel source position in 1/16 pixels, x in the low and y in the high nibble */
+	byte *_sourceFraction;
+	bool _filtering;
+	/** Set when the options changed since the tables were last generated */
+	bool _tableDirty;
+
 	struct {
 		float fieldOfView;
 		float linearScale;
@@ -70,8 +78,16 @@ public:
 
 	void mutateImage(uint16 *sourceBuffer, uint16 *destBuffer, uint32 destWidth, const Common::Rect &subRect);
 	void mutateImage(Graphics::Surface *dstBuf, Graphics::Surface *srcBuf);
+	/**
+	 * Regenerates the lookup tables for the current options. This does
+	 * nothing if the options did not change since the last call.
+	 */
 	void generateRenderTable();
 
+	/** Enables bilinear filtering of the warped image */
+	void setFiltering(bool filtering) { _filtering = filtering; }
+	bool getFiltering() const { return _filtering; }
+
 	void setPanoramaFoV(float fov);
 	void setPanoramaScale(float scale);
 	void setPanoramaReverse(bool reverse);
@@ -90,6 +106,8 @@ public:
 private:
 	void generatePanoramaLookupTable();
 	void generateTiltLookupTable();
+	void setTableEntry(uint x, uint y, float sourceX, float sourceY);
+	void mutateImageFiltered(uint16 *sourceBuffer, uint16 *destBuffer, uint32 destPitch, const Common::Rect &subRect, const Graphics::PixelFormat &format);
 };
 
 } // End of namespace ZVision
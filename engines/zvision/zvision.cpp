@@ -44,6 +44,7 @@
 #include "common/error.h"
 #include "common/system.h"
 #include "common/file.h"
+#include "common/profiler.h"
 
 #include "gui/message.h"
 #include "engines/util.h"
@@ -228,6 +229,9 @@ void ZVision::initialize() {
 	_console = new Console(this);
 	_doubleFPS = ConfMan.getBool("doublefps");
 
+	ConfMan.registerDefault("panoramafiltering", false);
+	_renderManager->getRenderTable()->setFiltering(ConfMan.getBool("panoramafiltering"));
+
 	// Initialize FPS timer callback
 	getTimerManager()->installTimerProc(&fpsTimerCallback, 1000000, this, "zvisionFPS");
 }
@@ -314,7 +318,10 @@ Common::Error ZVision::run() {
 		processEvents();
 		_renderManager->updateRotation();
 
-		_scriptManager->update(deltaTime);
+		{
+			PROFILE_ZONE("ZVision::ScriptManager::update");
+			_scriptManager->update(deltaTime);
+		}
 		_menu->process(deltaTime);
 
 		// Render the backBuffer to the screen
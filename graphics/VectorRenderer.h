@@ -289,6 +289,9 @@ public:
 		_activeSurface = surface;
 	}
 
+	/** Returns the active drawing surface. */
+	TransparentSurface *getSurface() const { return _activeSurface; }
+
 	/**
 	 * Fills the active surface with the specified fg/bg color or the active gradient.
 	 * Defaults to using the active Foreground color for filling.
@@ -451,6 +454,12 @@ public:
 	virtual void drawStep(const Common::Rect &area, const DrawStep &step, uint32 extra = 0);
 	virtual void drawStepClip(const Common::Rect &area, const Common::Rect &clip, const DrawStep &step, uint32 extra = 0);
 
+	/**
+	 * Sets the colors a draw step specifies, as drawing it would.
+	 * Colors a step does not specify are kept for the following steps.
+	 */
+	void setStepColors(const DrawStep &step);
+
 	/**
 	 * Copies the part of the current frame to the system overlay.
 	 *
@@ -515,6 +524,7 @@ public:
 	 */
 	virtual void disableShadows() { _disableShadows = true; }
 	virtual void enableShadows() { _disableShadows = false; }
+	bool shadowsDisabled() const { return _disableShadows; }
 
 	/**
 	 * Applies a whole-screen shading effect, used before opening a new dialog.
@@ -428,14 +428,11 @@ namespace Graphics {
 /**
  * Fills several pixels in a row with a given color.
  *
- * This is a replacement function for Common::fill, using an unrolled
- * loop to maximize performance on most architectures.
- * This function may (and should) be overloaded in any child renderers
- * for portable platforms with platform-specific assembly code.
+ * This is a replacement function for Common::fill, using the SIMD span
+ * kernels from graphics/pixel_span.h where available.
  *
  * This fill operation is extensively used throughout the renderer, so this
- * counts as one of the main bottlenecks. Please replace it with assembly
- * when possible!
+ * counts as one of the main bottlenecks.
  *
  * @param first Pointer to the first pixel to fill.
  * @param last Pointer to the last pixel to fill.
@@ -443,22 +440,7 @@ namespace Graphics {
  */
 template<typename PixelType>
 void colorFill(PixelType *first, PixelType *last, PixelType color) {
-	int count = (last - first);
-	if (!count)
-		return;
-	int n = (count + 7) >> 3;
-	switch (count % 8) {
-	case 0: do {
-				*first++ = color;	// fall through
-	case 7:		*first++ = color;	// fall through
-	case 6:		*first++ = color;	// fall through
-	case 5:		*first++ = color;	// fall through
-	case 4:		*first++ = color;	// fall through
-	case 3:		*first++ = color;	// fall through
-	case 2:		*first++ = color;	// fall through
-	case 1:		*first++ = color;
-			} while (--n > 0);
-	}
+	fillSpan(first, last, color, color);
 }
 
 template<typename PixelType>
@@ -482,22 +464,10 @@ void colorFillClip(PixelType *first, PixelType *last, PixelType color, int realX
 		count -= diff;
 	}
 
-	if (!count)
+	if (count <= 0)
 		return;
 
-	int n = (count + 7) >> 3;
-	switch (count % 8) {
-	case 0: do {
-		*first++ = color;	// fall through
-	case 7:		*first++ = color;	// fall through
-	case 6:		*first++ = color;	// fall through
-	case 5:		*first++ = color;	// fall through
-	case 4:		*first++ = color;	// fall through
-	case 3:		*first++ = color;	// fall through
-	case 2:		*first++ = color;	// fall through
-	case 1:		*first++ = color;
-	} while (--n > 0);
-	}
+	fillSpan(first, first + count, color, color);
 }
 
 
@@ -629,16 +599,14 @@ gradientFill(PixelType *ptr, int width, int x, int y) {
 	} else if (grad == 3 && ox) {
 		colorFill<PixelType>(ptr, ptr + width, _gradCache[curGrad + 1]);
 	} else {
-		for (int j = x; j < x + width; j++, ptr++) {
-			bool oy = ((j & 1) == 1);
+		// Every row of the dithering pattern alternates between two colors
+		PixelType oddColumn = (ox || grad == 3) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+		PixelType evenColumn = (ox && (grad == 2 || grad == 3)) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
 
-			if ((ox && oy) ||
-				((grad == 2 || grad == 3) && ox && !oy) ||
-				(grad == 3 && oy))
-				*ptr = _gradCache[curGrad + 1];
-			else
-				*ptr = _gradCache[curGrad];
-		}
+		if (x & 1)
+			fillSpan(ptr, ptr + width, oddColumn, evenColumn);
+		else
+			fillSpan(ptr, ptr + width, evenColumn, oddColumn);
 	}
 }
 
@@ -671,17 +639,19 @@ gradientFillClip(PixelType *ptr, int width, int x, int y, int realX, int realY)
 	} else if (grad == 3 && ox) {
 		colorFill<PixelType>(ptr, ptr + width, _gradCache[curGrad + 1]);
 	} else {
-		for (int j = x; j < x + width; j++, ptr++) {
-			if (realX + j - x < _clippingArea.left || realX + j - x >= _clippingArea.right) continue;
-			bool oy = ((j & 1) == 1);
-
-			if ((ox && oy) ||
-				((grad == 2 || grad == 3) && ox && !oy) ||
-				(grad == 3 && oy))
-				*ptr = _gradCache[curGrad + 1];
-			else
-				*ptr = _gradCache[curGrad];
-		}
+		// Every row of the dithering pattern alternates between two colors
+		PixelType oddColumn = (ox || grad == 3) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+		PixelType evenColumn = (ox && (grad == 2 || grad == 3)) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+
+		int start = MAX(0, _clippingArea.left - realX);
+		int end = MIN(width, _clippingArea.right - realX);
+		if (start >= end)
+			return;
+
+		if ((x + start) & 1)
+			fillSpan(ptr + start, ptr + end, oddColumn, evenColumn);
+		else
+			fillSpan(ptr + start, ptr + end, evenColumn, oddColumn);
 	}
 }
 
@@ -3512,9 +3482,7 @@ drawSquareShadow(int x, int y, int w, int h, int offset) {
 	ptr = (PixelType *)_activeSurface->getBasePtr(x + offset, y + h - 1);
 
 	while (i++ < offset) {
-		j = w - offset;
-		while (j--)
-			blendPixelPtr(ptr + j, 0, ((offset - i) << 8) / offset);
+		blendFill(ptr, ptr + w - offset, 0, ((offset - i) << 8) / offset);
 		ptr += pitch;
 	}
 
@@ -3556,9 +3524,7 @@ drawSquareShadowClip(int x, int y, int w, int h, int offset) {
 	ptr_y = y + h - 1;
 
 	while (i++ < offset) {
-		j = w - offset;
-		while (j--)
-			blendPixelPtrClip(ptr + j, 0, ((offset - i) << 8) / offset, ptr_x + j, ptr_y);
+		blendFillClip(ptr, ptr + w - offset, 0, ((offset - i) << 8) / offset, ptr_x, ptr_y);
 		ptr += pitch;
 		++ptr_y;
 	}
@@ -24,6 +24,7 @@
 #define VECTOR_RENDERER_SPEC_H
 
 #include "graphics/VectorRenderer.h"
+#include "graphics/pixel_span.h"
 
 namespace Graphics {
 
@@ -289,18 +290,16 @@ protected:
 	 * @param alpha Alpha intensity of the pixel (0-255)
 	 */
 	inline void blendFill(PixelType *first, PixelType *last, PixelType color, uint8 alpha) {
-		while (first != last) blendPixelPtr(first++, color, alpha);
+		blendSpan(first, last, _format, color, alpha);
 	}
 
 	inline void blendFillClip(PixelType *first, PixelType *last, PixelType color, uint8 alpha, int realX, int realY) {
 		if (_clippingArea.top <= realY && realY < _clippingArea.bottom) {
-			while (first != last) {
-				if (_clippingArea.left <= realX && realX < _clippingArea.right)
-					blendPixelPtr(first++, color, alpha);
-				else
-					++first;
-				++realX;
-			}
+			int count = last - first;
+			int start = MAX(0, _clippingArea.left - realX);
+			int end = MIN(count, _clippingArea.right - realX);
+			if (start < end)
+				blendSpan(first + start, first + end, _format, color, alpha);
 		}
 	}
 
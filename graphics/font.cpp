@@ -39,12 +39,12 @@ Common::Rect Font::getBoundingBox(uint32 chr) const {
 namespace {
 
 template<class StringType>
-Common::Rect getBoundingBoxImpl(const Font &font, const StringType &str, int x, int y, int w, TextAlign align, int deltax) {
+Common::Rect getBoundingBoxImpl(const Font &font, const StringType &str, int x, int y, int w, TextAlign align, int deltax, const Font::StringLayout *layout) {
 	// We follow the logic of drawStringImpl here. The only exception is
 	// that we do allow an empty width to be specified here. This allows us
 	// to obtain the complete bounding box of a string.
 	const int leftX = x, rightX = w ? (x + w) : 0x7FFFFFFF;
-	int width = font.getStringWidth(str);
+	int width = layout ? layout->width : font.getStringWidth(str);
 
 	if (align == kTextAlignCenter)
 		x = x + (w - width)/2;
@@ -55,12 +55,18 @@ Common::Rect getBoundingBoxImpl(const Font &font, const StringType &str, int x,
 	bool first = true;
 	Common::Rect bbox;
 
+	const int startX = x;
 	typename StringType::unsigned_type last = 0;
-	for (typename StringType::const_iterator i = str.begin(), end = str.end(); i != end; ++i) {
-		const typename StringType::unsigned_type cur = *i;
-		x += font.getKerningOffset(last, cur);
-		last = cur;
-		w = font.getCharWidth(cur);
+	for (uint n = 0; n < str.size(); ++n) {
+		const typename StringType::unsigned_type cur = str[n];
+		if (layout) {
+			x = startX + layout->charX[n];
+			w = layout->charWidth[n];
+		} else {
+			x += font.getKerningOffset(last, cur);
+			last = cur;
+			w = font.getCharWidth(cur);
+		}
 		if (x+w > rightX)
 			break;
 		if (x+w >= leftX) {
@@ -94,13 +100,13 @@ int getStringWidthImpl(const Font &font, const StringType &str) {
 }
 
 template<class StringType>
-void drawStringImpl(const Font &font, Surface *dst, const StringType &str, int x, int y, int w, uint32 color, TextAlign align, int deltax) {
+void drawStringImpl(const Font &font, Surface *dst, const StringType &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, const Font::StringLayout *layout) {
 	// The logic in getBoundingImpl is the same as we use here. In case we
 	// ever change something here we will need to change it there too.
 	assert(dst != 0);
 
 	const int leftX = x, rightX = x + w;
-	int width = font.getStringWidth(str);
+	int width = layout ? layout->width : font.getStringWidth(str);
 
 	if (align == kTextAlignCenter)
 		x = x + (w - width)/2;
@@ -108,12 +114,18 @@ void drawStringImpl(const Font &font, Surface *dst, const StringType &str, int x
 		x = x + w - width;
 	x += deltax;
 
+	const int startX = x;
 	typename StringType::unsigned_type last = 0;
-	for (typename StringType::const_iterator i = str.begin(), end = str.end(); i != end; ++i) {
-		const typename StringType::unsigned_type cur = *i;
-		x += font.getKerningOffset(last, cur);
-		last = cur;
-		w = font.getCharWidth(cur);
+	for (uint n = 0; n < str.size(); ++n) {
+		const typename StringType::unsigned_type cur = str[n];
+		if (layout) {
+			x = startX + layout->charX[n];
+			w = layout->charWidth[n];
+		} else {
+			x += font.getKerningOffset(last, cur);
+			last = cur;
+			w = font.getCharWidth(cur);
+		}
 		if (x+w > rightX)
 			break;
 		if (x+w >= leftX)
@@ -249,7 +261,7 @@ Common::Rect Font::getBoundingBox(const Common::String &input, int x, int y, con
 	}
 
 	const Common::String str = useEllipsis ? handleEllipsis(input, w) : input;
-	return getBoundingBoxImpl(*this, str, x, y, w, align, deltax);
+	return getBoundingBoxImpl(*this, str, x, y, w, align, deltax, getStringLayout(str, true));
 }
 
 Common::Rect Font::getBoundingBox(const Common::U32String &str, int x, int y, const int w, TextAlign align) const {
@@ -263,10 +275,14 @@ Common::Rect Font::getBoundingBox(const Common::U32String &str, int x, int y, co
 		align = kTextAlignLeft;
 	}
 
-	return getBoundingBoxImpl(*this, str, x, y, w, align, 0);
+	return getBoundingBoxImpl(*this, str, x, y, w, align, 0, 0);
 }
 
 int Font::getStringWidth(const Common::String &str) const {
+	const StringLayout *layout = getStringLayout(str, false);
+	if (layout)
+		return layout->width;
+
 	return getStringWidthImpl(*this, str);
 }
 
@@ -284,11 +300,11 @@ void Font::drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color)
 
 void Font::drawString(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
 	Common::String renderStr = useEllipsis ? handleEllipsis(str, w) : str;
-	drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax);
+	drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax, getStringLayout(renderStr, true));
 }
 
 void Font::drawString(Surface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align) const {
-	drawStringImpl(*this, dst, str, x, y, w, color, align, 0);
+	drawStringImpl(*this, dst, str, x, y, w, color, align, 0, 0);
 }
 
 void Font::drawString(ManagedSurface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
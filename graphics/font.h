@@ -23,13 +23,11 @@
 #ifndef GRAPHICS_FONT_H
 #define GRAPHICS_FONT_H
 
+#include "common/array.h"
 #include "common/str.h"
 #include "common/ustr.h"
 #include "common/rect.h"
 
-namespace Common {
-template<class T> class Array;
-}
 
 namespace Graphics {
 
@@ -51,6 +49,16 @@ enum TextAlign {
  */
 class Font {
 public:
+	/**
+	 * The horizontal layout of a string as drawn by drawString.
+	 * @see getStringLayout
+	 */
+	struct StringLayout {
+		Common::Array<int> charX;     ///< Position of every character relative to the start, kerning included
+		Common::Array<int> charWidth; ///< Width of every character
+		int width;                    ///< Width of the whole string
+	};
+
 	Font() {}
 	virtual ~Font() {}
 
@@ -178,6 +186,21 @@ public:
 	int wordWrapText(const Common::String &str, int maxWidth, Common::Array<Common::String> &lines, int initWidth = 0) const;
 	int wordWrapText(const Common::U32String &str, int maxWidth, Common::Array<Common::U32String> &lines, int initWidth = 0) const;
 
+protected:
+	/**
+	 * Query the cached layout of a string.
+	 *
+	 * Fonts which are expensive to measure can override this to remember the
+	 * layout of the strings they draw, so that measuring and drawing them
+	 * again does not need to query every character. The default
+	 * implementation does not cache anything.
+	 *
+	 * @param str    The string to query the layout of.
+	 * @param create Whether to lay out and cache str if it is not cached yet.
+	 * @return The layout, or 0 if str is not cached.
+	 */
+	virtual const StringLayout *getStringLayout(const Common::String &str, bool create) const { return 0; }
+
 private:
 	Common::String handleEllipsis(const Common::String &str, int w) const;
 };
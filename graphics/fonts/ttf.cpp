@@ -29,12 +29,14 @@
 
 #include "graphics/fonts/ttf.h"
 #include "graphics/font.h"
+#include "graphics/pixel_span.h"
 #include "graphics/surface.h"
 
 #include "common/singleton.h"
 #include "common/stream.h"
 #include "common/memstream.h"
 #include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "common/ptr.h"
 
 #include <ft2build.h>
@@ -122,7 +124,16 @@ public:
 	virtual Common::Rect getBoundingBox(uint32 chr) const;
 
 	virtual void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const;
+
+protected:
+	virtual const StringLayout *getStringLayout(const Common::String &str, bool create) const;
+
 private:
+	enum {
+		kAtlasPageSize = 256,
+		kMaxCachedLayouts = 256
+	};
+
 	bool _initialized;
 	FT_Face _face;
 
@@ -133,7 +144,7 @@ private:
 	int _ascent, _descent;
 
 	struct Glyph {
-		Surface image;
+		Surface image; // Area of an atlas page, not owned by the glyph
 		int xOffset, yOffset;
 		int advance;
 		FT_UInt slot;
@@ -145,6 +156,27 @@ private:
 	bool _allowLateCaching;
 	void assureCached(uint32 chr) const;
 
+	// The glyph images are packed into atlas pages, row by row, so drawing a
+	// string touches few cache lines and caching a glyph does not allocate.
+	void allocateGlyphImage(Surface &image, int w, int h) const;
+	mutable Common::Array<Surface *> _atlasPages;
+	mutable Surface *_atlasPage;
+	mutable int _atlasX, _atlasY, _atlasRowHeight;
+
+	// Kerning offsets, keyed by the glyph slots of both characters
+	typedef Common::HashMap<uint32, int> KerningCache;
+	mutable KerningCache _kerning;
+
+	// String layouts, with the value of _layoutClock when they were last used
+	struct CachedLayout {
+		StringLayout layout;
+		uint32 lastUse;
+	};
+
+	typedef Common::HashMap<Common::String, CachedLayout> LayoutCache;
+	mutable LayoutCache _layouts;
+	mutable uint32 _layoutClock;
+
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
 	int computePointSize(int size, TTFSizeMode sizeMode) const;
@@ -159,7 +191,7 @@ private:
 TTFFont::TTFFont()
     : _initialized(false), _face(), _ttfFile(0), _size(0), _width(0), _height(0), _ascent(0),
       _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
-      _hasKerning(false), _allowLateCaching(false) {
+      _hasKerning(false), _allowLateCaching(false), _atlasPage(0), _atlasX(0), _atlasY(0), _atlasRowHeight(0), _layoutClock(0) {
 }
 
 TTFFont::~TTFFont() {
@@ -169,11 +201,13 @@ TTFFont::~TTFFont() {
 		delete[] _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
-
 		_initialized = false;
 	}
+
+	for (uint i = 0; i < _atlasPages.size(); ++i) {
+		_atlasPages[i]->free();
+		delete _atlasPages[i];
+	}
 }
 
 bool TTFFont::load(Common::SeekableReadStream &stream, int size, TTFSizeMode sizeMode, uint dpi, TTFRenderMode renderMode, const uint32 *mapping) {
@@ -440,9 +474,66 @@ int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	if (!leftGlyph || !rightGlyph)
 		return 0;
 
+	// Slots beyond 16 bits are rare enough to not be worth caching
+	const bool cacheable = (leftGlyph | rightGlyph) <= 0xFFFF;
+	const uint32 key = (leftGlyph << 16) | rightGlyph;
+	if (cacheable) {
+		KerningCache::const_iterator kerningEntry = _kerning.find(key);
+		if (kerningEntry != _kerning.end())
+			return kerningEntry->_value;
+	}
+
 	FT_Vector kerningVector;
 	FT_Get_Kerning(_face, leftGlyph, rightGlyph, FT_KERNING_DEFAULT, &kerningVector);
-	return (kerningVector.x / 64);
+	const int offset = kerningVector.x / 64;
+
+	if (cacheable)
+		_kerning[key] = offset;
+	return offset;
+}
+
+const Font::StringLayout *TTFFont::getStringLayout(const Common::String &str, bool create) const {
+	LayoutCache::iterator layoutEntry = _layouts.find(str);
+	if (layoutEntry != _layouts.end()) {
+		layoutEntry->_value.lastUse = ++_layoutClock;
+		return &layoutEntry->_value.layout;
+	}
+
+	if (!create || str.empty())
+		return 0;
+
+	// Strings drawn by the GUI and by engines are mostly the same from frame
+	// to frame, so drop the least recently used layout to make room.
+	if (_layouts.size() >= kMaxCachedLayouts) {
+		LayoutCache::iterator oldest = _layouts.begin();
+		for (LayoutCache::iterator i = _layouts.begin(); i != _layouts.end(); ++i) {
+			if (i->_value.lastUse < oldest->_value.lastUse)
+				oldest = i;
+		}
+		_layouts.erase(oldest);
+	}
+
+	CachedLayout &cached = _layouts[str];
+	cached.lastUse = ++_layoutClock;
+
+	StringLayout &layout = cached.layout;
+	layout.charX.resize(str.size());
+	layout.charWidth.resize(str.size());
+
+	int x = 0;
+	Common::String::unsigned_type last = 0;
+	for (uint i = 0; i < str.size(); ++i) {
+		const Common::String::unsigned_type cur = str[i];
+		x += getKerningOffset(last, cur);
+		last = cur;
+
+		layout.charX[i] = x;
+		layout.charWidth[i] = getCharWidth(cur);
+		x += layout.charWidth[i];
+	}
+	layout.width = x;
+
+	return &layout;
 }
 
 Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
@@ -462,32 +553,9 @@ namespace {
 
 template<typename ColorType>
 void renderGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos, const int srcPitch, const int w, const int h, ColorType color, const PixelFormat &dstFormat) {
-	uint8 sR, sG, sB;
-	dstFormat.colorToRGB(color, sR, sG, sB);
-
 	for (int y = 0; y < h; ++y) {
 		ColorType *rDst = (ColorType *)dstPos;
-		const uint8 *src = srcPos;
-
-		for (int x = 0; x < w; ++x) {
-			if (*src == 255) {
-				*rDst = color;
-			} else if (*src) {
-				const uint8 a = *src;
-
-				uint8 dR, dG, dB;
-				dstFormat.colorToRGB(*rDst, dR, dG, dB);
-
-				dR = ((255 - a) * dR + a * sR) / 255;
-				dG = ((255 - a) * dG + a * sG) / 255;
-				dB = ((255 - a) * dB + a * sB) / 255;
-
-				*rDst = dstFormat.RGBToColor(dR, dG, dB);
-			}
-
-			++rDst;
-			++src;
-		}
+		maskSpan(rDst, rDst + w, srcPos, dstFormat, color);
 
 		dstPos += dstPitch;
 		srcPos += srcPitch;
@@ -594,7 +662,12 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	glyph.advance = ftCeil26_6(_face->glyph->advance.x);
 
 	const FT_Bitmap &bitmap = _face->glyph->bitmap;
-	glyph.image.create(bitmap.width, bitmap.rows, PixelFormat::createFormatCLUT8());
+	if (bitmap.pixel_mode != FT_PIXEL_MODE_MONO && bitmap.pixel_mode != FT_PIXEL_MODE_GRAY) {
+		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap.pixel_mode);
+		return false;
+	}
+
+	allocateGlyphImage(glyph.image, bitmap.width, bitmap.rows);
 
 	const uint8 *src = bitmap.buffer;
 	int srcPitch = bitmap.pitch;
@@ -604,10 +677,8 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	}
 
 	uint8 *dst = (uint8 *)glyph.image.getPixels();
-	memset(dst, 0, glyph.image.h * glyph.image.pitch);
 
-	switch (bitmap.pixel_mode) {
-	case FT_PIXEL_MODE_MONO:
+	if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO) {
 		for (int y = 0; y < (int)bitmap.rows; ++y) {
 			const uint8 *curSrc = src;
 			uint8 mask = 0;
@@ -617,33 +688,62 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 					mask = *curSrc++;
 
 				if (mask & 0x80)
-					*dst = 255;
+					dst[x] = 255;
 
 				mask <<= 1;
-				++dst;
 			}
 
+			dst += glyph.image.pitch;
 			src += srcPitch;
 		}
-		break;
-
-	case FT_PIXEL_MODE_GRAY:
+	} else {
 		for (int y = 0; y < (int)bitmap.rows; ++y) {
 			memcpy(dst, src, bitmap.width);
 			dst += glyph.image.pitch;
 			src += srcPitch;
 		}
-		break;
-
-	default:
-		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap.pixel_mode);
-		glyph.image.free();
-		return false;
 	}
 
 	return true;
 }
 
+void TTFFont::allocateGlyphImage(Surface &image, int w, int h) const {
+	if (w <= 0 || h <= 0) {
+		image.init(0, 0, 0, 0, PixelFormat::createFormatCLUT8());
+		return;
+	}
+
+	// Glyphs too large for the atlas get a page of their own
+	if (w > kAtlasPageSize || h > kAtlasPageSize) {
+		Surface *page = new Surface();
+		page->create(w, h, PixelFormat::createFormatCLUT8());
+		memset(page->getPixels(), 0, page->h * page->pitch);
+		_atlasPages.push_back(page);
+
+		image.init(w, h, page->pitch, page->getPixels(), page->format);
+		return;
+	}
+
+	if (_atlasX + w > kAtlasPageSize) {
+		_atlasX = 0;
+		_atlasY += _atlasRowHeight;
+		_atlasRowHeight = 0;
+	}
+
+	if (!_atlasPage || _atlasY + h > kAtlasPageSize) {
+		_atlasPage = new Surface();
+		_atlasPage->create(kAtlasPageSize, kAtlasPageSize, PixelFormat::createFormatCLUT8());
+		memset(_atlasPage->getPixels(), 0, _atlasPage->h * _atlasPage->pitch);
+		_atlasPages.push_back(_atlasPage);
+
+		_atlasX = _atlasY = _atlasRowHeight = 0;
+	}
+
+	image.init(w, h, _atlasPage->pitch, _atlasPage->getBasePtr(_atlasX, _atlasY), _atlasPage->format);
+	_atlasX += w;
+	_atlasRowHeight = MAX(_atlasRowHeight, h);
+}
+
 void TTFFont::assureCached(uint32 chr) const {
 	if (!chr || !_allowLateCaching || _glyphs.contains(chr)) {
 		return;
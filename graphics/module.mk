@@ -23,6 +23,7 @@ MODULE_OBJS := \
 	managed_surface.o \
 	nine_patch.o \
 	pixelformat.o \
+	pixel_span.o \
 	primitives.o \
 	scaler.o \
 	scaler/thumbnail_intern.o \
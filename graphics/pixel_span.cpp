@@ -0,0 +1,1371 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/util.h"
+#include "graphics/pixel_span.h"
+
+#if defined(__SSE2__)
+#define PIXEL_SPAN_SSE2
+#include <emmintrin.h>
+
+// AVX2 is not part of the x86-64 baseline, so it is compiled through a
+// function level target attribute and only used when the CPU reports it.
+#if GCC_ATLEAST(4, 9) || defined(__clang__)
+#define PIXEL_SPAN_AVX2
+#include <immintrin.h>
+#define PIXEL_SPAN_AVX2_TARGET __attribute__((__target__("avx2")))
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PIXEL_SPAN_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Graphics {
+
+namespace {
+
+/**
+ * A set of span functions. The count passed to them is always positive.
+ *
+ * All blend functions compute every channel as dst + (((src - dst) * alpha) >> 8),
+ * which is the same as (dst * (256 - alpha) + src * alpha) >> 8 and therefore
+ * never leaves the range of the channel. The SIMD versions use the latter form
+ * so all intermediate values fit into 16 bit lanes. The mask functions work on
+ * 8 bit channels and divide by 255 instead, which the SIMD versions compute as
+ * (x + 1 + (x >> 8)) >> 8. That is exact for every x up to 255 * 255.
+ */
+struct SpanKernel {
+	const char *name;
+	void (*fill16)(uint16 *dst, uint count, uint16 evenColor, uint16 oddColor);
+	void (*fill32)(uint32 *dst, uint count, uint32 evenColor, uint32 oddColor);
+	void (*blend16)(uint16 *dst, uint count, const PixelFormat &format, uint16 color, uint8 alpha);
+	void (*blend32)(uint32 *dst, uint count, const PixelFormat &format, uint32 color, uint8 alpha);
+	void (*mask16)(uint16 *dst, uint count, const byte *coverage, const PixelFormat &format, uint16 color);
+	void (*mask32)(uint32 *dst, uint count, const byte *coverage, const PixelFormat &format, uint32 color);
+	void (*blit)(TSpriteBlendMode blendMode, const byte *in, int32 inStep, byte *out, uint count, uint32 color);
+};
+
+inline uint32 channelMask(uint8 loss, uint8 shift) {
+	return (0xFF >> loss) << shift;
+}
+
+// The byte wise SIMD kernels for 32bpp need every channel in a byte of its own
+bool isByteFormat(const PixelFormat &format) {
+	return format.rLoss == 0 && format.gLoss == 0 && format.bLoss == 0
+	    && (format.rShift & 7) == 0 && (format.gShift & 7) == 0 && (format.bShift & 7) == 0
+	    && (format.aLoss == 8 || (format.aLoss == 0 && (format.aShift & 7) == 0));
+}
+
+// The pixel blended onto 32bpp surfaces by the byte wise kernels. Its alpha
+// channel is opaque, just like in the scalar implementation.
+uint32 byteFormatSource(const PixelFormat &format, uint32 color) {
+	uint32 rgbMask = channelMask(format.rLoss, format.rShift) | channelMask(format.gLoss, format.gShift) | channelMask(format.bLoss, format.bShift);
+	return (color & rgbMask) | channelMask(format.aLoss, format.aShift);
+}
+
+uint32 byteFormatMask(const PixelFormat &format) {
+	return channelMask(format.rLoss, format.rShift) | channelMask(format.gLoss, format.gShift)
+	     | channelMask(format.bLoss, format.bShift) | channelMask(format.aLoss, format.aShift);
+}
+
+// The SIMD mask kernels expand a channel to 8 bits with one shift each way,
+// which needs at least 4 bits per channel
+bool isExpandableFormat(const PixelFormat &format) {
+	return format.rLoss <= 4 && format.gLoss <= 4 && format.bLoss <= 4;
+}
+
+template<typename PixelInt>
+void fillSpanScalar(PixelInt *dst, uint count, PixelInt evenColor, PixelInt oddColor) {
+	if (evenColor != oddColor) {
+		for (uint i = 0; i + 1 < count; i += 2) {
+			dst[i] = evenColor;
+			dst[i + 1] = oddColor;
+		}
+		if (count & 1)
+			dst[count - 1] = evenColor;
+		return;
+	}
+
+	int n = (count + 7) >> 3;
+	switch (count % 8) {
+	case 0: do {
+				*dst++ = evenColor;	// fall through
+	case 7:		*dst++ = evenColor;	// fall through
+	case 6:		*dst++ = evenColor;	// fall through
+	case 5:		*dst++ = evenColor;	// fall through
+	case 4:		*dst++ = evenColor;	// fall through
+	case 3:		*dst++ = evenColor;	// fall through
+	case 2:		*dst++ = evenColor;	// fall through
+	case 1:		*dst++ = evenColor;
+			} while (--n > 0);
+	}
+}
+
+void blendSpanScalar16(uint16 *dst, uint count, const PixelFormat &format, uint16 color, uint8 alpha) {
+	const int redMask = channelMask(format.rLoss, format.rShift);
+	const int greenMask = channelMask(format.gLoss, format.gShift);
+	const int blueMask = channelMask(format.bLoss, format.bShift);
+	const int alphaMask = channelMask(format.aLoss, format.aShift);
+	const int isrc = color;
+
+	for (uint i = 0; i < count; i++) {
+		int idst = dst[i];
+
+		dst[i] = (uint16)(
+			(redMask & ((idst & redMask) +
+			((int)(((int)(isrc & redMask) -
+			(int)(idst & redMask)) * alpha) >> 8))) |
+			(greenMask & ((idst & greenMask) +
+			((int)(((int)(isrc & greenMask) -
+			(int)(idst & greenMask)) * alpha) >> 8))) |
+			(blueMask & ((idst & blueMask) +
+			((int)(((int)(isrc & blueMask) -
+			(int)(idst & blueMask)) * alpha) >> 8))) |
+			(alphaMask & ((idst & alphaMask) +
+			((int)(((int)(alphaMask) -
+			(int)(idst & alphaMask)) * alpha) >> 8))));
+	}
+}
+
+void blendSpanScalar32(uint32 *dst, uint count, const PixelFormat &format, uint32 color, uint8 alpha) {
+	const uint32 redMask = channelMask(format.rLoss, format.rShift);
+	const uint32 greenMask = channelMask(format.gLoss, format.gShift);
+	const uint32 blueMask = channelMask(format.bLoss, format.bShift);
+	const uint32 alphaMask = channelMask(format.aLoss, format.aShift);
+
+	const byte sR = (color & redMask) >> format.rShift;
+	const byte sG = (color & greenMask) >> format.gShift;
+	const byte sB = (color & blueMask) >> format.bShift;
+
+	for (uint i = 0; i < count; i++) {
+		byte dR = (dst[i] & redMask) >> format.rShift;
+		byte dG = (dst[i] & greenMask) >> format.gShift;
+		byte dB = (dst[i] & blueMask) >> format.bShift;
+		byte dA = (dst[i] & alphaMask) >> format.aShift;
+
+		dR += ((sR - dR) * alpha) >> 8;
+		dG += ((sG - dG) * alpha) >> 8;
+		dB += ((sB - dB) * alpha) >> 8;
+		dA += ((0xff - dA) * alpha) >> 8;
+
+		dst[i] = ((dR << format.rShift) & redMask)
+		       | ((dG << format.gShift) & greenMask)
+		       | ((dB << format.bShift) & blueMask)
+		       | ((dA << format.aShift) & alphaMask);
+	}
+}
+
+template<typename PixelInt>
+void maskSpanScalar(PixelInt *dst, uint count, const byte *coverage, const PixelFormat &format, PixelInt color) {
+	uint8 sR, sG, sB;
+	format.colorToRGB(color, sR, sG, sB);
+
+	for (uint i = 0; i < count; i++) {
+		const uint8 a = coverage[i];
+
+		if (a == 255) {
+			dst[i] = color;
+		} else if (a) {
+			uint8 dR, dG, dB;
+			format.colorToRGB(dst[i], dR, dG, dB);
+
+			dR = ((255 - a) * dR + a * sR) / 255;
+			dG = ((255 - a) * dG + a * sG) / 255;
+			dB = ((255 - a) * dB + a * sB) / 255;
+
+			dst[i] = format.RGBToColor(dR, dG, dB);
+		}
+	}
+}
+
+// Byte offsets of the channels of TransparentSurface pixels
+#ifdef SCUMM_LITTLE_ENDIAN
+enum {
+	kBlitAIndex = 0,
+	kBlitBIndex = 1,
+	kBlitGIndex = 2,
+	kBlitRIndex = 3
+};
+#else
+enum {
+	kBlitAIndex = 3,
+	kBlitBIndex = 2,
+	kBlitGIndex = 1,
+	kBlitRIndex = 0
+};
+#endif
+
+void blitSpanScalarAlpha(const byte *in, int32 inStep, byte *out, uint count, uint32 color) {
+	if (color == 0xffffffff) {
+		for (uint j = 0; j < count; j++) {
+			if (in[kBlitAIndex] != 0) {
+				out[kBlitAIndex] = 255;
+				out[kBlitRIndex] = ((in[kBlitRIndex] * in[kBlitAIndex]) + out[kBlitRIndex] * (255 - in[kBlitAIndex])) >> 8;
+				out[kBlitGIndex] = ((in[kBlitGIndex] * in[kBlitAIndex]) + out[kBlitGIndex] * (255 - in[kBlitAIndex])) >> 8;
+				out[kBlitBIndex] = ((in[kBlitBIndex] * in[kBlitAIndex]) + out[kBlitBIndex] * (255 - in[kBlitAIndex])) >> 8;
+			}
+
+			in += inStep;
+			out += 4;
+		}
+	} else {
+		byte ca = (color >> 24) & 0xFF;
+		byte cr = (color >> 16) & 0xFF;
+		byte cg = (color >> 8) & 0xFF;
+		byte cb = (color >> 0) & 0xFF;
+
+		for (uint j = 0; j < count; j++) {
+			uint32 ina = in[kBlitAIndex] * ca >> 8;
+			out[kBlitAIndex] = 255;
+			out[kBlitBIndex] = (out[kBlitBIndex] * (255 - ina) >> 8);
+			out[kBlitGIndex] = (out[kBlitGIndex] * (255 - ina) >> 8);
+			out[kBlitRIndex] = (out[kBlitRIndex] * (255 - ina) >> 8);
+
+			out[kBlitBIndex] = out[kBlitBIndex] + (in[kBlitBIndex] * ina * cb >> 16);
+			out[kBlitGIndex] = out[kBlitGIndex] + (in[kBlitGIndex] * ina * cg >> 16);
+			out[kBlitRIndex] = out[kBlitRIndex] + (in[kBlitRIndex] * ina * cr >> 16);
+
+			in += inStep;
+			out += 4;
+		}
+	}
+}
+
+void blitSpanScalarAdditive(const byte *in, int32 inStep, byte *out, uint count, uint32 color) {
+	if (color == 0xffffffff) {
+		for (uint j = 0; j < count; j++) {
+			if (in[kBlitAIndex] != 0) {
+				out[kBlitRIndex] = MIN((in[kBlitRIndex] * in[kBlitAIndex] >> 8) + out[kBlitRIndex], 255);
+				out[kBlitGIndex] = MIN((in[kBlitGIndex] * in[kBlitAIndex] >> 8) + out[kBlitGIndex], 255);
+				out[kBlitBIndex] = MIN((in[kBlitBIndex] * in[kBlitAIndex] >> 8) + out[kBlitBIndex], 255);
+			}
+
+			in += inStep;
+			out += 4;
+		}
+	} else {
+		byte ca = (color >> 24) & 0xFF;
+		byte cr = (color >> 16) & 0xFF;
+		byte cg = (color >> 8) & 0xFF;
+		byte cb = (color >> 0) & 0xFF;
+
+		for (uint j = 0; j < count; j++) {
+			uint32 ina = in[kBlitAIndex] * ca >> 8;
+
+			if (cb != 255) {
+				out[kBlitBIndex] = MIN<uint>(out[kBlitBIndex] + ((in[kBlitBIndex] * cb * ina) >> 16), 255u);
+			} else {
+				out[kBlitBIndex] = MIN<uint>(out[kBlitBIndex] + (in[kBlitBIndex] * ina >> 8), 255u);
+			}
+
+			if (cg != 255) {
+				out[kBlitGIndex] = MIN<uint>(out[kBlitGIndex] + ((in[kBlitGIndex] * cg * ina) >> 16), 255u);
+			} else {
+				out[kBlitGIndex] = MIN<uint>(out[kBlitGIndex] + (in[kBlitGIndex] * ina >> 8), 255u);
+			}
+
+			if (cr != 255) {
+				out[kBlitRIndex] = MIN<uint>(out[kBlitRIndex] + ((in[kBlitRIndex] * cr * ina) >> 16), 255u);
+			} else {
+				out[kBlitRIndex] = MIN<uint>(out[kBlitRIndex] + (in[kBlitRIndex] * ina >> 8), 255u);
+			}
+
+			in += inStep;
+			out += 4;
+		}
+	}
+}
+
+void blitSpanScalarSubtractive(const byte *in, int32 inStep, byte *out, uint count, uint32 color) {
+	if (color == 0xffffffff) {
+		for (uint j = 0; j < count; j++) {
+			if (in[kBlitAIndex] != 0) {
+				out[kBlitRIndex] = MAX(out[kBlitRIndex] - ((in[kBlitRIndex] * out[kBlitRIndex]) * in[kBlitAIndex] >> 16), 0);
+				out[kBlitGIndex] = MAX(out[kBlitGIndex] - ((in[kBlitGIndex] * out[kBlitGIndex]) * in[kBlitAIndex] >> 16), 0);
+				out[kBlitBIndex] = MAX(out[kBlitBIndex] - ((in[kBlitBIndex] * out[kBlitBIndex]) * in[kBlitAIndex] >> 16), 0);
+			}
+
+			in += inStep;
+			out += 4;
+		}
+	} else {
+		byte cr = (color >> 16) & 0xFF;
+		byte cg = (color >> 8) & 0xFF;
+		byte cb = (color >> 0) & 0xFF;
+
+		// The products of four channels need all 32 bits, so they are
+		// computed unsigned. The result never exceeds the target channel.
+		for (uint j = 0; j < count; j++) {
+			out[kBlitAIndex] = 255;
+			if (cb != 255) {
+				out[kBlitBIndex] = out[kBlitBIndex] - ((uint32)in[kBlitBIndex] * cb * out[kBlitBIndex] * in[kBlitAIndex] >> 24);
+			} else {
+				out[kBlitBIndex] = MAX(out[kBlitBIndex] - (in[kBlitBIndex] * (out[kBlitBIndex]) * in[kBlitAIndex] >> 16), 0);
+			}
+
+			if (cg != 255) {
+				out[kBlitGIndex] = out[kBlitGIndex] - ((uint32)in[kBlitGIndex] * cg * out[kBlitGIndex] * in[kBlitAIndex] >> 24);
+			} else {
+				out[kBlitGIndex] = MAX(out[kBlitGIndex] - (in[kBlitGIndex] * (out[kBlitGIndex]) * in[kBlitAIndex] >> 16), 0);
+			}
+
+			if (cr != 255) {
+				out[kBlitRIndex] = out[kBlitRIndex] - ((uint32)in[kBlitRIndex] * cr * out[kBlitRIndex] * in[kBlitAIndex] >> 24);
+			} else {
+				out[kBlitRIndex] = MAX(out[kBlitRIndex] - (in[kBlitRIndex] * (out[kBlitRIndex]) * in[kBlitAIndex] >> 16), 0);
+			}
+
+			in += inStep;
+			out += 4;
+		}
+	}
+}
+
+void blitSpanScalarMultiply(const byte *in, int32 inStep, byte *out, uint count, uint32 color) {
+	if (color == 0xffffffff) {
+		for (uint j = 0; j < count; j++) {
+			if (in[kBlitAIndex] != 0) {
+				out[kBlitRIndex] = MIN((in[kBlitRIndex] * in[kBlitAIndex] >> 8) * out[kBlitRIndex] >> 8, 255);
+				out[kBlitGIndex] = MIN((in[kBlitGIndex] * in[kBlitAIndex] >> 8) * out[kBlitGIndex] >> 8, 255);
+				out[kBlitBIndex] = MIN((in[kBlitBIndex] * in[kBlitAIndex] >> 8) * out[kBlitBIndex] >> 8, 255);
+			}
+
+			in += inStep;
+			out += 4;
+		}
+	} else {
+		byte ca = (color >> 24) & 0xFF;
+		byte cr = (color >> 16) & 0xFF;
+		byte cg = (color >> 8) & 0xFF;
+		byte cb = (color >> 0) & 0xFF;
+
+		for (uint j = 0; j < count; j++) {
+			uint32 ina = in[kBlitAIndex] * ca >> 8;
+
+			if (cb != 255) {
+				out[kBlitBIndex] = MIN<uint>(out[kBlitBIndex] * ((in[kBlitBIndex] * cb * ina) >> 16) >> 8, 255u);
+			} else {
+				out[kBlitBIndex] = MIN<uint>(out[kBlitBIndex] * (in[kBlitBIndex] * ina >> 8) >> 8, 255u);
+			}
+
+			if (cg != 255) {
+				out[kBlitGIndex] = MIN<uint>(out[kBlitGIndex] * ((in[kBlitGIndex] * cg * ina) >> 16) >> 8, 255u);
+			} else {
+				out[kBlitGIndex] = MIN<uint>(out[kBlitGIndex] * (in[kBlitGIndex] * ina >> 8) >> 8, 255u);
+			}
+
+			if (cr != 255) {
+				out[kBlitRIndex] = MIN<uint>(out[kBlitRIndex] * ((in[kBlitRIndex] * cr * ina) >> 16) >> 8, 255u);
+			} else {
+				out[kBlitRIndex] = MIN<uint>(out[kBlitRIndex] * (in[kBlitRIndex] * ina >> 8) >> 8, 255u);
+			}
+
+			in += inStep;
+			out += 4;
+		}
+	}
+}
+
+void blitSpanScalar(TSpriteBlendMode blendMode, const byte *in, int32 inStep, byte *out, uint count, uint32 color) {
+	switch (blendMode) {
+	case BLEND_ADDITIVE:
+		blitSpanScalarAdditive(in, inStep, out, count, color);
+		break;
+	case BLEND_SUBTRACTIVE:
+		blitSpanScalarSubtractive(in, inStep, out, count, color);
+		break;
+	case BLEND_MULTIPLY:
+		blitSpanScalarMultiply(in, inStep, out, count, color);
+		break;
+	default:
+		assert(blendMode == BLEND_NORMAL);
+		blitSpanScalarAlpha(in, inStep, out, count, color);
+		break;
+	}
+}
+
+/**
+ * Multipliers used by the SIMD blit kernels. They compute every blend mode
+ * with 16 bit lanes, by turning the special cases of the scalar code into
+ * factors: a color modulation of 255 is applied as 256 where the scalar code
+ * skips it, which makes (x * 256 * y) >> 16 equal to (x * y) >> 8.
+ */
+struct BlitModulation {
+	bool modulate;
+	uint16 a, r, g, b;
+
+	BlitModulation(TSpriteBlendMode blendMode, uint32 color) {
+		modulate = (color != 0xffffffff);
+
+		const uint16 ca = (color >> 24) & 0xFF;
+		const uint16 cr = (color >> 16) & 0xFF;
+		const uint16 cg = (color >> 8) & 0xFF;
+		const uint16 cb = (color >> 0) & 0xFF;
+
+		if (blendMode == BLEND_NORMAL) {
+			a = ca;
+			r = cr;
+			g = cg;
+			b = cb;
+		} else {
+			a = modulate ? ca : 256;
+			r = (cr == 255) ? 256 : cr;
+			g = (cg == 255) ? 256 : cg;
+			b = (cb == 255) ? 256 : cb;
+		}
+	}
+};
+
+const SpanKernel kSpanKernelScalar = {
+	"scalar",
+	fillSpanScalar<uint16>,
+	fillSpanScalar<uint32>,
+	blendSpanScalar16,
+	blendSpanScalar32,
+	maskSpanScalar<uint16>,
+	maskSpanScalar<uint32>,
+	blitSpanScalar
+};
+
+#ifdef PIXEL_SPAN_SSE2
+
+void fillSpan16SSE2(uint16 *dst, uint count, uint16 evenColor, uint16 oddColor) {
+	const __m128i pattern = _mm_set_epi16((short)oddColor, (short)evenColor, (short)oddColor, (short)evenColor,
+	                                      (short)oddColor, (short)evenColor, (short)oddColor, (short)evenColor);
+	uint i = 0;
+	for (; i + 8 <= count; i += 8)
+		_mm_storeu_si128((__m128i *)(dst + i), pattern);
+	for (; i < count; i++)
+		dst[i] = (i & 1) ? oddColor : evenColor;
+}
+
+void fillSpan32SSE2(uint32 *dst, uint count, uint32 evenColor, uint32 oddColor) {
+	const __m128i pattern = _mm_set_epi32((int)oddColor, (int)evenColor, (int)oddColor, (int)evenColor);
+	uint i = 0;
+	for (; i + 4 <= count; i += 4)
+		_mm_storeu_si128((__m128i *)(dst + i), pattern);
+	for (; i < count; i++)
+		dst[i] = (i & 1) ? oddColor : evenColor;
+}
+
+struct SpanChannelSSE2 {
+	__m128i shift; // shift of the channel
+	__m128i max;   // mask of the channel, shifted down
+	__m128i src;   // source channel multiplied with alpha
+
+	SpanChannelSSE2(uint8 loss, uint8 shift_, uint32 src_, uint8 alpha) {
+		shift = _mm_cvtsi32_si128(shift_);
+		max = _mm_set1_epi16((short)(0xFF >> loss));
+		src = _mm_set1_epi16((short)(src_ * alpha));
+	}
+
+	inline __m128i blend(__m128i dst, __m128i inv) const {
+		__m128i d = _mm_and_si128(_mm_srl_epi16(dst, shift), max);
+		d = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(d, inv), src), 8);
+		return _mm_sll_epi16(d, shift);
+	}
+};
+
+void blendSpan16SSE2(uint16 *dst, uint count, const PixelFormat &format, uint16 color, uint8 alpha) {
+	const SpanChannelSSE2 r(format.rLoss, format.rShift, (color >> format.rShift) & (0xFF >> format.rLoss), alpha);
+	const SpanChannelSSE2 g(format.gLoss, format.gShift, (color >> format.gShift) & (0xFF >> format.gLoss), alpha);
+	const SpanChannelSSE2 b(format.bLoss, format.bShift, (color >> format.bShift) & (0xFF >> format.bLoss), alpha);
+	const SpanChannelSSE2 a(format.aLoss, format.aShift, 0xFF >> format.aLoss, alpha);
+	const __m128i inv = _mm_set1_epi16((short)(256 - alpha));
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+		__m128i result = _mm_or_si128(_mm_or_si128(r.blend(d, inv), g.blend(d, inv)),
+		                              _mm_or_si128(b.blend(d, inv), a.blend(d, inv)));
+		_mm_storeu_si128((__m128i *)(dst + i), result);
+	}
+
+	if (i < count)
+		blendSpanScalar16(dst + i, count - i, format, color, alpha);
+}
+
+void blendSpan32SSE2(uint32 *dst, uint count, const PixelFormat &format, uint32 color, uint8 alpha) {
+	if (!isByteFormat(format)) {
+		blendSpanScalar32(dst, count, format, color, alpha);
+		return;
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i inv = _mm_set1_epi16((short)(256 - alpha));
+	const __m128i src = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32((int)byteFormatSource(format, color)), zero), _mm_set1_epi16(alpha));
+	const __m128i mask = _mm_set1_epi32((int)byteFormatMask(format));
+
+	uint i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+		__m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv), src), 8);
+		__m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv), src), 8);
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_and_si128(_mm_packus_epi16(lo, hi), mask));
+	}
+
+	if (i < count)
+		blendSpanScalar32(dst + i, count - i, format, color, alpha);
+}
+
+inline __m128i div255SSE2(__m128i x) {
+	return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+struct MaskChannelSSE2 {
+	__m128i shift;       // shift of the channel
+	__m128i max;         // mask of the channel, shifted down
+	__m128i expandLeft;  // shifts which expand the channel to 8 bits
+	__m128i expandRight;
+	__m128i loss;        // loss of the channel
+	__m128i src;         // 8 bit source channel
+
+	MaskChannelSSE2(uint8 loss_, uint8 shift_, uint8 src_) {
+		shift = _mm_cvtsi32_si128(shift_);
+		max = _mm_set1_epi16((short)(0xFF >> loss_));
+		expandLeft = _mm_cvtsi32_si128(loss_);
+		expandRight = _mm_cvtsi32_si128(8 - 2 * loss_);
+		loss = _mm_cvtsi32_si128(loss_);
+		src = _mm_set1_epi16(src_);
+	}
+
+	inline __m128i blend(__m128i dst, __m128i cov, __m128i inv) const {
+		__m128i d = _mm_and_si128(_mm_srl_epi16(dst, shift), max);
+		d = _mm_or_si128(_mm_sll_epi16(d, expandLeft), _mm_srl_epi16(d, expandRight));
+		d = div255SSE2(_mm_add_epi16(_mm_mullo_epi16(d, inv), _mm_mullo_epi16(src, cov)));
+		return _mm_sll_epi16(_mm_srl_epi16(d, loss), shift);
+	}
+};
+
+inline __m128i selectSSE2(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+void maskSpan16SSE2(uint16 *dst, uint count, const byte *coverage, const PixelFormat &format, uint16 color) {
+	if (!isExpandableFormat(format)) {
+		maskSpanScalar<uint16>(dst, count, coverage, format, color);
+		return;
+	}
+
+	uint8 sR, sG, sB;
+	format.colorToRGB(color, sR, sG, sB);
+
+	const MaskChannelSSE2 r(format.rLoss, format.rShift, sR);
+	const MaskChannelSSE2 g(format.gLoss, format.gShift, sG);
+	const MaskChannelSSE2 b(format.bLoss, format.bShift, sB);
+	const __m128i alphaBits = _mm_set1_epi16((short)channelMask(format.aLoss, format.aShift));
+	const __m128i solid = _mm_set1_epi16((short)color);
+	const __m128i full = _mm_set1_epi16(255);
+	const __m128i zero = _mm_setzero_si128();
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i cov8 = _mm_loadl_epi64((const __m128i *)(coverage + i));
+		if ((_mm_movemask_epi8(_mm_cmpeq_epi8(cov8, zero)) & 0xFF) == 0xFF)
+			continue;
+
+		const __m128i cov = _mm_unpacklo_epi8(cov8, zero);
+		const __m128i inv = _mm_sub_epi16(full, cov);
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+
+		__m128i result = _mm_or_si128(_mm_or_si128(r.blend(d, cov, inv), g.blend(d, cov, inv)),
+		                              _mm_or_si128(b.blend(d, cov, inv), alphaBits));
+		result = selectSSE2(_mm_cmpeq_epi16(cov, full), solid, result);
+		result = selectSSE2(_mm_cmpeq_epi16(cov, zero), d, result);
+		_mm_storeu_si128((__m128i *)(dst + i), result);
+	}
+
+	if (i < count)
+		maskSpanScalar<uint16>(dst + i, count - i, coverage + i, format, color);
+}
+
+void maskSpan32SSE2(uint32 *dst, uint count, const byte *coverage, const PixelFormat &format, uint32 color) {
+	if (!isByteFormat(format)) {
+		maskSpanScalar<uint32>(dst, count, coverage, format, color);
+		return;
+	}
+
+	const uint32 rgbMask = channelMask(format.rLoss, format.rShift) | channelMask(format.gLoss, format.gShift) | channelMask(format.bLoss, format.bShift);
+	const __m128i rgb = _mm_set1_epi32((int)rgbMask);
+	const __m128i alphaBits = _mm_set1_epi32((int)channelMask(format.aLoss, format.aShift));
+	const __m128i solid = _mm_set1_epi32((int)color);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i src = _mm_unpacklo_epi8(solid, zero);
+	const __m128i full = _mm_set1_epi16(255);
+	const __m128i full8 = _mm_set1_epi8((char)0xFF);
+
+	uint i = 0;
+	for (; i + 4 <= count; i += 4) {
+		uint32 cov4;
+		memcpy(&cov4, coverage + i, sizeof(cov4));
+		if (!cov4)
+			continue;
+
+		// Repeat the coverage of every pixel for all of its channels
+		__m128i cov = _mm_cvtsi32_si128((int)cov4);
+		cov = _mm_unpacklo_epi8(cov, cov);
+		cov = _mm_unpacklo_epi16(cov, cov);
+
+		const __m128i covLo = _mm_unpacklo_epi8(cov, zero);
+		const __m128i covHi = _mm_unpackhi_epi8(cov, zero);
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+
+		__m128i lo = div255SSE2(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(full, covLo)), _mm_mullo_epi16(src, covLo)));
+		__m128i hi = div255SSE2(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(full, covHi)), _mm_mullo_epi16(src, covHi)));
+
+		__m128i result = _mm_or_si128(_mm_and_si128(_mm_packus_epi16(lo, hi), rgb), alphaBits);
+		result = selectSSE2(_mm_cmpeq_epi8(cov, full8), solid, result);
+		result = selectSSE2(_mm_cmpeq_epi8(cov, zero), d, result);
+		_mm_storeu_si128((__m128i *)(dst + i), result);
+	}
+
+	if (i < count)
+		maskSpanScalar<uint32>(dst + i, count - i, coverage + i, format, color);
+}
+
+// Load four source pixels of a blit, in the order they are blitted in
+inline __m128i loadBlitSourceSSE2(const byte *in, int32 inStep) {
+	if (inStep > 0)
+		return _mm_loadu_si128((const __m128i *)in);
+	return _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(in - 12)), _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+// Blend the channels of two pixels, widened to 16 bits
+template<TSpriteBlendMode blendMode, bool modulate>
+inline __m128i blitChannelsSSE2(__m128i in, __m128i out, __m128i colorMod, __m128i alphaMod) {
+	const __m128i full = _mm_set1_epi16(255);
+	// The source alpha in every lane of its pixel
+	const __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(in, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0));
+
+	switch (blendMode) {
+	case BLEND_ADDITIVE: {
+		const __m128i ina = _mm_srli_epi16(_mm_mullo_epi16(a, alphaMod), 8);
+		return _mm_min_epi16(_mm_add_epi16(out, _mm_mulhi_epu16(_mm_mullo_epi16(in, colorMod), ina)), full);
+	}
+	case BLEND_SUBTRACTIVE:
+		return _mm_sub_epi16(out, _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(in, colorMod), _mm_mullo_epi16(out, a)), 8));
+	case BLEND_MULTIPLY: {
+		const __m128i ina = _mm_srli_epi16(_mm_mullo_epi16(a, alphaMod), 8);
+		return _mm_srli_epi16(_mm_mullo_epi16(out, _mm_mulhi_epu16(_mm_mullo_epi16(in, colorMod), ina)), 8);
+	}
+	default:
+		if (modulate) {
+			const __m128i ina = _mm_srli_epi16(_mm_mullo_epi16(a, alphaMod), 8);
+			return _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(out, _mm_sub_epi16(full, ina)), 8),
+			                     _mm_mulhi_epu16(_mm_mullo_epi16(in, colorMod), ina));
+		}
+		return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(in, a), _mm_mullo_epi16(out, _mm_sub_epi16(full, a))), 8);
+	}
+}
+
+template<TSpriteBlendMode blendMode, bool modulate>
+void blitSpanSSE2T(const byte *in, int32 inStep, byte *out, uint count, uint32 color) {
+	const BlitModulation mod(blendMode, color);
+	const __m128i colorMod = _mm_set_epi16(mod.r, mod.g, mod.b, 256, mod.r, mod.g, mod.b, 256);
+	const __m128i alphaMod = _mm_set1_epi16(mod.a);
+	const __m128i alphaBits = _mm_set1_epi32(0xFF);
+	const __m128i zero = _mm_setzero_si128();
+
+	// Which modes make the target opaque, and which skip transparent source pixels
+	const bool opaque = (blendMode == BLEND_NORMAL || (blendMode == BLEND_SUBTRACTIVE && modulate));
+	const bool skipTransparent = !modulate && (blendMode == BLEND_NORMAL || blendMode == BLEND_MULTIPLY);
+
+	uint i = 0;
+	for (; i + 4 <= count; i += 4, in += 4 * inStep, out += 16) {
+		const __m128i s = loadBlitSourceSSE2(in, inStep);
+		const __m128i d = _mm_loadu_si128((const __m128i *)out);
+
+		__m128i result = _mm_packus_epi16(
+			blitChannelsSSE2<blendMode, modulate>(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), colorMod, alphaMod),
+			blitChannelsSSE2<blendMode, modulate>(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), colorMod, alphaMod));
+
+		if (opaque)
+			result = _mm_or_si128(result, alphaBits);
+		else
+			result = selectSSE2(alphaBits, d, result);
+
+		if (skipTransparent)
+			result = selectSSE2(_mm_cmpeq_epi32(_mm_and_si128(s, alphaBits), zero), d, result);
+
+		_mm_storeu_si128((__m128i *)out, result);
+	}
+
+	if (i < count)
+		blitSpanScalar(blendMode, in, inStep, out, count - i, color);
+}
+
+void blitSpanSSE2(TSpriteBlendMode blendMode, const byte *in, int32 inStep, byte *out, uint count, uint32 color) {
+#ifdef SCUMM_LITTLE_ENDIAN
+	// The vector loads only handle source pixels next to each other
+	if (inStep != 4 && inStep != -4) {
+		blitSpanScalar(blendMode, in, inStep, out, count, color);
+		return;
+	}
+
+	const bool modulate = (color != 0xffffffff);
+
+	switch (blendMode) {
+	case BLEND_ADDITIVE:
+		if (modulate)
+			blitSpanSSE2T<BLEND_ADDITIVE, true>(in, inStep, out, count, color);
+		else
+			blitSpanSSE2T<BLEND_ADDITIVE, false>(in, inStep, out, count, color);
+		return;
+	case BLEND_SUBTRACTIVE:
+		if (modulate)
+			blitSpanSSE2T<BLEND_SUBTRACTIVE, true>(in, inStep, out, count, color);
+		else
+			blitSpanSSE2T<BLEND_SUBTRACTIVE, false>(in, inStep, out, count, color);
+		return;
+	case BLEND_MULTIPLY:
+		if (modulate)
+			blitSpanSSE2T<BLEND_MULTIPLY, true>(in, inStep, out, count, color);
+		else
+			blitSpanSSE2T<BLEND_MULTIPLY, false>(in, inStep, out, count, color);
+		return;
+	default:
+		assert(blendMode == BLEND_NORMAL);
+		if (modulate)
+			blitSpanSSE2T<BLEND_NORMAL, true>(in, inStep, out, count, color);
+		else
+			blitSpanSSE2T<BLEND_NORMAL, false>(in, inStep, out, count, color);
+		return;
+	}
+#else
+	blitSpanScalar(blendMode, in, inStep, out, count, color);
+#endif
+}
+
+const SpanKernel kSpanKernelSSE2 = {
+	"sse2",
+	fillSpan16SSE2,
+	fillSpan32SSE2,
+	blendSpan16SSE2,
+	blendSpan32SSE2,
+	maskSpan16SSE2,
+	maskSpan32SSE2,
+	blitSpanSSE2
+};
+
+#endif // PIXEL_SPAN_SSE2
+
+#ifdef PIXEL_SPAN_AVX2
+
+// The AVX2 kernel only replaces the 32bpp blends and the blits, the 16 bit
+// spans are too short in practice to gain anything over SSE2.
+
+PIXEL_SPAN_AVX2_TARGET void blendSpan32AVX2(uint32 *dst, uint count, const PixelFormat &format, uint32 color, uint8 alpha) {
+	if (!isByteFormat(format)) {
+		blendSpanScalar32(dst, count, format, color, alpha);
+		return;
+	}
+
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i inv = _mm256_set1_epi16((short)(256 - alpha));
+	const __m256i src = _mm256_mullo_epi16(_mm256_unpacklo_epi8(_mm256_set1_epi32((int)byteFormatSource(format, color)), zero), _mm256_set1_epi16(alpha));
+	const __m256i mask = _mm256_set1_epi32((int)byteFormatMask(format));
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+		__m256i lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), inv), src), 8);
+		__m256i hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), inv), src), 8);
+		_mm256_storeu_si256((__m256i *)(dst + i), _mm256_and_si256(_mm256_packus_epi16(lo, hi), mask));
+	}
+
+	if (i < count)
+		blendSpan32SSE2(dst + i, count - i, format, color, alpha);
+}
+
+PIXEL_SPAN_AVX2_TARGET inline __m256i selectAVX2(__m256i mask, __m256i a, __m256i b) {
+	return _mm256_or_si256(_mm256_and_si256(mask, a), _mm256_andnot_si256(mask, b));
+}
+
+// Load eight source pixels of a blit, in the order they are blitted in
+PIXEL_SPAN_AVX2_TARGET inline __m256i loadBlitSourceAVX2(const byte *in, int32 inStep) {
+	if (inStep > 0)
+		return _mm256_loadu_si256((const __m256i *)in);
+	return _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *)(in - 28)), _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+// Blend the channels of four pixels, widened to 16 bits. The same as
+// blitChannelsSSE2(), but for both 128 bit halves at once.
+template<TSpriteBlendMode blendMode, bool modulate>
+PIXEL_SPAN_AVX2_TARGET inline __m256i blitChannelsAVX2(__m256i in, __m256i out, __m256i colorMod, __m256i alphaMod) {
+	const __m256i full = _mm256_set1_epi16(255);
+	// The source alpha in every lane of its pixel
+	const __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(in, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0));
+
+	switch (blendMode) {
+	case BLEND_ADDITIVE: {
+		const __m256i ina = _mm256_srli_epi16(_mm256_mullo_epi16(a, alphaMod), 8);
+		return _mm256_min_epi16(_mm256_add_epi16(out, _mm256_mulhi_epu16(_mm256_mullo_epi16(in, colorMod), ina)), full);
+	}
+	case BLEND_SUBTRACTIVE:
+		return _mm256_sub_epi16(out, _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(in, colorMod), _mm256_mullo_epi16(out, a)), 8));
+	case BLEND_MULTIPLY: {
+		const __m256i ina = _mm256_srli_epi16(_mm256_mullo_epi16(a, alphaMod), 8);
+		return _mm256_srli_epi16(_mm256_mullo_epi16(out, _mm256_mulhi_epu16(_mm256_mullo_epi16(in, colorMod), ina)), 8);
+	}
+	default:
+		if (modulate) {
+			const __m256i ina = _mm256_srli_epi16(_mm256_mullo_epi16(a, alphaMod), 8);
+			return _mm256_add_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(out, _mm256_sub_epi16(full, ina)), 8),
+			                        _mm256_mulhi_epu16(_mm256_mullo_epi16(in, colorMod), ina));
+		}
+		return _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(in, a), _mm256_mullo_epi16(out, _mm256_sub_epi16(full, a))), 8);
+	}
+}
+
+template<TSpriteBlendMode blendMode, bool modulate>
+PIXEL_SPAN_AVX2_TARGET void blitSpanAVX2T(const byte *in, int32 inStep, byte *out, uint count, uint32 color) {
+	const BlitModulation mod(blendMode, color);
+	const __m256i colorMod = _mm256_set_epi16(mod.r, mod.g, mod.b, 256, mod.r, mod.g, mod.b, 256,
+	                                          mod.r, mod.g, mod.b, 256, mod.r, mod.g, mod.b, 256);
+	const __m256i alphaMod = _mm256_set1_epi16(mod.a);
+	const __m256i alphaBits = _mm256_set1_epi32(0xFF);
+	const __m256i zero = _mm256_setzero_si256();
+
+	// Which modes make the target opaque, and which skip transparent source pixels
+	const bool opaque = (blendMode == BLEND_NORMAL || (blendMode == BLEND_SUBTRACTIVE && modulate));
+	const bool skipTransparent = !modulate && (blendMode == BLEND_NORMAL || blendMode == BLEND_MULTIPLY);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8, in += 8 * inStep, out += 32) {
+		const __m256i s = loadBlitSourceAVX2(in, inStep);
+		const __m256i d = _mm256_loadu_si256((const __m256i *)out);
+
+		__m256i result = _mm256_packus_epi16(
+			blitChannelsAVX2<blendMode, modulate>(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), colorMod, alphaMod),
+			blitChannelsAVX2<blendMode, modulate>(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), colorMod, alphaMod));
+
+		if (opaque)
+			result = _mm256_or_si256(result, alphaBits);
+		else
+			result = selectAVX2(alphaBits, d, result);
+
+		if (skipTransparent)
+			result = selectAVX2(_mm256_cmpeq_epi32(_mm256_and_si256(s, alphaBits), zero), d, result);
+
+		_mm256_storeu_si256((__m256i *)out, result);
+	}
+
+	if (i < count)
+		blitSpanSSE2T<blendMode, modulate>(in, inStep, out, count - i, color);
+}
+
+PIXEL_SPAN_AVX2_TARGET void blitSpanAVX2(TSpriteBlendMode blendMode, const byte *in, int32 inStep, byte *out, uint count, uint32 color) {
+#ifdef SCUMM_LITTLE_ENDIAN
+	// The vector loads only handle source pixels next to each other
+	if (inStep != 4 && inStep != -4) {
+		blitSpanScalar(blendMode, in, inStep, out, count, color);
+		return;
+	}
+
+	const bool modulate = (color != 0xffffffff);
+
+	switch (blendMode) {
+	case BLEND_ADDITIVE:
+		if (modulate)
+			blitSpanAVX2T<BLEND_ADDITIVE, true>(in, inStep, out, count, color);
+		else
+			blitSpanAVX2T<BLEND_ADDITIVE, false>(in, inStep, out, count, color);
+		return;
+	case BLEND_SUBTRACTIVE:
+		if (modulate)
+			blitSpanAVX2T<BLEND_SUBTRACTIVE, true>(in, inStep, out, count, color);
+		else
+			blitSpanAVX2T<BLEND_SUBTRACTIVE, false>(in, inStep, out, count, color);
+		return;
+	case BLEND_MULTIPLY:
+		if (modulate)
+			blitSpanAVX2T<BLEND_MULTIPLY, true>(in, inStep, out, count, color);
+		else
+			blitSpanAVX2T<BLEND_MULTIPLY, false>(in, inStep, out, count, color);
+		return;
+	default:
+		assert(blendMode == BLEND_NORMAL);
+		if (modulate)
+			blitSpanAVX2T<BLEND_NORMAL, true>(in, inStep, out, count, color);
+		else
+			blitSpanAVX2T<BLEND_NORMAL, false>(in, inStep, out, count, color);
+		return;
+	}
+#else
+	blitSpanScalar(blendMode, in, inStep, out, count, color);
+#endif
+}
+
+const SpanKernel kSpanKernelAVX2 = {
+	"avx2",
+	fillSpan16SSE2,
+	fillSpan32SSE2,
+	blendSpan16SSE2,
+	blendSpan32AVX2,
+	maskSpan16SSE2,
+	maskSpan32SSE2,
+	blitSpanAVX2
+};
+
+#endif // PIXEL_SPAN_AVX2
+
+#ifdef PIXEL_SPAN_NEON
+
+void fillSpan16NEON(uint16 *dst, uint count, uint16 evenColor, uint16 oddColor) {
+	const uint16 patternData[8] = { evenColor, oddColor, evenColor, oddColor, evenColor, oddColor, evenColor, oddColor };
+	const uint16x8_t pattern = vld1q_u16(patternData);
+	uint i = 0;
+	for (; i + 8 <= count; i += 8)
+		vst1q_u16(dst + i, pattern);
+	for (; i < count; i++)
+		dst[i] = (i & 1) ? oddColor : evenColor;
+}
+
+void fillSpan32NEON(uint32 *dst, uint count, uint32 evenColor, uint32 oddColor) {
+	const uint32 patternData[4] = { evenColor, oddColor, evenColor, oddColor };
+	const uint32x4_t pattern = vld1q_u32(patternData);
+	uint i = 0;
+	for (; i + 4 <= count; i += 4)
+		vst1q_u32(dst + i, pattern);
+	for (; i < count; i++)
+		dst[i] = (i & 1) ? oddColor : evenColor;
+}
+
+struct SpanChannelNEON {
+	int16x8_t shift; // shift of the channel
+	uint16x8_t max;  // mask of the channel, shifted down
+	uint16x8_t src;  // source channel multiplied with alpha
+
+	SpanChannelNEON(uint8 loss, uint8 shift_, uint32 src_, uint8 alpha) {
+		shift = vdupq_n_s16(shift_);
+		max = vdupq_n_u16(0xFF >> loss);
+		src = vdupq_n_u16((uint16)(src_ * alpha));
+	}
+
+	inline uint16x8_t blend(uint16x8_t dst, uint16x8_t inv) const {
+		uint16x8_t d = vandq_u16(vshlq_u16(dst, vnegq_s16(shift)), max);
+		d = vshrq_n_u16(vmlaq_u16(src, d, inv), 8);
+		return vshlq_u16(d, shift);
+	}
+};
+
+void blendSpan16NEON(uint16 *dst, uint count, const PixelFormat &format, uint16 color, uint8 alpha) {
+	const SpanChannelNEON r(format.rLoss, format.rShift, (color >> format.rShift) & (0xFF >> format.rLoss), alpha);
+	const SpanChannelNEON g(format.gLoss, format.gShift, (color >> format.gShift) & (0xFF >> format.gLoss), alpha);
+	const SpanChannelNEON b(format.bLoss, format.bShift, (color >> format.bShift) & (0xFF >> format.bLoss), alpha);
+	const SpanChannelNEON a(format.aLoss, format.aShift, 0xFF >> format.aLoss, alpha);
+	const uint16x8_t inv = vdupq_n_u16(256 - alpha);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		uint16x8_t d = vld1q_u16(dst + i);
+		uint16x8_t result = vorrq_u16(vorrq_u16(r.blend(d, inv), g.blend(d, inv)),
+		                              vorrq_u16(b.blend(d, inv), a.blend(d, inv)));
+		vst1q_u16(dst + i, result);
+	}
+
+	if (i < count)
+		blendSpanScalar16(dst + i, count - i, format, color, alpha);
+}
+
+void blendSpan32NEON(uint32 *dst, uint count, const PixelFormat &format, uint32 color, uint8 alpha) {
+	if (!isByteFormat(format)) {
+		blendSpanScalar32(dst, count, format, color, alpha);
+		return;
+	}
+
+	const uint16x8_t inv = vdupq_n_u16(256 - alpha);
+	const uint16x8_t src = vmulq_n_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(byteFormatSource(format, color)))), alpha);
+	const uint8x16_t mask = vreinterpretq_u8_u32(vdupq_n_u32(byteFormatMask(format)));
+
+	uint i = 0;
+	for (; i + 4 <= count; i += 4) {
+		uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst + i));
+		uint16x8_t lo = vmlaq_u16(src, vmovl_u8(vget_low_u8(d)), inv);
+		uint16x8_t hi = vmlaq_u16(src, vmovl_u8(vget_high_u8(d)), inv);
+		uint8x16_t result = vandq_u8(vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)), mask);
+		vst1q_u32(dst + i, vreinterpretq_u32_u8(result));
+	}
+
+	if (i < count)
+		blendSpanScalar32(dst + i, count - i, format, color, alpha);
+}
+
+inline uint16x8_t div255NEON(uint16x8_t x) {
+	return vshrq_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+}
+
+struct MaskChannelNEON {
+	int16x8_t shiftUp;     // shifts of the channel
+	int16x8_t shiftDown;
+	uint16x8_t max;        // mask of the channel, shifted down
+	int16x8_t expandLeft;  // shifts which expand the channel to 8 bits
+	int16x8_t expandRight;
+	int16x8_t loss;        // negated loss of the channel
+	uint16x8_t src;        // 8 bit source channel
+
+	MaskChannelNEON(uint8 loss_, uint8 shift_, uint8 src_) {
+		shiftUp = vdupq_n_s16(shift_);
+		shiftDown = vdupq_n_s16(-shift_);
+		max = vdupq_n_u16(0xFF >> loss_);
+		expandLeft = vdupq_n_s16(loss_);
+		expandRight = vdupq_n_s16(2 * loss_ - 8);
+		loss = vdupq_n_s16(-loss_);
+		src = vdupq_n_u16(src_);
+	}
+
+	inline uint16x8_t blend(uint16x8_t dst, uint16x8_t cov, uint16x8_t inv) const {
+		uint16x8_t d = vandq_u16(vshlq_u16(dst, shiftDown), max);
+		d = vorrq_u16(vshlq_u16(d, expandLeft), vshlq_u16(d, expandRight));
+		d = div255NEON(vmlaq_u16(vmulq_u16(d, inv), src, cov));
+		return vshlq_u16(vshlq_u16(d, loss), shiftUp);
+	}
+};
+
+void maskSpan16NEON(uint16 *dst, uint count, const byte *coverage, const PixelFormat &format, uint16 color) {
+	if (!isExpandableFormat(format)) {
+		maskSpanScalar<uint16>(dst, count, coverage, format, color);
+		return;
+	}
+
+	uint8 sR, sG, sB;
+	format.colorToRGB(color, sR, sG, sB);
+
+	const MaskChannelNEON r(format.rLoss, format.rShift, sR);
+	const MaskChannelNEON g(format.gLoss, format.gShift, sG);
+	const MaskChannelNEON b(format.bLoss, format.bShift, sB);
+	const uint16x8_t alphaBits = vdupq_n_u16(channelMask(format.aLoss, format.aShift));
+	const uint16x8_t solid = vdupq_n_u16(color);
+	const uint16x8_t full = vdupq_n_u16(255);
+	const uint16x8_t zero = vdupq_n_u16(0);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const uint8x8_t cov8 = vld1_u8(coverage + i);
+		if (vget_lane_u64(vreinterpret_u64_u8(cov8), 0) == 0)
+			continue;
+
+		const uint16x8_t cov = vmovl_u8(cov8);
+		const uint16x8_t inv = vsubq_u16(full, cov);
+		const uint16x8_t d = vld1q_u16(dst + i);
+
+		uint16x8_t result = vorrq_u16(vorrq_u16(r.blend(d, cov, inv), g.blend(d, cov, inv)),
+		                              vorrq_u16(b.blend(d, cov, inv), alphaBits));
+		result = vbslq_u16(vceqq_u16(cov, full), solid, result);
+		result = vbslq_u16(vceqq_u16(cov, zero), d, result);
+		vst1q_u16(dst + i, result);
+	}
+
+	if (i < count)
+		maskSpanScalar<uint16>(dst + i, count - i, coverage + i, format, color);
+}
+
+void maskSpan32NEON(uint32 *dst, uint count, const byte *coverage, const PixelFormat &format, uint32 color) {
+	if (!isByteFormat(format)) {
+		maskSpanScalar<uint32>(dst, count, coverage, format, color);
+		return;
+	}
+
+	static const uint8 expandLoData[8] = { 0, 0, 0, 0, 1, 1, 1, 1 };
+	static const uint8 expandHiData[8] = { 2, 2, 2, 2, 3, 3, 3, 3 };
+	const uint8x8_t expandLo = vld1_u8(expandLoData);
+	const uint8x8_t expandHi = vld1_u8(expandHiData);
+
+	const uint32 rgbMask = channelMask(format.rLoss, format.rShift) | channelMask(format.gLoss, format.gShift) | channelMask(format.bLoss, format.bShift);
+	const uint8x16_t rgb = vreinterpretq_u8_u32(vdupq_n_u32(rgbMask));
+	const uint8x16_t alphaBits = vreinterpretq_u8_u32(vdupq_n_u32(channelMask(format.aLoss, format.aShift)));
+	const uint8x16_t solid = vreinterpretq_u8_u32(vdupq_n_u32(color));
+	const uint16x8_t src = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(color)));
+	const uint16x8_t full = vdupq_n_u16(255);
+
+	uint i = 0;
+	for (; i + 4 <= count; i += 4) {
+		uint32 cov4;
+		memcpy(&cov4, coverage + i, sizeof(cov4));
+		if (!cov4)
+			continue;
+
+		// Repeat the coverage of every pixel for all of its channels
+		const uint8x8_t cov8 = vreinterpret_u8_u32(vdup_n_u32(cov4));
+		const uint8x8_t covLo8 = vtbl1_u8(cov8, expandLo);
+		const uint8x8_t covHi8 = vtbl1_u8(cov8, expandHi);
+		const uint16x8_t covLo = vmovl_u8(covLo8);
+		const uint16x8_t covHi = vmovl_u8(covHi8);
+		const uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst + i));
+
+		uint16x8_t lo = div255NEON(vmlaq_u16(vmulq_u16(vmovl_u8(vget_low_u8(d)), vsubq_u16(full, covLo)), src, covLo));
+		uint16x8_t hi = div255NEON(vmlaq_u16(vmulq_u16(vmovl_u8(vget_high_u8(d)), vsubq_u16(full, covHi)), src, covHi));
+
+		const uint8x16_t cov = vcombine_u8(covLo8, covHi8);
+		uint8x16_t result = vorrq_u8(vandq_u8(vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)), rgb), alphaBits);
+		result = vbslq_u8(vceqq_u8(cov, vdupq_n_u8(255)), solid, result);
+		result = vbslq_u8(vceqq_u8(cov, vdupq_n_u8(0)), d, result);
+		vst1q_u32(dst + i, vreinterpretq_u32_u8(result));
+	}
+
+	if (i < count)
+		maskSpanScalar<uint32>(dst + i, count - i, coverage + i, format, color);
+}
+
+// Load four source pixels of a blit, in the order they are blitted in
+inline uint8x16_t loadBlitSourceNEON(const byte *in, int32 inStep) {
+	if (inStep > 0)
+		return vld1q_u8(in);
+	const uint32x4_t reversed = vrev64q_u32(vreinterpretq_u32_u8(vld1q_u8(in - 12)));
+	return vreinterpretq_u8_u32(vcombine_u32(vget_high_u32(reversed), vget_low_u32(reversed)));
+}
+
+inline uint16x8_t mulhiNEON(uint16x8_t x, uint16x8_t y) {
+	return vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(x), vget_low_u16(y)), 16),
+	                    vshrn_n_u32(vmull_u16(vget_high_u16(x), vget_high_u16(y)), 16));
+}
+
+// Blend the channels of two pixels, widened to 16 bits
+template<TSpriteBlendMode blendMode, bool modulate>
+inline uint16x8_t blitChannelsNEON(uint16x8_t in, uint16x8_t out, uint16x8_t a, uint16x8_t colorMod, uint16x8_t alphaMod) {
+	const uint16x8_t full = vdupq_n_u16(255);
+
+	switch (blendMode) {
+	case BLEND_ADDITIVE: {
+		const uint16x8_t ina = vshrq_n_u16(vmulq_u16(a, alphaMod), 8);
+		return vminq_u16(vaddq_u16(out, mulhiNEON(vmulq_u16(in, colorMod), ina)), full);
+	}
+	case BLEND_SUBTRACTIVE:
+		return vsubq_u16(out, vshrq_n_u16(mulhiNEON(vmulq_u16(in, colorMod), vmulq_u16(out, a)), 8));
+	case BLEND_MULTIPLY: {
+		const uint16x8_t ina = vshrq_n_u16(vmulq_u16(a, alphaMod), 8);
+		return vshrq_n_u16(vmulq_u16(out, mulhiNEON(vmulq_u16(in, colorMod), ina)), 8);
+	}
+	default:
+		if (modulate) {
+			const uint16x8_t ina = vshrq_n_u16(vmulq_u16(a, alphaMod), 8);
+			return vaddq_u16(vshrq_n_u16(vmulq_u16(out, vsubq_u16(full, ina)), 8),
+			                 mulhiNEON(vmulq_u16(in, colorMod), ina));
+		}
+		return vshrq_n_u16(vmlaq_u16(vmulq_u16(in, a), out, vsubq_u16(full, a)), 8);
+	}
+}
+
+template<TSpriteBlendMode blendMode, bool modulate>
+void blitSpanNEONT(const byte *in, int32 inStep, byte *out, uint count, uint32 color) {
+	const BlitModulation mod(blendMode, color);
+	const uint16 colorModData[8] = { 256, mod.b, mod.g, mod.r, 256, mod.b, mod.g, mod.r };
+	const uint16x8_t colorMod = vld1q_u16(colorModData);
+	const uint16x8_t alphaMod = vdupq_n_u16(mod.a);
+	const uint32x4_t alphaBits = vdupq_n_u32(0xFF);
+
+	// Which modes make the target opaque, and which skip transparent source pixels
+	const bool opaque = (blendMode == BLEND_NORMAL || (blendMode == BLEND_SUBTRACTIVE && modulate));
+	const bool skipTransparent = !modulate && (blendMode == BLEND_NORMAL || blendMode == BLEND_MULTIPLY);
+
+	uint i = 0;
+	for (; i + 4 <= count; i += 4, in += 4 * inStep, out += 16) {
+		const uint8x16_t s = loadBlitSourceNEON(in, inStep);
+		const uint8x16_t d = vld1q_u8(out);
+
+		// The source alpha in every byte of its pixel
+		const uint32x4_t sourceAlpha = vandq_u32(vreinterpretq_u32_u8(s), alphaBits);
+		const uint8x16_t a = vreinterpretq_u8_u32(vmulq_n_u32(sourceAlpha, 0x01010101));
+
+		const uint16x8_t lo = blitChannelsNEON<blendMode, modulate>(vmovl_u8(vget_low_u8(s)), vmovl_u8(vget_low_u8(d)), vmovl_u8(vget_low_u8(a)), colorMod, alphaMod);
+		const uint16x8_t hi = blitChannelsNEON<blendMode, modulate>(vmovl_u8(vget_high_u8(s)), vmovl_u8(vget_high_u8(d)), vmovl_u8(vget_high_u8(a)), colorMod, alphaMod);
+		uint32x4_t result = vreinterpretq_u32_u8(vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi)));
+
+		if (opaque)
+			result = vorrq_u32(result, alphaBits);
+		else
+			result = vbslq_u32(alphaBits, vreinterpretq_u32_u8(d), result);
+
+		if (skipTransparent)
+			result = vbslq_u32(vceqq_u32(sourceAlpha, vdupq_n_u32(0)), vreinterpretq_u32_u8(d), result);
+
+		vst1q_u8(out, vreinterpretq_u8_u32(result));
+	}
+
+	if (i < count)
+		blitSpanScalar(blendMode, in, inStep, out, count - i, color);
+}
+
+void blitSpanNEON(TSpriteBlendMode blendMode, const byte *in, int32 inStep, byte *out, uint count, uint32 color) {
+#ifdef SCUMM_LITTLE_ENDIAN
+	// The vector loads only handle source pixels next to each other
+	if (inStep != 4 && inStep != -4) {
+		blitSpanScalar(blendMode, in, inStep, out, count, color);
+		return;
+	}
+
+	const bool modulate = (color != 0xffffffff);
+
+	switch (blendMode) {
+	case BLEND_ADDITIVE:
+		if (modulate)
+			blitSpanNEONT<BLEND_ADDITIVE, true>(in, inStep, out, count, color);
+		else
+			blitSpanNEONT<BLEND_ADDITIVE, false>(in, inStep, out, count, color);
+		return;
+	case BLEND_SUBTRACTIVE:
+		if (modulate)
+			blitSpanNEONT<BLEND_SUBTRACTIVE, true>(in, inStep, out, count, color);
+		else
+			blitSpanNEONT<BLEND_SUBTRACTIVE, false>(in, inStep, out, count, color);
+		return;
+	case BLEND_MULTIPLY:
+		if (modulate)
+			blitSpanNEONT<BLEND_MULTIPLY, true>(in, inStep, out, count, color);
+		else
+			blitSpanNEONT<BLEND_MULTIPLY, false>(in, inStep, out, count, color);
+		return;
+	default:
+		assert(blendMode == BLEND_NORMAL);
+		if (modulate)
+			blitSpanNEONT<BLEND_NORMAL, true>(in, inStep, out, count, color);
+		else
+			blitSpanNEONT<BLEND_NORMAL, false>(in, inStep, out, count, color);
+		return;
+	}
+#else
+	blitSpanScalar(blendMode, in, inStep, out, count, color);
+#endif
+}
+
+const SpanKernel kSpanKernelNEON = {
+	"neon",
+	fillSpan16NEON,
+	fillSpan32NEON,
+	blendSpan16NEON,
+	blendSpan32NEON,
+	maskSpan16NEON,
+	maskSpan32NEON,
+	blitSpanNEON
+};
+
+#endif // PIXEL_SPAN_NEON
+
+const SpanKernel *s_spanKernels[4];
+uint s_spanKernelCount = 0;
+const SpanKernel *s_spanKernel = nullptr;
+
+// Fill the kernel table on first use. SSE2 and NEON are part of the baseline
+// of the targets that enable them, AVX2 depends on the CPU. The last kernel in
+// the table is the fastest one.
+const SpanKernel *getKernel() {
+	if (s_spanKernel)
+		return s_spanKernel;
+
+	s_spanKernels[s_spanKernelCount++] = &kSpanKernelScalar;
+#ifdef PIXEL_SPAN_SSE2
+	s_spanKernels[s_spanKernelCount++] = &kSpanKernelSSE2;
+#endif
+#ifdef PIXEL_SPAN_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		s_spanKernels[s_spanKernelCount++] = &kSpanKernelAVX2;
+#endif
+#ifdef PIXEL_SPAN_NEON
+	s_spanKernels[s_spanKernelCount++] = &kSpanKernelNEON;
+#endif
+
+	s_spanKernel = s_spanKernels[s_spanKernelCount - 1];
+	return s_spanKernel;
+}
+
+} // End of anonymous namespace
+
+void fillSpan(uint16 *first, uint16 *last, uint16 evenColor, uint16 oddColor) {
+	if (first < last)
+		getKernel()->fill16(first, last - first, evenColor, oddColor);
+}
+
+void fillSpan(uint32 *first, uint32 *last, uint32 evenColor, uint32 oddColor) {
+	if (first < last)
+		getKernel()->fill32(first, last - first, evenColor, oddColor);
+}
+
+void blendSpan(uint16 *first, uint16 *last, const PixelFormat &format, uint16 color, uint8 alpha) {
+	if (first >= last)
+		return;
+
+	if (alpha == 0xff) {
+		// fully opaque pixels, don't blend
+		color |= channelMask(format.aLoss, format.aShift);
+		getKernel()->fill16(first, last - first, color, color);
+	} else {
+		getKernel()->blend16(first, last - first, format, color, alpha);
+	}
+}
+
+void blendSpan(uint32 *first, uint32 *last, const PixelFormat &format, uint32 color, uint8 alpha) {
+	if (first >= last)
+		return;
+
+	if (alpha == 0xff) {
+		// fully opaque pixels, don't blend
+		color |= channelMask(format.aLoss, format.aShift);
+		getKernel()->fill32(first, last - first, color, color);
+	} else {
+		getKernel()->blend32(first, last - first, format, color, alpha);
+	}
+}
+
+void maskSpan(uint16 *first, uint16 *last, const byte *coverage, const PixelFormat &format, uint16 color) {
+	if (first < last)
+		getKernel()->mask16(first, last - first, coverage, format, color);
+}
+
+void maskSpan(uint32 *first, uint32 *last, const byte *coverage, const PixelFormat &format, uint32 color) {
+	if (first < last)
+		getKernel()->mask32(first, last - first, coverage, format, color);
+}
+
+void blitSpan(TSpriteBlendMode blendMode, const byte *in, int32 inStep, byte *out, uint count, uint32 color) {
+	if (count)
+		getKernel()->blit(blendMode, in, inStep, out, count, color);
+}
+
+uint getSpanKernelCount() {
+	getKernel();
+	return s_spanKernelCount;
+}
+
+const char *getSpanKernelName(uint kernel) {
+	getKernel();
+	assert(kernel < s_spanKernelCount);
+	return s_spanKernels[kernel]->name;
+}
+
+uint getSpanKernel() {
+	const SpanKernel *current = getKernel();
+	for (uint i = 0; i < s_spanKernelCount; i++) {
+		if (s_spanKernels[i] == current)
+			return i;
+	}
+	return 0;
+}
+
+void setSpanKernel(uint kernel) {
+	getKernel();
+	assert(kernel < s_spanKernelCount);
+	s_spanKernel = s_spanKernels[kernel];
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,104 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_PIXEL_SPAN_H
+#define GRAPHICS_PIXEL_SPAN_H
+
+#include "common/scummsys.h"
+#include "graphics/pixelformat.h"
+#include "graphics/transform_struct.h"
+
+namespace Graphics {
+
+// Fill and alpha blend horizontal runs of 16 or 32 bit pixels. These are the
+// inner loops of the vector renderer, of the TrueType glyph renderer and of
+// TransparentSurface.
+// Kernel 0 is always the portable implementation, the others are SIMD
+// implementations which produce identical output.
+
+/**
+ * Fill the pixels in [first, last) with a two pixel pattern.
+ *
+ * The pixels at even offsets from first receive evenColor, the others
+ * oddColor. Pass the same color twice for a solid fill.
+ */
+void fillSpan(uint16 *first, uint16 *last, uint16 evenColor, uint16 oddColor);
+void fillSpan(uint32 *first, uint32 *last, uint32 evenColor, uint32 oddColor);
+
+/**
+ * Alpha blend a color onto the pixels in [first, last).
+ *
+ * Every channel moves towards the channel of color by alpha / 256, the alpha
+ * channel towards fully opaque. An alpha of 255 stores the opaque color.
+ *
+ * @param format Format of the pixels and of color.
+ * @param alpha  Alpha intensity of color (0-255).
+ */
+void blendSpan(uint16 *first, uint16 *last, const PixelFormat &format, uint16 color, uint8 alpha);
+void blendSpan(uint32 *first, uint32 *last, const PixelFormat &format, uint32 color, uint8 alpha);
+
+/**
+ * Draw a color onto the pixels in [first, last) through a coverage mask,
+ * as used for anti-aliased glyphs.
+ *
+ * Pixels with a coverage of 255 are set to color, pixels with a coverage of
+ * 0 are left alone. All others become opaque, with every 8 bit channel set
+ * to (dst * (255 - coverage) + src * coverage) / 255.
+ *
+ * @param coverage One coverage value for every pixel.
+ * @param format   Format of the pixels and of color.
+ */
+void maskSpan(uint16 *first, uint16 *last, const byte *coverage, const PixelFormat &format, uint16 color);
+void maskSpan(uint32 *first, uint32 *last, const byte *coverage, const PixelFormat &format, uint32 color);
+
+/**
+ * Blend a run of TransparentSurface pixels onto a target, as done by
+ * TransparentSurface::blit().
+ *
+ * Both source and target are in TransparentSurface::getSupportedPixelFormat().
+ *
+ * @param blendMode How to combine source and target.
+ * @param in        First source pixel.
+ * @param inStep    Offset in bytes from one source pixel to the next, usually
+ *                  4 or -4 for horizontally flipped blits. Other steps are
+ *                  handled by the portable implementation.
+ * @param out       First target pixel.
+ * @param count     Number of pixels.
+ * @param color     Color modulation in 0xAARRGGBB format, 0xFFFFFFFF for none.
+ */
+void blitSpan(TSpriteBlendMode blendMode, const byte *in, int32 inStep, byte *out, uint count, uint32 color);
+
+/** Get the number of span kernels usable on this machine. */
+uint getSpanKernelCount();
+
+/** Get the name of a span kernel, e.g. "scalar", "sse2" or "avx2". */
+const char *getSpanKernelName(uint kernel);
+
+/** Get the kernel used for spans. Defaults to the fastest one. */
+uint getSpanKernel();
+
+/** Set the kernel used for spans. */
+void setSpanKernel(uint kernel);
+
+} // End of namespace Graphics
+
+#endif
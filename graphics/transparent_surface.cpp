@@ -33,15 +33,13 @@
 #include "common/rect.h"
 #include "common/math.h"
 #include "common/textconsole.h"
+#include "graphics/pixel_span.h"
 #include "graphics/primitives.h"
 #include "graphics/transparent_surface.h"
 #include "graphics/transform_tools.h"
 
 namespace Graphics {
 
-static const int kBModShift = 0;//img->format.bShift;
-static const int kGModShift = 8;//img->format.gShift;
-static const int kRModShift = 16;//img->format.rShift;
 static const int kAModShift = 24;//img->format.aShift;
 
 #ifdef SCUMM_LITTLE_ENDIAN
@@ -59,10 +57,7 @@ static const int kRIndex = 0;
 
 void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
 void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
-void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
-void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
-void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
-void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
+void doBlitBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color, TSpriteBlendMode blendMode);
 
 TransparentSurface::TransparentSurface() : Surface(), _alphaMode(ALPHA_FULL) {}
 
@@ -92,10 +87,19 @@ void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	for (uint32 i = 0; i < height; i++) {
 		out = outo;
 		in = ino;
-		memcpy(out, in, width * 4);
-		for (uint32 j = 0; j < width; j++) {
-			out[kAIndex] = 0xFF;
-			out += 4;
+		if (inStep == 4) {
+			memcpy(out, in, width * 4);
+			for (uint32 j = 0; j < width; j++) {
+				out[kAIndex] = 0xFF;
+				out += 4;
+			}
+		} else {
+			for (uint32 j = 0; j < width; j++) {
+				*(uint32 *)out = *(const uint32 *)in;
+				out[kAIndex] = 0xFF;
+				out += 4;
+				in += inStep;
+			}
 		}
 		outo += pitch;
 		ino += inoStep;
@@ -130,7 +134,7 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 }
 
 /**
- * Optimized version of doBlit to be used with alpha blended blitting
+ * Optimized version of doBlit to be used with blended blitting
  * @param ino a pointer to the input surface
  * @param outo a pointer to the output surface
  * @param width width of the input surface
@@ -139,406 +143,18 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  * @inStep size in bytes to skip to address each pixel, usually bpp of the source surface
  * @inoStep width in bytes of every row on the *input* surface / kind of like pitch
  * @color colormod in 0xAARRGGBB format - 0xFFFFFFFF for no colormod
+ * @blendMode how to combine the input with the output surface
  */
-void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
-	byte *in;
-	byte *out;
-
-	if (color == 0xffffffff) {
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kAIndex] = 255;
-					out[kRIndex] = ((in[kRIndex] * in[kAIndex]) + out[kRIndex] * (255 - in[kAIndex])) >> 8;
-					out[kGIndex] = ((in[kGIndex] * in[kAIndex]) + out[kGIndex] * (255 - in[kAIndex])) >> 8;
-					out[kBIndex] = ((in[kBIndex] * in[kAIndex]) + out[kBIndex] * (255 - in[kAIndex])) >> 8;
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	} else {
-
-		byte ca = (color >> kAModShift) & 0xFF;
-		byte cr = (color >> kRModShift) & 0xFF;
-		byte cg = (color >> kGModShift) & 0xFF;
-		byte cb = (color >> kBModShift) & 0xFF;
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				uint32 ina = in[kAIndex] * ca >> 8;
-				out[kAIndex] = 255;
-				out[kBIndex] = (out[kBIndex] * (255 - ina) >> 8);
-				out[kGIndex] = (out[kGIndex] * (255 - ina) >> 8);
-				out[kRIndex] = (out[kRIndex] * (255 - ina) >> 8);
-
-				out[kBIndex] = out[kBIndex] + (in[kBIndex] * ina * cb >> 16);
-				out[kGIndex] = out[kGIndex] + (in[kGIndex] * ina * cg >> 16);
-				out[kRIndex] = out[kRIndex] + (in[kRIndex] * ina * cr >> 16);
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	}
-}
-
-/**
- * Optimized version of doBlit to be used with additive blended blitting
- */
-void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
-	byte *in;
-	byte *out;
-
-	if (color == 0xffffffff) {
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) + out[kRIndex], 255);
-					out[kGIndex] = MIN((in[kGIndex] * in[kAIndex] >> 8) + out[kGIndex], 255);
-					out[kBIndex] = MIN((in[kBIndex] * in[kAIndex] >> 8) + out[kBIndex], 255);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	} else {
-
-		byte ca = (color >> kAModShift) & 0xFF;
-		byte cr = (color >> kRModShift) & 0xFF;
-		byte cg = (color >> kGModShift) & 0xFF;
-		byte cb = (color >> kBModShift) & 0xFF;
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				uint32 ina = in[kAIndex] * ca >> 8;
-
-				if (cb != 255) {
-					out[kBIndex] = MIN<uint>(out[kBIndex] + ((in[kBIndex] * cb * ina) >> 16), 255u);
-				} else {
-					out[kBIndex] = MIN<uint>(out[kBIndex] + (in[kBIndex] * ina >> 8), 255u);
-				}
-
-				if (cg != 255) {
-					out[kGIndex] = MIN<uint>(out[kGIndex] + ((in[kGIndex] * cg * ina) >> 16), 255u);
-				} else {
-					out[kGIndex] = MIN<uint>(out[kGIndex] + (in[kGIndex] * ina >> 8), 255u);
-				}
-
-				if (cr != 255) {
-					out[kRIndex] = MIN<uint>(out[kRIndex] + ((in[kRIndex] * cr * ina) >> 16), 255u);
-				} else {
-					out[kRIndex] = MIN<uint>(out[kRIndex] + (in[kRIndex] * ina >> 8), 255u);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	}
-}
-
-/**
- * Optimized version of doBlit to be used with subtractive blended blitting
- */
-void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
-	byte *in;
-	byte *out;
-
-	if (color == 0xffffffff) {
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * out[kRIndex]) * in[kAIndex] >> 16), 0);
-					out[kGIndex] = MAX(out[kGIndex] - ((in[kGIndex] * out[kGIndex]) * in[kAIndex] >> 16), 0);
-					out[kBIndex] = MAX(out[kBIndex] - ((in[kBIndex] * out[kBIndex]) * in[kAIndex] >> 16), 0);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	} else {
-
-		byte cr = (color >> kRModShift) & 0xFF;
-		byte cg = (color >> kGModShift) & 0xFF;
-		byte cb = (color >> kBModShift) & 0xFF;
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				out[kAIndex] = 255;
-				if (cb != 255) {
-					out[kBIndex] = MAX(out[kBIndex] - ((in[kBIndex] * cb  * (out[kBIndex]) * in[kAIndex]) >> 24), 0);
-				} else {
-					out[kBIndex] = MAX(out[kBIndex] - (in[kBIndex] * (out[kBIndex]) * in[kAIndex] >> 16), 0);
-				}
-
-				if (cg != 255) {
-					out[kGIndex] = MAX(out[kGIndex] - ((in[kGIndex] * cg  * (out[kGIndex]) * in[kAIndex]) >> 24), 0);
-				} else {
-					out[kGIndex] = MAX(out[kGIndex] - (in[kGIndex] * (out[kGIndex]) * in[kAIndex] >> 16), 0);
-				}
-
-				if (cr != 255) {
-					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * cr * (out[kRIndex]) * in[kAIndex]) >> 24), 0);
-				} else {
-					out[kRIndex] = MAX(out[kRIndex] - (in[kRIndex] * (out[kRIndex]) * in[kAIndex] >> 16), 0);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	}
-}
-
-/**
- * Optimized version of doBlit to be used with multiply blended blitting
- */
-void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
-	byte *in;
-	byte *out;
-
-	if (color == 0xffffffff) {
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) * out[kRIndex] >> 8, 255);
-					out[kGIndex] = MIN((in[kGIndex] * in[kAIndex] >> 8) * out[kGIndex] >> 8, 255);
-					out[kBIndex] = MIN((in[kBIndex] * in[kAIndex] >> 8) * out[kBIndex] >> 8, 255);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	} else {
-		byte ca = (color >> kAModShift) & 0xFF;
-		byte cr = (color >> kRModShift) & 0xFF;
-		byte cg = (color >> kGModShift) & 0xFF;
-		byte cb = (color >> kBModShift) & 0xFF;
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				uint32 ina = in[kAIndex] * ca >> 8;
-
-				if (cb != 255) {
-					out[kBIndex] = MIN<uint>(out[kBIndex] * ((in[kBIndex] * cb * ina) >> 16) >> 8, 255u);
-				} else {
-					out[kBIndex] = MIN<uint>(out[kBIndex] * (in[kBIndex] * ina >> 8) >> 8, 255u);
-				}
-
-				if (cg != 255) {
-					out[kGIndex] = MIN<uint>(out[kGIndex] * ((in[kGIndex] * cg * ina) >> 16) >> 8, 255u);
-				} else {
-					out[kGIndex] = MIN<uint>(out[kGIndex] * (in[kGIndex] * ina >> 8) >> 8, 255u);
-				}
-
-				if (cr != 255) {
-					out[kRIndex] = MIN<uint>(out[kRIndex] * ((in[kRIndex] * cr * ina) >> 16) >> 8, 255u);
-				} else {
-					out[kRIndex] = MIN<uint>(out[kRIndex] * (in[kRIndex] * ina >> 8) >> 8, 255u);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
+void doBlitBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color, TSpriteBlendMode blendMode) {
+	for (uint32 i = 0; i < height; i++) {
+		blitSpan(blendMode, ino, inStep, outo, width, color);
+		outo += pitch;
+		ino += inoStep;
 	}
-
 }
 
 Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int posY, int flipping, Common::Rect *pPartRect, uint color, int width, int height, TSpriteBlendMode blendMode) {
-
-	Common::Rect retSize;
-	retSize.top = 0;
-	retSize.left = 0;
-	retSize.setWidth(0);
-	retSize.setHeight(0);
-	// Check if we need to draw anything at all
-	int ca = (color >> kAModShift) & 0xff;
-
-	if (ca == 0) {
-		return retSize;
-	}
-
-	// Create an encapsulating surface for the data
-	TransparentSurface srcImage(*this, false);
-	// TODO: Is the data really in the screen format?
-	if (format.bytesPerPixel != 4) {
-		warning("TransparentSurface can only blit 32bpp images, but got %d", format.bytesPerPixel * 8);
-		return retSize;
-	}
-
-	if (pPartRect) {
-
-		int xOffset = pPartRect->left;
-		int yOffset = pPartRect->top;
-
-		if (flipping & FLIP_V) {
-			yOffset = srcImage.h - pPartRect->bottom;
-		}
-
-		if (flipping & FLIP_H) {
-			xOffset = srcImage.w - pPartRect->right;
-		}
-
-		srcImage.pixels = getBasePtr(xOffset, yOffset);
-		srcImage.w = pPartRect->width();
-		srcImage.h = pPartRect->height();
-
-		debug(6, "Blit(%d, %d, %d, [%d, %d, %d, %d], %08x, %d, %d)", posX, posY, flipping,
-			  pPartRect->left,  pPartRect->top, pPartRect->width(), pPartRect->height(), color, width, height);
-	} else {
-
-		debug(6, "Blit(%d, %d, %d, [%d, %d, %d, %d], %08x, %d, %d)", posX, posY, flipping, 0, 0,
-			  srcImage.w, srcImage.h, color, width, height);
-	}
-
-	if (width == -1) {
-		width = srcImage.w;
-	}
-	if (height == -1) {
-		height = srcImage.h;
-	}
-
-#ifdef SCALING_TESTING
-	// Hardcode scaling to 66% to test scaling
-	width = width * 2 / 3;
-	height = height * 2 / 3;
-#endif
-
-	Graphics::Surface *img = nullptr;
-	Graphics::Surface *imgScaled = nullptr;
-	byte *savedPixels = nullptr;
-	if ((width != srcImage.w) || (height != srcImage.h)) {
-		// Scale the image
-		img = imgScaled = srcImage.scale(width, height);
-		savedPixels = (byte *)img->getPixels();
-	} else {
-		img = &srcImage;
-	}
-
-	// Handle off-screen clipping
-	if (posY < 0) {
-		img->h = MAX(0, (int)img->h - -posY);
-		if (!(flipping & FLIP_V))
-			img->setPixels((byte *)img->getBasePtr(0, -posY));
-		posY = 0;
-	}
-
-	if (posX < 0) {
-		img->w = MAX(0, (int)img->w - -posX);
-		if (!(flipping & FLIP_H))
-			img->setPixels((byte *)img->getBasePtr(-posX, 0));
-		posX = 0;
-	}
-
-	if (img->w > target.w - posX) {
-		if (flipping & FLIP_H)
-			img->setPixels((byte *)img->getBasePtr(img->w - target.w + posX, 0));
-		img->w = CLIP((int)img->w, 0, (int)MAX((int)target.w - posX, 0));
-	}
-
-	if (img->h > target.h - posY) {
-		if (flipping & FLIP_V)
-			img->setPixels((byte *)img->getBasePtr(0, img->h - target.h + posY));
-		img->h = CLIP((int)img->h, 0, (int)MAX((int)target.h - posY, 0));
-	}
-
-	// Flip surface
-	if ((img->w > 0) && (img->h > 0)) {
-		int xp = 0, yp = 0;
-
-		int inStep = 4;
-		int inoStep = img->pitch;
-		if (flipping & FLIP_H) {
-			inStep = -inStep;
-			xp = img->w - 1;
-		}
-
-		if (flipping & FLIP_V) {
-			inoStep = -inoStep;
-			yp = img->h - 1;
-		}
-
-		byte *ino = (byte *)img->getBasePtr(xp, yp);
-		byte *outo = (byte *)target.getBasePtr(posX, posY);
-
-		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_OPAQUE) {
-			doBlitOpaqueFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_BINARY) {
-			doBlitBinaryFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else {
-			if (blendMode == BLEND_ADDITIVE) {
-				doBlitAdditiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_SUBTRACTIVE) {
-				doBlitSubtractiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_MULTIPLY) {
-				doBlitMultiplyBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else {
-				assert(blendMode == BLEND_NORMAL);
-				doBlitAlphaBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			}
-		}
-
-	}
-
-	retSize.setWidth(img->w);
-	retSize.setHeight(img->h);
-
-	if (imgScaled) {
-		imgScaled->setPixels(savedPixels);
-		imgScaled->free();
-		delete imgScaled;
-	}
-
-	return retSize;
+	return blitClip(target, Common::Rect(target.w, target.h), posX, posY, flipping, pPartRect, color, width, height, blendMode);
 }
 
 Common::Rect TransparentSurface::blitClip(Graphics::Surface &target, Common::Rect clippingArea, int posX, int posY, int flipping, Common::Rect *pPartRect, uint color, int width, int height, TSpriteBlendMode blendMode) {
@@ -600,94 +216,103 @@ Common::Rect TransparentSurface::blitClip(Graphics::Surface &target, Common::Rec
 	height = height * 2 / 3;
 #endif
 
-	Graphics::Surface *img = nullptr;
-	Graphics::Surface *imgScaled = nullptr;
-	byte *savedPixels = nullptr;
-	if ((width != srcImage.w) || (height != srcImage.h)) {
-		// Scale the image
-		img = imgScaled = srcImage.scale(width, height);
-		savedPixels = (byte *)img->getPixels();
-	} else {
-		img = &srcImage;
-	}
+	// The image is scaled to width x height while it is blitted. Clipping is
+	// done on the scaled image, whose visible part is (imgX, imgY, imgW, imgH).
+	const bool scaled = (width != srcImage.w) || (height != srcImage.h);
+	int imgX = 0, imgY = 0;
+	int imgW = MAX(width, 0), imgH = MAX(height, 0);
 
 	// Handle off-screen clipping
 	if (posY < clippingArea.top) {
-		img->h = MAX(0, (int)img->h - (clippingArea.top - posY));
+		imgH = MAX(0, imgH - (clippingArea.top - posY));
 		if (!(flipping & FLIP_V))
-			img->setPixels((byte *)img->getBasePtr(0, clippingArea.top - posY));
+			imgY += clippingArea.top - posY;
 		posY = clippingArea.top;
 	}
 
 	if (posX < clippingArea.left) {
-		img->w = MAX(0, (int)img->w - (clippingArea.left - posX));
+		imgW = MAX(0, imgW - (clippingArea.left - posX));
 		if (!(flipping & FLIP_H))
-			img->setPixels((byte *)img->getBasePtr(clippingArea.left - posX, 0));
+			imgX += clippingArea.left - posX;
 		posX = clippingArea.left;
 	}
 
-	if (img->w > clippingArea.right - posX) {
+	if (imgW > clippingArea.right - posX) {
 		if (flipping & FLIP_H)
-			img->setPixels((byte *)img->getBasePtr(img->w - clippingArea.right + posX, 0));
-		img->w = CLIP((int)img->w, 0, (int)MAX((int)clippingArea.right - posX, 0));
+			imgX += imgW - clippingArea.right + posX;
+		imgW = CLIP(imgW, 0, (int)MAX((int)clippingArea.right - posX, 0));
 	}
 
-	if (img->h > clippingArea.bottom - posY) {
+	if (imgH > clippingArea.bottom - posY) {
 		if (flipping & FLIP_V)
-			img->setPixels((byte *)img->getBasePtr(0, img->h - clippingArea.bottom + posY));
-		img->h = CLIP((int)img->h, 0, (int)MAX((int)clippingArea.bottom - posY, 0));
+			imgY += imgH - clippingArea.bottom + posY;
+		imgH = CLIP(imgH, 0, (int)MAX((int)clippingArea.bottom - posY, 0));
 	}
 
 	// Flip surface
-	if ((img->w > 0) && (img->h > 0)) {
-		int xp = 0, yp = 0;
+	if ((imgW > 0) && (imgH > 0)) {
+		byte *outo = (byte *)target.getBasePtr(posX, posY);
 
-		int inStep = 4;
-		int inoStep = img->pitch;
-		if (flipping & FLIP_H) {
-			inStep = -inStep;
-			xp = img->w - 1;
-		}
+		if (!scaled) {
+			int xp = imgX, yp = imgY;
 
-		if (flipping & FLIP_V) {
-			inoStep = -inoStep;
-			yp = img->h - 1;
-		}
+			int inStep = 4;
+			int inoStep = srcImage.pitch;
+			if (flipping & FLIP_H) {
+				inStep = -inStep;
+				xp += imgW - 1;
+			}
 
-		byte *ino = (byte *)img->getBasePtr(xp, yp);
-		byte *outo = (byte *)target.getBasePtr(posX, posY);
+			if (flipping & FLIP_V) {
+				inoStep = -inoStep;
+				yp += imgH - 1;
+			}
 
-		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_OPAQUE) {
-			doBlitOpaqueFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_BINARY) {
-			doBlitBinaryFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
+			doBlit((byte *)srcImage.getBasePtr(xp, yp), outo, imgW, imgH, target.pitch, inStep, inoStep, color, blendMode);
 		} else {
-			if (blendMode == BLEND_ADDITIVE) {
-				doBlitAdditiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_SUBTRACTIVE) {
-				doBlitSubtractiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_MULTIPLY) {
-				doBlitMultiplyBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else {
-				assert(blendMode == BLEND_NORMAL);
-				doBlitAlphaBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
+			// Sample the rows of the scaled image straight from the source,
+			// nearest neighbour like scale() does, instead of scaling the
+			// whole image first.
+			if (_scaleRow.size() < (uint)imgW) {
+				_scaleCacheX.resize(imgW);
+				_scaleRow.resize(imgW);
 			}
-		}
 
-	}
+			int *scaleCacheX = _scaleCacheX.begin();
+			for (int x = 0; x < imgW; x++) {
+				const int scaledX = (flipping & FLIP_H) ? imgX + imgW - 1 - x : imgX + x;
+				scaleCacheX[x] = (scaledX * srcImage.w) / width;
+			}
 
-	retSize.setWidth(img->w);
-	retSize.setHeight(img->h);
+			uint32 *row = _scaleRow.begin();
+			for (int y = 0; y < imgH; y++) {
+				const int scaledY = (flipping & FLIP_V) ? imgY + imgH - 1 - y : imgY + y;
+				const uint32 *srcP = (const uint32 *)srcImage.getBasePtr(0, (scaledY * srcImage.h) / height);
+				for (int x = 0; x < imgW; x++)
+					row[x] = srcP[scaleCacheX[x]];
 
-	if (imgScaled) {
-		imgScaled->setPixels(savedPixels);
-		imgScaled->free();
-		delete imgScaled;
+				doBlit((byte *)row, outo, imgW, 1, target.pitch, 4, 0, color, blendMode);
+				outo += target.pitch;
+			}
+		}
 	}
 
+	retSize.setWidth(imgW);
+	retSize.setHeight(imgH);
+
 	return retSize;
 }
 
+void TransparentSurface::doBlit(byte *ino, byte *outo, uint32 width, uint32 height, uint32 outPitch, int32 inStep, int32 inoStep, uint color, TSpriteBlendMode blendMode) const {
+	if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_OPAQUE) {
+		doBlitOpaqueFast(ino, outo, width, height, outPitch, inStep, inoStep);
+	} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_BINARY) {
+		doBlitBinaryFast(ino, outo, width, height, outPitch, inStep, inoStep);
+	} else {
+		doBlitBlend(ino, outo, width, height, outPitch, inStep, inoStep, color, blendMode);
+	}
+}
+
 /**
  * Writes a color key to the alpha channel of the surface
  * @param rKey  the red component of the color key
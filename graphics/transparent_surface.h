@@ -23,6 +23,7 @@
 #ifndef GRAPHICS_TRANSPARENTSURFACE_H
 #define GRAPHICS_TRANSPARENTSURFACE_H
 
+#include "common/array.h"
 #include "graphics/surface.h"
 #include "graphics/transform_struct.h"
 
@@ -177,6 +178,12 @@ struct TransparentSurface : public Graphics::Surface {
 private:
 	AlphaType _alphaMode;
 
+	// Scratch buffers of scaled blits, kept to avoid allocating them on every blit
+	Common::Array<int> _scaleCacheX;
+	Common::Array<uint32> _scaleRow;
+
+	void doBlit(byte *ino, byte *outo, uint32 width, uint32 height, uint32 outPitch, int32 inStep, int32 inoStep, uint color, TSpriteBlendMode blendMode) const;
+
 	template <typename Size>
 	void scaleNN(int *scaleCacheX, TransparentSurface *target) const;
 };
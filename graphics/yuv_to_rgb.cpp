@@ -86,6 +86,24 @@
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
+#if defined(__SSE2__)
+#define YUV_TO_RGB_SSE2
+#include <emmintrin.h>
+
+// AVX2 is not part of the x86-64 baseline, so it is compiled through a
+// function level target attribute and only used when the CPU reports it.
+#if GCC_ATLEAST(4, 9) || defined(__clang__)
+#define YUV_TO_RGB_AVX2
+#include <immintrin.h>
+#define YUV_TO_RGB_AVX2_TARGET __attribute__((__target__("avx2")))
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define YUV_TO_RGB_NEON
+#include <arm_neon.h>
+#endif
+
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
 }
@@ -99,6 +117,7 @@ public:
 	Graphics::PixelFormat getFormat() const { return _format; }
 	YUVToRGBManager::LuminanceScale getScale() const { return _scale; }
 	const uint32 *getRGBToPix() const { return _rgbToPix; }
+	uint32 getAlphaBits() const { return (0xFF >> _format.aLoss) << _format.aShift; }
 
 private:
 	Graphics::PixelFormat _format;
@@ -157,8 +176,514 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 	}
 }
 
+#define PUT_PIXEL(s, d) \
+	L = &rgbToPix[(s)]; \
+	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
+
+/**
+ * Row kernels convert a row of YUV444 pixels, or a pair of rows of YUV420
+ * pixels which share their chroma. Each kernel produces the same output as
+ * the lookup table implementation in convertYUV444ToRGB/convertYUV420ToRGB.
+ */
+typedef void (*YUVToRGBRowFunc)(byte *dstPtr, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width);
+typedef void (*YUVToRGBRowPairFunc)(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width);
+
+struct YUVToRGBKernel {
+	const char *name;
+	YUVToRGBRowFunc row444[2][2];         // [bytesPerPixel == 4][scale]
+	YUVToRGBRowPairFunc rowPair420[2][2]; // [bytesPerPixel == 4][scale]
+};
+
+// Lookup table versions of the row kernels, used for the pixels at the end of
+// a row which do not fill a whole vector
+template<typename PixelInt>
+static void convertYUV444RowLookup(byte *dstPtr, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width) {
+	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+
+	for (int i = 0; i < width; i++) {
+		const uint32 *L;
+
+		int16 cr_r  = Cr_r_tab[vSrc[i]];
+		int16 crb_g = Cr_g_tab[vSrc[i]] + Cb_g_tab[uSrc[i]];
+		int16 cb_b  = Cb_b_tab[uSrc[i]];
+
+		PUT_PIXEL(ySrc[i], dstPtr + i * sizeof(PixelInt));
+	}
+}
+
+template<typename PixelInt>
+static void convertYUV420RowPairLookup(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width) {
+	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+
+	for (int i = 0; i < width; i += 2) {
+		const uint32 *L;
+
+		int16 cr_r  = Cr_r_tab[vSrc[i >> 1]];
+		int16 crb_g = Cr_g_tab[vSrc[i >> 1]] + Cb_g_tab[uSrc[i >> 1]];
+		int16 cb_b  = Cb_b_tab[uSrc[i >> 1]];
+
+		PUT_PIXEL(ySrc[i], dstPtr + i * sizeof(PixelInt));
+		PUT_PIXEL(ySrc[i + yPitch], dstPtr + dstPitch + i * sizeof(PixelInt));
+		PUT_PIXEL(ySrc[i + 1], dstPtr + (i + 1) * sizeof(PixelInt));
+		PUT_PIXEL(ySrc[i + 1 + yPitch], dstPtr + dstPitch + (i + 1) * sizeof(PixelInt));
+	}
+}
+
+static const YUVToRGBKernel kKernelScalar = {
+	"scalar",
+	{ { 0, 0 }, { 0, 0 } },
+	{ { 0, 0 }, { 0, 0 } }
+};
+
+// The chroma tables hold (int16)(c * (value - 128)) for four constants c. The
+// SIMD kernels compute the same truncated products as sign(x) * ((|x| << s) * m) >> 16,
+// which equals the table entries for every |x| <= 128.
+enum {
+	kChromaCrR = 45916, // 0.419 / 0.299, s = 1
+	kChromaCrG = 46763, // 0.299 / 0.419, s = 0
+	kChromaCbG = 22568, // 0.114 / 0.331, s = 0
+	kChromaCbB = 58109  // 0.587 / 0.331, s = 1
+};
+
+// The ITU scale maps [16, 235] to [0, 255] through (c - 16) * 255 / 219.
+// For every c in that range, ((c - 16) * 255 * kITUScaleMul) >> (16 + kITUScaleShift)
+// equals the quotient.
+enum {
+	kITUScaleMul = 19153,
+	kITUScaleShift = 6
+};
+
+#ifdef YUV_TO_RGB_SSE2
+
+struct YUVToRGBShiftsSSE2 {
+	__m128i rLoss, rShift, gLoss, gShift, bLoss, bShift;
+
+	YUVToRGBShiftsSSE2(const Graphics::PixelFormat &format) {
+		rLoss = _mm_cvtsi32_si128(format.rLoss);
+		rShift = _mm_cvtsi32_si128(format.rShift);
+		gLoss = _mm_cvtsi32_si128(format.gLoss);
+		gShift = _mm_cvtsi32_si128(format.gShift);
+		bLoss = _mm_cvtsi32_si128(format.bLoss);
+		bShift = _mm_cvtsi32_si128(format.bShift);
+	}
+};
+
+static inline __m128i mulChromaSSE2(__m128i absValue, __m128i sign, int16 mul) {
+	__m128i product = _mm_mulhi_epu16(absValue, _mm_set1_epi16(mul));
+	return _mm_sub_epi16(_mm_xor_si128(product, sign), sign);
+}
+
+static inline void chromaOffsetsSSE2(__m128i u, __m128i v, __m128i &rOffset, __m128i &gOffset, __m128i &bOffset) {
+	__m128i cr = _mm_sub_epi16(v, _mm_set1_epi16(128));
+	__m128i cb = _mm_sub_epi16(u, _mm_set1_epi16(128));
+	__m128i crSign = _mm_srai_epi16(cr, 15);
+	__m128i cbSign = _mm_srai_epi16(cb, 15);
+	__m128i crAbs = _mm_sub_epi16(_mm_xor_si128(cr, crSign), crSign);
+	__m128i cbAbs = _mm_sub_epi16(_mm_xor_si128(cb, cbSign), cbSign);
+
+	rOffset = mulChromaSSE2(_mm_slli_epi16(crAbs, 1), crSign, (int16)kChromaCrR);
+	gOffset = _mm_sub_epi16(_mm_setzero_si128(), _mm_add_epi16(mulChromaSSE2(crAbs, crSign, (int16)kChromaCrG), mulChromaSSE2(cbAbs, cbSign, (int16)kChromaCbG)));
+	bOffset = mulChromaSSE2(_mm_slli_epi16(cbAbs, 1), cbSign, (int16)kChromaCbB);
+}
+
+template<YUVToRGBManager::LuminanceScale scale>
+static inline __m128i yuvChannelSSE2(__m128i y, __m128i offset) {
+	__m128i c = _mm_add_epi16(y, offset);
+
+	if (scale == YUVToRGBManager::kScaleFull)
+		return _mm_min_epi16(_mm_max_epi16(c, _mm_setzero_si128()), _mm_set1_epi16(255));
+
+	c = _mm_min_epi16(_mm_max_epi16(c, _mm_set1_epi16(16)), _mm_set1_epi16(235));
+	c = _mm_mullo_epi16(_mm_sub_epi16(c, _mm_set1_epi16(16)), _mm_set1_epi16(255));
+	return _mm_srli_epi16(_mm_mulhi_epu16(c, _mm_set1_epi16((int16)kITUScaleMul)), kITUScaleShift);
+}
+
+// Converts and stores 8 pixels
+template<typename PixelInt, YUVToRGBManager::LuminanceScale scale>
+static inline void putPixelsSSE2(byte *dstPtr, const YUVToRGBShiftsSSE2 &shifts, __m128i alpha, __m128i y, __m128i rOffset, __m128i gOffset, __m128i bOffset) {
+	__m128i r = _mm_srl_epi16(yuvChannelSSE2<scale>(y, rOffset), shifts.rLoss);
+	__m128i g = _mm_srl_epi16(yuvChannelSSE2<scale>(y, gOffset), shifts.gLoss);
+	__m128i b = _mm_srl_epi16(yuvChannelSSE2<scale>(y, bOffset), shifts.bLoss);
+
+	if (sizeof(PixelInt) == 2) {
+		__m128i pixels = _mm_or_si128(alpha, _mm_sll_epi16(r, shifts.rShift));
+		pixels = _mm_or_si128(pixels, _mm_sll_epi16(g, shifts.gShift));
+		pixels = _mm_or_si128(pixels, _mm_sll_epi16(b, shifts.bShift));
+		_mm_storeu_si128((__m128i *)dstPtr, pixels);
+	} else {
+		const __m128i zero = _mm_setzero_si128();
+		__m128i lo = _mm_or_si128(alpha, _mm_sll_epi32(_mm_unpacklo_epi16(r, zero), shifts.rShift));
+		lo = _mm_or_si128(lo, _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), shifts.gShift));
+		lo = _mm_or_si128(lo, _mm_sll_epi32(_mm_unpacklo_epi16(b, zero), shifts.bShift));
+		__m128i hi = _mm_or_si128(alpha, _mm_sll_epi32(_mm_unpackhi_epi16(r, zero), shifts.rShift));
+		hi = _mm_or_si128(hi, _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), shifts.gShift));
+		hi = _mm_or_si128(hi, _mm_sll_epi32(_mm_unpackhi_epi16(b, zero), shifts.bShift));
+		_mm_storeu_si128((__m128i *)dstPtr, lo);
+		_mm_storeu_si128((__m128i *)(dstPtr + 16), hi);
+	}
+}
+
+template<typename PixelInt>
+static inline __m128i alphaSSE2(const YUVToRGBLookup *lookup) {
+	if (sizeof(PixelInt) == 2)
+		return _mm_set1_epi16((int16)lookup->getAlphaBits());
+	return _mm_set1_epi32((int32)lookup->getAlphaBits());
+}
+
+template<typename PixelInt, YUVToRGBManager::LuminanceScale scale>
+static void convertYUV444RowSSE2(byte *dstPtr, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width) {
+	const YUVToRGBShiftsSSE2 shifts(lookup->getFormat());
+	const __m128i alpha = alphaSSE2<PixelInt>(lookup);
+	const __m128i zero = _mm_setzero_si128();
+
+	int i = 0;
+	for (; i + 8 <= width; i += 8) {
+		__m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + i)), zero);
+		__m128i u = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(uSrc + i)), zero);
+		__m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(vSrc + i)), zero);
+
+		__m128i rOffset, gOffset, bOffset;
+		chromaOffsetsSSE2(u, v, rOffset, gOffset, bOffset);
+		putPixelsSSE2<PixelInt, scale>(dstPtr + i * sizeof(PixelInt), shifts, alpha, y, rOffset, gOffset, bOffset);
+	}
+
+	convertYUV444RowLookup<PixelInt>(dstPtr + i * sizeof(PixelInt), lookup, colorTab, ySrc + i, uSrc + i, vSrc + i, width - i);
+}
+
+template<typename PixelInt, YUVToRGBManager::LuminanceScale scale>
+static void convertYUV420RowPairSSE2(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width) {
+	const YUVToRGBShiftsSSE2 shifts(lookup->getFormat());
+	const __m128i alpha = alphaSSE2<PixelInt>(lookup);
+	const __m128i zero = _mm_setzero_si128();
+
+	int i = 0;
+	for (; i + 16 <= width; i += 16) {
+		__m128i u = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(uSrc + (i >> 1))), zero);
+		__m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(vSrc + (i >> 1))), zero);
+
+		__m128i rOffset, gOffset, bOffset;
+		chromaOffsetsSSE2(u, v, rOffset, gOffset, bOffset);
+
+		// Each chroma sample covers two horizontal pixels
+		__m128i rLo = _mm_unpacklo_epi16(rOffset, rOffset), rHi = _mm_unpackhi_epi16(rOffset, rOffset);
+		__m128i gLo = _mm_unpacklo_epi16(gOffset, gOffset), gHi = _mm_unpackhi_epi16(gOffset, gOffset);
+		__m128i bLo = _mm_unpacklo_epi16(bOffset, bOffset), bHi = _mm_unpackhi_epi16(bOffset, bOffset);
+
+		for (int row = 0; row < 2; row++) {
+			__m128i y = _mm_loadu_si128((const __m128i *)(ySrc + row * yPitch + i));
+			byte *dst = dstPtr + row * dstPitch + i * sizeof(PixelInt);
+
+			putPixelsSSE2<PixelInt, scale>(dst, shifts, alpha, _mm_unpacklo_epi8(y, zero), rLo, gLo, bLo);
+			putPixelsSSE2<PixelInt, scale>(dst + 8 * sizeof(PixelInt), shifts, alpha, _mm_unpackhi_epi8(y, zero), rHi, gHi, bHi);
+		}
+	}
+
+	convertYUV420RowPairLookup<PixelInt>(dstPtr + i * sizeof(PixelInt), dstPitch, lookup, colorTab, ySrc + i, yPitch, uSrc + (i >> 1), vSrc + (i >> 1), width - i);
+}
+
+static const YUVToRGBKernel kKernelSSE2 = {
+	"sse2",
+	{
+		{ convertYUV444RowSSE2<uint16, YUVToRGBManager::kScaleFull>, convertYUV444RowSSE2<uint16, YUVToRGBManager::kScaleITU> },
+		{ convertYUV444RowSSE2<uint32, YUVToRGBManager::kScaleFull>, convertYUV444RowSSE2<uint32, YUVToRGBManager::kScaleITU> }
+	},
+	{
+		{ convertYUV420RowPairSSE2<uint16, YUVToRGBManager::kScaleFull>, convertYUV420RowPairSSE2<uint16, YUVToRGBManager::kScaleITU> },
+		{ convertYUV420RowPairSSE2<uint32, YUVToRGBManager::kScaleFull>, convertYUV420RowPairSSE2<uint32, YUVToRGBManager::kScaleITU> }
+	}
+};
+
+#endif // YUV_TO_RGB_SSE2
+
+#ifdef YUV_TO_RGB_AVX2
+
+struct YUVToRGBShiftsAVX2 {
+	__m128i rLoss, rShift, gLoss, gShift, bLoss, bShift;
+
+	YUV_TO_RGB_AVX2_TARGET YUVToRGBShiftsAVX2(const Graphics::PixelFormat &format) {
+		rLoss = _mm_cvtsi32_si128(format.rLoss);
+		rShift = _mm_cvtsi32_si128(format.rShift);
+		gLoss = _mm_cvtsi32_si128(format.gLoss);
+		gShift = _mm_cvtsi32_si128(format.gShift);
+		bLoss = _mm_cvtsi32_si128(format.bLoss);
+		bShift = _mm_cvtsi32_si128(format.bShift);
+	}
+};
+
+YUV_TO_RGB_AVX2_TARGET static inline void chromaOffsetsAVX2(__m256i u, __m256i v, __m256i &rOffset, __m256i &gOffset, __m256i &bOffset) {
+	__m256i cr = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+	__m256i cb = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+	__m256i crAbs = _mm256_abs_epi16(cr);
+	__m256i cbAbs = _mm256_abs_epi16(cb);
+
+	// _mm256_sign_epi16 zeroes the lanes where the chroma is 0, and so is the product
+	rOffset = _mm256_sign_epi16(_mm256_mulhi_epu16(_mm256_slli_epi16(crAbs, 1), _mm256_set1_epi16((int16)kChromaCrR)), cr);
+	gOffset = _mm256_add_epi16(_mm256_sign_epi16(_mm256_mulhi_epu16(crAbs, _mm256_set1_epi16((int16)kChromaCrG)), cr),
+	                           _mm256_sign_epi16(_mm256_mulhi_epu16(cbAbs, _mm256_set1_epi16((int16)kChromaCbG)), cb));
+	gOffset = _mm256_sub_epi16(_mm256_setzero_si256(), gOffset);
+	bOffset = _mm256_sign_epi16(_mm256_mulhi_epu16(_mm256_slli_epi16(cbAbs, 1), _mm256_set1_epi16((int16)kChromaCbB)), cb);
+}
+
+template<YUVToRGBManager::LuminanceScale scale>
+YUV_TO_RGB_AVX2_TARGET static inline __m256i yuvChannelAVX2(__m256i y, __m256i offset) {
+	__m256i c = _mm256_add_epi16(y, offset);
+
+	if (scale == YUVToRGBManager::kScaleFull)
+		return _mm256_min_epi16(_mm256_max_epi16(c, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+
+	c = _mm256_min_epi16(_mm256_max_epi16(c, _mm256_set1_epi16(16)), _mm256_set1_epi16(235));
+	c = _mm256_mullo_epi16(_mm256_sub_epi16(c, _mm256_set1_epi16(16)), _mm256_set1_epi16(255));
+	return _mm256_srli_epi16(_mm256_mulhi_epu16(c, _mm256_set1_epi16((int16)kITUScaleMul)), kITUScaleShift);
+}
+
+// Converts and stores 16 pixels
+template<typename PixelInt, YUVToRGBManager::LuminanceScale scale>
+YUV_TO_RGB_AVX2_TARGET static inline void putPixelsAVX2(byte *dstPtr, const YUVToRGBShiftsAVX2 &shifts, __m256i alpha, __m256i y, __m256i rOffset, __m256i gOffset, __m256i bOffset) {
+	__m256i r = _mm256_srl_epi16(yuvChannelAVX2<scale>(y, rOffset), shifts.rLoss);
+	__m256i g = _mm256_srl_epi16(yuvChannelAVX2<scale>(y, gOffset), shifts.gLoss);
+	__m256i b = _mm256_srl_epi16(yuvChannelAVX2<scale>(y, bOffset), shifts.bLoss);
+
+	if (sizeof(PixelInt) == 2) {
+		__m256i pixels = _mm256_or_si256(alpha, _mm256_sll_epi16(r, shifts.rShift));
+		pixels = _mm256_or_si256(pixels, _mm256_sll_epi16(g, shifts.gShift));
+		pixels = _mm256_or_si256(pixels, _mm256_sll_epi16(b, shifts.bShift));
+		_mm256_storeu_si256((__m256i *)dstPtr, pixels);
+	} else {
+		__m256i lo = _mm256_or_si256(alpha, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(r)), shifts.rShift));
+		lo = _mm256_or_si256(lo, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(g)), shifts.gShift));
+		lo = _mm256_or_si256(lo, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(b)), shifts.bShift));
+		__m256i hi = _mm256_or_si256(alpha, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(r, 1)), shifts.rShift));
+		hi = _mm256_or_si256(hi, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(g, 1)), shifts.gShift));
+		hi = _mm256_or_si256(hi, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(b, 1)), shifts.bShift));
+		_mm256_storeu_si256((__m256i *)dstPtr, lo);
+		_mm256_storeu_si256((__m256i *)(dstPtr + 32), hi);
+	}
+}
+
+template<typename PixelInt>
+YUV_TO_RGB_AVX2_TARGET static inline __m256i alphaAVX2(const YUVToRGBLookup *lookup) {
+	if (sizeof(PixelInt) == 2)
+		return _mm256_set1_epi16((int16)lookup->getAlphaBits());
+	return _mm256_set1_epi32((int32)lookup->getAlphaBits());
+}
+
+template<typename PixelInt, YUVToRGBManager::LuminanceScale scale>
+YUV_TO_RGB_AVX2_TARGET static void convertYUV444RowAVX2(byte *dstPtr, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width) {
+	const YUVToRGBShiftsAVX2 shifts(lookup->getFormat());
+	const __m256i alpha = alphaAVX2<PixelInt>(lookup);
+
+	int i = 0;
+	for (; i + 16 <= width; i += 16) {
+		__m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + i)));
+		__m256i u = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(uSrc + i)));
+		__m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(vSrc + i)));
+
+		__m256i rOffset, gOffset, bOffset;
+		chromaOffsetsAVX2(u, v, rOffset, gOffset, bOffset);
+		putPixelsAVX2<PixelInt, scale>(dstPtr + i * sizeof(PixelInt), shifts, alpha, y, rOffset, gOffset, bOffset);
+	}
+
+	convertYUV444RowLookup<PixelInt>(dstPtr + i * sizeof(PixelInt), lookup, colorTab, ySrc + i, uSrc + i, vSrc + i, width - i);
+}
+
+template<typename PixelInt, YUVToRGBManager::LuminanceScale scale>
+YUV_TO_RGB_AVX2_TARGET static void convertYUV420RowPairAVX2(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width) {
+	const YUVToRGBShiftsAVX2 shifts(lookup->getFormat());
+	const __m256i alpha = alphaAVX2<PixelInt>(lookup);
+
+	int i = 0;
+	for (; i + 32 <= width; i += 32) {
+		__m256i u = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(uSrc + (i >> 1))));
+		__m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(vSrc + (i >> 1))));
+
+		__m256i rOffset, gOffset, bOffset;
+		chromaOffsetsAVX2(u, v, rOffset, gOffset, bOffset);
+
+		// Each chroma sample covers two horizontal pixels. The unpack works
+		// within 128 bit lanes, so the lanes are put back in order afterwards.
+		__m256i rA = _mm256_unpacklo_epi16(rOffset, rOffset), rB = _mm256_unpackhi_epi16(rOffset, rOffset);
+		__m256i gA = _mm256_unpacklo_epi16(gOffset, gOffset), gB = _mm256_unpackhi_epi16(gOffset, gOffset);
+		__m256i bA = _mm256_unpacklo_epi16(bOffset, bOffset), bB = _mm256_unpackhi_epi16(bOffset, bOffset);
+		__m256i rLo = _mm256_permute2x128_si256(rA, rB, 0x20), rHi = _mm256_permute2x128_si256(rA, rB, 0x31);
+		__m256i gLo = _mm256_permute2x128_si256(gA, gB, 0x20), gHi = _mm256_permute2x128_si256(gA, gB, 0x31);
+		__m256i bLo = _mm256_permute2x128_si256(bA, bB, 0x20), bHi = _mm256_permute2x128_si256(bA, bB, 0x31);
+
+		for (int row = 0; row < 2; row++) {
+			const byte *y = ySrc + row * yPitch + i;
+			byte *dst = dstPtr + row * dstPitch + i * sizeof(PixelInt);
+
+			putPixelsAVX2<PixelInt, scale>(dst, shifts, alpha, _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)y)), rLo, gLo, bLo);
+			putPixelsAVX2<PixelInt, scale>(dst + 16 * sizeof(PixelInt), shifts, alpha, _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(y + 16))), rHi, gHi, bHi);
+		}
+	}
+
+	convertYUV420RowPairLookup<PixelInt>(dstPtr + i * sizeof(PixelInt), dstPitch, lookup, colorTab, ySrc + i, yPitch, uSrc + (i >> 1), vSrc + (i >> 1), width - i);
+}
+
+static const YUVToRGBKernel kKernelAVX2 = {
+	"avx2",
+	{
+		{ convertYUV444RowAVX2<uint16, YUVToRGBManager::kScaleFull>, convertYUV444RowAVX2<uint16, YUVToRGBManager::kScaleITU> },
+		{ convertYUV444RowAVX2<uint32, YUVToRGBManager::kScaleFull>, convertYUV444RowAVX2<uint32, YUVToRGBManager::kScaleITU> }
+	},
+	{
+		{ convertYUV420RowPairAVX2<uint16, YUVToRGBManager::kScaleFull>, convertYUV420RowPairAVX2<uint16, YUVToRGBManager::kScaleITU> },
+		{ convertYUV420RowPairAVX2<uint32, YUVToRGBManager::kScaleFull>, convertYUV420RowPairAVX2<uint32, YUVToRGBManager::kScaleITU> }
+	}
+};
+
+#endif // YUV_TO_RGB_AVX2
+
+#ifdef YUV_TO_RGB_NEON
+
+static inline int16x8_t mulChromaNEON(uint16x8_t absValue, int16x8_t sign, uint16 mul) {
+	uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(absValue), vdup_n_u16(mul)), 16);
+	uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(absValue), vdup_n_u16(mul)), 16);
+	int16x8_t product = vreinterpretq_s16_u16(vcombine_u16(lo, hi));
+	return vsubq_s16(veorq_s16(product, sign), sign);
+}
+
+static inline void chromaOffsetsNEON(int16x8_t u, int16x8_t v, int16x8_t &rOffset, int16x8_t &gOffset, int16x8_t &bOffset) {
+	int16x8_t cr = vsubq_s16(v, vdupq_n_s16(128));
+	int16x8_t cb = vsubq_s16(u, vdupq_n_s16(128));
+	int16x8_t crSign = vshrq_n_s16(cr, 15);
+	int16x8_t cbSign = vshrq_n_s16(cb, 15);
+	uint16x8_t crAbs = vreinterpretq_u16_s16(vabsq_s16(cr));
+	uint16x8_t cbAbs = vreinterpretq_u16_s16(vabsq_s16(cb));
+
+	rOffset = mulChromaNEON(vshlq_n_u16(crAbs, 1), crSign, kChromaCrR);
+	gOffset = vnegq_s16(vaddq_s16(mulChromaNEON(crAbs, crSign, kChromaCrG), mulChromaNEON(cbAbs, cbSign, kChromaCbG)));
+	bOffset = mulChromaNEON(vshlq_n_u16(cbAbs, 1), cbSign, kChromaCbB);
+}
+
+template<YUVToRGBManager::LuminanceScale scale>
+static inline uint16x8_t yuvChannelNEON(int16x8_t y, int16x8_t offset) {
+	int16x8_t c = vaddq_s16(y, offset);
+
+	if (scale == YUVToRGBManager::kScaleFull)
+		return vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(c, vdupq_n_s16(0)), vdupq_n_s16(255)));
+
+	c = vminq_s16(vmaxq_s16(c, vdupq_n_s16(16)), vdupq_n_s16(235));
+	uint16x8_t u = vmulq_u16(vreinterpretq_u16_s16(vsubq_s16(c, vdupq_n_s16(16))), vdupq_n_u16(255));
+	uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(u), vdup_n_u16(kITUScaleMul)), 16);
+	uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(u), vdup_n_u16(kITUScaleMul)), 16);
+	return vshrq_n_u16(vcombine_u16(lo, hi), kITUScaleShift);
+}
+
+// Converts and stores 8 pixels
+template<typename PixelInt, YUVToRGBManager::LuminanceScale scale>
+static inline void putPixelsNEON(byte *dstPtr, const Graphics::PixelFormat &format, uint32 alpha, int16x8_t y, int16x8_t rOffset, int16x8_t gOffset, int16x8_t bOffset) {
+	uint16x8_t r = vshlq_u16(yuvChannelNEON<scale>(y, rOffset), vdupq_n_s16(-format.rLoss));
+	uint16x8_t g = vshlq_u16(yuvChannelNEON<scale>(y, gOffset), vdupq_n_s16(-format.gLoss));
+	uint16x8_t b = vshlq_u16(yuvChannelNEON<scale>(y, bOffset), vdupq_n_s16(-format.bLoss));
+
+	if (sizeof(PixelInt) == 2) {
+		uint16x8_t pixels = vorrq_u16(vdupq_n_u16((uint16)alpha), vshlq_u16(r, vdupq_n_s16(format.rShift)));
+		pixels = vorrq_u16(pixels, vshlq_u16(g, vdupq_n_s16(format.gShift)));
+		pixels = vorrq_u16(pixels, vshlq_u16(b, vdupq_n_s16(format.bShift)));
+		vst1q_u16((uint16 *)dstPtr, pixels);
+	} else {
+		const int32x4_t rShift = vdupq_n_s32(format.rShift), gShift = vdupq_n_s32(format.gShift), bShift = vdupq_n_s32(format.bShift);
+		uint32x4_t lo = vorrq_u32(vdupq_n_u32(alpha), vshlq_u32(vmovl_u16(vget_low_u16(r)), rShift));
+		lo = vorrq_u32(lo, vshlq_u32(vmovl_u16(vget_low_u16(g)), gShift));
+		lo = vorrq_u32(lo, vshlq_u32(vmovl_u16(vget_low_u16(b)), bShift));
+		uint32x4_t hi = vorrq_u32(vdupq_n_u32(alpha), vshlq_u32(vmovl_u16(vget_high_u16(r)), rShift));
+		hi = vorrq_u32(hi, vshlq_u32(vmovl_u16(vget_high_u16(g)), gShift));
+		hi = vorrq_u32(hi, vshlq_u32(vmovl_u16(vget_high_u16(b)), bShift));
+		vst1q_u32((uint32 *)dstPtr, lo);
+		vst1q_u32((uint32 *)(dstPtr + 16), hi);
+	}
+}
+
+template<typename PixelInt, YUVToRGBManager::LuminanceScale scale>
+static void convertYUV444RowNEON(byte *dstPtr, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width) {
+	const Graphics::PixelFormat format = lookup->getFormat();
+	const uint32 alpha = lookup->getAlphaBits();
+
+	int i = 0;
+	for (; i + 8 <= width; i += 8) {
+		int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc + i)));
+		int16x8_t u = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(uSrc + i)));
+		int16x8_t v = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(vSrc + i)));
+
+		int16x8_t rOffset, gOffset, bOffset;
+		chromaOffsetsNEON(u, v, rOffset, gOffset, bOffset);
+		putPixelsNEON<PixelInt, scale>(dstPtr + i * sizeof(PixelInt), format, alpha, y, rOffset, gOffset, bOffset);
+	}
+
+	convertYUV444RowLookup<PixelInt>(dstPtr + i * sizeof(PixelInt), lookup, colorTab, ySrc + i, uSrc + i, vSrc + i, width - i);
+}
+
+template<typename PixelInt, YUVToRGBManager::LuminanceScale scale>
+static void convertYUV420RowPairNEON(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width) {
+	const Graphics::PixelFormat format = lookup->getFormat();
+	const uint32 alpha = lookup->getAlphaBits();
+
+	int i = 0;
+	for (; i + 16 <= width; i += 16) {
+		int16x8_t u = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(uSrc + (i >> 1))));
+		int16x8_t v = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(vSrc + (i >> 1))));
+
+		int16x8_t rOffset, gOffset, bOffset;
+		chromaOffsetsNEON(u, v, rOffset, gOffset, bOffset);
+
+		// Each chroma sample covers two horizontal pixels
+		int16x8x2_t r = vzipq_s16(rOffset, rOffset);
+		int16x8x2_t g = vzipq_s16(gOffset, gOffset);
+		int16x8x2_t b = vzipq_s16(bOffset, bOffset);
+
+		for (int row = 0; row < 2; row++) {
+			uint8x16_t y = vld1q_u8(ySrc + row * yPitch + i);
+			byte *dst = dstPtr + row * dstPitch + i * sizeof(PixelInt);
+
+			putPixelsNEON<PixelInt, scale>(dst, format, alpha, vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y))), r.val[0], g.val[0], b.val[0]);
+			putPixelsNEON<PixelInt, scale>(dst + 8 * sizeof(PixelInt), format, alpha, vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y))), r.val[1], g.val[1], b.val[1]);
+		}
+	}
+
+	convertYUV420RowPairLookup<PixelInt>(dstPtr + i * sizeof(PixelInt), dstPitch, lookup, colorTab, ySrc + i, yPitch, uSrc + (i >> 1), vSrc + (i >> 1), width - i);
+}
+
+static const YUVToRGBKernel kKernelNEON = {
+	"neon",
+	{
+		{ convertYUV444RowNEON<uint16, YUVToRGBManager::kScaleFull>, convertYUV444RowNEON<uint16, YUVToRGBManager::kScaleITU> },
+		{ convertYUV444RowNEON<uint32, YUVToRGBManager::kScaleFull>, convertYUV444RowNEON<uint32, YUVToRGBManager::kScaleITU> }
+	},
+	{
+		{ convertYUV420RowPairNEON<uint16, YUVToRGBManager::kScaleFull>, convertYUV420RowPairNEON<uint16, YUVToRGBManager::kScaleITU> },
+		{ convertYUV420RowPairNEON<uint32, YUVToRGBManager::kScaleFull>, convertYUV420RowPairNEON<uint32, YUVToRGBManager::kScaleITU> }
+	}
+};
+
+#endif // YUV_TO_RGB_NEON
+
 YUVToRGBManager::YUVToRGBManager() {
 	_lookup = 0;
+	_kernelCount = 0;
+
+	// The first kernel is the portable lookup table implementation, the
+	// fastest one supported by the CPU is the last one and is the default.
+	_kernels[_kernelCount++] = &kKernelScalar;
+#ifdef YUV_TO_RGB_SSE2
+	_kernels[_kernelCount++] = &kKernelSSE2;
+#endif
+#ifdef YUV_TO_RGB_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		_kernels[_kernelCount++] = &kKernelAVX2;
+#endif
+#ifdef YUV_TO_RGB_NEON
+	_kernels[_kernelCount++] = &kKernelNEON;
+#endif
+	_kernel = _kernelCount - 1;
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -192,9 +717,22 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
-#define PUT_PIXEL(s, d) \
-	L = &rgbToPix[(s)]; \
-	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
+const char *YUVToRGBManager::getKernelName(uint kernel) const {
+	assert(kernel < _kernelCount);
+	return _kernels[kernel]->name;
+}
+
+void YUVToRGBManager::setKernel(uint kernel) {
+	assert(kernel < _kernelCount);
+	_kernel = kernel;
+}
+
+byte *YUVToRGBManager::getChromaBuffer(int width) {
+	if (_chromaBuffer.size() < (uint)width * 2)
+		_chromaBuffer.resize(width * 2);
+
+	return _chromaBuffer.begin();
+}
 
 template<typename PixelInt>
 void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
@@ -227,6 +765,17 @@ void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	}
 }
 
+static void convertYUV444ToRGBRows(YUVToRGBRowFunc rowFunc, byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	for (int h = 0; h < yHeight; h++) {
+		rowFunc(dstPtr, lookup, colorTab, ySrc, uSrc, vSrc, yWidth);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
 void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -235,6 +784,12 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	YUVToRGBRowFunc rowFunc = _kernels[_kernel]->row444[dst->format.bytesPerPixel == 4][scale];
+	if (rowFunc) {
+		convertYUV444ToRGBRows(rowFunc, (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -281,6 +836,19 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	}
 }
 
+static void convertYUV420ToRGBRows(YUVToRGBRowPairFunc rowPairFunc, byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	int halfHeight = yHeight >> 1;
+
+	for (int h = 0; h < halfHeight; h++) {
+		rowPairFunc(dstPtr, dstPitch, lookup, colorTab, ySrc, yPitch, uSrc, vSrc, yWidth);
+
+		dstPtr += dstPitch << 1;
+		ySrc += yPitch << 1;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
 void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -291,6 +859,12 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	YUVToRGBRowPairFunc rowPairFunc = _kernels[_kernel]->rowPair420[dst->format.bytesPerPixel == 4][scale];
+	if (rowPairFunc) {
+		convertYUV420ToRGBRows(rowPairFunc, (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -366,6 +940,35 @@ void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 #undef DO_INTERPOLATION
 #undef DO_YUV410_PIXEL
 
+static void convertYUV410ToRGBRows(YUVToRGBRowFunc rowFunc, byte *chroma, byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	int quarterWidth = yWidth >> 2;
+	byte *uRow = chroma;
+	byte *vRow = chroma + yWidth;
+
+	for (int y = 0; y < yHeight; y++) {
+		int yDiff = y & 3;
+
+		// Upsample the chroma of the row with the same bilinear interpolation
+		// as convertYUV410ToRGB, then convert it as a YUV444 row
+		for (int x = 0; x < quarterWidth; x++) {
+			int index = (y >> 2) * uvPitch + x;
+			int uA = uSrc[index], uB = uSrc[index + 1], uC = uSrc[index + uvPitch], uD = uSrc[index + uvPitch + 1];
+			int vA = vSrc[index], vB = vSrc[index + 1], vC = vSrc[index + uvPitch], vD = vSrc[index + uvPitch + 1];
+
+			for (int xDiff = 0; xDiff < 4; xDiff++) {
+				uRow[x * 4 + xDiff] = (uA * (4 - xDiff) * (4 - yDiff) + uB * xDiff * (4 - yDiff) + uC * yDiff * (4 - xDiff) + uD * xDiff * yDiff) >> 4;
+				vRow[x * 4 + xDiff] = (vA * (4 - xDiff) * (4 - yDiff) + vB * xDiff * (4 - yDiff) + vC * yDiff * (4 - xDiff) + vD * xDiff * yDiff) >> 4;
+			}
+		}
+
+		// Only the chroma of whole quads is filled, as in convertYUV410ToRGB
+		rowFunc(dstPtr, lookup, colorTab, ySrc, uRow, vRow, quarterWidth * 4);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+	}
+}
+
 void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -376,6 +979,12 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	YUVToRGBRowFunc rowFunc = _kernels[_kernel]->row444[dst->format.bytesPerPixel == 4][scale];
+	if (rowFunc) {
+		convertYUV410ToRGBRows(rowFunc, getChromaBuffer(yWidth), (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
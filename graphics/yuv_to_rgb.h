@@ -39,12 +39,14 @@
 #define GRAPHICS_YUV_TO_RGB_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/singleton.h"
 #include "graphics/surface.h"
 
 namespace Graphics {
 
 class YUVToRGBLookup;
+struct YUVToRGBKernel;
 
 class YUVToRGBManager : public Common::Singleton<YUVToRGBManager> {
 public:
@@ -105,15 +107,42 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Get the number of conversion kernels usable on this machine.
+	 *
+	 * Kernel 0 is always the portable lookup table implementation. The
+	 * others are SIMD implementations which produce identical output.
+	 */
+	uint getKernelCount() const { return _kernelCount; }
+
+	/** Get the name of a conversion kernel, e.g. "scalar" or "sse2". */
+	const char *getKernelName(uint kernel) const;
+
+	/** Get the kernel used for conversions. Defaults to the fastest one. */
+	uint getKernel() const { return _kernel; }
+
+	/** Set the kernel used for conversions. */
+	void setKernel(uint kernel);
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
 	~YUVToRGBManager();
 
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale);
+	byte *getChromaBuffer(int width);
 
 	YUVToRGBLookup *_lookup;
 	int16 _colorTab[4 * 256]; // 2048 bytes
+
+	enum {
+		kMaxKernels = 4
+	};
+
+	const YUVToRGBKernel *_kernels[kMaxKernels];
+	uint _kernelCount;
+	uint _kernel;
+	Common::Array<byte> _chromaBuffer;
 };
 
 } // End of namespace Graphics
@@ -30,8 +30,6 @@ DECLARE_SINGLETON(GUI::EventRecorder);
 }
 
 #include "common/debug-channels.h"
-#include "backends/timer/sdl/sdl-timer.h"
-#include "backends/mixer/sdl/sdl-mixer.h"
 #include "common/config-manager.h"
 #include "common/md5.h"
 #include "gui/gui-manager.h"
@@ -72,17 +70,21 @@ void writeTime(Common::WriteStream *outFile, uint32 d) {
 EventRecorder::EventRecorder() {
 	_timerManager = NULL;
 	_recordMode = kPassthrough;
+#ifdef SDL_BACKEND
 	_fakeMixerManager = NULL;
+	_realMixerManager = 0;
+#endif
 	_initialized = false;
 	_needRedraw = false;
 	_fastPlayback = false;
+	_benchmark = false;
+	_benchmarkQuitSent = false;
 
 	_fakeTimer = 0;
 	_savedState = false;
 	_needcontinueGame = false;
 	_temporarySlot = 0;
 	_realSaveManager = 0;
-	_realMixerManager = 0;
 	_controlPanel = 0;
 	_lastMillis = 0;
 	_lastScreenshotTime = 0;
@@ -106,8 +108,10 @@ void EventRecorder::deinit() {
 	_needRedraw = false;
 	_initialized = false;
 	_recordMode = kPassthrough;
+#ifdef SDL_BACKEND
 	delete _fakeMixerManager;
 	_fakeMixerManager = NULL;
+#endif
 	_controlPanel->close();
 	delete _controlPanel;
 	debugC(1, kDebugLevelEventRec, "playback:action=stopplayback");
@@ -115,8 +119,11 @@ void EventRecorder::deinit() {
 	_recordMode = kPassthrough;
 	_playbackFile->close();
 	delete _playbackFile;
+	_playbackFile = 0;
 	switchMixer();
 	switchTimerManagers();
+	_fastPlayback = false;
+	_benchmark = false;
 	DebugMan.disableDebugChannel("EventRec");
 }
 
@@ -152,6 +159,16 @@ void EventRecorder::processMillis(uint32 &millis, bool skipRecord) {
 			_fakeTimer = _nextEvent.time;
 			_nextEvent = _playbackFile->getNextEvent();
 			_timerManager->handler();
+		} else if (_benchmark && _nextEvent.type == Common::EVENT_INVALID) {
+			// The recording is exhausted. A benchmark run ends here, so ask
+			// the engine to quit instead of reporting a desynchronization.
+			if (!_benchmarkQuitSent) {
+				debugC(1, kDebugLevelEventRec, "playback:action=stopplayback reason=\"end of recording\"");
+				Common::Event eventQuit;
+				eventQuit.type = Common::EVENT_QUIT;
+				g_system->getEventManager()->pushEvent(eventQuit);
+				_benchmarkQuitSent = true;
+			}
 		} else {
 			if (_nextEvent.type == Common::EVENT_RTL) {
 				error("playback:action=stopplayback");
@@ -261,16 +278,23 @@ Common::String EventRecorder::generateRecordFileName(const Common::String &targe
 }
 
 
-void EventRecorder::init(Common::String recordFileName, RecordMode mode) {
+void EventRecorder::init(Common::String recordFileName, RecordMode mode, bool benchmark) {
+#ifdef SDL_BACKEND
 	_fakeMixerManager = new NullSdlMixerManager();
 	_fakeMixerManager->init();
 	_fakeMixerManager->suspendAudio();
+#endif
 	_fakeTimer = 0;
 	_lastMillis = g_system->getMillis();
 	_playbackFile = new Common::PlaybackFile();
 	_lastScreenshotTime = 0;
 	_recordMode = mode;
 	_needcontinueGame = false;
+	// A benchmark replays as fast as the CPU allows, so delays are skipped
+	// from the start rather than only after toggling fast mode while paused.
+	_benchmark = benchmark && (mode == kRecorderPlayback);
+	_benchmarkQuitSent = false;
+	_fastPlayback = _benchmark;
 	if (ConfMan.hasKey("disable_display")) {
 		DebugMan.enableDebugChannel("EventRec");
 		gDebugLevel = 1;
@@ -350,19 +374,24 @@ bool EventRecorder::checkGameHash(const ADGameDescription *gameDesc) {
 	return true;
 }
 
+#ifdef SDL_BACKEND
 void EventRecorder::registerMixerManager(SdlMixerManager *mixerManager) {
 	_realMixerManager = mixerManager;
 }
+#endif
 
 void EventRecorder::switchMixer() {
+#ifdef SDL_BACKEND
 	if (_recordMode == kPassthrough) {
 		_realMixerManager->resumeAudio();
 	} else {
 		_realMixerManager->suspendAudio();
 		_fakeMixerManager->resumeAudio();
 	}
+#endif
 }
 
+#ifdef SDL_BACKEND
 SdlMixerManager *EventRecorder::getMixerManager() {
 	if (_recordMode == kPassthrough) {
 		return _realMixerManager;
@@ -370,6 +399,7 @@ SdlMixerManager *EventRecorder::getMixerManager() {
 		return _fakeMixerManager;
 	}
 }
+#endif
 
 void EventRecorder::getConfigFromDomain(const Common::ConfigManager::Domain *domain) {
 	for (Common::ConfigManager::Domain::const_iterator entry = domain->begin(); entry!= domain->end(); ++entry) {
@@ -417,21 +447,27 @@ void EventRecorder::registerTimerManager(DefaultTimerManager *timerManager) {
 
 void EventRecorder::switchTimerManagers() {
 	delete _timerManager;
+#ifdef SDL_BACKEND
 	if (_recordMode == kPassthrough) {
 		_timerManager = new SdlTimerManager();
-	} else {
-		_timerManager = new DefaultTimerManager();
+		return;
 	}
+#endif
+	// Backends without a dedicated timer thread drive the timer manager
+	// through processMillis.
+	_timerManager = new DefaultTimerManager();
 }
 
 void EventRecorder::updateSubsystems() {
 	if (_recordMode == kPassthrough) {
 		return;
 	}
+#ifdef SDL_BACKEND
 	RecordMode oldRecordMode = _recordMode;
 	_recordMode = kPassthrough;
 	_fakeMixerManager->update();
 	_recordMode = oldRecordMode;
+#endif
 }
 
 Common::List<Common::Event> EventRecorder::mapEvent(const Common::Event &ev, Common::EventSource *source) {
@@ -445,6 +481,9 @@ Common::List<Common::Event> EventRecorder::mapEvent(const Common::Event &ev, Com
 	evt.mouse.y = evt.mouse.y * (g_system->getOverlayHeight() / g_system->getHeight());
 	switch (_recordMode) {
 	case kRecorderPlayback:
+		if (_benchmarkQuitSent && ev.type == Common::EVENT_QUIT) {
+			return Common::DefaultEventMapper::mapEvent(ev, source);
+		}
 		if (ev.kbdRepeat != true) {
 			return Common::List<Common::Event>();
 		}
@@ -557,6 +596,11 @@ Common::SaveFileManager *EventRecorder::getSaveManager(Common::SaveFileManager *
 }
 
 void EventRecorder::preDrawOverlayGui() {
+	// Benchmark runs are headless; drawing the control panel would only
+	// skew the measured frame times.
+	if (_benchmark) {
+		return;
+	}
     if ((_initialized) || (_needRedraw)) {
 		RecordMode oldMode = _recordMode;
 		_recordMode = kPassthrough;
@@ -571,6 +615,9 @@ void EventRecorder::preDrawOverlayGui() {
 }
 
 void EventRecorder::postDrawOverlayGui() {
+	if (_benchmark) {
+		return;
+	}
     if ((_initialized) || (_needRedraw)) {
 		RecordMode oldMode = _recordMode;
 		_recordMode = kPassthrough;
@@ -611,10 +658,12 @@ void EventRecorder::setFileHeader() {
 	_playbackFile->getHeader().name = _name;
 }
 
+#ifdef SDL_BACKEND
 SDL_Surface *EventRecorder::getSurface(int width, int height) {
 	// Create a RGB565 surface of the requested dimensions.
 	return SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 16, 0xF800, 0x07E0, 0x001F, 0x0000);
 }
+#endif
 
 bool EventRecorder::switchMode() {
 	const Common::String gameId = ConfMan.get("gameid");
@@ -657,6 +706,14 @@ bool EventRecorder::switchMode() {
 	return true;
 }
 
+uint EventRecorder::getScreenshotChecks() const {
+	return _playbackFile ? _playbackFile->getScreenshotChecks() : 0;
+}
+
+uint EventRecorder::getScreenshotMismatches() const {
+	return _playbackFile ? _playbackFile->getScreenshotMismatches() : 0;
+}
+
 bool EventRecorder::checkForContinueGame() {
 	bool result = _needcontinueGame;
 	_needcontinueGame = false;
@@ -37,16 +37,20 @@
 #include "common/array.h"
 #include "common/memstream.h"
 #include "backends/keymapper/keymapper.h"
-#include "backends/mixer/sdl/sdl-mixer.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
-#include "backends/timer/sdl/sdl-timer.h"
+#include "backends/timer/default/default-timer.h"
 #include "common/config-manager.h"
 #include "common/recorderfile.h"
 #include "backends/saves/recorder/recorder-saves.h"
-#include "backends/mixer/nullmixer/nullsdl-mixer.h"
 #include "backends/saves/default/default-saves.h"
 
+#ifdef SDL_BACKEND
+#include "backends/mixer/sdl/sdl-mixer.h"
+#include "backends/timer/sdl/sdl-timer.h"
+#include "backends/mixer/nullmixer/nullsdl-mixer.h"
+#endif
+
 
 #define g_eventRec (GUI::EventRecorder::instance())
 
@@ -78,7 +82,7 @@ public:
 		kRecorderPlaybackPause = 3	/**< kRecordetPlaybackPause, interal state when user pauses the playback */
 	};
 
-	void init(Common::String recordFileName, RecordMode mode);
+	void init(Common::String recordFileName, RecordMode mode, bool benchmark = false);
 	void deinit();
 	bool processDelayMillis();
 	uint32 getRandomSeed(const Common::String &name);
@@ -143,10 +147,11 @@ public:
 		_needRedraw = redraw;
 	}
 
+#ifdef SDL_BACKEND
 	void registerMixerManager(SdlMixerManager *mixerManager);
-	void registerTimerManager(DefaultTimerManager *timerManager);
-
 	SdlMixerManager *getMixerManager();
+#endif
+	void registerTimerManager(DefaultTimerManager *timerManager);
 	DefaultTimerManager *getTimerManager();
 
 	void deleteRecord(const Common::String& fileName);
@@ -165,7 +170,9 @@ public:
 	Common::String generateRecordFileName(const Common::String &target);
 
 	Common::SaveFileManager *getSaveManager(Common::SaveFileManager *realSaveManager);
+#ifdef SDL_BACKEND
 	SDL_Surface *getSurface(int width, int height);
+#endif
 	void RegisterEventSource();
 
 	/** Retrieve game screenshot and compute its checksum for comparison */
@@ -175,6 +182,19 @@ public:
 	bool switchMode();
 	void switchFastMode();
 
+	/**
+	 * Whether the current playback is a benchmark run. Benchmark runs never
+	 * wait on the real clock and quit the engine once the recording ends.
+	 */
+	bool isBenchmarking() const {
+		return _initialized && _benchmark;
+	}
+
+	/** Number of recorded screenshots compared against the screen so far */
+	uint getScreenshotChecks() const;
+	/** Number of compared screenshots whose MD5 did not match */
+	uint getScreenshotMismatches() const;
+
 private:
 	virtual Common::List<Common::Event> mapEvent(const Common::Event &ev, Common::EventSource *source);
 	bool notifyPoll();
@@ -189,10 +209,12 @@ private:
 	Common::String _name;
 
 	Common::SaveFileManager *_realSaveManager;
+#ifdef SDL_BACKEND
 	SdlMixerManager *_realMixerManager;
+	NullSdlMixerManager *_fakeMixerManager;
+#endif
 	DefaultTimerManager *_timerManager;
 	RecorderSaveFileManager _fakeSaveManager;
-	NullSdlMixerManager *_fakeMixerManager;
 	GUI::OnScreenDialog *_controlPanel;
 	Common::RecorderEvent _nextEvent;
 
@@ -229,6 +251,8 @@ private:
 	Common::String _recordFileName;
 	bool _fastPlayback;
 	bool _needRedraw;
+	bool _benchmark;
+	bool _benchmarkQuitSent;
 };
 
 } // End of namespace GUI
@@ -91,6 +91,9 @@ struct WidgetDrawData {
 
 	bool _buffer;
 
+	/** Whether the result of drawing the steps can be cached, see calcRasterCacheable() */
+	bool _rasterCacheable;
+
 
 	/**
 	 * Calculates the background threshold offset of a given DrawData item.
@@ -100,6 +103,14 @@ struct WidgetDrawData {
 	 * value will be added when restoring the background of the widget.
 	 */
 	void calcBackgroundOffset();
+
+	/**
+	 * Determines whether drawing the steps only depends on the steps
+	 * themselves and the background. That is not the case when a step
+	 * relies on colors left in the renderer by a previous DrawData, or
+	 * when it draws outside of the widget area.
+	 */
+	void calcRasterCacheable();
 };
 
 class ThemeItem {
@@ -280,11 +291,8 @@ void ThemeItemDrawData::drawSelf(bool draw, bool restore) {
 	if (restore)
 		_engine->restoreBackground(extendedRect);
 
-	if (draw) {
-		Common::List<Graphics::DrawStep>::const_iterator step;
-		for (step = _data->_steps.begin(); step != _data->_steps.end(); ++step)
-			_engine->renderer()->drawStep(_area, *step, _dynamicData);
-	}
+	if (draw)
+		_engine->drawSteps(_data, _area, extendedRect, 0, _dynamicData);
 
 	_engine->addDirtyRect(extendedRect);
 }
@@ -301,12 +309,8 @@ void ThemeItemDrawDataClip::drawSelf(bool draw, bool restore) {
 	if (restore)
 		_engine->restoreBackground(extendedRect);
 
-	if (draw) {
-		Common::List<Graphics::DrawStep>::const_iterator step;
-		for (step = _data->_steps.begin(); step != _data->_steps.end(); ++step) {
-			_engine->renderer()->drawStepClip(_area, _clip, *step, _dynamicData);
-		}
-	}
+	if (draw)
+		_engine->drawSteps(_data, _area, extendedRect, &_clip, _dynamicData);
 
 	extendedRect.clip(_clip);
 
@@ -375,7 +379,7 @@ void ThemeItemBitmapClip::drawSelf(bool draw, bool restore) {
 ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 	_system(0), _vectorRenderer(0),
 	_buffering(false), _bytesPerPixel(0),  _graphicsMode(kGfxDisabled),
-	_font(0), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
+	_font(0), _rasterCacheSize(0), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
 	_cursor(0) {
 
 	_system = g_system;
@@ -427,6 +431,7 @@ ThemeEngine::~ThemeEngine() {
 	_backBuffer.free();
 
 	unloadTheme();
+	clearRasterCache();
 
 	// Release all graphics surfaces
 	for (ImagesMap::iterator i = _bitmaps.begin(); i != _bitmaps.end(); ++i) {
@@ -653,6 +658,9 @@ void ThemeEngine::setGraphicsMode(GraphicsMode mode) {
 	// list. Clearing it avoids invalid overlay writes when the backend
 	// resizes the overlay.
 	_dirtyScreen.clear();
+
+	// The cached rasters have the wrong size or pixel format now
+	clearRasterCache();
 }
 
 void WidgetDrawData::calcBackgroundOffset() {
@@ -670,6 +678,139 @@ void WidgetDrawData::calcBackgroundOffset() {
 	_shadowOffset = maxShadow;
 }
 
+void WidgetDrawData::calcRasterCacheable() {
+	bool fgSet = false, bgSet = false, gradientSet = false, bevelSet = false;
+
+	_rasterCacheable = true;
+	for (Common::List<Graphics::DrawStep>::const_iterator step = _steps.begin();
+	        step != _steps.end(); ++step) {
+		fgSet |= step->fgColor.set;
+		bgSet |= step->bgColor.set;
+		gradientSet |= step->gradColor1.set && step->gradColor2.set;
+		bevelSet |= step->bevelColor.set;
+
+		// Fills the whole surface, not just the widget area
+		if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_FILLSURFACE)
+			_rasterCacheable = false;
+
+		// Bitmaps and void steps do not use any colors
+		if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_BITMAP ||
+		        step->drawingCall == &Graphics::VectorRenderer::drawCallback_ALPHABITMAP ||
+		        step->drawingCall == &Graphics::VectorRenderer::drawCallback_VOID)
+			continue;
+
+		if (!fgSet || !bgSet)
+			_rasterCacheable = false;
+		if (step->fillMode == Graphics::VectorRenderer::kFillGradient && !gradientSet)
+			_rasterCacheable = false;
+		if ((step->bevel || step->drawingCall == &Graphics::VectorRenderer::drawCallback_BEVELSQ) && !bevelSet)
+			_rasterCacheable = false;
+	}
+}
+
+uint ThemeEngine::RasterKey_Hash::operator()(const RasterKey &key) const {
+	uint hash = key.backgroundHash;
+	hash = hash * 31 + (uint)(size_t)key.data;
+	hash = hash * 31 + ((uint)key.areaWidth << 16 | key.areaHeight);
+	hash = hash * 31 + ((uint)(uint16)key.raster.left << 16 | (uint16)key.raster.top);
+	hash = hash * 31 + ((uint)key.raster.width() << 16 | key.raster.height());
+	hash = hash * 31 + key.dynamic;
+	return hash;
+}
+
+bool ThemeEngine::RasterKey_EqualTo::operator()(const RasterKey &a, const RasterKey &b) const {
+	return a.data == b.data && a.areaWidth == b.areaWidth && a.areaHeight == b.areaHeight &&
+	       a.raster == b.raster && a.dynamic == b.dynamic && a.shadows == b.shadows &&
+	       a.backgroundHash == b.backgroundHash;
+}
+
+static uint32 hashSurfaceArea(const Graphics::Surface &surface, const Common::Rect &r) {
+	// FNV-1a over the pixel data, one row at a time
+	uint32 hash = 2166136261U;
+	const uint rowBytes = r.width() * surface.format.bytesPerPixel;
+	for (int y = r.top; y < r.bottom; ++y) {
+		const byte *row = (const byte *)surface.getBasePtr(r.left, y);
+		uint x = 0;
+		for (; x + 4 <= rowBytes; x += 4)
+			hash = (hash ^ READ_UINT32(row + x)) * 16777619U;
+		for (; x < rowBytes; ++x)
+			hash = (hash ^ row[x]) * 16777619U;
+	}
+	return hash;
+}
+
+void ThemeEngine::drawSteps(const WidgetDrawData *data, const Common::Rect &area, const Common::Rect &extendedRect, const Common::Rect *clip, uint32 dynamic) {
+	Graphics::TransparentSurface *surface = _vectorRenderer->getSurface();
+
+	// Everything the steps can touch, as far as it is visible
+	Common::Rect raster = extendedRect;
+	raster.clip(surface->w, surface->h);
+	if (clip)
+		raster.clip(*clip);
+
+	const uint32 rasterBytes = raster.width() * raster.height() * surface->format.bytesPerPixel;
+	if (!data->_rasterCacheable || raster.isEmpty() || rasterBytes > kRasterCacheBudget / 4) {
+		Common::List<Graphics::DrawStep>::const_iterator step;
+		for (step = data->_steps.begin(); step != data->_steps.end(); ++step) {
+			if (clip)
+				_vectorRenderer->drawStepClip(area, *clip, *step, dynamic);
+			else
+				_vectorRenderer->drawStep(area, *step, dynamic);
+		}
+		return;
+	}
+
+	// The steps blend with what is below them, so the background is part
+	// of the key.
+	RasterKey key;
+	key.data = data;
+	key.areaWidth = area.width();
+	key.areaHeight = area.height();
+	key.raster = raster;
+	key.raster.translate(-area.left, -area.top);
+	key.dynamic = dynamic;
+	key.shadows = !_vectorRenderer->shadowsDisabled();
+	key.backgroundHash = hashSurfaceArea(*surface, raster);
+
+	RasterCache::const_iterator cached = _rasterCache.find(key);
+	if (cached != _rasterCache.end()) {
+		surface->copyRectToSurface(*cached->_value, raster.left, raster.top, Common::Rect(raster.width(), raster.height()));
+
+		// Steps which do not set all colors themselves draw with the ones
+		// left behind by the previous steps.
+		Common::List<Graphics::DrawStep>::const_iterator step;
+		for (step = data->_steps.begin(); step != data->_steps.end(); ++step)
+			_vectorRenderer->setStepColors(*step);
+		return;
+	}
+
+	Common::List<Graphics::DrawStep>::const_iterator step;
+	for (step = data->_steps.begin(); step != data->_steps.end(); ++step) {
+		if (clip)
+			_vectorRenderer->drawStepClip(area, *clip, *step, dynamic);
+		else
+			_vectorRenderer->drawStep(area, *step, dynamic);
+	}
+
+	if (_rasterCacheSize + rasterBytes > kRasterCacheBudget)
+		clearRasterCache();
+
+	Graphics::Surface *result = new Graphics::Surface();
+	result->create(raster.width(), raster.height(), surface->format);
+	result->copyRectToSurface(*surface, 0, 0, raster);
+	_rasterCache[key] = result;
+	_rasterCacheSize += rasterBytes;
+}
+
+void ThemeEngine::clearRasterCache() {
+	for (RasterCache::iterator i = _rasterCache.begin(); i != _rasterCache.end(); ++i) {
+		i->_value->free();
+		delete i->_value;
+	}
+	_rasterCache.clear();
+	_rasterCacheSize = 0;
+}
+
 void ThemeEngine::restoreBackground(Common::Rect r) {
 	r.clip(_screen.w, _screen.h);
 	_vectorRenderer->blitSurface(&_backBuffer, r);
@@ -873,6 +1014,7 @@ bool ThemeEngine::addDrawData(const Common::String &data, bool cached) {
 	_widgets[id] = new WidgetDrawData;
 	_widgets[id]->_buffer = kDrawDataDefaults[id].buffer;
 	_widgets[id]->_textDataId = kTextDataNone;
+	_widgets[id]->_rasterCacheable = false;
 
 	return true;
 }
@@ -903,6 +1045,7 @@ void ThemeEngine::loadTheme(const Common::String &themeId) {
 			warning("Missing data asset: '%s'", kDrawDataDefaults[i].name);
 		} else {
 			_widgets[i]->calcBackgroundOffset();
+			_widgets[i]->calcRasterCacheable();
 		}
 	}
 }
@@ -911,6 +1054,8 @@ void ThemeEngine::unloadTheme() {
 	if (!_themeOk)
 		return;
 
+	clearRasterCache();
+
 	for (int i = 0; i < kDrawDataMAX; ++i) {
 		delete _widgets[i];
 		_widgets[i] = 0;
@@ -1921,6 +2066,31 @@ void ThemeEngine::renderDirtyScreen() {
 	if (_dirtyScreen.empty())
 		return;
 
+	// Every copy to the overlay has a fixed cost, so merge rectangles as
+	// long as that does not copy many pixels which are not dirty. Widgets
+	// usually come as overlapping background and text rectangles.
+	bool merged;
+	do {
+		merged = false;
+		for (Common::List<Common::Rect>::iterator a = _dirtyScreen.begin(); a != _dirtyScreen.end(); ++a) {
+			Common::List<Common::Rect>::iterator b = a;
+			for (++b; b != _dirtyScreen.end();) {
+				Common::Rect unionRect = *a;
+				unionRect.extend(*b);
+				Common::Rect overlap = a->findIntersectingRect(*b);
+
+				const int dirtyArea = a->width() * a->height() + b->width() * b->height() - overlap.width() * overlap.height();
+				if (unionRect.width() * unionRect.height() - dirtyArea <= kDirtyRectangleMergeSlack) {
+					*a = unionRect;
+					b = _dirtyScreen.erase(b);
+					merged = true;
+				} else {
+					++b;
+				}
+			}
+		}
+	} while (merged);
+
 	Common::List<Common::Rect>::iterator i;
 	for (i = _dirtyScreen.begin(); i != _dirtyScreen.end(); ++i) {
 		_vectorRenderer->copyFrame(_system, *i);
@@ -269,6 +269,9 @@ public:
 	/** Constant value to expand dirty rectangles, to make sure they are fully copied */
 	static const int kDirtyRectangleThreshold = 1;
 
+	/** Number of clean pixels which may be copied to the overlay to save a copy call */
+	static const int kDirtyRectangleMergeSlack = 1024;
+
 	struct Renderer {
 		const char *name;
 		const char *shortname;
@@ -581,6 +584,16 @@ public:
 	 */
 	void restoreBackground(Common::Rect r);
 
+	/**
+	 * Draws the steps of a DrawData item into the active surface. When the
+	 * same item was drawn with the same size onto the same background
+	 * before, its cached result is copied instead.
+	 *
+	 * @param extendedRect Area the steps may touch, see ThemeItemDrawData.
+	 * @param clip         Clipping rectangle, or 0 to draw unclipped.
+	 */
+	void drawSteps(const WidgetDrawData *data, const Common::Rect &area, const Common::Rect &extendedRect, const Common::Rect *clip, uint32 dynamic);
+
 	const Common::String &getThemeName() const { return _themeName; }
 	const Common::String &getThemeId() const { return _themeId; }
 	int getGraphicsMode() const { return _graphicsMode; }
@@ -630,6 +643,9 @@ protected:
 	 */
 	void renderDirtyScreen();
 
+	/** Releases all cached widget rasters. */
+	void clearRasterCache();
+
 	/**
 	 * Generates a DrawQueue item and enqueues it so it's drawn to the screen
 	 * when the drawing queue is processed.
@@ -731,6 +747,37 @@ protected:
 	/** List of all the dirty screens that must be blitted to the overlay. */
 	Common::List<Common::Rect> _dirtyScreen;
 
+	/** Identifies the result of drawing a DrawData item, see drawSteps() */
+	struct RasterKey {
+		const WidgetDrawData *data;
+		int16 areaWidth, areaHeight;
+		/** Area covered by the raster, relative to the widget */
+		Common::Rect raster;
+		uint32 dynamic;
+		bool shadows;
+		/** Hash of the background the steps were drawn onto */
+		uint32 backgroundHash;
+	};
+
+	struct RasterKey_Hash {
+		uint operator()(const RasterKey &key) const;
+	};
+
+	struct RasterKey_EqualTo {
+		bool operator()(const RasterKey &a, const RasterKey &b) const;
+	};
+
+	typedef Common::HashMap<RasterKey, Graphics::Surface *, RasterKey_Hash, RasterKey_EqualTo> RasterCache;
+
+	enum {
+		/** Memory limit for cached widget rasters, in bytes */
+		kRasterCacheBudget = 4 * 1024 * 1024
+	};
+
+	/** Cached results of drawing DrawData items */
+	RasterCache _rasterCache;
+	uint32 _rasterCacheSize;
+
 	/** Queue with all the drawing that must be done to the Back Buffer */
 	Common::List<ThemeItem *> _bufferQueue;
 
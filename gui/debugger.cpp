@@ -27,6 +27,11 @@
 #include "common/debug-channels.h"
 #include "common/system.h"
 
+#ifdef ENABLE_ZONE_PROFILER
+#include "common/file.h"
+#include "common/profiler.h"
+#endif
+
 #ifndef DISABLE_MD5
 #include "common/md5.h"
 #include "common/archive.h"
@@ -78,6 +83,9 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+#ifdef ENABLE_ZONE_PROFILER
+	registerCmd("profile",			WRAP_METHOD(Debugger, cmdProfile));
+#endif
 }
 
 Debugger::~Debugger() {
@@ -781,6 +789,46 @@ bool Debugger::cmdDebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+#ifdef ENABLE_ZONE_PROFILER
+bool Debugger::cmdProfile(int argc, const char **argv) {
+	Common::Profiler &profiler = Common::Profiler::instance();
+
+	if (argc == 1) {
+		Common::Array<Common::Profiler::ZoneStats> stats;
+		profiler.getStats(stats);
+		if (stats.empty()) {
+			debugPrintf("No profiler zones recorded%s\n", profiler.isEnabled() ? "" : " (profiler is off)");
+			return true;
+		}
+
+		debugPrintf("%-40s %7s %8s %8s %8s %8s\n", "zone (times in us)", "count", "p50", "p90", "p99", "max");
+		for (uint i = 0; i < stats.size(); i++) {
+			const Common::Profiler::ZoneStats &zone = stats[i];
+			debugPrintf("%-40s %7u %8u %8u %8u %8u\n", zone.name, zone.count, zone.p50, zone.p90, zone.p99, zone.max);
+		}
+	} else if (!scumm_stricmp(argv[1], "on") || !scumm_stricmp(argv[1], "off")) {
+		profiler.setEnabled(!scumm_stricmp(argv[1], "on"));
+		debugPrintf("Profiler is %s\n", argv[1]);
+	} else if (!scumm_stricmp(argv[1], "reset")) {
+		profiler.reset();
+		debugPrintf("Profiler events cleared\n");
+	} else if (!scumm_stricmp(argv[1], "export") && argc == 3) {
+		Common::DumpFile out;
+		if (!out.open(argv[2])) {
+			debugPrintf("Failed to open '%s' for writing\n", argv[2]);
+			return true;
+		}
+		profiler.exportChromeTrace(out);
+		out.finalize();
+		debugPrintf("Wrote Chrome trace to '%s'\n", argv[2]);
+	} else {
+		debugPrintf("Usage: %s [on | off | reset | export <file>]\n", argv[0]);
+		debugPrintf("Without arguments, prints duration percentiles of the recent profiler zones\n");
+	}
+	return true;
+}
+#endif
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
@@ -232,6 +232,9 @@ protected:
 	bool cmdDebugFlagsList(int argc, const char **argv);
 	bool cmdDebugFlagEnable(int argc, const char **argv);
 	bool cmdDebugFlagDisable(int argc, const char **argv);
+#ifdef ENABLE_ZONE_PROFILER
+	bool cmdProfile(int argc, const char **argv);
+#endif
 
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 private:
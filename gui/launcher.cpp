@@ -244,11 +244,28 @@ void LauncherDialog::close() {
 	Dialog::close();
 }
 
+namespace {
+
+struct LauncherEntry {
+	Common::String description;
+	Common::String domain;
+
+	LauncherEntry(const Common::String &d, const Common::String &t) : description(d), domain(t) {}
+};
+
+bool launcherEntryLess(const LauncherEntry &x, const LauncherEntry &y) {
+	const int cmp = scumm_stricmp(x.description.c_str(), y.description.c_str());
+	if (cmp)
+		return cmp < 0;
+	return x.domain < y.domain;
+}
+
+} // End of anonymous namespace
+
 void LauncherDialog::updateListing() {
-	StringArray l;
+	Common::Array<LauncherEntry> entries;
 
 	// Retrieve a list of all games defined in the config file
-	_domains.clear();
 	const ConfigManager::DomainMap &domains = ConfMan.getGameDomains();
 	ConfigManager::DomainMap::const_iterator iter;
 	for (iter = domains.begin(); iter != domains.end(); ++iter) {
@@ -266,24 +283,36 @@ void LauncherDialog::updateListing() {
 		if (gameid.empty())
 			gameid = iter->_key;
 		if (description.empty()) {
-			GameDescriptor g = EngineMan.findGame(gameid);
-			if (g.contains("description"))
-				description = g.description();
+			Common::StringMap::const_iterator known = _engineDescriptions.find(gameid);
+			if (known != _engineDescriptions.end()) {
+				description = known->_value;
+			} else {
+				GameDescriptor g = EngineMan.findGame(gameid);
+				if (g.contains("description"))
+					description = g.description();
+				_engineDescriptions[gameid] = description;
+			}
 		}
 
 		if (description.empty()) {
 			description = Common::String::format("Unknown (target %s, gameid %s)", iter->_key.c_str(), gameid.c_str());
 		}
 
-		if (!gameid.empty() && !description.empty()) {
-			// Insert the game into the launcher list
-			int pos = 0, size = l.size();
+		if (!gameid.empty() && !description.empty())
+			entries.push_back(LauncherEntry(description, iter->_key));
+	}
 
-			while (pos < size && (scumm_stricmp(description.c_str(), l[pos].c_str()) > 0))
-				pos++;
-			l.insert_at(pos, description);
-			_domains.insert_at(pos, iter->_key);
-		}
+	// Sort the games by description, in one go rather than by inserting
+	// every game at its place, which gets slow with big collections
+	Common::sort(entries.begin(), entries.end(), launcherEntryLess);
+
+	StringArray l;
+	l.reserve(entries.size());
+	_domains.clear();
+	_domains.reserve(entries.size());
+	for (Common::Array<LauncherEntry>::const_iterator i = entries.begin(); i != entries.end(); ++i) {
+		l.push_back(i->description);
+		_domains.push_back(i->domain);
 	}
 
 	const int oldSel = _list->getSelected();
@@ -25,6 +25,8 @@
 
 #include "gui/dialog.h"
 #include "engines/game.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
 
 namespace GUI {
 
@@ -74,6 +76,13 @@ protected:
 
 	String _search;
 
+	/**
+	 * Descriptions of the games known to the engines, by game id. Filled in
+	 * on demand by updateListing() for targets without a description, as
+	 * asking the engines is slow.
+	 */
+	Common::StringMap _engineDescriptions;
+
 	virtual void reflowLayout();
 
 	/**
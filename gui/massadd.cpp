@@ -20,10 +20,12 @@
  *
  */
 
+#include "base/version.h"
 #include "engines/metaengine.h"
 #include "common/algorithm.h"
 #include "common/config-manager.h"
 #include "common/debug.h"
+#include "common/stream.h"
 #include "common/system.h"
 #include "common/taskbar.h"
 #include "common/translation.h"
@@ -51,6 +53,12 @@ enum {
 	kMaxScanTime = 50
 };
 
+enum {
+	kScanCacheVersion = 2
+};
+
+static const char *const kScanCacheName = "massadd-scan.idx";
+
 enum {
 	kOkCmd = 'OK  ',
 	kCancelCmd = 'CNCL'
@@ -60,6 +68,8 @@ enum {
 
 MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	: Dialog("MassAdd"),
+	_scanCacheLoaded(false),
+	_scanCacheDirty(false),
 	_dirsScanned(0),
 	_oldGamesCount(0),
 	_dirTotal(0),
@@ -71,6 +81,9 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 
 	// The dir we start our scan at
 	_scanStack.push(startDir);
+	_scanRoot = startDir.getPath();
+	while (_scanRoot != "/" && _scanRoot.lastChar() == '/')
+		_scanRoot.deleteLastChar();
 
 	// Removed for now... Why would you put a title on mass add dialog called "Mass Add Dialog"?
 	// new StaticTextWidget(this, "massadddialog_caption", "Mass Add Dialog");
@@ -119,6 +132,16 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	}
 }
 
+void MassAddDialog::open() {
+	Dialog::open();
+	loadScanCache();
+}
+
+void MassAddDialog::close() {
+	saveScanCache();
+	Dialog::close();
+}
+
 struct GameTargetLess {
 	bool operator()(const GameDescriptor &x, const GameDescriptor &y) const {
 		return x.preferredtarget().compareToIgnoreCase(y.preferredtarget()) < 0;
@@ -178,81 +201,21 @@ void MassAddDialog::handleTickle() {
 	uint32 t = g_system->getMillis();
 
 	// Perform a breadth-first scan of the filesystem.
-	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
-		Common::FSNode dir = _scanStack.pop();
-
-		Common::FSList files;
-		if (!dir.getChildren(files, Common::FSNode::kListAll)) {
-			continue;
-		}
-
-		// Run the detector on the dir
-		GameList candidates(EngineMan.detectGames(files));
-
-		// Just add all detected games / game variants. If we get more than one,
-		// that either means the directory contains multiple games, or the detector
-		// could not fully determine which game variant it was seeing. In either
-		// case, let the user choose which entries he wants to keep.
-		//
-		// However, we only add games which are not already in the config file.
-		for (GameList::const_iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
-			GameDescriptor result = *cand;
-			Common::String path = dir.getPath();
-
-			// Remove trailing slashes
-			while (path != "/" && path.lastChar() == '/')
-				path.deleteLastChar();
-
-			// Check for existing config entries for this path/gameid/lang/platform combination
-			if (_pathToTargets.contains(path)) {
-				bool duplicate = false;
-				const StringArray &targets = _pathToTargets[path];
-				for (StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
-					// If the gameid, platform and language match -> skip it
-					Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
-					assert(dom);
-
-					if ((*dom)["gameid"] == result["gameid"] &&
-					    (*dom)["platform"] == result["platform"] &&
-					    (*dom)["language"] == result["language"]) {
-						duplicate = true;
-						break;
-					}
-				}
-				if (duplicate) {
-					_oldGamesCount++;
-					break;	// Skip duplicates
-				}
-			}
-			result["path"] = path;
-			_games.push_back(result);
-
-			_list->append(result.description());
-		}
-
-
-		// Recurse into all subdirs
-		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-			if (file->isDirectory()) {
-				_scanStack.push(*file);
-
-				_dirTotal++;
-			}
-		}
-
-		_dirsScanned++;
+	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime)
+		scanDirectory(_scanStack.pop());
 
 #if defined(USE_TASKBAR)
-		g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
-		g_system->getTaskbarManager()->setCount(_games.size());
+	g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
+	g_system->getTaskbarManager()->setCount(_games.size());
 #endif
-	}
-
 
 	// Update the dialog
 	Common::String buf;
 
 	if (_scanStack.empty()) {
+		pruneScanCache();
+		saveScanCache();
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
@@ -277,6 +240,219 @@ void MassAddDialog::handleTickle() {
 	drawDialog();
 }
 
+void MassAddDialog::scanDirectory(const Common::FSNode &dir) {
+	Common::FSList files;
+	if (!dir.getChildren(files, Common::FSNode::kListAll))
+		return;
+
+	Common::String path = dir.getPath();
+
+	// Remove trailing slashes
+	while (path != "/" && path.lastChar() == '/')
+		path.deleteLastChar();
+
+	_scannedDirs[path] = true;
+
+	DirSignature signature;
+	signature.entryCount = files.size();
+	signature.nameHash = 0;
+	bool isLeaf = true;
+	for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
+		signature.nameHash += Common::hashit(file->getName()) + (file->isDirectory() ? 1 : 0);
+		if (file->isDirectory())
+			isLeaf = false;
+	}
+
+	// Directories without games make up most of a scan. Skip running the
+	// detectors on them again, unless their contents changed. Only leaf
+	// directories are skipped, since detectors may look into subdirectories
+	// and the signature does not cover those.
+	GameList candidates;
+	DirSignatureMap::const_iterator cached = _scanCache.find(path);
+	if (!isLeaf || cached == _scanCache.end() || cached->_value.entryCount != signature.entryCount || cached->_value.nameHash != signature.nameHash) {
+		candidates = EngineMan.detectGames(files);
+
+		if (candidates.empty() && isLeaf) {
+			_scanCache[path] = signature;
+			_scanCacheDirty = true;
+		} else if (cached != _scanCache.end()) {
+			_scanCache.erase(path);
+			_scanCacheDirty = true;
+		}
+	}
+
+	// Just add all detected games / game variants. If we get more than one,
+	// that either means the directory contains multiple games, or the detector
+	// could not fully determine which game variant it was seeing. In either
+	// case, let the user choose which entries he wants to keep.
+	//
+	// However, we only add games which are not already in the config file.
+	for (GameList::const_iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
+		GameDescriptor result = *cand;
+
+		// Check for existing config entries for this path/gameid/lang/platform combination
+		if (_pathToTargets.contains(path)) {
+			bool duplicate = false;
+			const StringArray &targets = _pathToTargets[path];
+			for (StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
+				// If the gameid, platform and language match -> skip it
+				Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
+				assert(dom);
+
+				if ((*dom)["gameid"] == result["gameid"] &&
+				    (*dom)["platform"] == result["platform"] &&
+				    (*dom)["language"] == result["language"]) {
+					duplicate = true;
+					break;
+				}
+			}
+			if (duplicate) {
+				_oldGamesCount++;
+				break;	// Skip duplicates
+			}
+		}
+		result["path"] = path;
+		_games.push_back(result);
+
+		_list->append(result.description());
+	}
+
+	// Recurse into all subdirs
+	for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
+		if (file->isDirectory()) {
+			_scanStack.push(*file);
+
+			_dirTotal++;
+		}
+	}
+
+	_dirsScanned++;
+}
+
+static Common::String readScanCacheString(Common::ReadStream &in) {
+	Common::String str;
+	for (uint16 len = in.readUint16BE(); len && !in.eos(); --len)
+		str += (char)in.readByte();
+	return str;
+}
+
+static void writeScanCacheString(Common::WriteStream &out, const Common::String &str) {
+	out.writeUint16BE(str.size());
+	out.writeString(str);
+}
+
+static bool getScanCacheNode(Common::FSNode &node) {
+#if defined(UNCACHED_PLUGINS) && defined(DYNAMIC_MODULES)
+	// Only one engine plugin is loaded at a time, so the plugin set the
+	// cache depends on is not known
+	return false;
+#endif
+
+	const Common::String cachePath = g_system->getCachePath();
+	if (cachePath.empty())
+		return false;
+
+	node = Common::FSNode(cachePath).getChild(kScanCacheName);
+	return true;
+}
+
+static Common::String getPluginSetKey() {
+	Common::StringArray names;
+	const PluginList &plugins = EngineMan.getPlugins();
+	for (PluginList::const_iterator plugin = plugins.begin(); plugin != plugins.end(); ++plugin)
+		names.push_back((*plugin)->getName());
+	Common::sort(names.begin(), names.end());
+
+	Common::String key;
+	for (Common::StringArray::const_iterator name = names.begin(); name != names.end(); ++name) {
+		key += *name;
+		key += ';';
+	}
+	return key;
+}
+
+void MassAddDialog::loadScanCache() {
+	if (_scanCacheLoaded)
+		return;
+	_scanCacheLoaded = true;
+
+	Common::FSNode node;
+	if (!getScanCacheNode(node) || !node.exists())
+		return;
+
+	Common::SeekableReadStream *in = node.createReadStream();
+	if (!in)
+		return;
+
+	// Newer versions and other engines may detect games the old ones did not
+	if (in->readUint32BE() == kScanCacheVersion && readScanCacheString(*in) == gScummVMVersion &&
+	    readScanCacheString(*in) == getPluginSetKey()) {
+		uint32 count = in->readUint32BE();
+		while (count-- && !in->eos() && !in->err()) {
+			const Common::String path = readScanCacheString(*in);
+			DirSignature &signature = _scanCache[path];
+			signature.entryCount = in->readUint32BE();
+			signature.nameHash = in->readUint32BE();
+		}
+
+		if (in->eos() || in->err()) {
+			warning("MassAddDialog: Discarding corrupt scan cache");
+			_scanCache.clear();
+		}
+	}
+
+	delete in;
+}
+
+void MassAddDialog::pruneScanCache() {
+	// Directories below the scanned one which were not visited are gone,
+	// the others are only checked for existence
+	StringArray removed;
+	for (DirSignatureMap::const_iterator i = _scanCache.begin(); i != _scanCache.end(); ++i) {
+		if (_scannedDirs.contains(i->_key))
+			continue;
+
+		if (i->_key.hasPrefix(_scanRoot) || !Common::FSNode(i->_key).exists())
+			removed.push_back(i->_key);
+	}
+
+	for (StringArray::const_iterator path = removed.begin(); path != removed.end(); ++path)
+		_scanCache.erase(*path);
+
+	if (!removed.empty())
+		_scanCacheDirty = true;
+}
+
+void MassAddDialog::saveScanCache() {
+	if (!_scanCacheDirty)
+		return;
+
+	Common::FSNode node;
+	if (!getScanCacheNode(node))
+		return;
+
+	Common::WriteStream *out = node.createWriteStream();
+	if (!out)
+		return;
+
+	out->writeUint32BE(kScanCacheVersion);
+	writeScanCacheString(*out, gScummVMVersion);
+	writeScanCacheString(*out, getPluginSetKey());
+	out->writeUint32BE(_scanCache.size());
+	for (DirSignatureMap::const_iterator i = _scanCache.begin(); i != _scanCache.end(); ++i) {
+		writeScanCacheString(*out, i->_key);
+		out->writeUint32BE(i->_value.entryCount);
+		out->writeUint32BE(i->_value.nameHash);
+	}
+
+	out->finalize();
+	if (out->err())
+		warning("MassAddDialog: Could not write scan cache");
+	delete out;
+
+	_scanCacheDirty = false;
+}
+
 
 } // End of namespace GUI
 
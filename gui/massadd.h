@@ -26,6 +26,7 @@
 #include "gui/dialog.h"
 #include "common/fs.h"
 #include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "common/stack.h"
 #include "common/str.h"
 
@@ -38,7 +39,8 @@ class MassAddDialog : public Dialog {
 public:
 	MassAddDialog(const Common::FSNode &startDir);
 
-	//void open();
+	void open();
+	void close();
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data);
 	void handleTickle();
 
@@ -49,7 +51,36 @@ public:
 	}
 
 private:
+	/**
+	 * Contents of a directory, as far as the FS layer can tell. There are
+	 * no modification times, so the names of the entries are hashed.
+	 */
+	struct DirSignature {
+		uint32 entryCount;
+		uint32 nameHash;
+	};
+
+	void scanDirectory(const Common::FSNode &dir);
+
+	void loadScanCache();
+	void pruneScanCache();
+	void saveScanCache();
+
 	Common::Stack<Common::FSNode>  _scanStack;
+
+	/**
+	 * Signatures of the leaf directories in which previous scans did not
+	 * find any games.
+	 */
+	typedef Common::HashMap<Common::String, DirSignature> DirSignatureMap;
+	DirSignatureMap _scanCache;
+	bool _scanCacheLoaded;
+	bool _scanCacheDirty;
+
+	/** The directory the scan started at, and all directories scanned so far. */
+	Common::String _scanRoot;
+	Common::HashMap<Common::String, bool> _scannedDirs;
+
 	GameList _games;
 
 	/**
@@ -20,6 +20,7 @@ MODULE_OBJS := \
 	saveload.o \
 	saveload-dialog.o \
 	themebrowser.o \
+	thumbnail-cache.o \
 	ThemeEngine.o \
 	ThemeEval.o \
 	ThemeLayout.o \
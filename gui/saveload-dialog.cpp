@@ -33,6 +33,7 @@
 
 #include "gui/message.h"
 #include "gui/gui-manager.h"
+#include "gui/thumbnail-cache.h"
 #include "gui/ThemeEval.h"
 #include "gui/widgets/edittext.h"
 
@@ -176,6 +177,7 @@ void SaveLoadChooserDialog::close() {
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 	CloudMan.setSyncTarget(nullptr); //not that dialog, at least
 #endif
+	g_system->getSavefileManager()->flushMetaInfoCache();
 	Dialog::close();
 }
 
@@ -319,6 +321,45 @@ void SaveLoadChooserDialog::listSaves() {
 #endif
 }
 
+Common::String SaveLoadChooserDialog::getSaveFileName(int slot) const {
+	if (!_metaEngine->hasFeature(MetaEngine::kSimpleSavesNames) || slot < 0 || slot > 999)
+		return Common::String();
+	return Common::String::format("%s.%03d", _target.c_str(), slot);
+}
+
+SaveStateDescriptor SaveLoadChooserDialog::getSaveMetaInfos(int slot, bool withThumbnail) {
+	const Common::String fileName = getSaveFileName(slot);
+	if (fileName.empty())
+		return _metaEngine->querySaveMetaInfos(_target.c_str(), slot);
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	Common::SaveFileMetaInfo info;
+	if (saveFileMan->getCachedMetaInfo(_target, fileName, info)) {
+		SaveStateDescriptor desc(info.slot, info.description);
+		desc.setDeletableFlag(info.deletable);
+		desc.setWriteProtectedFlag(info.writeProtected);
+		desc.setSaveDate(info.saveDate);
+		desc.setSaveTime(info.saveTime);
+		desc.setPlayTime(info.playTime);
+		if (withThumbnail)
+			desc.setThumbnail(saveFileMan->loadCachedThumbnail(_target, fileName));
+		return desc;
+	}
+
+	SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), slot);
+	if (desc.getSaveSlot() == slot) {
+		info.slot = slot;
+		info.description = desc.getDescription();
+		info.saveDate = desc.getSaveDate();
+		info.saveTime = desc.getSaveTime();
+		info.playTime = desc.getPlayTime();
+		info.deletable = desc.getDeletableFlag();
+		info.writeProtected = desc.getWriteProtectedFlag();
+		saveFileMan->setCachedMetaInfo(_target, fileName, info, desc.getThumbnail());
+	}
+	return desc;
+}
+
 #ifndef DISABLE_SAVELOADCHOOSER_GRID
 void SaveLoadChooserDialog::addChooserButtons() {
 	if (_listButton) {
@@ -534,7 +575,7 @@ void SaveLoadChooserSimple::updateSelection(bool redraw) {
 	_playtime->setLabel(_("No playtime saved"));
 
 	if (selItem >= 0 && _metaInfoSupport) {
-		SaveStateDescriptor desc = (_saveList[selItem].getLocked() ? _saveList[selItem] : _metaEngine->querySaveMetaInfos(_target.c_str(), _saveList[selItem].getSaveSlot()));
+		SaveStateDescriptor desc = (_saveList[selItem].getLocked() ? _saveList[selItem] : getSaveMetaInfos(_saveList[selItem].getSaveSlot(), _thumbnailSupport));
 
 		isDeletable = desc.getDeletableFlag() && _delSupport;
 		isWriteProtected = desc.getWriteProtectedFlag();
@@ -799,8 +840,15 @@ void SaveLoadChooserGrid::handleMouseWheel(int x, int y, int direction) {
 	}
 }
 
+void SaveLoadChooserGrid::handleTickle() {
+	loadNextMetaInfos();
+	SaveLoadChooserDialog::handleTickle();
+}
+
 void SaveLoadChooserGrid::updateSaveList() {
 	SaveLoadChooserDialog::updateSaveList();
+	// The saves might have changed, so forget what was loaded so far.
+	_metaInfos.clear();
 	updateSaves();
 	draw();
 }
@@ -841,7 +889,7 @@ void SaveLoadChooserGrid::open() {
 			// In case there was a gap found use the slot.
 			if (lastSlot + 1 < curSlot) {
 				// Check that the save slot can be used for user saves.
-				SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), lastSlot + 1);
+				SaveStateDescriptor desc = getSaveMetaInfos(lastSlot + 1, false);
 				if (!desc.getWriteProtectedFlag()) {
 					_nextFreeSaveSlot = lastSlot + 1;
 					break;
@@ -855,13 +903,14 @@ void SaveLoadChooserGrid::open() {
 		const int maxSlot = _metaEngine->getMaximumSaveSlot();
 		for (int i = lastSlot; _nextFreeSaveSlot == -1 && i < maxSlot; ++i) {
 			// Check that the save slot can be used for user saves.
-			SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), i + 1);
+			SaveStateDescriptor desc = getSaveMetaInfos(i + 1, false);
 			if (!desc.getWriteProtectedFlag()) {
 				_nextFreeSaveSlot = i + 1;
 			}
 		}
 	}
 
+	_metaInfos.clear();
 	updateSaves();
 }
 
@@ -964,6 +1013,8 @@ void SaveLoadChooserGrid::reflowLayout() {
 }
 
 void SaveLoadChooserGrid::close() {
+	_loadQueue.clear();
+
 	// Save the current page.
 	const int result = getResult();
 	if (result >= 0 && result != _nextFreeSaveSlot) {
@@ -1046,58 +1097,39 @@ void SaveLoadChooserGrid::hideButtons() {
 void SaveLoadChooserGrid::updateSaves() {
 	hideButtons();
 
-	for (uint i = _curPage * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
-		const uint saveSlot = _saveList[i].getSaveSlot();
+	// Slots of the previous page are not interesting anymore.
+	_loadQueue.clear();
 
-		SaveStateDescriptor desc =  (_saveList[i].getLocked() ? _saveList[i] : _metaEngine->querySaveMetaInfos(_target.c_str(), saveSlot));
+	for (uint i = _curPage * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
+		const int saveSlot = _saveList[i].getSaveSlot();
 		SlotButton &curButton = _buttons[curNum];
-		curButton.setVisible(true);
-		const Graphics::Surface *thumbnail = desc.getThumbnail();
-		if (thumbnail) {
-			curButton.button->setGfx(desc.getThumbnail());
-		} else {
-			curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
-		}
-		curButton.description->setLabel(Common::String::format("%d. %s", saveSlot, desc.getDescription().c_str()));
 
-		Common::String tooltip(_("Name: "));
-		tooltip += desc.getDescription();
-
-		if (_saveDateSupport) {
-			const Common::String &saveDate = desc.getSaveDate();
-			if (!saveDate.empty()) {
-				tooltip += "\n";
-				tooltip +=  _("Date: ") + saveDate;
-			}
-
-			const Common::String &saveTime = desc.getSaveTime();
-			if (!saveTime.empty()) {
-				tooltip += "\n";
-				tooltip += _("Time: ") + saveTime;
-			}
+		if (_saveList[i].getLocked()) {
+			updateSlotButton(curButton, _saveList[i], 0);
+			continue;
 		}
 
-		if (_playTimeSupport) {
-			const Common::String &playTime = desc.getPlayTime();
-			if (!playTime.empty()) {
-				tooltip += "\n";
-				tooltip += _("Playtime: ") + playTime;
-			}
+		MetaInfoMap::const_iterator metaInfo = _metaInfos.find(saveSlot);
+		if (metaInfo == _metaInfos.end()) {
+			// Show what listing the saves told us until the rest is loaded.
+			updateSlotButton(curButton, _saveList[i], 0);
+			requestMetaInfos(saveSlot);
+			continue;
 		}
 
-		curButton.button->setTooltip(tooltip);
-
-		// In save mode we disable the button, when it's write protected.
-		// TODO: Maybe we should not display it at all then?
-		if (_saveMode && desc.getWriteProtectedFlag()) {
-			curButton.button->setEnabled(false);
-		} else {
-			curButton.button->setEnabled(true);
+		ThumbnailCache::SurfacePtr thumbnail;
+		if (_thumbnailSupport) {
+			thumbnail = ThumbCache.get(_target, saveSlot, getThumbnailStamp(metaInfo->_value));
+			if (!thumbnail)
+				requestMetaInfos(saveSlot);
 		}
+		updateSlotButton(curButton, metaInfo->_value, thumbnail.get());
+	}
 
-		//that would make it look "disabled" if slot is locked
-		curButton.button->setEnabled(!desc.getLocked());
-		curButton.description->setEnabled(!desc.getLocked());
+	// Prefetch the next page, so flipping to it is instant.
+	for (uint i = (_curPage + 1) * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
+		if (!_saveList[i].getLocked() && !_metaInfos.contains(_saveList[i].getSaveSlot()))
+			requestMetaInfos(_saveList[i].getSaveSlot());
 	}
 
 	const uint numPages = (_entriesPerPage != 0 && !_saveList.empty()) ? ((_saveList.size() + _entriesPerPage - 1) / _entriesPerPage) : 1;
@@ -1114,6 +1146,107 @@ void SaveLoadChooserGrid::updateSaves() {
 		_nextButton->setEnabled(false);
 }
 
+void SaveLoadChooserGrid::updateSlotButton(SlotButton &button, const SaveStateDescriptor &desc, const Graphics::Surface *thumbnail) {
+	button.setVisible(true);
+	if (thumbnail) {
+		button.button->setGfx(thumbnail);
+	} else {
+		button.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
+	}
+	button.description->setLabel(Common::String::format("%d. %s", desc.getSaveSlot(), desc.getDescription().c_str()));
+
+	Common::String tooltip(_("Name: "));
+	tooltip += desc.getDescription();
+
+	if (_saveDateSupport) {
+		const Common::String &saveDate = desc.getSaveDate();
+		if (!saveDate.empty()) {
+			tooltip += "\n";
+			tooltip +=  _("Date: ") + saveDate;
+		}
+
+		const Common::String &saveTime = desc.getSaveTime();
+		if (!saveTime.empty()) {
+			tooltip += "\n";
+			tooltip += _("Time: ") + saveTime;
+		}
+	}
+
+	if (_playTimeSupport) {
+		const Common::String &playTime = desc.getPlayTime();
+		if (!playTime.empty()) {
+			tooltip += "\n";
+			tooltip += _("Playtime: ") + playTime;
+		}
+	}
+
+	button.button->setTooltip(tooltip);
+
+	// In save mode we disable the button, when it's write protected.
+	// TODO: Maybe we should not display it at all then?
+	if (_saveMode && desc.getWriteProtectedFlag()) {
+		button.button->setEnabled(false);
+	} else {
+		button.button->setEnabled(true);
+	}
+
+	//that would make it look "disabled" if slot is locked
+	button.button->setEnabled(!desc.getLocked());
+	button.description->setEnabled(!desc.getLocked());
+}
+
+void SaveLoadChooserGrid::requestMetaInfos(int slot) {
+	for (uint i = 0; i < _loadQueue.size(); ++i) {
+		if (_loadQueue[i] == slot)
+			return;
+	}
+	_loadQueue.push_back(slot);
+}
+
+void SaveLoadChooserGrid::loadNextMetaInfos() {
+	if (_loadQueue.empty())
+		return;
+
+	const int slot = _loadQueue.remove_at(0);
+
+	uint index = 0;
+	while (index < _saveList.size() && _saveList[index].getSaveSlot() != slot)
+		++index;
+	// The save list changed in the meantime.
+	if (index == _saveList.size())
+		return;
+
+	SaveStateDescriptor desc = getSaveMetaInfos(slot, _thumbnailSupport);
+	if (desc.getSaveSlot() != slot) {
+		// The engine could not provide any meta infos, so stick to
+		// what listing the saves told us.
+		desc = _saveList[index];
+	}
+
+	ThumbnailCache::SurfacePtr thumbnail;
+	if (desc.getThumbnail()) {
+		Graphics::Surface *copy = new Graphics::Surface();
+		copy->copyFrom(*desc.getThumbnail());
+		thumbnail = ThumbnailCache::SurfacePtr(copy, Graphics::SurfaceDeleter());
+		ThumbCache.put(_target, slot, getThumbnailStamp(desc), thumbnail);
+	}
+	// Thumbnails are kept by the thumbnail cache only.
+	desc.setThumbnail(ThumbnailCache::SurfacePtr());
+	_metaInfos[slot] = desc;
+
+	const uint pageStart = _curPage * _entriesPerPage;
+	if (index >= pageStart && index < pageStart + _entriesPerPage) {
+		updateSlotButton(_buttons[index - pageStart], desc, thumbnail.get());
+		draw();
+	}
+}
+
+Common::String SaveLoadChooserGrid::getThumbnailStamp(const SaveStateDescriptor &desc) {
+	// Savefiles are not timestamped, but these change whenever a slot is
+	// overwritten by a new save.
+	return desc.getDescription() + '\n' + desc.getSaveDate() + '\n' + desc.getSaveTime() + '\n' + desc.getPlayTime();
+}
+
 SavenameDialog::SavenameDialog()
 	: Dialog("SavenameDialog") {
 	_title = new StaticTextWidget(this, "SavenameDialog.DescriptionText", Common::String());
@@ -110,6 +110,17 @@ protected:
 	*/
 	virtual void listSaves();
 
+	/**
+	 * Query the meta infos of a save slot, going through the savefile
+	 * manager's metadata cache when the engine uses simple save names.
+	 *
+	 * @param withThumbnail Whether the thumbnail is needed.
+	 */
+	SaveStateDescriptor getSaveMetaInfos(int slot, bool withThumbnail);
+
+	/** Name of the savefile of a slot, or an empty string if unknown. */
+	Common::String getSaveFileName(int slot) const;
+
 	const bool				_saveMode;
 	const MetaEngine		*_metaEngine;
 	bool					_delSupport;
@@ -206,6 +217,7 @@ public:
 protected:
 	virtual void handleCommand(CommandSender *sender, uint32 cmd, uint32 data);
 	virtual void handleMouseWheel(int x, int y, int direction);
+	virtual void handleTickle();
 	virtual void updateSaveList();
 private:
 	virtual int runIntern();
@@ -243,6 +255,27 @@ private:
 	void destroyButtons();
 	void hideButtons();
 	void updateSaves();
+	void updateSlotButton(SlotButton &button, const SaveStateDescriptor &desc, const Graphics::Surface *thumbnail);
+
+	/**
+	 * @name Deferred loading
+	 *
+	 * Meta infos and thumbnails of the shown slots are loaded one slot per
+	 * tickle, which keeps paging responsive even when the engine needs to
+	 * parse the savefiles. Until then the slots show a placeholder.
+	 */
+	//@{
+	void requestMetaInfos(int slot);
+	void loadNextMetaInfos();
+	static Common::String getThumbnailStamp(const SaveStateDescriptor &desc);
+
+	/** Slots whose meta infos still need to be loaded, in order */
+	Common::Array<int> _loadQueue;
+
+	/** Meta infos loaded so far, without thumbnails */
+	typedef Common::HashMap<int, SaveStateDescriptor> MetaInfoMap;
+	MetaInfoMap _metaInfos;
+	//@}
 };
 
 #endif // !DISABLE_SAVELOADCHOOSER_GRID
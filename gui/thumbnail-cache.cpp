@@ -0,0 +1,95 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "gui/thumbnail-cache.h"
+
+#include "graphics/surface.h"
+
+namespace Common {
+DECLARE_SINGLETON(GUI::ThumbnailCache);
+}
+
+namespace GUI {
+
+enum {
+	// Room for about 250 thumbnails of 160x100 pixels in 16bpp.
+	kBudget = 8 * 1024 * 1024
+};
+
+ThumbnailCache::ThumbnailCache() : _size(0) {
+}
+
+Common::String ThumbnailCache::makeKey(const Common::String &target, int slot) {
+	return Common::String::format("%s:%d", target.c_str(), slot);
+}
+
+ThumbnailCache::SurfacePtr ThumbnailCache::get(const Common::String &target, int slot, const Common::String &stamp) {
+	EntryMap::iterator entry = _entries.find(makeKey(target, slot));
+	if (entry == _entries.end())
+		return SurfacePtr();
+
+	if (entry->_value.stamp != stamp) {
+		remove(entry);
+		return SurfacePtr();
+	}
+
+	// Mark as most recently used
+	_lru.erase(entry->_value.lruPos);
+	_lru.push_back(entry->_key);
+	entry->_value.lruPos = _lru.reverse_begin();
+	return entry->_value.thumbnail;
+}
+
+void ThumbnailCache::put(const Common::String &target, int slot, const Common::String &stamp, SurfacePtr thumbnail) {
+	if (!thumbnail)
+		return;
+
+	const Common::String key = makeKey(target, slot);
+	EntryMap::iterator old = _entries.find(key);
+	if (old != _entries.end())
+		remove(old);
+
+	Entry &entry = _entries[key];
+	entry.stamp = stamp;
+	entry.thumbnail = thumbnail;
+	entry.size = thumbnail->h * thumbnail->pitch;
+	_lru.push_back(key);
+	entry.lruPos = _lru.reverse_begin();
+	_size += entry.size;
+
+	evict();
+}
+
+void ThumbnailCache::remove(EntryMap::iterator entry) {
+	_size -= entry->_value.size;
+	_lru.erase(entry->_value.lruPos);
+	_entries.erase(entry);
+}
+
+void ThumbnailCache::evict() {
+	// Thumbnails still shown by a dialog stay alive through their shared
+	// pointers, so evicting them here is safe.
+	while (_size > kBudget && !_lru.empty())
+		remove(_entries.find(_lru.front()));
+}
+
+} // End of namespace GUI
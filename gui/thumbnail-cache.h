@@ -0,0 +1,103 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GUI_THUMBNAIL_CACHE_H
+#define GUI_THUMBNAIL_CACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/list.h"
+#include "common/ptr.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+namespace Graphics {
+struct Surface;
+}
+
+namespace GUI {
+
+/**
+ * Keeps recently shown savegame thumbnails around, so that save/load
+ * dialogs do not need to decode them again when paging back and forth or
+ * when being reopened.
+ *
+ * Entries are identified by target and save slot. Each entry also stores a
+ * stamp describing the save state it was created from, and a lookup with a
+ * different stamp treats the entry as stale. The least recently used
+ * thumbnails are evicted once their total size exceeds the memory budget.
+ *
+ * The cache is only meant to be used from the GUI thread.
+ */
+class ThumbnailCache : public Common::Singleton<ThumbnailCache> {
+	friend class Common::Singleton<SingletonBaseType>;
+	ThumbnailCache();
+
+public:
+	typedef Common::SharedPtr<Graphics::Surface> SurfacePtr;
+
+	/**
+	 * Look up a thumbnail.
+	 *
+	 * @return The thumbnail, or a null pointer if it is not cached.
+	 */
+	SurfacePtr get(const Common::String &target, int slot, const Common::String &stamp);
+
+	/**
+	 * Add a thumbnail to the cache, replacing any older thumbnail of the
+	 * same slot. The cache shares ownership of the surface.
+	 */
+	void put(const Common::String &target, int slot, const Common::String &stamp, SurfacePtr thumbnail);
+
+private:
+	typedef Common::List<Common::String> KeyList;
+
+	struct Entry {
+		Common::String stamp;
+		SurfacePtr thumbnail;
+		uint32 size;
+
+		/** Position in _lru */
+		KeyList::iterator lruPos;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	static Common::String makeKey(const Common::String &target, int slot);
+	void remove(EntryMap::iterator entry);
+	void evict();
+
+	EntryMap _entries;
+
+	/** Keys of all entries, least recently used first */
+	KeyList _lru;
+
+	/** Total size of all thumbnails in bytes */
+	uint32 _size;
+};
+
+} // End of namespace GUI
+
+/** Shortcut for accessing the thumbnail cache. */
+#define ThumbCache GUI::ThumbnailCache::instance()
+
+#endif
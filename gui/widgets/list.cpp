@@ -119,16 +119,17 @@ void ListWidget::setSelected(int item) {
 	// we will need to look up, whether the user selected
 	// item is present in that list
 	if (_listIndex.size()) {
-		int filteredItem = -1;
-
-		for (uint i = 0; i < _listIndex.size(); ++i) {
-			if (_listIndex[i] == item) {
-				filteredItem = i;
-				break;
-			}
+		// _listIndex is in ascending order, so we can do a binary search
+		int low = 0, high = _listIndex.size();
+		while (low < high) {
+			const int mid = (low + high) / 2;
+			if (_listIndex[mid] < item)
+				low = mid + 1;
+			else
+				high = mid;
 		}
 
-		item = filteredItem;
+		item = (low < (int)_listIndex.size() && _listIndex[low] == item) ? low : -1;
 	}
 
 	assert(item >= -1 && item < (int)_list.size());
@@ -166,6 +167,9 @@ void ListWidget::setList(const StringArray &list, const ColorList *colors) {
 	// Copy everything
 	_dataList = list;
 	_list = list;
+	_searchList = list;
+	for (StringArray::iterator i = _searchList.begin(); i != _searchList.end(); ++i)
+		i->toLowercase();
 	_filter.clear();
 	_listIndex.clear();
 	_listColors.clear();
@@ -201,8 +205,13 @@ void ListWidget::append(const String &s, ThemeEngine::FontColor color) {
 
 	_dataList.push_back(s);
 	_list.push_back(s);
+	_searchList.push_back(s);
+	_searchList.back().toLowercase();
 
-	setFilter(_filter, false);
+	// Refilter from scratch, as the new entry might not match
+	String filter = _filter;
+	_filter.clear();
+	setFilter(filter, false);
 
 	scrollBarRecalc();
 }
@@ -504,7 +513,11 @@ void ListWidget::drawWidget() {
 	g_gui.theme()->drawWidgetBackgroundClip(Common::Rect(_x, _y, _x + _w, _y + _h), getBossClipRect(), 0, ThemeEngine::kWidgetBackgroundBorder);
 	const int scrollbarW = (_scrollBar && _scrollBar->isVisible()) ? _scrollBarWidth : 0;
 
-	// Draw the list items
+	// Only the horizontal extent of the edit rect is used, which is the same
+	// for all rows
+	const Common::Rect r(getEditRect());
+
+	// Draw the visible list items
 	for (i = 0, pos = _currentPos; i < _entriesPerPage && pos < len; i++, pos++) {
 		const int y = _y + _topPadding + kLineHeight * i;
 		const int fontHeight = kLineHeight;
@@ -514,7 +527,6 @@ void ListWidget::drawWidget() {
 		if (_selectedItem == pos)
 			inverted = _inversion;
 
-		Common::Rect r(getEditRect());
 		int pad = _leftPadding;
 
 		// If in numbering mode, we first print a number prefix
@@ -530,7 +542,7 @@ void ListWidget::drawWidget() {
 		ThemeEngine::FontColor color = ThemeEngine::kFontColorNormal;
 
 		if (!_listColors.empty()) {
-			if (_filter.empty() || _selectedItem == -1)
+			if (_filter.empty())
 				color = _listColors[pos];
 			else
 				color = _listColors[_listIndex[pos]];
@@ -692,6 +704,7 @@ void ListWidget::setFilter(const String &filter, bool redraw) {
 	if (_filter == filt) // Filter was not changed
 		return;
 
+	const String oldFilter = _filter;
 	_filter = filt;
 
 	if (_filter.empty()) {
@@ -702,28 +715,39 @@ void ListWidget::setFilter(const String &filter, bool redraw) {
 		// Restrict the list to everything which contains all words in _filter
 		// as substrings, ignoring case.
 
+		StringArray words;
 		Common::StringTokenizer tok(_filter);
-		String tmp;
-		int n = 0;
+		while (!tok.empty())
+			words.push_back(tok.nextToken());
+
+		// When the filter merely got extended, e.g. by typing another
+		// character into the search box, every entry matching it also
+		// matched the old filter. Then only the old matches need checking.
+		Common::Array<int> candidates;
+		if (!oldFilter.empty() && _filter.hasPrefix(oldFilter)) {
+			candidates = _listIndex;
+		} else {
+			candidates.resize(_dataList.size());
+			for (uint n = 0; n < _dataList.size(); ++n)
+				candidates[n] = n;
+		}
 
 		_list.clear();
 		_listIndex.clear();
 
-		for (StringArray::iterator i = _dataList.begin(); i != _dataList.end(); ++i, ++n) {
-			tmp = *i;
-			tmp.toLowercase();
+		for (Common::Array<int>::const_iterator i = candidates.begin(); i != candidates.end(); ++i) {
+			const String &entry = _searchList[*i];
 			bool matches = true;
-			tok.reset();
-			while (!tok.empty()) {
-				if (!tmp.contains(tok.nextToken())) {
+			for (StringArray::const_iterator word = words.begin(); word != words.end(); ++word) {
+				if (!entry.contains(*word)) {
 					matches = false;
 					break;
 				}
 			}
 
 			if (matches) {
-				_list.push_back(*i);
-				_listIndex.push_back(n);
+				_list.push_back(_dataList[*i]);
+				_listIndex.push_back(*i);
 			}
 		}
 	}
@@ -55,6 +55,7 @@ public:
 protected:
 	StringArray		_list;
 	StringArray		_dataList;
+	StringArray		_searchList;	///< lower case copy of _dataList, matched against the filter
 	ColorList		_listColors;
 	Common::Array<int>		_listIndex;
 	bool			_editable;
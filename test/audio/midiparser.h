@@ -0,0 +1,278 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mididrv.h"
+#include "audio/midiparser.h"
+
+#include "common/array.h"
+#include "common/hashmap.h"
+
+class MidiParserTestSuite : public CxxTest::TestSuite {
+	enum {
+		kEventCount = 4000
+	};
+
+	/**
+	 * Keeps the state a MIDI device would have after the messages sent
+	 * to it, apart from the notes, and all messages in order.
+	 */
+	class RecordingDriver : public MidiDriver_BASE {
+	public:
+		int controllers[16][128];
+		int programs[16];
+		int programBanks[16]; ///< The bank select controllers at the last program change
+		int pitchBends[16];
+		int pressures[16];
+		Common::HashMap<uint32, int> dataEntries;
+		Common::Array<uint32> extEvents;
+		Common::Array<uint32> messages;
+
+		RecordingDriver() { reset(); }
+
+		void reset() {
+			memset(controllers, 0xFF, sizeof(controllers));
+			memset(programs, 0xFF, sizeof(programs));
+			memset(programBanks, 0xFF, sizeof(programBanks));
+			memset(pitchBends, 0xFF, sizeof(pitchBends));
+			memset(pressures, 0xFF, sizeof(pressures));
+			memset(_nrpnSelected, 0, sizeof(_nrpnSelected));
+			dataEntries.clear();
+			extEvents.clear();
+			messages.clear();
+		}
+
+		bool sameState(const RecordingDriver &other) const {
+			if (memcmp(controllers, other.controllers, sizeof(controllers)) ||
+			    memcmp(programs, other.programs, sizeof(programs)) ||
+			    memcmp(programBanks, other.programBanks, sizeof(programBanks)) ||
+			    memcmp(pitchBends, other.pitchBends, sizeof(pitchBends)) ||
+			    memcmp(pressures, other.pressures, sizeof(pressures)) ||
+			    extEvents != other.extEvents ||
+			    dataEntries.size() != other.dataEntries.size())
+				return false;
+
+			for (Common::HashMap<uint32, int>::const_iterator i = dataEntries.begin(); i != dataEntries.end(); ++i) {
+				if (!other.dataEntries.contains(i->_key) || other.dataEntries[i->_key] != i->_value)
+					return false;
+			}
+			return true;
+		}
+
+		void send(uint32 b) {
+			messages.push_back(b);
+
+			const byte channel = b & 0x0F;
+			const byte param1 = (b >> 8) & 0x7F;
+			const byte param2 = (b >> 16) & 0x7F;
+
+			switch ((b >> 4) & 0x0F) {
+			case 0xB:
+				controllers[channel][param1] = param2;
+				if (param1 == 0x06 || param1 == 0x26) {
+					// Remember the value for the selected RPN or NRPN
+					const uint32 parameter = _nrpnSelected[channel] ?
+						(0x10000 | (controllers[channel][0x63] & 0x7F) << 7 | (controllers[channel][0x62] & 0x7F)) :
+						((controllers[channel][0x65] & 0x7F) << 7 | (controllers[channel][0x64] & 0x7F));
+					dataEntries[channel << 24 | param1 << 17 | parameter] = param2;
+				} else if (param1 == 0x62 || param1 == 0x63) {
+					_nrpnSelected[channel] = true;
+				} else if (param1 == 0x64 || param1 == 0x65) {
+					_nrpnSelected[channel] = false;
+				}
+				break;
+			case 0xC:
+				programs[channel] = param1;
+				programBanks[channel] = (controllers[channel][0x00] & 0xFF) << 8 | (controllers[channel][0x20] & 0xFF);
+				break;
+			case 0xD:
+				pressures[channel] = param1;
+				break;
+			case 0xE:
+				pitchBends[channel] = param1 | param2 << 7;
+				break;
+			default:
+				break;
+			}
+		}
+
+		void sysEx(const byte *msg, uint16 length) {
+			extEvents.push_back(0xF0000000 | length << 8 | msg[0]);
+		}
+
+		void metaEvent(byte type, byte *data, uint16 length) {
+			extEvents.push_back(0xFF000000 | type << 16 | length << 8 | (length ? data[0] : 0));
+		}
+
+	private:
+		bool _nrpnSelected[16];
+	};
+
+	Common::Array<byte> _smf;
+	uint32 _lastTick;
+	uint32 _seed;
+
+	uint32 nextRandom(uint32 range) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % range;
+	}
+
+	void writeVLQ(Common::Array<byte> &data, uint32 value) {
+		byte bytes[4];
+		int count = 0;
+		do {
+			bytes[count++] = value & 0x7F;
+			value >>= 7;
+		} while (value);
+		while (count > 1)
+			data.push_back(bytes[--count] | 0x80);
+		data.push_back(bytes[0]);
+	}
+
+	/**
+	 * Creates a type 0 SMF with random notes, controllers (including RPN
+	 * and NRPN data entry), program changes, pitch bends, SysEx and META
+	 * events. The first tempo event comes after a while.
+	 */
+	void createSMF() {
+		static const byte controllers[] = { 0x00, 0x01, 0x06, 0x07, 0x0A, 0x20, 0x26, 0x40, 0x62, 0x63, 0x64, 0x65, 0x79 };
+
+		Common::Array<byte> track;
+		_seed = 1;
+		_lastTick = 0;
+
+		for (int i = 0; i < kEventCount; i++) {
+			const uint32 delta = nextRandom(4) ? nextRandom(24) : 0;
+			const byte channel = nextRandom(16);
+			_lastTick += delta;
+			writeVLQ(track, delta);
+
+			const uint32 type = nextRandom(100);
+			if (type < 40) {
+				track.push_back((nextRandom(2) ? 0x90 : 0x80) | channel);
+				track.push_back(nextRandom(128));
+				track.push_back(nextRandom(128));
+			} else if (type < 75) {
+				track.push_back(0xB0 | channel);
+				track.push_back(controllers[nextRandom(ARRAYSIZE(controllers))]);
+				track.push_back(nextRandom(128));
+			} else if (type < 82) {
+				track.push_back(0xC0 | channel);
+				track.push_back(nextRandom(128));
+			} else if (type < 89) {
+				track.push_back(0xE0 | channel);
+				track.push_back(nextRandom(128));
+				track.push_back(nextRandom(128));
+			} else if (type < 92) {
+				track.push_back(0xD0 | channel);
+				track.push_back(nextRandom(128));
+			} else if (type < 94) {
+				track.push_back(0xA0 | channel);
+				track.push_back(nextRandom(128));
+				track.push_back(nextRandom(128));
+			} else if (type < 96) {
+				track.push_back(0xF0);
+				track.push_back(4);
+				track.push_back(0x41);
+				track.push_back(nextRandom(128));
+				track.push_back(nextRandom(128));
+				track.push_back(0xF7);
+			} else if (type < 98 && i > kEventCount / 4) {
+				const uint32 tempo = 300000 + nextRandom(400000);
+				track.push_back(0xFF);
+				track.push_back(0x51);
+				track.push_back(3);
+				track.push_back(tempo >> 16);
+				track.push_back(tempo >> 8);
+				track.push_back(tempo);
+			} else {
+				track.push_back(0xFF);
+				track.push_back(0x01);
+				track.push_back(1);
+				track.push_back('a' + nextRandom(26));
+			}
+		}
+
+		track.push_back(0);
+		track.push_back(0xFF);
+		track.push_back(0x2F);
+		track.push_back(0);
+
+		static const byte header[] = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96, 'M', 'T', 'r', 'k' };
+		_smf.clear();
+		for (uint i = 0; i < ARRAYSIZE(header); i++)
+			_smf.push_back(header[i]);
+		_smf.push_back(track.size() >> 24);
+		_smf.push_back(track.size() >> 16);
+		_smf.push_back(track.size() >> 8);
+		_smf.push_back(track.size());
+		for (uint i = 0; i < track.size(); i++)
+			_smf.push_back(track[i]);
+	}
+
+	MidiParser *createParser(RecordingDriver &driver) {
+		MidiParser *parser = MidiParser::createParser_SMF();
+		parser->setMidiDriver(&driver);
+		parser->setTimerRate(20000);
+		parser->loadMusic(&_smf[0], _smf.size());
+		return parser;
+	}
+
+	/**
+	 * Jumps with a parser that has recorded checkpoints and with a new one,
+	 * which has to parse the track from the start, and compares the device
+	 * state and the playback after the jump.
+	 */
+	void checkJumps(bool fireEvents, bool dontSendNoteOn) {
+		createSMF();
+
+		RecordingDriver driver;
+		MidiParser *parser = createParser(driver);
+
+		// Record the checkpoints, and play a bit
+		TS_ASSERT(parser->jumpToTick(_lastTick - 1));
+		for (int i = 0; i < 10; i++)
+			parser->onTimer();
+
+		for (int jump = 0; jump < 60; jump++) {
+			uint32 tick = 1 + nextRandom(_lastTick + 100);
+
+			RecordingDriver referenceDriver;
+			MidiParser *reference = createParser(referenceDriver);
+
+			// Events before the first tempo event play at the tempo of the jump
+			parser->setTempo(500000);
+			referenceDriver.reset();
+			driver.reset();
+
+			const bool result = parser->jumpToTick(tick, fireEvents, true, dontSendNoteOn);
+			TS_ASSERT_EQUALS(result, reference->jumpToTick(tick, fireEvents, true, dontSendNoteOn));
+			TS_ASSERT(driver.sameState(referenceDriver));
+
+			if (result) {
+				TS_ASSERT_EQUALS(parser->getTick(), reference->getTick());
+
+				driver.messages.clear();
+				referenceDriver.messages.clear();
+				for (int i = 0; i < 20; i++) {
+					parser->onTimer();
+					reference->onTimer();
+					TS_ASSERT_EQUALS(parser->getTick(), reference->getTick());
+				}
+				TS_ASSERT(driver.messages == referenceDriver.messages);
+			}
+
+			delete reference;
+		}
+
+		delete parser;
+	}
+
+public:
+	void test_jump_to_tick() {
+		checkJumps(false, false);
+	}
+
+	void test_jump_to_tick_fire_events() {
+		checkJumps(true, false);
+		checkJumps(true, true);
+	}
+};
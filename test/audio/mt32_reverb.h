@@ -0,0 +1,74 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+
+#ifdef USE_MT32EMU
+#include "audio/softsynth/mt32/BReverbModel.h"
+#endif
+
+class MT32ReverbTestSuite : public CxxTest::TestSuite {
+	enum {
+		kSampleCount = 20000
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom(uint32 range) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % range;
+	}
+
+#ifdef USE_MT32EMU
+	/**
+	 * Feeds the same input to process() and processReference() of two
+	 * models, in chunks of random size, and compares the output.
+	 */
+	void checkMode(MT32Emu::ReverbMode mode, bool mt32CompatibleModel) {
+		MT32Emu::BReverbModel model(mode, mt32CompatibleModel);
+		MT32Emu::BReverbModel reference(mode, mt32CompatibleModel);
+		model.open();
+		reference.open();
+		model.setParameters(3, 5);
+		reference.setParameters(3, 5);
+
+		MT32Emu::Sample inLeft[1000], inRight[1000];
+		MT32Emu::Sample outLeft[1000], outRight[1000];
+		MT32Emu::Sample referenceLeft[1000], referenceRight[1000];
+
+		uint32 done = 0;
+		while (done < kSampleCount) {
+			const uint32 count = 1 + nextRandom(ARRAYSIZE(inLeft));
+			if (nextRandom(4) == 0) {
+				const byte time = nextRandom(8);
+				const byte level = nextRandom(8);
+				model.setParameters(time, level);
+				reference.setParameters(time, level);
+			}
+
+			// Loud input with silent stretches, to get the filters saturated and decaying
+			const bool silent = nextRandom(3) == 0;
+			for (uint32 i = 0; i < count; i++) {
+				inLeft[i] = silent ? 0 : (int16)nextRandom(65536);
+				inRight[i] = silent ? 0 : (int16)nextRandom(65536);
+			}
+
+			model.process(inLeft, inRight, outLeft, outRight, count);
+			reference.processReference(inLeft, inRight, referenceLeft, referenceRight, count);
+			TS_ASSERT(!memcmp(outLeft, referenceLeft, count * sizeof(MT32Emu::Sample)));
+			TS_ASSERT(!memcmp(outRight, referenceRight, count * sizeof(MT32Emu::Sample)));
+			done += count;
+		}
+	}
+#endif
+
+public:
+	void test_process_matches_reference() {
+#ifdef USE_MT32EMU
+		_seed = 1;
+		for (int mode = MT32Emu::REVERB_MODE_ROOM; mode <= MT32Emu::REVERB_MODE_TAP_DELAY; mode++) {
+			checkMode((MT32Emu::ReverbMode)mode, false);
+			checkMode((MT32Emu::ReverbMode)mode, true);
+		}
+#endif
+	}
+};
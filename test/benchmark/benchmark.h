@@ -0,0 +1,32 @@
+#ifndef TEST_BENCHMARK_H
+#define TEST_BENCHMARK_H
+
+#include "common/scummsys.h"
+
+#include <stdio.h>
+#include <sys/time.h>
+
+/**
+ * Simple wall clock timer for the benchmarks. The benchmark runner does not
+ * have an OSystem, so g_system->getMillis() cannot be used.
+ */
+class BenchmarkTimer {
+public:
+	BenchmarkTimer() { reset(); }
+
+	void reset() { _start = now(); }
+
+	/** Elapsed time in seconds since construction or the last reset(). */
+	double elapsed() const { return now() - _start; }
+
+private:
+	static double now() {
+		struct timeval tv;
+		gettimeofday(&tv, 0);
+		return tv.tv_sec + tv.tv_usec / 1000000.0;
+	}
+
+	double _start;
+};
+
+#endif
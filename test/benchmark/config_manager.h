@@ -0,0 +1,43 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/config-manager.h"
+
+#include "test/benchmark/benchmark.h"
+
+class ConfigManagerBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kIterations = 2000000
+	};
+
+public:
+	void test_lookups() {
+		ConfMan.registerDefault("bench_subtitles", false);
+		ConfMan.registerDefault("bench_talkspeed", 60);
+		ConfMan.addGameDomain("bench_game");
+		ConfMan.setActiveDomain("bench_game");
+		ConfMan.setBool("bench_subtitles", true);
+
+		// Some unrelated keys, so the domains are not trivially small
+		for (int i = 0; i < 32; i++)
+			ConfMan.setInt(Common::String::format("bench_filler_%d", i), i);
+
+		int sum = 0;
+		BenchmarkTimer timer;
+		for (int i = 0; i < kIterations; i++)
+			sum += ConfMan.getBool("bench_subtitles") + ConfMan.getInt("bench_talkspeed");
+		const double plain = timer.elapsed();
+
+		const Common::ConfigManager::KeyHandle subtitles = ConfMan.internKey("bench_subtitles");
+		const Common::ConfigManager::KeyHandle talkspeed = ConfMan.internKey("bench_talkspeed");
+		timer.reset();
+		for (int i = 0; i < kIterations; i++)
+			sum -= ConfMan.getBool(subtitles) + ConfMan.getInt(talkspeed);
+		const double interned = timer.elapsed();
+
+		TS_ASSERT_EQUALS(sum, 0);
+		printf("\nConfigManager getBool+getInt: strings %7.1f ns, interned %7.1f ns per pair",
+		       plain * 1e9 / kIterations, interned * 1e9 / kIterations);
+
+		ConfMan.removeGameDomain("bench_game");
+	}
+};
@@ -0,0 +1,137 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/coroutines.h"
+
+#include "test/benchmark/benchmark.h"
+
+namespace {
+
+uint32 g_benchEvents[8];
+int g_benchWakeups = 0;
+
+/** Waits for one of the events over and over */
+void benchWaiterProcess(CORO_PARAM, const void *param) {
+	const int event = *(const int *)param;
+
+	CORO_BEGIN_CONTEXT;
+	CORO_END_CONTEXT(_ctx);
+
+	CORO_BEGIN_CODE(_ctx);
+
+	for (;;) {
+		CORO_INVOKE_2(CoroScheduler.waitForSingleObject, g_benchEvents[event], CORO_INFINITE);
+		g_benchWakeups++;
+	}
+
+	CORO_END_CODE;
+}
+
+/** Sets one of the events every few ticks */
+void benchSetterProcess(CORO_PARAM, const void *param) {
+	const int event = *(const int *)param;
+
+	CORO_BEGIN_CONTEXT;
+	CORO_END_CONTEXT(_ctx);
+
+	CORO_BEGIN_CODE(_ctx);
+
+	for (;;) {
+		CORO_SLEEP(4 + event);
+		CoroScheduler.setEvent(g_benchEvents[event]);
+	}
+
+	CORO_END_CODE;
+}
+
+/** Sleeps for a few ticks, and ends */
+void benchSleeperProcess(CORO_PARAM, const void *param) {
+	const int ticks = *(const int *)param;
+
+	CORO_BEGIN_CONTEXT;
+	CORO_END_CONTEXT(_ctx);
+
+	CORO_BEGIN_CODE(_ctx);
+
+	CORO_SLEEP(ticks);
+
+	CORO_END_CODE;
+}
+
+/** Waits for the process given in the parameter to end */
+void benchJoinerProcess(CORO_PARAM, const void *param) {
+	const uint32 pid = *(const uint32 *)param;
+
+	CORO_BEGIN_CONTEXT;
+	CORO_END_CONTEXT(_ctx);
+
+	CORO_BEGIN_CODE(_ctx);
+
+	CORO_INVOKE_2(CoroScheduler.waitForSingleObject, pid, CORO_INFINITE);
+	g_benchWakeups++;
+
+	CORO_END_CODE;
+}
+
+} // End of anonymous namespace
+
+/**
+ * Runs the coroutine scheduler with as many processes as it allows, most
+ * of them waiting for events or other processes.
+ */
+class CoroutineSchedulerBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kTicks = 200000,
+		kEvents = 8,
+		kWaitersPerEvent = 10,
+		kSleepTicks = 16
+	};
+
+public:
+	void test_waiting_processes() {
+		CoroScheduler.reset();
+		g_benchWakeups = 0;
+
+		for (int i = 0; i < kEvents; i++) {
+			g_benchEvents[i] = CoroScheduler.createEvent(false, false);
+			CoroScheduler.createProcess(benchSetterProcess, &i, sizeof(i));
+			for (int j = 0; j < kWaitersPerEvent; j++)
+				CoroScheduler.createProcess(benchWaiterProcess, &i, sizeof(i));
+		}
+
+		BenchmarkTimer timer;
+		for (int i = 0; i < kTicks; i++)
+			CoroScheduler.schedule();
+		const double elapsed = timer.elapsed();
+
+		TS_ASSERT_LESS_THAN(kTicks, g_benchWakeups);
+		printf("\nCoroutineScheduler %d processes waiting for events: %7.1f ns per tick, %d wakeups",
+		       kEvents * (kWaitersPerEvent + 1), elapsed * 1e9 / kTicks, g_benchWakeups);
+
+		CoroScheduler.reset();
+		for (int i = 0; i < kEvents; i++)
+			CoroScheduler.closeEvent(g_benchEvents[i]);
+	}
+
+	void test_process_churn() {
+		CoroScheduler.reset();
+		g_benchWakeups = 0;
+
+		// Each tick starts a process that sleeps for a while, and another one
+		// waiting for it to end, so that there are about 2 * kSleepTicks of
+		// them at any time
+		BenchmarkTimer timer;
+		for (int i = 0; i < kTicks; i++) {
+			int ticks = 1 + i % kSleepTicks;
+			uint32 pid = CoroScheduler.createProcess(benchSleeperProcess, &ticks, sizeof(ticks));
+			CoroScheduler.createProcess(benchJoinerProcess, &pid, sizeof(pid));
+			CoroScheduler.schedule();
+		}
+		const double elapsed = timer.elapsed();
+
+		TS_ASSERT_LESS_THAN(kTicks - 2 * kSleepTicks, g_benchWakeups);
+		printf("\nCoroutineScheduler %d short lived processes: %7.1f ns per process",
+		       2 * kTicks, elapsed * 1e9 / (2 * kTicks));
+
+		CoroScheduler.reset();
+	}
+};
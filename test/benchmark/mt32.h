@@ -0,0 +1,172 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+
+#ifdef USE_MT32EMU
+#include "audio/softsynth/mt32/BReverbModel.h"
+#include "audio/softsynth/mt32/File.h"
+#include "audio/softsynth/mt32/ROMInfo.h"
+#include "audio/softsynth/mt32/Synth.h"
+#endif
+
+#include "common/array.h"
+
+#include "test/benchmark/benchmark.h"
+
+#include <stdlib.h>
+
+/**
+ * Reports how many times faster than real time the MT-32 emulator runs.
+ *
+ * The reverb model is benchmarked on its own. Rendering the whole synth
+ * needs the MT-32 ROMs, which are looked for in the directory given by the
+ * MT32_ROM_PATH environment variable.
+ */
+class MT32BenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kSeconds = 60,
+		kChunkSize = 512
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom(uint32 range) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % range;
+	}
+
+#ifdef USE_MT32EMU
+	void runReverb(MT32Emu::ReverbMode mode, bool reference) {
+		MT32Emu::BReverbModel model(mode);
+		model.open();
+		model.setParameters(5, 5);
+
+		MT32Emu::Sample inLeft[kChunkSize], inRight[kChunkSize];
+		MT32Emu::Sample outLeft[kChunkSize], outRight[kChunkSize];
+		_seed = 1;
+		for (int i = 0; i < kChunkSize; i++) {
+			inLeft[i] = (int16)nextRandom(16384) - 8192;
+			inRight[i] = (int16)nextRandom(16384) - 8192;
+		}
+
+		const uint32 chunks = kSeconds * MT32Emu::SAMPLE_RATE / kChunkSize;
+		BenchmarkTimer timer;
+		for (uint32 i = 0; i < chunks; i++) {
+			if (reference)
+				model.processReference(inLeft, inRight, outLeft, outRight, kChunkSize);
+			else
+				model.process(inLeft, inRight, outLeft, outRight, kChunkSize);
+		}
+		printf(" %s %7.1fx", reference ? "reference" : "process", kSeconds / timer.elapsed());
+	}
+
+	static bool readFile(const char *path, const char *fileName, Common::Array<byte> &data) {
+		char name[1024];
+		snprintf(name, sizeof(name), "%s/%s", path, fileName);
+		FILE *file = fopen(name, "rb");
+		if (!file)
+			return false;
+
+		byte buffer[4096];
+		size_t read;
+		while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+			for (size_t i = 0; i < read; i++)
+				data.push_back(buffer[i]);
+		}
+		fclose(file);
+		return !data.empty();
+	}
+
+	/**
+	 * Sends a SysEx message to the system area of the synth, which sets
+	 * the reverb mode, time and level.
+	 */
+	static void setReverb(MT32Emu::Synth &synth, byte mode, byte time, byte level) {
+		byte sysEx[] = { 0xF0, 0x41, 0x10, 0x16, 0x12, 0x10, 0x00, 0x01, mode, time, level, 0x00, 0xF7 };
+		uint checksum = 0;
+		for (int i = 5; i < 11; i++)
+			checksum += sysEx[i];
+		sysEx[11] = (128 - checksum % 128) & 0x7F;
+		synth.playSysexNow(sysEx, sizeof(sysEx));
+	}
+
+	/**
+	 * Plays chords with random programs on all eight melodic parts, which
+	 * keeps most partials busy, and the rhythm part.
+	 */
+	void playEvents(MT32Emu::Synth &synth, uint32 chunk) {
+		if (chunk % 64 == 0)
+			setReverb(synth, nextRandom(4), 3 + nextRandom(5), 3 + nextRandom(5));
+
+		if (chunk % 8 == 0) {
+			const byte channel = 1 + nextRandom(8);
+			synth.playMsgNow(0x000000C0 | channel | nextRandom(128) << 8);
+			synth.playMsgNow(0x00007BB0 | channel);
+			for (int i = 0; i < 4; i++)
+				synth.playMsgNow(0x00000090 | channel | (36 + nextRandom(48)) << 8 | (64 + nextRandom(64)) << 16);
+		}
+
+		if (chunk % 4 == 0)
+			synth.playMsgNow(0x00000099 | (35 + nextRandom(47)) << 8 | (64 + nextRandom(64)) << 16);
+	}
+
+	void runSynth(const char *romPath) {
+		Common::Array<byte> controlData, pcmData;
+		if (!readFile(romPath, "MT32_CONTROL.ROM", controlData) || !readFile(romPath, "MT32_PCM.ROM", pcmData)) {
+			printf("\nMT-32 render: no ROMs in %s, skipped", romPath);
+			return;
+		}
+
+		MT32Emu::ArrayFile controlFile(&controlData[0], controlData.size());
+		MT32Emu::ArrayFile pcmFile(&pcmData[0], pcmData.size());
+		const MT32Emu::ROMImage *controlROM = MT32Emu::ROMImage::makeROMImage(&controlFile);
+		const MT32Emu::ROMImage *pcmROM = MT32Emu::ROMImage::makeROMImage(&pcmFile);
+
+		MT32Emu::Synth synth;
+		if (!controlROM || !pcmROM || !synth.open(*controlROM, *pcmROM)) {
+			printf("\nMT-32 render: could not open the synth, skipped");
+		} else {
+			int16 buffer[kChunkSize * 2];
+			const uint32 chunks = kSeconds * MT32Emu::SAMPLE_RATE / kChunkSize;
+			_seed = 1;
+
+			BenchmarkTimer timer;
+			for (uint32 i = 0; i < chunks; i++) {
+				playEvents(synth, i);
+				synth.render(buffer, kChunkSize);
+			}
+			printf("\nMT-32 render: %7.1fx real time", kSeconds / timer.elapsed());
+			synth.close();
+		}
+
+		if (controlROM)
+			MT32Emu::ROMImage::freeROMImage(controlROM);
+		if (pcmROM)
+			MT32Emu::ROMImage::freeROMImage(pcmROM);
+	}
+#endif
+
+public:
+	void test_reverb() {
+#ifdef USE_MT32EMU
+		static const char *const names[] = { "room", "hall", "plate", "tap delay" };
+		for (int mode = MT32Emu::REVERB_MODE_ROOM; mode <= MT32Emu::REVERB_MODE_TAP_DELAY; mode++) {
+			printf("\nMT-32 reverb %-9s:", names[mode]);
+			runReverb((MT32Emu::ReverbMode)mode, true);
+			runReverb((MT32Emu::ReverbMode)mode, false);
+		}
+		printf("\n");
+#endif
+	}
+
+	void test_render() {
+#ifdef USE_MT32EMU
+		const char *romPath = getenv("MT32_ROM_PATH");
+		if (romPath)
+			runSynth(romPath);
+		else
+			printf("\nMT-32 render: MT32_ROM_PATH not set, skipped");
+		printf("\n");
+#endif
+	}
+};
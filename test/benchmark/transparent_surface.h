@@ -0,0 +1,97 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/pixel_span.h"
+#include "graphics/transparent_surface.h"
+
+#include "test/benchmark/benchmark.h"
+
+class TransparentSurfaceBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kTargetWidth = 640,
+		kTargetHeight = 480,
+		kPixelsPerRun = 20000000
+	};
+
+	struct ModeDesc {
+		const char *name;
+		Graphics::AlphaType alphaMode;
+		Graphics::TSpriteBlendMode blendMode;
+		uint32 color;
+	};
+
+	static const ModeDesc *getModes() {
+		static const ModeDesc modes[] = {
+			{ "opaque",          Graphics::ALPHA_OPAQUE, Graphics::BLEND_NORMAL,      0xFFFFFFFF },
+			{ "binary",          Graphics::ALPHA_BINARY, Graphics::BLEND_NORMAL,      0xFFFFFFFF },
+			{ "normal",          Graphics::ALPHA_FULL,   Graphics::BLEND_NORMAL,      0xFFFFFFFF },
+			{ "normal_mod",      Graphics::ALPHA_FULL,   Graphics::BLEND_NORMAL,      0x80FF8040 },
+			{ "additive",        Graphics::ALPHA_FULL,   Graphics::BLEND_ADDITIVE,    0xFFFFFFFF },
+			{ "additive_mod",    Graphics::ALPHA_FULL,   Graphics::BLEND_ADDITIVE,    0x80FF8040 },
+			{ "subtractive",     Graphics::ALPHA_FULL,   Graphics::BLEND_SUBTRACTIVE, 0xFFFFFFFF },
+			{ "subtractive_mod", Graphics::ALPHA_FULL,   Graphics::BLEND_SUBTRACTIVE, 0x80FF8040 },
+			{ "multiply",        Graphics::ALPHA_FULL,   Graphics::BLEND_MULTIPLY,    0xFFFFFFFF },
+			{ "multiply_mod",    Graphics::ALPHA_FULL,   Graphics::BLEND_MULTIPLY,    0x80FF8040 },
+			{ 0, Graphics::ALPHA_FULL, Graphics::BLEND_NORMAL, 0 }
+		};
+		return modes;
+	}
+
+	static void fillSprite(Graphics::TransparentSurface &sprite) {
+		uint32 seed = 0x13579BDF;
+		for (int y = 0; y < sprite.h; y++) {
+			byte *row = (byte *)sprite.getBasePtr(0, y);
+			for (int x = 0; x < sprite.w * 4; x++) {
+				seed = seed * 1103515245 + 12345;
+				row[x] = seed >> 8;
+			}
+		}
+	}
+
+	void run(bool scaled) {
+		static const int sizes[] = { 16, 64, 256 };
+
+		Graphics::TransparentSurface target;
+		target.create(kTargetWidth, kTargetHeight, Graphics::TransparentSurface::getSupportedPixelFormat());
+		memset(target.getPixels(), 0x80, target.pitch * target.h);
+
+		for (uint kernel = 0; kernel < Graphics::getSpanKernelCount(); kernel++) {
+			Graphics::setSpanKernel(kernel);
+
+			for (const ModeDesc *desc = getModes(); desc->name; desc++) {
+				printf("\nTransparentSurface %-6s %s %-15s:", Graphics::getSpanKernelName(kernel), scaled ? "scaled" : "blit  ", desc->name);
+
+				for (uint size = 0; size < ARRAYSIZE(sizes); size++) {
+					Graphics::TransparentSurface sprite;
+					sprite.create(sizes[size], sizes[size], Graphics::TransparentSurface::getSupportedPixelFormat());
+					fillSprite(sprite);
+					sprite.setAlphaMode(desc->alphaMode);
+
+					// Scaled blits draw the sprite at 1.5 times its size
+					const int width = scaled ? sizes[size] * 3 / 2 : sizes[size];
+					const int pixels = width * width;
+					const int draws = MAX(1, kPixelsPerRun / pixels / 10);
+
+					BenchmarkTimer timer;
+					for (int i = 0; i < draws; i++)
+						sprite.blit(target, i & 63, i & 31, (i >> 6) & 3, nullptr, desc->color, width, width, desc->blendMode);
+					printf(" %3dx%-3d %7.1f", width, width, pixels * (double)draws / timer.elapsed() / 1000000.0);
+
+					sprite.free();
+				}
+				printf(" Mpixel/s");
+			}
+		}
+
+		Graphics::setSpanKernel(Graphics::getSpanKernelCount() - 1);
+		target.free();
+	}
+
+public:
+	void test_transparent_surface_blit() {
+		run(false);
+	}
+
+	void test_transparent_surface_scaled_blit() {
+		run(true);
+	}
+};
@@ -0,0 +1,115 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/pixel_span.h"
+#include "graphics/transparent_surface.h"
+#include "graphics/VectorRendererSpec.h"
+
+#include "test/benchmark/benchmark.h"
+
+class VectorRendererBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kSurfaceWidth = 640,
+		kSurfaceHeight = 480,
+		kMargin = 16,
+		kPixelsPerRun = 20000000
+	};
+
+	// The draw steps of the scummmodern DrawData, grouped by the shape and
+	// fill they exercise
+	struct StepDesc {
+		const char *name;
+		Graphics::DrawingFunctionCallback call;
+		int fill;
+		int radius;
+		int stroke;
+		int shadow;
+		int factor;
+	};
+
+	static const StepDesc *getSteps() {
+		static const StepDesc steps[] = {
+			{ "mainmenu_bg",   &Graphics::VectorRenderer::drawCallback_FILLSURFACE, Graphics::VectorRenderer::kFillGradient,   0,  0, 0, 1 },
+			{ "special_bg",    &Graphics::VectorRenderer::drawCallback_ROUNDSQ,     Graphics::VectorRenderer::kFillGradient,   5,  0, 7, 3 },
+			{ "button_idle",   &Graphics::VectorRenderer::drawCallback_ROUNDSQ,     Graphics::VectorRenderer::kFillGradient,   5,  1, 3, 3 },
+			{ "scrollbar",     &Graphics::VectorRenderer::drawCallback_ROUNDSQ,     Graphics::VectorRenderer::kFillBackground, 10, 1, 0, 1 },
+			{ "popup_idle",    &Graphics::VectorRenderer::drawCallback_SQUARE,      Graphics::VectorRenderer::kFillGradient,   0,  0, 0, 1 },
+			{ "separator",     &Graphics::VectorRenderer::drawCallback_SQUARE,      Graphics::VectorRenderer::kFillForeground, 0,  0, 0, 1 },
+			{ "widget_border", &Graphics::VectorRenderer::drawCallback_ROUNDSQ,     Graphics::VectorRenderer::kFillDisabled,   5,  2, 0, 1 },
+			{ "tab_active",    &Graphics::VectorRenderer::drawCallback_TAB,         Graphics::VectorRenderer::kFillBackground, 4,  0, 3, 1 },
+			{ 0, 0, 0, 0, 0, 0, 0 }
+		};
+		return steps;
+	}
+
+	static Graphics::DrawStep makeStep(const StepDesc &desc) {
+		Graphics::DrawStep step;
+
+		step.fgColor.r = 64; step.fgColor.g = 64; step.fgColor.b = 64; step.fgColor.set = true;
+		step.bgColor.r = 255; step.bgColor.g = 238; step.bgColor.b = 127; step.bgColor.set = true;
+		step.gradColor1.r = 206; step.gradColor1.g = 121; step.gradColor1.b = 0; step.gradColor1.set = true;
+		step.gradColor2.r = 255; step.gradColor2.g = 220; step.gradColor2.b = 140; step.gradColor2.set = true;
+		step.bevelColor.set = false;
+		step.autoWidth = step.autoHeight = true;
+		step.x = step.y = step.w = step.h = 0;
+		step.xAlign = step.yAlign = Graphics::DrawStep::kVectorAlignManual;
+		step.radius = desc.radius;
+		step.stroke = desc.stroke;
+		step.shadow = desc.shadow;
+		step.factor = desc.factor;
+		step.fillMode = desc.fill;
+		step.shadowFillMode = Graphics::VectorRenderer::kShadowExponential;
+		step.bevel = 0;
+		step.extraData = 0;
+		step.scale = 1 << 16;
+		step.autoscale = GUI::ThemeEngine::kAutoScaleNone;
+		step.drawingCall = desc.call;
+		step.blitSrc = 0;
+		step.blitAlphaSrc = 0;
+		return step;
+	}
+
+	template<typename PixelType>
+	void run(const Graphics::PixelFormat &format) {
+		static const int sizes[][2] = { { 24, 16 }, { 120, 24 }, { 320, 200 }, { 600, 440 } };
+
+		Graphics::TransparentSurface surface;
+		surface.create(kSurfaceWidth, kSurfaceHeight, format);
+		memset(surface.getPixels(), 0x80, surface.pitch * surface.h);
+
+		Graphics::VectorRendererSpec<PixelType> renderer(format);
+		renderer.setSurface(&surface);
+
+		for (uint kernel = 0; kernel < Graphics::getSpanKernelCount(); kernel++) {
+			Graphics::setSpanKernel(kernel);
+
+			for (const StepDesc *desc = getSteps(); desc->name; desc++) {
+				const Graphics::DrawStep step = makeStep(*desc);
+				printf("\nVectorRenderer %-6s %dbpp %-13s:", Graphics::getSpanKernelName(kernel), format.bytesPerPixel * 8, desc->name);
+
+				for (uint size = 0; size < ARRAYSIZE(sizes); size++) {
+					const Common::Rect area(kMargin, kMargin, kMargin + sizes[size][0], kMargin + sizes[size][1]);
+					const int pixels = desc->call == &Graphics::VectorRenderer::drawCallback_FILLSURFACE ? kSurfaceWidth * kSurfaceHeight : area.width() * area.height();
+					const int draws = MAX(1, kPixelsPerRun / pixels / 10);
+
+					BenchmarkTimer timer;
+					for (int i = 0; i < draws; i++)
+						renderer.drawStep(area, step);
+					printf(" %3dx%-3d %7.1f", sizes[size][0], sizes[size][1], pixels * (double)draws / timer.elapsed() / 1000000.0);
+				}
+				printf(" Mpixel/s");
+			}
+		}
+
+		Graphics::setSpanKernel(Graphics::getSpanKernelCount() - 1);
+		surface.free();
+	}
+
+public:
+	void test_vector_renderer_16bpp() {
+		run<uint16>(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+	}
+
+	void test_vector_renderer_32bpp() {
+		run<uint32>(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+	}
+};
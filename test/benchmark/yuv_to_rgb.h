@@ -0,0 +1,69 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "test/benchmark/benchmark.h"
+
+class YUVToRGBBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 640,
+		kHeight = 480,
+		kFrames = 100
+	};
+
+	void run(const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		byte *y = new byte[kWidth * kHeight];
+		byte *u = new byte[kWidth * kHeight];
+		byte *v = new byte[kWidth * kHeight];
+		for (int i = 0; i < kWidth * kHeight; i++) {
+			y[i] = i * 7;
+			u[i] = i * 13 + (i >> 9);
+			v[i] = i * 5 + (i >> 7);
+		}
+
+		Graphics::Surface dst;
+		dst.create(kWidth, kHeight, format);
+
+		for (uint kernel = 0; kernel < YUVToRGBMan.getKernelCount(); kernel++) {
+			YUVToRGBMan.setKernel(kernel);
+
+			BenchmarkTimer timer;
+			for (int frame = 0; frame < kFrames; frame++)
+				YUVToRGBMan.convert420(&dst, scale, y, u, v, kWidth, kHeight, kWidth, kWidth);
+			double convert420 = kWidth * kHeight * (double)kFrames / timer.elapsed() / 1000000.0;
+
+			timer.reset();
+			for (int frame = 0; frame < kFrames; frame++)
+				YUVToRGBMan.convert444(&dst, scale, y, u, v, kWidth, kHeight, kWidth, kWidth);
+			double convert444 = kWidth * kHeight * (double)kFrames / timer.elapsed() / 1000000.0;
+
+			timer.reset();
+			for (int frame = 0; frame < kFrames; frame++)
+				YUVToRGBMan.convert410(&dst, scale, y, u, v, kWidth, kHeight - 4, kWidth, kWidth);
+			double convert410 = kWidth * (kHeight - 4) * (double)kFrames / timer.elapsed() / 1000000.0;
+
+			printf("\nYUVToRGB %-6s %dbpp %-4s: 420 %8.1f, 444 %8.1f, 410 %8.1f Mpixel/s",
+			       YUVToRGBMan.getKernelName(kernel), format.bytesPerPixel * 8,
+			       scale == Graphics::YUVToRGBManager::kScaleFull ? "full" : "itu",
+			       convert420, convert444, convert410);
+		}
+
+		YUVToRGBMan.setKernel(YUVToRGBMan.getKernelCount() - 1);
+		dst.free();
+		delete[] y;
+		delete[] u;
+		delete[] v;
+	}
+
+public:
+	void test_yuv_to_rgb_16bpp() {
+		run(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), Graphics::YUVToRGBManager::kScaleFull);
+		run(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), Graphics::YUVToRGBManager::kScaleITU);
+	}
+
+	void test_yuv_to_rgb_32bpp() {
+		run(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), Graphics::YUVToRGBManager::kScaleFull);
+		run(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), Graphics::YUVToRGBManager::kScaleITU);
+	}
+};
@@ -0,0 +1,51 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/config-manager.h"
+
+class ConfigManagerTestSuite : public CxxTest::TestSuite {
+public:
+	void test_interned_key_lookup() {
+		Common::ConfigManager::KeyHandle key = ConfMan.internKey("test_interned_int");
+		TS_ASSERT(key.isValid());
+		TS_ASSERT(!ConfMan.hasKey(key));
+		TS_ASSERT_EQUALS(ConfMan.getInt(key), 0);
+
+		ConfMan.registerDefault("test_interned_int", 5);
+		TS_ASSERT(!ConfMan.hasKey(key));
+		TS_ASSERT_EQUALS(ConfMan.getInt(key), 5);
+		TS_ASSERT_EQUALS(ConfMan.get(key), "5");
+
+		ConfMan.setInt("test_interned_int", 0x10);
+		TS_ASSERT(ConfMan.hasKey(key));
+		TS_ASSERT_EQUALS(ConfMan.getInt(key), 16);
+
+		// Interning is case insensitive, like the domains
+		Common::ConfigManager::KeyHandle same = ConfMan.internKey("TEST_INTERNED_INT");
+		TS_ASSERT_EQUALS(ConfMan.getInt(same), 16);
+
+		ConfMan.removeKey("test_interned_int", Common::ConfigManager::kApplicationDomain);
+		TS_ASSERT_EQUALS(ConfMan.getInt(key), 5);
+	}
+
+	void test_interned_key_domains() {
+		Common::ConfigManager::KeyHandle key = ConfMan.internKey("test_interned_bool");
+		ConfMan.registerDefault("test_interned_bool", false);
+		TS_ASSERT(!ConfMan.getBool(key));
+
+		ConfMan.addGameDomain("interned_test_game");
+		ConfMan.getDomain("interned_test_game")->setVal("test_interned_bool", "true");
+		TS_ASSERT(!ConfMan.getBool(key));
+
+		ConfMan.setActiveDomain("interned_test_game");
+		TS_ASSERT(ConfMan.getBool(key));
+
+		ConfMan.getDomain(Common::ConfigManager::kTransientDomain)->setVal("test_interned_bool", "false");
+		TS_ASSERT(!ConfMan.getBool(key));
+		ConfMan.getDomain(Common::ConfigManager::kTransientDomain)->erase("test_interned_bool");
+		TS_ASSERT(ConfMan.getBool(key));
+
+		ConfMan.removeGameDomain("interned_test_game");
+		TS_ASSERT(!ConfMan.getBool(key));
+		TS_ASSERT(ConfMan.getActiveDomainName().empty());
+	}
+};
@@ -0,0 +1,162 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/coroutines.h"
+
+namespace {
+
+int g_coroTick = 0;
+
+struct CoroWaiter {
+	uint32 pid;
+	int ticks;    ///< number of ticks to sleep before finishing, if pid is 0
+	int wokenAt;  ///< tick the process continued at
+};
+
+/**
+ * Waits for the process or event given in the parameter, or sleeps if
+ * there is none
+ */
+void waiterProcess(CORO_PARAM, const void *param) {
+	CoroWaiter *waiter = *(CoroWaiter * const *)param;
+
+	CORO_BEGIN_CONTEXT;
+	CORO_END_CONTEXT(_ctx);
+
+	CORO_BEGIN_CODE(_ctx);
+
+	if (waiter->pid)
+		CORO_INVOKE_2(CoroScheduler.waitForSingleObject, waiter->pid, CORO_INFINITE);
+	else
+		CORO_SLEEP(waiter->ticks);
+
+	waiter->wokenAt = g_coroTick;
+
+	CORO_END_CODE;
+}
+
+struct CoroSetter {
+	uint32 pidEvent;
+	int ticks;    ///< number of ticks to sleep before setting the event
+};
+
+void setterProcess(CORO_PARAM, const void *param) {
+	const CoroSetter *setter = *(const CoroSetter * const *)param;
+
+	CORO_BEGIN_CONTEXT;
+	CORO_END_CONTEXT(_ctx);
+
+	CORO_BEGIN_CODE(_ctx);
+
+	CORO_SLEEP(setter->ticks);
+	CoroScheduler.setEvent(setter->pidEvent);
+
+	CORO_END_CODE;
+}
+
+void runCoroTicks(int count) {
+	for (int i = 0; i < count; i++) {
+		g_coroTick++;
+		CoroScheduler.schedule();
+	}
+}
+
+} // End of anonymous namespace
+
+class CoroutineSchedulerTestSuite : public CxxTest::TestSuite {
+public:
+	void test_wait_for_event() {
+		CoroScheduler.reset();
+		g_coroTick = 0;
+
+		uint32 pidEvent = CoroScheduler.createEvent(false, false);
+		CoroWaiter waiter = { pidEvent, 0, -1 };
+		CoroSetter setter = { pidEvent, 3 };
+		CoroWaiter *pWaiter = &waiter;
+		const CoroSetter *pSetter = &setter;
+
+		// New processes go to the front of the list, so the setter runs first
+		CoroScheduler.createProcess(waiterProcess, &pWaiter, sizeof(pWaiter));
+		CoroScheduler.createProcess(setterProcess, &pSetter, sizeof(pSetter));
+
+		runCoroTicks(10);
+		TS_ASSERT_EQUALS(waiter.wokenAt, 4);
+
+		// The event was reset automatically, so a new waiter has to wait
+		CoroWaiter waiter2 = { pidEvent, 0, -1 };
+		CoroWaiter *pWaiter2 = &waiter2;
+		CoroScheduler.createProcess(waiterProcess, &pWaiter2, sizeof(pWaiter2));
+		runCoroTicks(5);
+		TS_ASSERT_EQUALS(waiter2.wokenAt, -1);
+
+		CoroScheduler.setEvent(pidEvent);
+		runCoroTicks(1);
+		TS_ASSERT_EQUALS(waiter2.wokenAt, 16);
+
+		CoroScheduler.closeEvent(pidEvent);
+	}
+
+	void test_auto_reset_wakes_one() {
+		CoroScheduler.reset();
+		g_coroTick = 0;
+
+		uint32 pidEvent = CoroScheduler.createEvent(false, false);
+		CoroWaiter waiter1 = { pidEvent, 0, -1 };
+		CoroWaiter waiter2 = { pidEvent, 0, -1 };
+		CoroWaiter *pWaiter1 = &waiter1;
+		CoroWaiter *pWaiter2 = &waiter2;
+		CoroScheduler.createProcess(waiterProcess, &pWaiter1, sizeof(pWaiter1));
+		CoroScheduler.createProcess(waiterProcess, &pWaiter2, sizeof(pWaiter2));
+		runCoroTicks(2);
+
+		// The process created last is first in the list
+		CoroScheduler.setEvent(pidEvent);
+		runCoroTicks(1);
+		TS_ASSERT_EQUALS(waiter1.wokenAt, -1);
+		TS_ASSERT_EQUALS(waiter2.wokenAt, 3);
+
+		CoroScheduler.setEvent(pidEvent);
+		runCoroTicks(1);
+		TS_ASSERT_EQUALS(waiter1.wokenAt, 4);
+
+		CoroScheduler.closeEvent(pidEvent);
+	}
+
+	void test_wait_for_process() {
+		CoroScheduler.reset();
+		g_coroTick = 0;
+
+		CoroWaiter sleeper = { 0, 3, -1 };
+		CoroWaiter *pSleeper = &sleeper;
+		uint32 pidSleeper = CoroScheduler.createProcess(waiterProcess, &pSleeper, sizeof(pSleeper));
+
+		CoroWaiter waiter = { pidSleeper, 0, -1 };
+		CoroWaiter *pWaiter = &waiter;
+		CoroScheduler.createProcess(waiterProcess, &pWaiter, sizeof(pWaiter));
+
+		// The waiter runs before the sleeper, so it sees that it ended a tick later
+		runCoroTicks(10);
+		TS_ASSERT_EQUALS(sleeper.wokenAt, 4);
+		TS_ASSERT_EQUALS(waiter.wokenAt, 5);
+	}
+
+	void test_wait_for_killed_process() {
+		CoroScheduler.reset();
+		g_coroTick = 0;
+
+		CoroWaiter sleeper = { 0, 1000, -1 };
+		CoroWaiter *pSleeper = &sleeper;
+		uint32 pidSleeper = CoroScheduler.createProcess(waiterProcess, &pSleeper, sizeof(pSleeper));
+
+		CoroWaiter waiter = { pidSleeper, 0, -1 };
+		CoroWaiter *pWaiter = &waiter;
+		CoroScheduler.createProcess(waiterProcess, &pWaiter, sizeof(pWaiter));
+
+		runCoroTicks(5);
+		TS_ASSERT_EQUALS(waiter.wokenAt, -1);
+
+		TS_ASSERT_EQUALS(CoroScheduler.killMatchingProcess(pidSleeper), 1);
+		runCoroTicks(1);
+		TS_ASSERT_EQUALS(sleeper.wokenAt, -1);
+		TS_ASSERT_EQUALS(waiter.wokenAt, 6);
+	}
+};
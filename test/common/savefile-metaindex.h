@@ -0,0 +1,146 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/savefile-metaindex.h"
+#include "common/memstream.h"
+
+class SaveFileMetaIndexTestSuite : public CxxTest::TestSuite {
+	static Common::SaveFileMetaIndex::Signature makeSignature(uint32 size, byte first) {
+		Common::SaveFileMetaIndex::Signature signature;
+		signature.size = size;
+		for (int i = 0; i < 16; i++)
+			signature.md5[i] = first + i;
+		return signature;
+	}
+
+	static Common::SaveFileMetaInfo makeInfo(int slot, const char *description) {
+		Common::SaveFileMetaInfo info;
+		info.slot = slot;
+		info.description = description;
+		info.saveDate = "18.10.2026";
+		info.saveTime = "12:34";
+		info.playTime = "1:02:03";
+		info.deletable = false;
+		info.writeProtected = true;
+		return info;
+	}
+
+	static bool roundTrip(Common::SaveFileMetaIndex &in, Common::SaveFileMetaIndex &out) {
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::YES);
+		if (!in.save(stream))
+			return false;
+
+		Common::MemoryReadStream data(stream.getData(), stream.size());
+		return out.load(data);
+	}
+
+public:
+	void test_round_trip() {
+		Common::SaveFileMetaIndex index;
+		index.set("game.001", makeSignature(1000, 20), makeInfo(1, "First"), true);
+		index.set("game.002", makeSignature(2000, 40), Common::SaveFileMetaInfo(), false);
+		TS_ASSERT(index.isDirty());
+
+		Common::SaveFileMetaIndex loaded;
+		TS_ASSERT(roundTrip(index, loaded));
+		TS_ASSERT(!index.isDirty());
+		TS_ASSERT(!loaded.isDirty());
+
+		Common::SaveFileMetaInfo info;
+		TS_ASSERT(loaded.lookup("GAME.001", makeSignature(1000, 20), info));
+		TS_ASSERT_EQUALS(info.slot, 1);
+		TS_ASSERT_EQUALS(info.description, "First");
+		TS_ASSERT_EQUALS(info.saveDate, "18.10.2026");
+		TS_ASSERT_EQUALS(info.saveTime, "12:34");
+		TS_ASSERT_EQUALS(info.playTime, "1:02:03");
+		TS_ASSERT(!info.deletable);
+		TS_ASSERT(info.writeProtected);
+		TS_ASSERT(loaded.hasThumbnail("game.001"));
+
+		TS_ASSERT(loaded.lookup("game.002", makeSignature(2000, 40), info));
+		TS_ASSERT_EQUALS(info.slot, 0);
+		TS_ASSERT(info.description.empty());
+		TS_ASSERT(info.deletable);
+		TS_ASSERT(!loaded.hasThumbnail("game.002"));
+		TS_ASSERT(!loaded.isDirty());
+	}
+
+	void test_signature_mismatch() {
+		Common::SaveFileMetaIndex index;
+		index.set("game.001", makeSignature(1000, 20), makeInfo(1, "First"), true);
+		index.set("game.002", makeSignature(2000, 40), makeInfo(2, "Second"), true);
+
+		Common::SaveFileMetaIndex loaded;
+		TS_ASSERT(roundTrip(index, loaded));
+
+		// Same size, but different contents
+		Common::SaveFileMetaInfo info;
+		TS_ASSERT(!loaded.lookup("game.001", makeSignature(1000, 21), info));
+		TS_ASSERT(!loaded.contains("game.001"));
+		TS_ASSERT(!loaded.hasThumbnail("game.001"));
+		TS_ASSERT(loaded.isDirty());
+
+		// Same hash, but a different size
+		TS_ASSERT(!loaded.lookup("game.002", makeSignature(2001, 40), info));
+		TS_ASSERT(!loaded.contains("game.002"));
+	}
+
+	void test_remove() {
+		Common::SaveFileMetaIndex index;
+		index.set("game.001", makeSignature(1000, 20), makeInfo(1, "First"), false);
+
+		Common::SaveFileMetaIndex loaded;
+		TS_ASSERT(roundTrip(index, loaded));
+		TS_ASSERT(!loaded.remove("game.002"));
+		TS_ASSERT(!loaded.isDirty());
+		TS_ASSERT(loaded.remove("game.001"));
+		TS_ASSERT(loaded.isDirty());
+		TS_ASSERT(!loaded.contains("game.001"));
+	}
+
+	void test_invalid_index() {
+		Common::SaveFileMetaIndex index;
+		index.set("game.001", makeSignature(1000, 20), makeInfo(1, "First"), true);
+
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::YES);
+		TS_ASSERT(index.save(stream));
+
+		Common::SaveFileMetaIndex loaded;
+		loaded.set("other.001", makeSignature(10, 10), makeInfo(1, "Other"), false);
+
+		// Truncated in the middle of the entry
+		Common::MemoryReadStream truncated(stream.getData(), stream.size() - 3);
+		TS_ASSERT(!loaded.load(truncated));
+		TS_ASSERT(!loaded.contains("game.001"));
+		TS_ASSERT(!loaded.contains("other.001"));
+
+		// Not an index at all
+		static const byte garbage[] = { 'S', 'A', 'V', 'E', 0, 0, 0, 0 };
+		Common::MemoryReadStream wrongTag(garbage, sizeof(garbage));
+		TS_ASSERT(!loaded.load(wrongTag));
+
+		Common::MemoryReadStream empty(garbage, 0);
+		TS_ASSERT(!loaded.load(empty));
+	}
+
+	void test_compute_signature() {
+		static const byte data[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+		static const byte changed[] = { 1, 2, 3, 4, 0, 6, 7, 8, 9, 10, 11, 12 };
+		Common::SaveFileMetaIndex::Signature signature, other;
+
+		Common::MemoryReadStream stream(data, sizeof(data));
+		TS_ASSERT(Common::SaveFileMetaIndex::computeSignature(stream, signature));
+		TS_ASSERT_EQUALS(signature.size, sizeof(data));
+
+		// The whole file is hashed, from the start
+		Common::MemoryReadStream again(data, sizeof(data));
+		again.seek(5);
+		TS_ASSERT(Common::SaveFileMetaIndex::computeSignature(again, other));
+		TS_ASSERT(signature == other);
+
+		// A savefile rewritten in place at the same size and with the same end
+		Common::MemoryReadStream changedStream(changed, sizeof(changed));
+		TS_ASSERT(Common::SaveFileMetaIndex::computeSignature(changedStream, other));
+		TS_ASSERT_EQUALS(other.size, sizeof(data));
+		TS_ASSERT(!(signature == other));
+	}
+};
@@ -0,0 +1,76 @@
+#include <cxxtest/TestSuite.h>
+#include "engines/groovie/cell.h"
+
+/**
+ * Plays cell games between random search depths and checks that the fast
+ * search of the microscope puzzle chooses the same moves as the original.
+ */
+class GroovieCellTestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed ^= _seed << 13;
+		_seed ^= _seed >> 17;
+		_seed ^= _seed << 5;
+		return _seed;
+	}
+
+	static bool sameMove(Groovie::CellGame &a, Groovie::CellGame &b) {
+		return a.getStartX() == b.getStartX() && a.getStartY() == b.getStartY() &&
+		       a.getEndX() == b.getEndX() && a.getEndY() == b.getEndY();
+	}
+
+	// Applies a move to a board in the encoding of the scripts, where 50
+	// is a blue and 66 a green cell
+	static void applyMove(byte *board, byte color, int startX, int startY, int endX, int endY) {
+		byte cell = color == CELL_BLUE ? 50 : 66;
+
+		if (ABS(endX - startX) > 1 || ABS(endY - startY) > 1)
+			board[startY * 7 + startX] = 0;
+		board[endY * 7 + endX] = cell;
+
+		for (int y = MAX(endY - 1, 0); y <= MIN(endY + 1, 6); ++y) {
+			for (int x = MAX(endX - 1, 0); x <= MIN(endX + 1, 6); ++x) {
+				if (board[y * 7 + x])
+					board[y * 7 + x] = cell;
+			}
+		}
+	}
+
+public:
+	void test_same_moves() {
+		_seed = 0x13579BDF;
+
+		for (int game = 0; game < 4; ++game) {
+			Groovie::CellGame reference;
+			Groovie::CellGame fast;
+			reference.setFastSearch(false);
+			fast.setFastSearch(true);
+
+			byte board[49];
+			memset(board, 0, sizeof(board));
+			board[0] = board[48] = 50;
+			board[6] = board[42] = 66;
+
+			byte color = CELL_BLUE;
+			int passes = 0;
+			for (int ply = 0; ply < 100 && passes < 2; ++ply) {
+				uint16 depth = nextRandom() % 9;
+
+				int referenceResult = reference.playStauf(color, depth, board);
+				int fastResult = fast.playStauf(color, depth, board);
+
+				TS_ASSERT_EQUALS(referenceResult, fastResult);
+				if (!referenceResult) {
+					++passes;
+				} else {
+					TS_ASSERT(sameMove(reference, fast));
+					passes = 0;
+					applyMove(board, color, reference.getStartX(), reference.getStartY(), reference.getEndX(), reference.getEndY());
+				}
+
+				color = color == CELL_BLUE ? CELL_GREEN : CELL_BLUE;
+			}
+		}
+	}
+};
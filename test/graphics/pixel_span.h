@@ -0,0 +1,282 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/pixel_span.h"
+
+class PixelSpanTestSuite : public CxxTest::TestSuite {
+	enum {
+		kSize = 45
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	// Per pixel blending, as done by VectorRendererSpec::blendPixelPtr
+	template<typename PixelInt>
+	PixelInt blendPixel(const Graphics::PixelFormat &format, PixelInt dst, PixelInt color, uint8 alpha) {
+		const uint32 redMask = (0xFF >> format.rLoss) << format.rShift;
+		const uint32 greenMask = (0xFF >> format.gLoss) << format.gShift;
+		const uint32 blueMask = (0xFF >> format.bLoss) << format.bShift;
+		const uint32 alphaMask = (0xFF >> format.aLoss) << format.aShift;
+
+		if (alpha == 0xff)
+			return color | alphaMask;
+
+		if (sizeof(PixelInt) == 4) {
+			byte dR = (dst & redMask) >> format.rShift;
+			byte dG = (dst & greenMask) >> format.gShift;
+			byte dB = (dst & blueMask) >> format.bShift;
+			byte dA = (dst & alphaMask) >> format.aShift;
+
+			dR += ((int)((color & redMask) >> format.rShift) - dR) * alpha >> 8;
+			dG += ((int)((color & greenMask) >> format.gShift) - dG) * alpha >> 8;
+			dB += ((int)((color & blueMask) >> format.bShift) - dB) * alpha >> 8;
+			dA += (0xff - dA) * alpha >> 8;
+
+			return ((dR << format.rShift) & redMask) | ((dG << format.gShift) & greenMask)
+			     | ((dB << format.bShift) & blueMask) | ((dA << format.aShift) & alphaMask);
+		}
+
+		int result = 0;
+		const uint32 masks[4] = { redMask, greenMask, blueMask, alphaMask };
+		for (int i = 0; i < 4; i++) {
+			int src = (i == 3) ? (int)alphaMask : (int)(color & masks[i]);
+			int d = dst & masks[i];
+			result |= masks[i] & (d + ((src - d) * alpha >> 8));
+		}
+		return result;
+	}
+
+	template<typename PixelInt>
+	void checkBlend(const Graphics::PixelFormat &format) {
+		static const uint8 alphas[] = { 0, 1, 4, 127, 128, 200, 254, 255 };
+		PixelInt src[kSize], expected[kSize], result[kSize];
+
+		_seed = 0x12345678;
+		for (uint kernel = 0; kernel < Graphics::getSpanKernelCount(); kernel++) {
+			Graphics::setSpanKernel(kernel);
+
+			for (uint a = 0; a < ARRAYSIZE(alphas); a++) {
+				for (int start = 0; start < 4; start++) {
+					for (int end = start; end <= kSize; end += 5) {
+						PixelInt color = (PixelInt)nextRandom();
+						for (int i = 0; i < kSize; i++)
+							src[i] = (PixelInt)nextRandom();
+
+						for (int i = 0; i < kSize; i++) {
+							expected[i] = (i >= start && i < end) ? blendPixel<PixelInt>(format, src[i], color, alphas[a]) : src[i];
+							result[i] = src[i];
+						}
+
+						Graphics::blendSpan(result + start, result + end, format, color, alphas[a]);
+						TS_ASSERT_SAME_DATA(expected, result, sizeof(result));
+					}
+				}
+			}
+		}
+
+		Graphics::setSpanKernel(Graphics::getSpanKernelCount() - 1);
+	}
+
+	// Per pixel coverage blending, as done by the TrueType glyph renderer
+	template<typename PixelInt>
+	PixelInt maskPixel(const Graphics::PixelFormat &format, PixelInt dst, PixelInt color, uint8 coverage) {
+		if (coverage == 255)
+			return color;
+		if (coverage == 0)
+			return dst;
+
+		uint8 sR, sG, sB, dR, dG, dB;
+		format.colorToRGB(color, sR, sG, sB);
+		format.colorToRGB(dst, dR, dG, dB);
+
+		dR = ((255 - coverage) * dR + coverage * sR) / 255;
+		dG = ((255 - coverage) * dG + coverage * sG) / 255;
+		dB = ((255 - coverage) * dB + coverage * sB) / 255;
+		return format.RGBToColor(dR, dG, dB);
+	}
+
+	template<typename PixelInt>
+	void checkMask(const Graphics::PixelFormat &format) {
+		PixelInt src[kSize], expected[kSize], result[kSize];
+		byte coverage[kSize];
+
+		_seed = 0x87654321;
+		for (uint kernel = 0; kernel < Graphics::getSpanKernelCount(); kernel++) {
+			Graphics::setSpanKernel(kernel);
+
+			for (int start = 0; start < 4; start++) {
+				for (int end = start; end <= kSize; end += 3) {
+					PixelInt color = (PixelInt)format.ARGBToColor(0xFF, nextRandom(), nextRandom(), nextRandom());
+					for (int i = 0; i < kSize; i++) {
+						src[i] = (PixelInt)nextRandom();
+						// Mostly fully covered or empty, like real glyphs
+						switch (nextRandom() % 4) {
+						case 0:
+							coverage[i] = 0;
+							break;
+						case 1:
+							coverage[i] = 255;
+							break;
+						default:
+							coverage[i] = nextRandom();
+							break;
+						}
+					}
+					// A run of empty pixels wider than a vector
+					if (end == kSize)
+						memset(coverage + start, 0, MIN(20, end - start));
+
+					for (int i = 0; i < kSize; i++) {
+						expected[i] = (i >= start && i < end) ? maskPixel<PixelInt>(format, src[i], color, coverage[i]) : src[i];
+						result[i] = src[i];
+					}
+
+					Graphics::maskSpan(result + start, result + end, coverage + start, format, color);
+					TS_ASSERT_SAME_DATA(expected, result, sizeof(result));
+				}
+			}
+		}
+
+		Graphics::setSpanKernel(Graphics::getSpanKernelCount() - 1);
+	}
+
+	void checkBlit(Graphics::TSpriteBlendMode blendMode) {
+		static const uint32 colors[] = { 0xFFFFFFFF, 0xFFFF00FF, 0x80FFFFFF, 0xFF12FF34, 0x7F563412, 0x01FFFFFF };
+		// Flipped blits step backwards, the last step skips every other pixel
+		static const int32 steps[] = { 4, -4, 8 };
+		byte src[kSize * 8], dst[kSize * 4], expected[kSize * 4], result[kSize * 4];
+
+		_seed = 0x2468ACE0;
+		for (uint kernel = 1; kernel < Graphics::getSpanKernelCount(); kernel++) {
+			for (uint c = 0; c < ARRAYSIZE(colors); c++) {
+				for (uint step = 0; step < ARRAYSIZE(steps); step++) {
+					for (int count = 0; count <= kSize; count += 3) {
+						for (int i = 0; i < kSize * 8; i++)
+							src[i] = nextRandom();
+						for (int i = 0; i < kSize * 4; i++)
+							dst[i] = nextRandom();
+						// Make sure fully transparent and opaque pixels are covered
+						for (int i = 0; i < kSize * 2; i += 3)
+							src[i * 4 + (nextRandom() & 3)] = (i & 1) ? 0 : 255;
+
+						const int32 inStep = steps[step];
+						const byte *in = (inStep < 0) ? src + (count - 1) * 4 : src;
+
+						memcpy(expected, dst, sizeof(dst));
+						Graphics::setSpanKernel(0);
+						Graphics::blitSpan(blendMode, in, inStep, expected, count, colors[c]);
+
+						memcpy(result, dst, sizeof(dst));
+						Graphics::setSpanKernel(kernel);
+						Graphics::blitSpan(blendMode, in, inStep, result, count, colors[c]);
+
+						TS_ASSERT_SAME_DATA(expected, result, sizeof(result));
+					}
+				}
+			}
+		}
+
+		Graphics::setSpanKernel(Graphics::getSpanKernelCount() - 1);
+	}
+
+	template<typename PixelInt>
+	void checkFill() {
+		PixelInt expected[kSize], result[kSize];
+
+		for (uint kernel = 0; kernel < Graphics::getSpanKernelCount(); kernel++) {
+			Graphics::setSpanKernel(kernel);
+
+			for (int start = 0; start < 4; start++) {
+				for (int end = start; end <= kSize; end++) {
+					for (int pattern = 0; pattern < 2; pattern++) {
+						PixelInt even = (PixelInt)0x12345678;
+						PixelInt odd = pattern ? (PixelInt)0x9ABCDEF0 : even;
+
+						for (int i = 0; i < kSize; i++) {
+							expected[i] = (i >= start && i < end) ? (((i - start) & 1) ? odd : even) : 0;
+							result[i] = 0;
+						}
+
+						Graphics::fillSpan(result + start, result + end, even, odd);
+						TS_ASSERT_SAME_DATA(expected, result, sizeof(result));
+					}
+				}
+			}
+		}
+
+		Graphics::setSpanKernel(Graphics::getSpanKernelCount() - 1);
+	}
+
+public:
+	void test_blend_rgb565() {
+		checkBlend<uint16>(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+	}
+
+	void test_blend_argb4444() {
+		checkBlend<uint16>(Graphics::PixelFormat(2, 4, 4, 4, 4, 8, 4, 0, 12));
+	}
+
+	void test_blend_rgba8888() {
+		checkBlend<uint32>(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+	}
+
+	void test_blend_xrgb8888() {
+		checkBlend<uint32>(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0));
+	}
+
+	void test_blend_rgb666() {
+		checkBlend<uint32>(Graphics::PixelFormat(4, 6, 6, 6, 0, 12, 6, 0, 0));
+	}
+
+	void test_mask_rgb565() {
+		checkMask<uint16>(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+	}
+
+	void test_mask_argb4444() {
+		checkMask<uint16>(Graphics::PixelFormat(2, 4, 4, 4, 4, 8, 4, 0, 12));
+	}
+
+	void test_mask_rgb332() {
+		checkMask<uint16>(Graphics::PixelFormat(2, 3, 3, 2, 0, 5, 2, 0, 0));
+	}
+
+	void test_mask_rgba8888() {
+		checkMask<uint32>(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+	}
+
+	void test_mask_xrgb8888() {
+		checkMask<uint32>(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0));
+	}
+
+	void test_mask_rgb666() {
+		checkMask<uint32>(Graphics::PixelFormat(4, 6, 6, 6, 0, 12, 6, 0, 0));
+	}
+
+	void test_blit_normal() {
+		checkBlit(Graphics::BLEND_NORMAL);
+	}
+
+	void test_blit_additive() {
+		checkBlit(Graphics::BLEND_ADDITIVE);
+	}
+
+	void test_blit_subtractive() {
+		checkBlit(Graphics::BLEND_SUBTRACTIVE);
+	}
+
+	void test_blit_multiply() {
+		checkBlit(Graphics::BLEND_MULTIPLY);
+	}
+
+	void test_fill_16bpp() {
+		checkFill<uint16>();
+	}
+
+	void test_fill_32bpp() {
+		checkFill<uint32>();
+	}
+};
@@ -0,0 +1,107 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/transparent_surface.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite {
+	enum {
+		kTargetWidth = 40,
+		kTargetHeight = 30
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	void fillRandom(Graphics::Surface &surface) {
+		for (int y = 0; y < surface.h; y++) {
+			byte *row = (byte *)surface.getBasePtr(0, y);
+			for (int x = 0; x < surface.w * 4; x++)
+				row[x] = nextRandom();
+		}
+	}
+
+	// Blitting a sprite scaled must give the same result as blitting the
+	// sprite scaled by scale() beforehand
+	void checkScaledBlit(Graphics::AlphaType alphaMode, Graphics::TSpriteBlendMode blendMode, uint32 color) {
+		static const int sizes[][2] = { { 20, 5 }, { 7, 17 }, { 26, 18 }, { 1, 1 } };
+		static const int positions[][2] = { { 3, 4 }, { -5, -3 }, { 30, 22 }, { -8, 25 } };
+
+		Graphics::TransparentSurface sprite;
+		sprite.create(13, 9, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fillRandom(sprite);
+		sprite.setAlphaMode(alphaMode);
+
+		Graphics::Surface expected, result;
+		expected.create(kTargetWidth, kTargetHeight, Graphics::TransparentSurface::getSupportedPixelFormat());
+		result.create(kTargetWidth, kTargetHeight, Graphics::TransparentSurface::getSupportedPixelFormat());
+
+		for (uint size = 0; size < ARRAYSIZE(sizes); size++) {
+			Graphics::TransparentSurface *scaled = sprite.scale(sizes[size][0], sizes[size][1]);
+			scaled->setAlphaMode(alphaMode);
+
+			for (uint pos = 0; pos < ARRAYSIZE(positions); pos++) {
+				for (int flipping = 0; flipping < 4; flipping++) {
+					for (int clip = 0; clip < 2; clip++) {
+						fillRandom(expected);
+						result.copyFrom(expected);
+
+						Common::Rect expectedRect, resultRect;
+						if (clip) {
+							const Common::Rect clippingArea(5, 2, 33, 27);
+							expectedRect = scaled->blitClip(expected, clippingArea, positions[pos][0], positions[pos][1], flipping, nullptr, color, -1, -1, blendMode);
+							resultRect = sprite.blitClip(result, clippingArea, positions[pos][0], positions[pos][1], flipping, nullptr, color, sizes[size][0], sizes[size][1], blendMode);
+						} else {
+							expectedRect = scaled->blit(expected, positions[pos][0], positions[pos][1], flipping, nullptr, color, -1, -1, blendMode);
+							resultRect = sprite.blit(result, positions[pos][0], positions[pos][1], flipping, nullptr, color, sizes[size][0], sizes[size][1], blendMode);
+						}
+
+						TS_ASSERT_EQUALS(expectedRect, resultRect);
+						TS_ASSERT_SAME_DATA(expected.getPixels(), result.getPixels(), expected.pitch * expected.h);
+					}
+				}
+			}
+
+			scaled->free();
+			delete scaled;
+		}
+
+		expected.free();
+		result.free();
+		sprite.free();
+	}
+
+public:
+	void test_scaled_blit_opaque() {
+		_seed = 1;
+		checkScaledBlit(Graphics::ALPHA_OPAQUE, Graphics::BLEND_NORMAL, 0xFFFFFFFF);
+	}
+
+	void test_scaled_blit_binary() {
+		_seed = 2;
+		checkScaledBlit(Graphics::ALPHA_BINARY, Graphics::BLEND_NORMAL, 0xFFFFFFFF);
+	}
+
+	void test_scaled_blit_normal() {
+		_seed = 3;
+		checkScaledBlit(Graphics::ALPHA_FULL, Graphics::BLEND_NORMAL, 0xFFFFFFFF);
+		checkScaledBlit(Graphics::ALPHA_FULL, Graphics::BLEND_NORMAL, 0x80FF40FF);
+	}
+
+	void test_scaled_blit_additive() {
+		_seed = 4;
+		checkScaledBlit(Graphics::ALPHA_FULL, Graphics::BLEND_ADDITIVE, 0xC0FFFFFF);
+	}
+
+	void test_scaled_blit_subtractive() {
+		_seed = 5;
+		checkScaledBlit(Graphics::ALPHA_FULL, Graphics::BLEND_SUBTRACTIVE, 0xFFFFFFFF);
+	}
+
+	void test_scaled_blit_multiply() {
+		_seed = 6;
+		checkScaledBlit(Graphics::ALPHA_FULL, Graphics::BLEND_MULTIPLY, 0xFF8080FF);
+	}
+};
@@ -0,0 +1,93 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 84,
+		kHeight = 36,
+		kPitch = kWidth + 8
+	};
+
+	enum Subsampling {
+		k444,
+		k420,
+		k410
+	};
+
+	byte _y[kPitch * kHeight];
+	byte _u[kPitch * kHeight];
+	byte _v[kPitch * kHeight];
+
+	void fillPlanes() {
+		uint32 seed = 0x12345678;
+		for (int i = 0; i < kPitch * kHeight; i++) {
+			seed = seed * 1103515245 + 12345;
+			_y[i] = seed >> 24;
+			seed = seed * 1103515245 + 12345;
+			_u[i] = seed >> 24;
+			seed = seed * 1103515245 + 12345;
+			_v[i] = seed >> 24;
+		}
+	}
+
+	void convert(Graphics::Surface &dst, Subsampling subsampling, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		switch (subsampling) {
+		case k444:
+			YUVToRGBMan.convert444(&dst, scale, _y, _u, _v, kWidth, kHeight, kPitch, kPitch);
+			break;
+		case k420:
+			YUVToRGBMan.convert420(&dst, scale, _y, _u, _v, kWidth, kHeight, kPitch, kPitch);
+			break;
+		case k410:
+			YUVToRGBMan.convert410(&dst, scale, _y, _u, _v, kWidth, kHeight, kPitch, kPitch);
+			break;
+		}
+	}
+
+	void checkKernels(const Graphics::PixelFormat &format) {
+		fillPlanes();
+
+		Graphics::Surface reference, result;
+		reference.create(kWidth, kHeight, format);
+		result.create(kWidth, kHeight, format);
+
+		for (int subsampling = k444; subsampling <= k410; subsampling++) {
+			for (int scale = Graphics::YUVToRGBManager::kScaleFull; scale <= Graphics::YUVToRGBManager::kScaleITU; scale++) {
+				YUVToRGBMan.setKernel(0);
+				convert(reference, (Subsampling)subsampling, (Graphics::YUVToRGBManager::LuminanceScale)scale);
+
+				for (uint kernel = 1; kernel < YUVToRGBMan.getKernelCount(); kernel++) {
+					YUVToRGBMan.setKernel(kernel);
+					memset(result.getPixels(), 0, result.pitch * result.h);
+					convert(result, (Subsampling)subsampling, (Graphics::YUVToRGBManager::LuminanceScale)scale);
+
+					for (int y = 0; y < kHeight; y++)
+						TS_ASSERT_SAME_DATA(reference.getBasePtr(0, y), result.getBasePtr(0, y), kWidth * format.bytesPerPixel);
+				}
+			}
+		}
+
+		YUVToRGBMan.setKernel(YUVToRGBMan.getKernelCount() - 1);
+		reference.free();
+		result.free();
+	}
+
+public:
+	void test_kernels_rgb565() {
+		checkKernels(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+	}
+
+	void test_kernels_argb1555() {
+		checkKernels(Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15));
+	}
+
+	void test_kernels_rgba8888() {
+		checkKernels(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+	}
+
+	void test_kernels_xbgr8888() {
+		checkKernels(Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 24));
+	}
+};
@@ -5,14 +5,23 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h
+TEST_LIBS    := audio/libaudio.a graphics/libgraphics.a common/libcommon.a
+
+ifdef USE_MT32EMU
+	TEST_LIBS := audio/softsynth/mt32/libmt32.a $(TEST_LIBS)
+endif
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
 	TEST_LIBS += engines/wintermute/libwintermute.a
 endif
 
+ifeq ($(ENABLE_GROOVIE), STATIC_PLUGIN)
+	TESTS += $(srcdir)/test/engines/groovie/*.h
+	TEST_LIBS += engines/groovie/libgroovie.a
+endif
+
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/cxxtest_mingw.h
 TEST_CFLAGS  := $(CFLAGS) -I$(srcdir)/test/cxxtest
@@ -42,8 +51,24 @@ test/runner.cpp: $(TESTS)
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+######################################################################
+# Benchmarks, also based on CxxTest. They are not part of the 'test'
+# target since they take a while; use the 'benchmark' target to run them.
+#
+######################################################################
+
+BENCHMARKS   := $(srcdir)/test/benchmark/*.h
+
+benchmark: test/benchmark_runner
+	./test/benchmark_runner
+test/benchmark_runner: test/benchmark_runner.cpp $(TEST_LIBS)
+	$(QUIET_CXX)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -DFORBIDDEN_SYMBOL_ALLOW_ALL -o $@ $+ $(TEST_LDFLAGS)
+test/benchmark_runner.cpp: $(BENCHMARKS)
+	@mkdir -p test
+	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner
+	-$(RM) test/runner.cpp test/runner test/benchmark_runner.cpp test/benchmark_runner
 
-.PHONY: test clean-test
+.PHONY: test benchmark clean-test
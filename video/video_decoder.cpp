@@ -27,6 +27,7 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/profiler.h"
 #include "common/system.h"
 
 #include "graphics/palette.h"
@@ -182,6 +183,8 @@ Graphics::PixelFormat VideoDecoder::getPixelFormat() const {
 }
 
 const Graphics::Surface *VideoDecoder::decodeNextFrame() {
+	PROFILE_ZONE("VideoDecoder::decodeNextFrame");
+
 	_needsUpdate = false;
 	_canSetDither = false;
 